@@ -0,0 +1,201 @@
+//
+//  YYBenchAlloc.c
+//  ModelBenchmark
+//
+
+/*
+ Counts heap allocations of the whole process.
+
+ Linux (glibc): malloc() and friends are defined in the executable, so they interpose the
+ libc functions for every library (Foundation, objc runtime, ...), and forward to the
+ __libc_* entry points. Live bytes are tracked with malloc_usable_size().
+
+ macOS: the malloc_logger hook of libmalloc is installed while counting, it's called for
+ every allocation of every zone. Live bytes are not tracked.
+ */
+
+#include "YYBenchAlloc.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/resource.h>
+
+static int YYAllocEnabled;
+static uint64_t YYAllocCount;
+static uint64_t YYAllocBytes;
+static int64_t YYAllocLive;
+static int64_t YYAllocPeak;
+
+static inline int YYAllocIsEnabled(void) {
+    return __atomic_load_n(&YYAllocEnabled, __ATOMIC_RELAXED);
+}
+
+/// A block allocated before YYBenchAllocBegin() may be freed while counting, the live bytes
+/// are clamped at the baseline (0) so such frees can't make them negative.
+static inline void YYAllocAddLive(int64_t delta) {
+    int64_t live = __atomic_load_n(&YYAllocLive, __ATOMIC_RELAXED), next;
+    do {
+        next = live + delta;
+        if (next < 0) next = 0;
+    } while (!__atomic_compare_exchange_n(&YYAllocLive, &live, next, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+    live = next;
+    int64_t peak = __atomic_load_n(&YYAllocPeak, __ATOMIC_RELAXED);
+    while (live > peak && !__atomic_compare_exchange_n(&YYAllocPeak, &peak, live, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {}
+}
+
+static inline void YYAllocAddCount(uint64_t size) {
+    __atomic_add_fetch(&YYAllocCount, 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&YYAllocBytes, size, __ATOMIC_RELAXED);
+}
+
+#if defined(__linux__) && defined(__GLIBC__)
+
+#include <malloc.h>
+
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t count, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+extern void *__libc_memalign(size_t alignment, size_t size);
+extern void __libc_free(void *ptr);
+
+static inline void YYAllocRecord(void *ptr, size_t size) {
+    if (!ptr || !YYAllocIsEnabled()) return;
+    YYAllocAddCount(size);
+    YYAllocAddLive((int64_t)malloc_usable_size(ptr));
+}
+
+void *malloc(size_t size) {
+    void *ptr = __libc_malloc(size);
+    YYAllocRecord(ptr, size);
+    return ptr;
+}
+
+void *calloc(size_t count, size_t size) {
+    void *ptr = __libc_calloc(count, size);
+    YYAllocRecord(ptr, count * size);
+    return ptr;
+}
+
+void *realloc(void *ptr, size_t size) {
+    size_t old = (ptr && YYAllocIsEnabled()) ? malloc_usable_size(ptr) : 0;
+    void *result = __libc_realloc(ptr, size);
+    if (result || size == 0) {
+        if (old) YYAllocAddLive(-(int64_t)old);
+        YYAllocRecord(result, size);
+    }
+    return result;
+}
+
+void *memalign(size_t alignment, size_t size) {
+    void *ptr = __libc_memalign(alignment, size);
+    YYAllocRecord(ptr, size);
+    return ptr;
+}
+
+void *aligned_alloc(size_t alignment, size_t size) {
+    return memalign(alignment, size);
+}
+
+int posix_memalign(void **result, size_t alignment, size_t size) {
+    if (alignment < sizeof(void *) || (alignment & (alignment - 1))) return EINVAL;
+    void *ptr = memalign(alignment, size);
+    if (!ptr) return ENOMEM;
+    *result = ptr;
+    return 0;
+}
+
+void free(void *ptr) {
+    if (ptr && YYAllocIsEnabled()) YYAllocAddLive(-(int64_t)malloc_usable_size(ptr));
+    __libc_free(ptr);
+}
+
+bool YYBenchAllocIsAvailable(void) { return true; }
+bool YYBenchAllocTracksLiveBytes(void) { return true; }
+static void YYAllocInstallHook(bool install) { (void)install; }
+
+#elif defined(__APPLE__)
+
+#include <malloc/malloc.h>
+
+/// The hook of libmalloc (used by MallocStackLogging), it's exported but not declared in public headers.
+typedef void (YYMallocLogger)(uint32_t type, uintptr_t arg1, uintptr_t arg2, uintptr_t arg3, uintptr_t result, uint32_t skip);
+extern YYMallocLogger *malloc_logger;
+
+#define kYYMallocLogTypeAllocate   2
+#define kYYMallocLogTypeDeallocate 4
+
+static void YYAllocLogger(uint32_t type, uintptr_t arg1, uintptr_t arg2, uintptr_t arg3, uintptr_t result, uint32_t skip) {
+    if (!(type & kYYMallocLogTypeAllocate) || !result) return;
+    // realloc: arg2 is the old pointer and arg3 is the size, others: arg2 is the size
+    YYAllocAddCount((type & kYYMallocLogTypeDeallocate) ? arg3 : arg2);
+}
+
+bool YYBenchAllocIsAvailable(void) { return true; }
+bool YYBenchAllocTracksLiveBytes(void) { return false; }
+static void YYAllocInstallHook(bool install) { malloc_logger = install ? YYAllocLogger : NULL; }
+
+#else
+
+bool YYBenchAllocIsAvailable(void) { return false; }
+bool YYBenchAllocTracksLiveBytes(void) { return false; }
+static void YYAllocInstallHook(bool install) { (void)install; }
+
+#endif
+
+void YYBenchAllocBegin(void) {
+    __atomic_store_n(&YYAllocCount, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&YYAllocBytes, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&YYAllocLive, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&YYAllocPeak, 0, __ATOMIC_RELAXED);
+    YYAllocInstallHook(true);
+    __atomic_store_n(&YYAllocEnabled, 1, __ATOMIC_SEQ_CST);
+}
+
+YYBenchAllocStats YYBenchAllocEnd(void) {
+    __atomic_store_n(&YYAllocEnabled, 0, __ATOMIC_SEQ_CST);
+    YYAllocInstallHook(false);
+    YYBenchAllocStats stats;
+    stats.count = __atomic_load_n(&YYAllocCount, __ATOMIC_RELAXED);
+    stats.bytes = __atomic_load_n(&YYAllocBytes, __ATOMIC_RELAXED);
+    stats.live = __atomic_load_n(&YYAllocLive, __ATOMIC_RELAXED);
+    stats.peak = __atomic_load_n(&YYAllocPeak, __ATOMIC_RELAXED);
+    return stats;
+}
+
+bool YYBenchPeakRSSReset(void) {
+#if defined(__linux__)
+    // "5" resets the peak RSS (VmHWM) to the current RSS, see proc(5)
+    int fd = open("/proc/self/clear_refs", O_WRONLY);
+    if (fd < 0) return false;
+    bool succeed = write(fd, "5", 1) == 1;
+    close(fd);
+    return succeed;
+#else
+    return false;
+#endif
+}
+
+uint64_t YYBenchPeakRSS(void) {
+#if defined(__linux__)
+    FILE *file = fopen("/proc/self/status", "r");
+    if (file) {
+        char line[256];
+        unsigned long long kb = 0;
+        while (fgets(line, sizeof(line), file)) {
+            if (sscanf(line, "VmHWM: %llu kB", &kb) == 1) break;
+        }
+        fclose(file);
+        if (kb) return (uint64_t)kb * 1024;
+    }
+#endif
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+#if defined(__APPLE__)
+    return (uint64_t)usage.ru_maxrss; // bytes
+#else
+    return (uint64_t)usage.ru_maxrss * 1024; // kilobytes
+#endif
+}
@@ -0,0 +1,47 @@
+//
+//  YYBenchAlloc.h
+//  ModelBenchmark
+//
+
+#ifndef YYBenchAlloc_h
+#define YYBenchAlloc_h
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Heap statistics between YYBenchAllocBegin() and YYBenchAllocEnd().
+typedef struct {
+    uint64_t count; ///< number of allocations (malloc, calloc, realloc, memalign...)
+    uint64_t bytes; ///< requested bytes of the allocations
+    int64_t live;   ///< live heap bytes at the end, relative to the beginning (not below 0)
+    int64_t peak;   ///< peak of the live heap bytes, relative to the beginning
+} YYBenchAllocStats;
+
+/// Whether the allocations are counted on this platform.
+bool YYBenchAllocIsAvailable(void);
+
+/// Whether the live/peak heap bytes are tracked on this platform.
+bool YYBenchAllocTracksLiveBytes(void);
+
+/// Reset the statistics and start counting, the calls should not be nested.
+void YYBenchAllocBegin(void);
+
+/// Stop counting and return the statistics.
+YYBenchAllocStats YYBenchAllocEnd(void);
+
+/// Reset the peak resident set size of the process, returns false if it's not supported
+/// (then the peak is the peak of the process lifetime).
+bool YYBenchPeakRSSReset(void);
+
+/// Peak resident set size in bytes, or 0 if unknown.
+uint64_t YYBenchPeakRSS(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* YYBenchAlloc_h */
@@ -0,0 +1,218 @@
+//
+//  YYBenchCompare.m
+//  ModelBenchmark
+//
+
+#import "YYBenchSupport.h"
+#import "GitHubUser.h"
+#import "YYWeiboModel.h"
+#if YYBENCH_VENDOR
+#import "MTWeiboModel.h"
+#import "JSWeiboModel.h"
+#endif
+#if YYBENCH_VENDOR_COREDATA
+#import "FEWeiboModel.h"
+#import "MJWeiboModel.h"
+#endif
+
+/*
+ The comparison of ViewController.m (benchmarkGithubUser and benchmarkWeiboStatus), with
+ the same json, iteration counts and warm-up. Unlike the app, the results of every library
+ are kept in the holder array, so all of them pay for the same deallocation. The last
+ column is the decode time relative to the first row (the hand-written "Manually" baseline
+ of GHUser, there's no hand-written WeiboStatus).
+
+ The vendor libraries are compiled with YYBENCH_VENDOR, except FastEasyMapping and
+ MJExtension, which need CoreData and are compiled with YYBENCH_VENDOR_COREDATA.
+ */
+
+typedef id _Nullable (^YYBenchDecode)(void);
+typedef id _Nullable (^YYBenchEncode)(id model);
+
+/// A library in the comparison: decode the json, encode the model (nil if not supported),
+/// and whether the model supports NSCoding.
+@interface YYBenchLibrary : NSObject
+@property (nonatomic, copy) NSString *name;
+@property (nonatomic, copy) YYBenchDecode decode;
+@property (nonatomic, copy) YYBenchEncode encode;
+@property (nonatomic, assign) BOOL archive;
+@end
+
+@implementation YYBenchLibrary
+@end
+
+static YYBenchLibrary *YYBenchLibraryCreate(NSString *name, YYBenchDecode decode, YYBenchEncode encode, BOOL archive) {
+    YYBenchLibrary *library = [YYBenchLibrary new];
+    library.name = name;
+    library.decode = decode;
+    library.encode = encode;
+    library.archive = archive;
+    return library;
+}
+
+/// Returns the time in milliseconds of `count` operations.
+static double YYBenchMeasureTime(NSMutableArray *holder, NSUInteger count, id (^operation)(void)) {
+    [holder removeAllObjects];
+    double begin = YYBenchNow();
+    @autoreleasepool {
+        for (NSUInteger i = 0; i < count; i++) {
+            id result = operation();
+            if (result) [holder addObject:result];
+        }
+    }
+    double end = YYBenchNow();
+    [holder removeAllObjects];
+    return (end - begin) * 1000;
+}
+
+static YYBenchReport *YYBenchCompareLibraries(NSString *title, NSArray *libraries, NSUInteger count, NSUInteger warmUp,
+                                              BOOL (^check)(id model)) {
+    // warm up (NSDictionary's hot cache, and JSON to model framework cache)
+    @autoreleasepool {
+        for (NSUInteger i = 0; i < warmUp; i++) {
+            for (YYBenchLibrary *library in libraries) YYBenchUse(library.decode());
+        }
+    }
+    // warm up holder
+    NSMutableArray *holder = [NSMutableArray new];
+    for (NSUInteger i = 0; i < count; i++) [holder addObject:[NSDate new]];
+    [holder removeAllObjects];
+
+    YYBenchReport *report = [[YYBenchReport alloc] initWithTitle:title
+                                                         columns:@[ @"from json ms", @"to json ms", @"archive ms", @"from json / first" ]];
+    id none = [NSNull null];
+    double baseline = 0;
+    for (YYBenchLibrary *library in libraries) {
+        double decode = YYBenchMeasureTime(holder, count, library.decode);
+        id model = library.decode();
+        if (!model || (check && !check(model))) {
+            fprintf(stderr, "error: %s decodes an invalid model\n", library.name.UTF8String);
+        }
+        if (baseline == 0) baseline = decode;
+
+        id encode = none;
+        if (library.encode) {
+            YYBenchEncode block = library.encode;
+            double time = YYBenchMeasureTime(holder, count, ^id { return block(model); });
+            id json = block(model);
+            encode = (json && [NSJSONSerialization isValidJSONObject:json]) ? @(time) : @"error";
+        }
+
+        id archive = none;
+        if (library.archive) {
+            archive = @(YYBenchMeasureTime(holder, count, ^id { return [NSKeyedArchiver archivedDataWithRootObject:model]; }));
+        }
+        [report addRow:library.name values:@[ @(decode), encode, archive, baseline > 0 ? @(decode / baseline) : none ]];
+    }
+    [report print];
+    return report;
+}
+
+int YYBenchRunCompare(YYBenchOptions *options) {
+    NSDictionary *user = [options JSONObjectOfFixture:@"user"];
+    NSDictionary *weibo = [options JSONObjectOfFixture:@"weibo"];
+    NSMutableArray *reports = [NSMutableArray new];
+
+    /*------------------- GithubUser -------------------*/
+    {
+        NSDictionary *json = user;
+        NSMutableArray *libraries = [NSMutableArray new];
+        [libraries addObject:YYBenchLibraryCreate(@"Manually", ^id {
+            return [[GHUser alloc] initWithJSONDictionary:json];
+        }, ^id(GHUser *model) {
+            return [model convertToJSONDictionary];
+        }, YES)];
+        [libraries addObject:YYBenchLibraryCreate(@"YYModel", ^id {
+            return [YYGHUser yy_modelWithJSON:json];
+        }, ^id(YYGHUser *model) {
+            return [model yy_modelToJSONObject];
+        }, YES)];
+#if YYBENCH_VENDOR_COREDATA
+        FEMMapping *mapping = [FEGHUser defaultMapping];
+        [libraries addObject:YYBenchLibraryCreate(@"FastEasyMapping", ^id {
+            FEGHUser *model = [FEGHUser new];
+            [FEMDeserializer fillObject:model fromRepresentation:json mapping:mapping];
+            return model;
+        }, ^id(FEGHUser *model) {
+            return [FEMSerializer serializeObject:model usingMapping:mapping];
+        }, NO)]; // FastEasyMapping does not support NSCoding
+#endif
+#if YYBENCH_VENDOR
+        MTLJSONAdapter *adapter = [[MTLJSONAdapter alloc] initWithModelClass:[MTGHUser class]];
+        [libraries addObject:YYBenchLibraryCreate(@"JSONModel", ^id {
+            return [[JSGHUser alloc] initWithDictionary:json error:nil];
+        }, ^id(JSGHUser *model) {
+            return [model toDictionary];
+        }, YES)];
+        [libraries addObject:YYBenchLibraryCreate(@"Mantle", ^id {
+            return [adapter modelFromJSONDictionary:json error:nil];
+        }, ^id(MTGHUser *model) {
+            return [adapter JSONDictionaryFromModel:model error:nil];
+        }, YES)];
+#endif
+#if YYBENCH_VENDOR_COREDATA
+        [libraries addObject:YYBenchLibraryCreate(@"MJExtension", ^id {
+            return [MJGHUser mj_objectWithKeyValues:json];
+        }, ^id(MJGHUser *model) {
+            return [model mj_JSONObject];
+        }, YES)];
+#endif
+        NSUInteger count = [options iterations:10000];
+        [reports addObject:YYBenchCompareLibraries([NSString stringWithFormat:@"GHUser (%lu times)", (unsigned long)count],
+                                                   libraries, count, count, ^BOOL(id model) {
+            return [[model valueForKey:@"userID"] unsignedLongLongValue] != 0 && [model valueForKey:@"login"] && [model valueForKey:@"htmlURL"];
+        })];
+    }
+
+    /*------------------- WeiboStatus -------------------*/
+    {
+        NSDictionary *json = weibo;
+        NSMutableArray *libraries = [NSMutableArray new];
+        [libraries addObject:YYBenchLibraryCreate(@"YYModel", ^id {
+            return [YYWeiboStatus yy_modelWithJSON:json];
+        }, ^id(YYWeiboStatus *model) {
+            return [model yy_modelToJSONObject];
+        }, YES)];
+#if YYBENCH_VENDOR_COREDATA
+        FEMMapping *mapping = [FEWeiboStatus defaultMapping];
+        [libraries addObject:YYBenchLibraryCreate(@"FastEasyMapping", ^id {
+            FEWeiboStatus *model = [FEWeiboStatus new];
+            [FEMDeserializer fillObject:model fromRepresentation:json mapping:mapping];
+            return model;
+        }, ^id(FEWeiboStatus *model) {
+            return [FEMSerializer serializeObject:model usingMapping:mapping];
+        }, NO)];
+#endif
+#if YYBENCH_VENDOR
+        MTLJSONAdapter *adapter = [[MTLJSONAdapter alloc] initWithModelClass:[MTWeiboStatus class]];
+        [libraries addObject:YYBenchLibraryCreate(@"JSONModel", ^id {
+            return [[JSWeiboStatus alloc] initWithDictionary:json error:nil];
+        }, ^id(JSWeiboStatus *model) {
+            return [model toDictionary];
+        }, YES)];
+        [libraries addObject:YYBenchLibraryCreate(@"Mantle", ^id {
+            return [adapter modelFromJSONDictionary:json error:nil];
+        }, ^id(MTWeiboStatus *model) {
+            return [adapter JSONDictionaryFromModel:model error:nil];
+        }, YES)];
+#endif
+#if YYBENCH_VENDOR_COREDATA
+        [libraries addObject:YYBenchLibraryCreate(@"MJExtension", ^id {
+            return [MJWeiboStatus mj_objectWithKeyValues:json];
+        }, ^id(MJWeiboStatus *model) {
+            return [model mj_JSONObject];
+        }, YES)];
+#endif
+        NSUInteger count = [options iterations:1000];
+        [reports addObject:YYBenchCompareLibraries([NSString stringWithFormat:@"WeiboStatus (%lu times)", (unsigned long)count],
+                                                   libraries, count, count * 2, nil)];
+    }
+
+#if !YYBENCH_VENDOR
+    printf("the vendor libraries are not compiled (make VENDOR=1)\n");
+#elif !YYBENCH_VENDOR_COREDATA
+    printf("FastEasyMapping and MJExtension are not compiled, they need CoreData (make COREDATA=1)\n");
+#endif
+    YYBenchWriteReports(options, @"compare", reports);
+    return 0;
+}
@@ -0,0 +1,125 @@
+//
+//  YYBenchConvert.m
+//  ModelBenchmark
+//
+
+#import "YYBenchSupport.h"
+#import "YYModel.h"
+#import "YYModelMeta.h"
+
+/*
+ Cost of every json value -> property conversion (the coercions of YYTestAutoTypeConvert.m),
+ measured with YYModelSetValueForProperty(), which is the setter of `-yy_modelSetWithDictionary:`
+ without the dictionary lookup. The results are two matrixes (target property x source json
+ type): ns per conversion and allocations per conversion.
+ */
+
+@interface YYBenchConvertModel : NSObject
+@property bool boolValue;
+@property char charValue;
+@property unsigned char unsignedCharValue;
+@property short shortValue;
+@property unsigned short unsignedShortValue;
+@property int intValue;
+@property unsigned int unsignedIntValue;
+@property long long longLongValue;
+@property unsigned long long unsignedLongLongValue;
+@property float floatValue;
+@property double doubleValue;
+@property long double longDoubleValue;
+@property (strong) Class classValue;
+@property SEL selectorValue;
+
+@property (nonatomic, strong) id anyObject;
+@property (nonatomic, strong) NSNumber *number;
+@property (nonatomic, strong) NSDecimalNumber *decimal;
+@property (nonatomic, strong) NSString *string;
+@property (nonatomic, strong) NSMutableString *mString;
+@property (nonatomic, strong) NSData *data;
+@property (nonatomic, strong) NSDate *date;
+@property (nonatomic, strong) NSValue *value;
+@property (nonatomic, strong) NSURL *url;
+@property (nonatomic, strong) NSArray *array;
+@property (nonatomic, strong) NSMutableArray *mArray;
+@property (nonatomic, strong) NSDictionary *dict;
+@property (nonatomic, strong) NSMutableDictionary *mDict;
+@property (nonatomic, strong) NSSet *set;
+@property (nonatomic, strong) NSMutableSet *mSet;
+@end
+
+@implementation YYBenchConvertModel
+@end
+
+
+/// Returns @[ns per conversion, allocations per conversion].
+static NSArray *YYBenchMeasureConversion(id model, id value, _YYModelPropertyMeta *meta, NSUInteger count) {
+    @autoreleasepool {
+        for (NSUInteger i = 0; i < 64; i++) YYModelSetValueForProperty(model, value, meta);
+    }
+    YYBenchAllocBegin();
+    double begin = YYBenchNow();
+    for (NSUInteger i = 0; i < count;) {
+        @autoreleasepool {
+            for (NSUInteger end = MIN(i + 1024, count); i < end; i++) {
+                YYModelSetValueForProperty(model, value, meta);
+            }
+        }
+    }
+    double end = YYBenchNow();
+    YYBenchAllocStats stats = YYBenchAllocEnd();
+    return @[ @((end - begin) * 1e9 / count),
+              YYBenchAllocIsAvailable() ? @((double)stats.count / count) : [NSNull null] ];
+}
+
+int YYBenchRunConvert(YYBenchOptions *options) {
+    NSUInteger count = [options iterations:100000];
+    NSString *filter = [options stringForKey:@"filter"];
+
+    // source json values, the column names
+    NSArray *sources = @[
+        @[ @"int", @123456 ],
+        @[ @"double", @1234.5678 ],
+        @[ @"bool", @YES ],
+        @[ @"decimal", [NSDecimalNumber decimalNumberWithString:@"1234.5678"] ],
+        @[ @"int str", @"123456" ],
+        @[ @"double str", @"1234.5678" ],
+        @[ @"bool str", @"true" ],
+        @[ @"date str", @"2015-09-18T12:34:56" ],
+        @[ @"url str", @"https://github.com/ibireme/YYModel" ],
+        @[ @"text", @"YYModel: High performance model framework for iOS/OSX." ],
+        @[ @"null", [NSNull null] ],
+        @[ @"array", @[ @1, @"2", @3.5 ] ],
+        @[ @"dict", @{ @"a" : @1, @"b" : @"2" } ],
+    ];
+    NSMutableArray *sourceNames = [NSMutableArray new];
+    for (NSArray *source in sources) [sourceNames addObject:source[0]];
+
+    YYBenchReport *timeReport = [[YYBenchReport alloc] initWithTitle:[NSString stringWithFormat:@"ns per conversion (%lu times)", (unsigned long)count]
+                                                             columns:sourceNames];
+    YYBenchReport *allocReport = [[YYBenchReport alloc] initWithTitle:@"allocations per conversion" columns:sourceNames];
+
+    _YYModelMeta *classMeta = [_YYModelMeta metaWithClass:[YYBenchConvertModel class]];
+    NSArray *metas = [classMeta->_allPropertyMetas sortedArrayUsingComparator:^NSComparisonResult(_YYModelPropertyMeta *a, _YYModelPropertyMeta *b) {
+        // c numbers first, then objects, sorted by name
+        if (a->_isCNumber != b->_isCNumber) return a->_isCNumber ? NSOrderedAscending : NSOrderedDescending;
+        return [a->_name compare:b->_name];
+    }];
+    YYBenchConvertModel *model = [YYBenchConvertModel new];
+    for (_YYModelPropertyMeta *meta in metas) {
+        if (!meta->_setter) continue;
+        if (filter && [meta->_name rangeOfString:filter].location == NSNotFound) continue;
+        NSMutableArray *times = [NSMutableArray new];
+        NSMutableArray *allocs = [NSMutableArray new];
+        for (NSArray *source in sources) {
+            NSArray *result = YYBenchMeasureConversion(model, source[1], meta, count);
+            [times addObject:result[0]];
+            [allocs addObject:result[1]];
+        }
+        [timeReport addRow:meta->_name values:times];
+        [allocReport addRow:meta->_name values:allocs];
+    }
+    [timeReport print];
+    [allocReport print];
+    YYBenchWriteReports(options, @"convert", @[ timeReport, allocReport ]);
+    return 0;
+}
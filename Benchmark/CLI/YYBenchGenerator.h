@@ -0,0 +1,73 @@
+//
+//  YYBenchGenerator.h
+//  ModelBenchmark
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// Property types of the generated models.
+typedef NS_ENUM(NSUInteger, YYBenchPropertyType) {
+    YYBenchPropertyTypeInt64 = 0,   ///< int64_t
+    YYBenchPropertyTypeDouble,      ///< double
+    YYBenchPropertyTypeBool,        ///< bool
+    YYBenchPropertyTypeString,      ///< NSString
+    YYBenchPropertyTypeNumber,      ///< NSNumber
+    YYBenchPropertyTypeDate,        ///< NSDate (json: "yyyy-MM-ddTHH:mm:ss")
+    YYBenchPropertyTypeURL,         ///< NSURL (json: string)
+    YYBenchPropertyTypeModel,       ///< nested model
+    YYBenchPropertyTypeModelArray,  ///< NSArray of nested models (generic class)
+    YYBenchPropertyTypeModelDictionary, ///< NSDictionary of nested models (generic class)
+    YYBenchPropertyTypeStringArray, ///< NSArray of NSString
+};
+
+/**
+ Creates model classes at runtime (objc_allocateClassPair, class_addIvar, class_addProperty)
+ and json payloads that match them.
+
+ A generated root class has `width` properties, the model properties point to a class of
+ the next level, until `depth` levels (the last level has no model properties). The
+ classes implement `modelCustomPropertyMapper` (key paths) and
+ `modelContainerPropertyGenericClass` when needed. The same seed generates the same
+ classes and payloads (the class names are unique in the process).
+ */
+@interface YYBenchGenerator : NSObject
+
+- (instancetype)initWithSeed:(uint32_t)seed;
+
+/// Properties of each class, default is 16.
+@property (nonatomic, assign) NSUInteger width;
+/// Levels of nested models below the root, default is 2.
+@property (nonatomic, assign) NSUInteger depth;
+/// Elements of the array and dictionary properties, default is 4.
+@property (nonatomic, assign) NSUInteger collectionCount;
+/// Length of the string values, default is 16.
+@property (nonatomic, assign) NSUInteger stringLength;
+/// Ratio of the properties mapped to a key path ("name_obj.v"), default is 0.1.
+@property (nonatomic, assign) double keyPathRatio;
+/// Ratio of the scalar/string values written with another json type
+/// (such as "12" for an int64_t, 12 for a NSString), default is 0.
+@property (nonatomic, assign) double coercionRatio;
+/// The type mix, an array of YYBenchPropertyType, default is all types.
+@property (nonatomic, copy) NSArray<NSNumber *> *types;
+
+/// Parse a type list such as "int,double,bool,string,number,date,url,model,array,dict,strings",
+/// returns nil if a name is unknown.
++ (nullable NSArray<NSNumber *> *)typesWithString:(NSString *)string;
+
+/// Create the root model class (and the classes of the nested models).
+- (Class)generateClass;
+
+/// A json dictionary for the generated class, the values are random.
+- (NSDictionary *)JSONObjectForClass:(Class)cls;
+
+/// A json array of the generated class encoded as UTF-8, its length is at least `length` bytes
+/// (or one element). Every element is generated, the objects of an element are released after
+/// it's written, so only the bytes are kept in memory.
+/// @param count Returns the number of elements, can be NULL.
+- (NSData *)JSONDataForClass:(Class)cls length:(NSUInteger)length count:(nullable NSUInteger *)count;
+
+@end
+
+NS_ASSUME_NONNULL_END
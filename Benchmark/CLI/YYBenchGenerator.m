@@ -0,0 +1,382 @@
+//
+//  YYBenchGenerator.m
+//  ModelBenchmark
+//
+
+#import "YYBenchGenerator.h"
+#import "YYModel.h"
+#import <objc/runtime.h>
+
+/// A property of a generated class.
+@interface _YYBenchGeneratedProperty : NSObject {
+    @package
+    NSString *_name;          ///< property name
+    YYBenchPropertyType _type; ///< property type
+    NSArray *_keyPath;        ///< json key path, nil if the key is the name
+    Class _cls;               ///< class of the nested model (or nil)
+}
+@end
+
+@implementation _YYBenchGeneratedProperty
+@end
+
+
+@implementation YYBenchGenerator {
+    uint32_t _state;
+    NSMutableDictionary *_propertiesByClass; ///< Dictionary<class name, Array<_YYBenchGeneratedProperty>>
+}
+
+- (instancetype)init {
+    return [self initWithSeed:1];
+}
+
+- (instancetype)initWithSeed:(uint32_t)seed {
+    self = [super init];
+    _state = seed ? seed : 1;
+    _width = 16;
+    _depth = 2;
+    _collectionCount = 4;
+    _stringLength = 16;
+    _keyPathRatio = 0.1;
+    _coercionRatio = 0;
+    _types = [YYBenchGenerator typesWithString:@"int,double,bool,string,number,date,url,model,array,dict,strings"];
+    _propertiesByClass = [NSMutableDictionary new];
+    return self;
+}
+
++ (NSArray *)typesWithString:(NSString *)string {
+    static NSDictionary *names;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        names = @{ @"int" : @(YYBenchPropertyTypeInt64),
+                   @"double" : @(YYBenchPropertyTypeDouble),
+                   @"bool" : @(YYBenchPropertyTypeBool),
+                   @"string" : @(YYBenchPropertyTypeString),
+                   @"number" : @(YYBenchPropertyTypeNumber),
+                   @"date" : @(YYBenchPropertyTypeDate),
+                   @"url" : @(YYBenchPropertyTypeURL),
+                   @"model" : @(YYBenchPropertyTypeModel),
+                   @"array" : @(YYBenchPropertyTypeModelArray),
+                   @"dict" : @(YYBenchPropertyTypeModelDictionary),
+                   @"strings" : @(YYBenchPropertyTypeStringArray) };
+    });
+    NSMutableArray *types = [NSMutableArray new];
+    for (NSString *name in [string componentsSeparatedByString:@","]) {
+        NSString *trimmed = [name stringByTrimmingCharactersInSet:[NSCharacterSet whitespaceCharacterSet]];
+        if (trimmed.length == 0) continue;
+        NSNumber *type = names[trimmed];
+        if (!type) return nil;
+        [types addObject:type];
+    }
+    return types.count ? types : nil;
+}
+
+#pragma mark - Random
+
+/// xorshift32
+- (uint32_t)random {
+    uint32_t x = _state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    _state = x;
+    return x;
+}
+
+- (double)randomRatio {
+    return [self random] / 4294967296.0;
+}
+
+- (NSString *)randomString {
+    static const char table[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789 ";
+    NSUInteger length = _stringLength;
+    char *buf = malloc(length + 1);
+    for (NSUInteger i = 0; i < length; i++) buf[i] = table[[self random] % (sizeof(table) - 1)];
+    buf[length] = '\0';
+    NSString *string = [NSString stringWithUTF8String:buf];
+    free(buf);
+    return string;
+}
+
+#pragma mark - Class
+
+static NSString *YYBenchTypeName(YYBenchPropertyType type) {
+    switch (type) {
+        case YYBenchPropertyTypeInt64: return @"int";
+        case YYBenchPropertyTypeDouble: return @"double";
+        case YYBenchPropertyTypeBool: return @"bool";
+        case YYBenchPropertyTypeString: return @"string";
+        case YYBenchPropertyTypeNumber: return @"number";
+        case YYBenchPropertyTypeDate: return @"date";
+        case YYBenchPropertyTypeURL: return @"url";
+        case YYBenchPropertyTypeModel: return @"model";
+        case YYBenchPropertyTypeModelArray: return @"array";
+        case YYBenchPropertyTypeModelDictionary: return @"dict";
+        case YYBenchPropertyTypeStringArray: return @"strings";
+    }
+    return @"unknown";
+}
+
+static const char *YYBenchTypeEncoding(YYBenchPropertyType type) {
+    switch (type) {
+        case YYBenchPropertyTypeInt64: return @encode(int64_t);
+        case YYBenchPropertyTypeDouble: return @encode(double);
+        case YYBenchPropertyTypeBool: return @encode(bool);
+        default: return @encode(id);
+    }
+}
+
+static NSString *YYBenchPropertyClassName(_YYBenchGeneratedProperty *property) {
+    switch (property->_type) {
+        case YYBenchPropertyTypeString: return @"NSString";
+        case YYBenchPropertyTypeNumber: return @"NSNumber";
+        case YYBenchPropertyTypeDate: return @"NSDate";
+        case YYBenchPropertyTypeURL: return @"NSURL";
+        case YYBenchPropertyTypeModel: return NSStringFromClass(property->_cls);
+        case YYBenchPropertyTypeModelArray: return @"NSArray";
+        case YYBenchPropertyTypeModelDictionary: return @"NSDictionary";
+        case YYBenchPropertyTypeStringArray: return @"NSArray";
+        default: return nil;
+    }
+}
+
+/// Add the getter and setter of a scalar ivar.
+#define YYBenchAddScalarAccessors(_cls_, _getter_, _setter_, _offset_, _type_) do { \
+    ptrdiff_t scalarOffset = (_offset_); \
+    IMP getter = imp_implementationWithBlock(^_type_(__unsafe_unretained id object) { \
+        return *(_type_ *)((uint8_t *)(__bridge void *)object + scalarOffset); \
+    }); \
+    IMP setter = imp_implementationWithBlock(^(__unsafe_unretained id object, _type_ value) { \
+        *(_type_ *)((uint8_t *)(__bridge void *)object + scalarOffset) = value; \
+    }); \
+    char types[16]; \
+    snprintf(types, sizeof(types), "%s@:", @encode(_type_)); \
+    class_addMethod(_cls_, _getter_, getter, types); \
+    snprintf(types, sizeof(types), "v@:%s", @encode(_type_)); \
+    class_addMethod(_cls_, _setter_, setter, types); \
+} while (0)
+
+- (Class)createClassAtLevel:(NSUInteger)level nestedClass:(Class)nestedClass {
+    static int32_t classCount = 0;
+    int32_t index = __atomic_add_fetch(&classCount, 1, __ATOMIC_RELAXED);
+    NSString *className = [NSString stringWithFormat:@"YYBenchGenerated%d_L%lu", index, (unsigned long)level];
+    Class cls = objc_allocateClassPair([NSObject class], className.UTF8String, 0);
+    if (!cls) return nil;
+
+    NSMutableArray *properties = [NSMutableArray new];
+    NSArray *types = _types.count ? _types : @[ @(YYBenchPropertyTypeString) ];
+    for (NSUInteger i = 0; i < _width; i++) {
+        _YYBenchGeneratedProperty *property = [_YYBenchGeneratedProperty new];
+        property->_type = [types[[self random] % types.count] unsignedIntegerValue];
+        switch (property->_type) {
+            case YYBenchPropertyTypeModel:
+            case YYBenchPropertyTypeModelArray:
+            case YYBenchPropertyTypeModelDictionary: {
+                if (nestedClass) property->_cls = nestedClass;
+                else property->_type = YYBenchPropertyTypeString; // the last level
+            } break;
+            default: break;
+        }
+        property->_name = [NSString stringWithFormat:@"%@%lu", YYBenchTypeName(property->_type), (unsigned long)i];
+        if (_keyPathRatio > 0 && [self randomRatio] < _keyPathRatio) {
+            property->_keyPath = @[ [property->_name stringByAppendingString:@"_obj"], @"v" ];
+        }
+
+        const char *encoding = YYBenchTypeEncoding(property->_type);
+        NSUInteger size, alignment;
+        NSGetSizeAndAlignment(encoding, &size, &alignment);
+        uint8_t log2Alignment = 0;
+        while ((1UL << log2Alignment) < alignment) log2Alignment++;
+        NSString *ivarName = [@"_" stringByAppendingString:property->_name];
+        class_addIvar(cls, ivarName.UTF8String, size, log2Alignment, encoding);
+        [properties addObject:property];
+    }
+    objc_registerClassPair(cls);
+
+    NSMutableData *objectOffsets = [NSMutableData new];
+    NSMutableDictionary *mapper = [NSMutableDictionary new];
+    NSMutableDictionary *genericClasses = [NSMutableDictionary new];
+    for (_YYBenchGeneratedProperty *property in properties) {
+        NSString *name = property->_name;
+        NSString *ivarName = [@"_" stringByAppendingString:name];
+        ptrdiff_t offset = ivar_getOffset(class_getInstanceVariable(cls, ivarName.UTF8String));
+        SEL getter = NSSelectorFromString(name);
+        SEL setter = NSSelectorFromString([NSString stringWithFormat:@"set%@%@:",
+                                           [name substringToIndex:1].uppercaseString, [name substringFromIndex:1]]);
+
+        NSString *typeAttribute;
+        switch (property->_type) {
+            case YYBenchPropertyTypeInt64: {
+                YYBenchAddScalarAccessors(cls, getter, setter, offset, int64_t);
+                typeAttribute = @(@encode(int64_t));
+            } break;
+            case YYBenchPropertyTypeDouble: {
+                YYBenchAddScalarAccessors(cls, getter, setter, offset, double);
+                typeAttribute = @(@encode(double));
+            } break;
+            case YYBenchPropertyTypeBool: {
+                YYBenchAddScalarAccessors(cls, getter, setter, offset, bool);
+                typeAttribute = @(@encode(bool));
+            } break;
+            default: {
+                IMP getterIMP = imp_implementationWithBlock(^id(__unsafe_unretained id object) {
+                    return *(__strong id *)(void *)((uint8_t *)(__bridge void *)object + offset);
+                });
+                IMP setterIMP = imp_implementationWithBlock(^(__unsafe_unretained id object, id value) {
+                    *(__strong id *)(void *)((uint8_t *)(__bridge void *)object + offset) = value;
+                });
+                class_addMethod(cls, getter, getterIMP, "@@:");
+                class_addMethod(cls, setter, setterIMP, "v@:@");
+                [objectOffsets appendBytes:&offset length:sizeof(offset)];
+                typeAttribute = [NSString stringWithFormat:@"@\"%@\"", YYBenchPropertyClassName(property)];
+            } break;
+        }
+
+        // T@"NSString",&,N,V_name or Tq,N,V_name
+        objc_property_attribute_t attributes[4];
+        unsigned int attributeCount = 0;
+        attributes[attributeCount++] = (objc_property_attribute_t){ "T", typeAttribute.UTF8String };
+        if ([typeAttribute hasPrefix:@"@"]) attributes[attributeCount++] = (objc_property_attribute_t){ "&", "" };
+        attributes[attributeCount++] = (objc_property_attribute_t){ "N", "" };
+        attributes[attributeCount++] = (objc_property_attribute_t){ "V", ivarName.UTF8String };
+        class_addProperty(cls, name.UTF8String, attributes, attributeCount);
+
+        if (property->_keyPath) mapper[name] = [property->_keyPath componentsJoinedByString:@"."];
+        if (property->_type == YYBenchPropertyTypeModelArray ||
+            property->_type == YYBenchPropertyTypeModelDictionary) {
+            genericClasses[name] = property->_cls;
+        } else if (property->_type == YYBenchPropertyTypeStringArray) {
+            genericClasses[name] = [NSString class];
+        }
+    }
+
+    // the ivars have no layout information, so dealloc releases the objects
+    if (objectOffsets.length) {
+        SEL deallocSEL = NSSelectorFromString(@"dealloc");
+        IMP superDealloc = class_getMethodImplementation([NSObject class], deallocSEL);
+        NSData *offsets = objectOffsets.copy;
+        IMP dealloc = imp_implementationWithBlock(^(__unsafe_unretained id object) {
+            const ptrdiff_t *list = offsets.bytes;
+            NSUInteger count = offsets.length / sizeof(ptrdiff_t);
+            for (NSUInteger i = 0; i < count; i++) {
+                *(__strong id *)(void *)((uint8_t *)(__bridge void *)object + list[i]) = nil;
+            }
+            ((void (*)(id, SEL))(void *)superDealloc)(object, deallocSEL);
+        });
+        class_addMethod(cls, deallocSEL, dealloc, "v@:");
+    }
+
+    Class metaClass = object_getClass(cls);
+    if (mapper.count) {
+        NSDictionary *result = mapper.copy;
+        class_addMethod(metaClass, @selector(modelCustomPropertyMapper),
+                        imp_implementationWithBlock(^NSDictionary *(__unsafe_unretained id object) { return result; }), "@@:");
+    }
+    if (genericClasses.count) {
+        NSDictionary *result = genericClasses.copy;
+        class_addMethod(metaClass, @selector(modelContainerPropertyGenericClass),
+                        imp_implementationWithBlock(^NSDictionary *(__unsafe_unretained id object) { return result; }), "@@:");
+    }
+
+    _propertiesByClass[className] = properties;
+    return cls;
+}
+
+- (Class)generateClass {
+    Class nestedClass = nil;
+    for (NSInteger level = _depth; level >= 0; level--) {
+        nestedClass = [self createClassAtLevel:level nestedClass:nestedClass];
+        if (!nestedClass) return nil;
+    }
+    return nestedClass;
+}
+
+#pragma mark - JSON
+
+- (id)valueForProperty:(_YYBenchGeneratedProperty *)property {
+    BOOL coerce = _coercionRatio > 0 && [self randomRatio] < _coercionRatio;
+    switch (property->_type) {
+        case YYBenchPropertyTypeInt64: {
+            int64_t value = (int64_t)[self random] - INT32_MAX;
+            return coerce ? [NSString stringWithFormat:@"%lld", (long long)value] : @(value);
+        }
+        case YYBenchPropertyTypeDouble: {
+            double value = [self random] / 1000.0;
+            return coerce ? [NSString stringWithFormat:@"%.3f", value] : @(value);
+        }
+        case YYBenchPropertyTypeBool: {
+            BOOL value = [self random] & 1;
+            return coerce ? (value ? @"true" : @"false") : @(value);
+        }
+        case YYBenchPropertyTypeString: {
+            return coerce ? @([self random]) : [self randomString];
+        }
+        case YYBenchPropertyTypeNumber: {
+            uint32_t value = [self random];
+            return coerce ? [NSString stringWithFormat:@"%u", value] : @(value);
+        }
+        case YYBenchPropertyTypeDate: {
+            uint32_t value = [self random];
+            return [NSString stringWithFormat:@"20%02u-%02u-%02uT%02u:%02u:%02u", value % 30, value % 12 + 1, value % 28 + 1,
+                    value % 24, value % 60, (value >> 8) % 60];
+        }
+        case YYBenchPropertyTypeURL: {
+            return [@"https://example.com/" stringByAppendingString:[[self randomString] stringByReplacingOccurrencesOfString:@" " withString:@"_"]];
+        }
+        case YYBenchPropertyTypeModel: {
+            return [self JSONObjectForClass:property->_cls];
+        }
+        case YYBenchPropertyTypeModelArray: {
+            NSMutableArray *array = [NSMutableArray arrayWithCapacity:_collectionCount];
+            for (NSUInteger i = 0; i < _collectionCount; i++) [array addObject:[self JSONObjectForClass:property->_cls]];
+            return array;
+        }
+        case YYBenchPropertyTypeModelDictionary: {
+            NSMutableDictionary *dic = [NSMutableDictionary dictionaryWithCapacity:_collectionCount];
+            for (NSUInteger i = 0; i < _collectionCount; i++) {
+                dic[[NSString stringWithFormat:@"k%lu", (unsigned long)i]] = [self JSONObjectForClass:property->_cls];
+            }
+            return dic;
+        }
+        case YYBenchPropertyTypeStringArray: {
+            NSMutableArray *array = [NSMutableArray arrayWithCapacity:_collectionCount];
+            for (NSUInteger i = 0; i < _collectionCount; i++) [array addObject:[self randomString]];
+            return array;
+        }
+    }
+    return [NSNull null];
+}
+
+- (NSDictionary *)JSONObjectForClass:(Class)cls {
+    NSArray *properties = _propertiesByClass[NSStringFromClass(cls)];
+    NSMutableDictionary *json = [NSMutableDictionary dictionaryWithCapacity:properties.count];
+    for (_YYBenchGeneratedProperty *property in properties) {
+        id value = [self valueForProperty:property];
+        if (property->_keyPath) {
+            // the first component is unique for each property
+            json[property->_keyPath[0]] = @{ property->_keyPath[1] : value };
+        } else {
+            json[property->_name] = value;
+        }
+    }
+    return json;
+}
+
+- (NSData *)JSONDataForClass:(Class)cls length:(NSUInteger)length count:(NSUInteger *)count {
+    NSMutableData *data = [NSMutableData dataWithCapacity:length + 1024];
+    [data appendBytes:"[" length:1];
+    NSUInteger elementCount = 0;
+    do {
+        @autoreleasepool {
+            NSData *element = [NSJSONSerialization dataWithJSONObject:[self JSONObjectForClass:cls] options:0 error:NULL];
+            if (elementCount) [data appendBytes:"," length:1];
+            [data appendData:element];
+        }
+        elementCount++;
+    } while (data.length + 1 < length); // "]"
+    [data appendBytes:"]" length:1];
+    if (count) *count = elementCount;
+    return data;
+}
+
+@end
@@ -0,0 +1,148 @@
+//
+//  YYBenchMemory.m
+//  ModelBenchmark
+//
+
+#import "YYBenchSupport.h"
+#import "GitHubUser.h"
+#import "YYWeiboModel.h"
+#import <objc/runtime.h>
+
+/*
+ Allocations of each operation, measured with all results kept alive (like the holder
+ array of the app benchmark), so the peak heap is the memory retained by `count` results.
+ */
+
+typedef id (^YYBenchOperation)(void);
+
+static NSArray *YYBenchMeasureMemory(NSUInteger count, YYBenchOperation operation) {
+    NSMutableArray *holder = [NSMutableArray arrayWithCapacity:count];
+    @autoreleasepool { // warm up: class metas, caches, formatters...
+        for (NSUInteger i = 0; i < 3; i++) YYBenchUse(operation());
+    }
+
+    bool rssReset = YYBenchPeakRSSReset();
+    YYBenchAllocBegin();
+    double begin = YYBenchNow();
+    @autoreleasepool {
+        for (NSUInteger i = 0; i < count; i++) {
+            id result = operation();
+            if (result) [holder addObject:result];
+        }
+    }
+    double end = YYBenchNow();
+    YYBenchAllocStats stats = YYBenchAllocEnd();
+    uint64_t rss = YYBenchPeakRSS();
+    if (holder.count != count) fprintf(stderr, "warning: an operation returns nil\n");
+    [holder removeAllObjects];
+
+    id none = [NSNull null];
+    BOOL counted = YYBenchAllocIsAvailable();
+    BOOL live = YYBenchAllocTracksLiveBytes();
+    return @[ @(count),
+              counted ? @((double)stats.count / count) : none,
+              counted ? @((double)stats.bytes / count) : none,
+              live ? @(stats.peak / 1024.0) : none,
+              rss ? @(rss / 1024.0) : none,
+              rssReset ? @"op" : @"process",
+              @((end - begin) * 1000) ];
+}
+
+static YYBenchReport *YYBenchMemoryReport(NSString *title) {
+    return [[YYBenchReport alloc] initWithTitle:title
+                                        columns:@[ @"iterations", @"allocs/op", @"bytes/op", @"peak heap KB",
+                                                   @"peak RSS KB", @"RSS scope", @"time ms" ]];
+}
+
+static YYBenchReport *YYBenchMemoryModel(NSString *title, Class cls, id json, NSUInteger count) {
+    YYBenchReport *report = YYBenchMemoryReport(title);
+    BOOL isArray = [json isKindOfClass:[NSArray class]];
+    id (^decode)(void) = ^id {
+        return isArray ? [NSArray yy_modelArrayWithClass:cls json:json] : [cls yy_modelWithJSON:json];
+    };
+    id model = decode();
+    if (!model) {
+        fprintf(stderr, "error: can not decode %s\n", title.UTF8String);
+        return report;
+    }
+
+    [report addRow:@"decode" values:YYBenchMeasureMemory(count, decode)];
+    [report addRow:@"encode" values:YYBenchMeasureMemory(count, ^id {
+        return [model yy_modelToJSONObject];
+    })];
+    [report addRow:@"copy" values:YYBenchMeasureMemory(count, ^id {
+        if (!isArray) return [model yy_modelCopy];
+        NSMutableArray *copy = [NSMutableArray arrayWithCapacity:[model count]];
+        for (id one in model) [copy addObject:[one yy_modelCopy]];
+        return copy;
+    })];
+    [report addRow:@"archive" values:YYBenchMeasureMemory(count, ^id {
+        return [NSKeyedArchiver archivedDataWithRootObject:model];
+    })];
+    [report print];
+    return report;
+}
+
+/// Peak heap (KB) of one decode of the array, the temporary objects are released after the measurement.
+static id YYBenchPeakOfArrayDecode(Class cls, NSArray *json) {
+    if (!YYBenchAllocTracksLiveBytes()) return [NSNull null];
+    YYBenchAllocStats stats;
+    @autoreleasepool {
+        YYBenchAllocBegin();
+        YYBenchUse([NSArray yy_modelArrayWithClass:cls json:json]);
+        stats = YYBenchAllocEnd();
+    }
+    return @(stats.peak / 1024.0);
+}
+
+/// A subclass of the class without autorelease batches (+modelAutoreleaseBatchSize returns 0).
+static Class YYBenchNoBatchClass(Class cls) {
+    NSString *name = [NSStringFromClass(cls) stringByAppendingString:@"_NoBatch"];
+    Class subclass = objc_getClass(name.UTF8String);
+    if (subclass) return subclass;
+    subclass = objc_allocateClassPair(cls, name.UTF8String, 0);
+    IMP imp = imp_implementationWithBlock(^NSUInteger(__unsafe_unretained id object) { return 0; });
+    NSString *types = [NSString stringWithFormat:@"%s@:", @encode(NSUInteger)];
+    class_addMethod(object_getClass(subclass), @selector(modelAutoreleaseBatchSize), imp, types.UTF8String);
+    objc_registerClassPair(subclass);
+    return subclass;
+}
+
+int YYBenchRunMemory(YYBenchOptions *options) {
+    if (!YYBenchAllocIsAvailable()) printf("allocation counting is not available on this platform\n");
+    if (!YYBenchPeakRSSReset()) printf("peak RSS can not be reset on this platform, it's the peak of the process\n");
+
+    NSMutableArray *reports = [NSMutableArray new];
+    NSDictionary *user = [options JSONObjectOfFixture:@"user"];
+    NSDictionary *weibo = [options JSONObjectOfFixture:@"weibo"];
+
+    [reports addObject:YYBenchMemoryModel(@"GithubUser (user.json)", [YYGHUser class], user, [options iterations:10000])];
+    [reports addObject:YYBenchMemoryModel(@"WeiboStatus (weibo.json)", [YYWeiboStatus class], weibo, [options iterations:1000])];
+
+    // scaled payloads: an array of N statuses, the iterations are reduced to keep the total work
+    NSString *sizes = [options stringForKey:@"sizes"] ?: @"10,100,1000";
+    YYBenchReport *batchReport = [[YYBenchReport alloc] initWithTitle:@"Peak heap KB of one array decode (+modelAutoreleaseBatchSize)"
+                                                              columns:@[ @"batch 64", @"no batch", @"reduction %" ]];
+    for (NSString *size in [sizes componentsSeparatedByString:@","]) {
+        NSUInteger n = (NSUInteger)size.integerValue;
+        if (n == 0) continue;
+        NSMutableArray *array = [NSMutableArray arrayWithCapacity:n];
+        for (NSUInteger i = 0; i < n; i++) [array addObject:weibo];
+        NSString *title = [NSString stringWithFormat:@"WeiboStatus x %lu", (unsigned long)n];
+        NSUInteger count = [options iterations:MAX(1000 / n, 1)];
+        [reports addObject:YYBenchMemoryModel(title, [YYWeiboStatus class], array, count)];
+
+        id batch = YYBenchPeakOfArrayDecode([YYWeiboStatus class], array);
+        id noBatch = YYBenchPeakOfArrayDecode(YYBenchNoBatchClass([YYWeiboStatus class]), array);
+        id reduction = [NSNull null];
+        if ([batch isKindOfClass:[NSNumber class]] && [noBatch doubleValue] > 0) {
+            reduction = @((1 - [batch doubleValue] / [noBatch doubleValue]) * 100);
+        }
+        [batchReport addRow:title values:@[ batch, noBatch, reduction ]];
+    }
+    [batchReport print];
+    [reports addObject:batchReport];
+
+    YYBenchWriteReports(options, @"memory", reports);
+    return 0;
+}
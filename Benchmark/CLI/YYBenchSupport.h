@@ -0,0 +1,72 @@
+//
+//  YYBenchSupport.h
+//  ModelBenchmark
+//
+
+#import <Foundation/Foundation.h>
+#import "YYBenchAlloc.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// Monotonic time in seconds.
+double YYBenchNow(void);
+
+/// Prevent the compiler from removing an unused result.
+void YYBenchUse(id _Nullable object);
+
+
+/// Command line options: "--name value" or "--name=value", a flag without value is "1".
+@interface YYBenchOptions : NSObject
+
++ (instancetype)optionsWithArguments:(NSArray<NSString *> *)arguments;
+
+/// The directory of user.json and weibo.json (--fixtures).
+@property (nonatomic, copy) NSString *fixtureDirectory;
+/// The file to write the results as json (--json), or nil.
+@property (nonatomic, copy, nullable) NSString *JSONPath;
+/// Multiplier of the iteration counts (--scale), default is 1.
+@property (nonatomic, assign) double scale;
+
+- (nullable NSString *)stringForKey:(NSString *)key;
+- (NSInteger)integerForKey:(NSString *)key defaultValue:(NSInteger)defaultValue;
+
+/// The iteration count scaled with `scale`, at least 1.
+- (NSUInteger)iterations:(NSUInteger)count;
+
+/// Returns the parsed json of a fixture (such as @"user"), exits if it can not be read.
+- (id)JSONObjectOfFixture:(NSString *)name;
+
+@end
+
+
+/// A result table, printed as text and written as json.
+@interface YYBenchReport : NSObject
+
+- (instancetype)initWithTitle:(NSString *)title columns:(NSArray<NSString *> *)columns;
+
+@property (nonatomic, copy, readonly) NSString *title;
+@property (nonatomic, copy, readonly) NSArray<NSString *> *columns;
+
+/// Add a row, the values are NSNumber, NSString, or NSNull (printed as N/A).
+- (void)addRow:(NSString *)name values:(NSArray *)values;
+
+/// Print the table to stdout.
+- (void)print;
+
+- (NSDictionary *)JSONObject;
+
+@end
+
+
+/// Write the reports to the json file of the options (if any).
+void YYBenchWriteReports(YYBenchOptions *options, NSString *mode, NSArray<YYBenchReport *> *reports);
+
+
+/// Modes of the command line benchmark, returns the exit code.
+int YYBenchRunMemory(YYBenchOptions *options);
+int YYBenchRunThreads(YYBenchOptions *options);
+int YYBenchRunCompare(YYBenchOptions *options);
+int YYBenchRunSynthetic(YYBenchOptions *options);
+int YYBenchRunConvert(YYBenchOptions *options);
+
+NS_ASSUME_NONNULL_END
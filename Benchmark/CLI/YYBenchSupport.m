@@ -0,0 +1,168 @@
+//
+//  YYBenchSupport.m
+//  ModelBenchmark
+//
+
+#import "YYBenchSupport.h"
+#include <time.h>
+
+#ifndef YYBENCH_FIXTURE_DIR
+#define YYBENCH_FIXTURE_DIR "../ModelBenchmark"
+#endif
+
+double YYBenchNow(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+void YYBenchUse(id object) {
+    __asm__ __volatile__("" : : "r"((__bridge void *)object) : "memory");
+}
+
+
+@implementation YYBenchOptions {
+    NSMutableDictionary *_values;
+}
+
++ (instancetype)optionsWithArguments:(NSArray *)arguments {
+    YYBenchOptions *options = [self new];
+    options->_values = [NSMutableDictionary new];
+    for (NSUInteger i = 0; i < arguments.count; i++) {
+        NSString *arg = arguments[i];
+        if (![arg hasPrefix:@"--"]) continue;
+        arg = [arg substringFromIndex:2];
+        NSRange equal = [arg rangeOfString:@"="];
+        if (equal.location != NSNotFound) {
+            options->_values[[arg substringToIndex:equal.location]] = [arg substringFromIndex:NSMaxRange(equal)];
+        } else if (i + 1 < arguments.count && ![arguments[i + 1] hasPrefix:@"--"]) {
+            options->_values[arg] = arguments[++i];
+        } else {
+            options->_values[arg] = @"1";
+        }
+    }
+    options.fixtureDirectory = [options stringForKey:@"fixtures"] ?: @YYBENCH_FIXTURE_DIR;
+    options.JSONPath = [options stringForKey:@"json"];
+    NSString *scale = [options stringForKey:@"scale"];
+    options.scale = scale ? scale.doubleValue : 1;
+    if (options.scale <= 0) options.scale = 1;
+    return options;
+}
+
+- (NSString *)stringForKey:(NSString *)key {
+    return _values[key];
+}
+
+- (NSInteger)integerForKey:(NSString *)key defaultValue:(NSInteger)defaultValue {
+    NSString *value = _values[key];
+    return value ? value.integerValue : defaultValue;
+}
+
+- (NSUInteger)iterations:(NSUInteger)count {
+    double scaled = count * _scale;
+    return scaled < 1 ? 1 : (NSUInteger)scaled;
+}
+
+- (id)JSONObjectOfFixture:(NSString *)name {
+    NSString *path = [[_fixtureDirectory stringByAppendingPathComponent:name] stringByAppendingPathExtension:@"json"];
+    NSData *data = [NSData dataWithContentsOfFile:path];
+    id json = data ? [NSJSONSerialization JSONObjectWithData:data options:0 error:NULL] : nil;
+    if (!json) {
+        fprintf(stderr, "error: can not read fixture %s (use --fixtures <dir>)\n", path.UTF8String);
+        exit(1);
+    }
+    return json;
+}
+
+@end
+
+
+@implementation YYBenchReport {
+    NSMutableArray *_rows; ///< Array<@[name, values]>
+}
+
+- (instancetype)initWithTitle:(NSString *)title columns:(NSArray *)columns {
+    self = [super init];
+    _title = title.copy;
+    _columns = columns.copy;
+    _rows = [NSMutableArray new];
+    return self;
+}
+
+- (void)addRow:(NSString *)name values:(NSArray *)values {
+    [_rows addObject:@[name, values.copy]];
+}
+
+static NSString *YYBenchFormatValue(id value) {
+    if (!value || value == (id)kCFNull) return @"N/A";
+    if ([value isKindOfClass:[NSNumber class]]) {
+        double num = [value doubleValue];
+        if (num == floor(num) && fabs(num) < 1e15) return [NSString stringWithFormat:@"%lld", (long long)num];
+        return [NSString stringWithFormat:fabs(num) >= 100 ? @"%.1f" : @"%.3f", num];
+    }
+    return [value description];
+}
+
+- (void)print {
+    NSUInteger nameWidth = 4;
+    for (NSArray *row in _rows) nameWidth = MAX(nameWidth, [row[0] length]);
+    NSMutableArray *widths = [NSMutableArray new];
+    for (NSUInteger i = 0; i < _columns.count; i++) {
+        NSUInteger width = MAX(10, [_columns[i] length]);
+        for (NSArray *row in _rows) {
+            NSArray *values = row[1];
+            if (i < values.count) width = MAX(width, YYBenchFormatValue(values[i]).length);
+        }
+        [widths addObject:@(width)];
+    }
+
+    printf("----------------------\n");
+    printf("%s\n", _title.UTF8String);
+    printf("%-*s", (int)nameWidth, "");
+    for (NSUInteger i = 0; i < _columns.count; i++) {
+        printf("  %*s", [widths[i] intValue], [_columns[i] UTF8String]);
+    }
+    printf("\n");
+    for (NSArray *row in _rows) {
+        NSArray *values = row[1];
+        printf("%-*s", (int)nameWidth, [row[0] UTF8String]);
+        for (NSUInteger i = 0; i < _columns.count; i++) {
+            NSString *text = i < values.count ? YYBenchFormatValue(values[i]) : @"";
+            printf("  %*s", [widths[i] intValue], text.UTF8String);
+        }
+        printf("\n");
+    }
+    printf("----------------------\n\n");
+    fflush(stdout);
+}
+
+- (NSDictionary *)JSONObject {
+    NSMutableArray *rows = [NSMutableArray new];
+    for (NSArray *row in _rows) {
+        NSMutableDictionary *values = [NSMutableDictionary new];
+        NSArray *rowValues = row[1];
+        for (NSUInteger i = 0; i < _columns.count && i < rowValues.count; i++) {
+            values[_columns[i]] = rowValues[i];
+        }
+        [rows addObject:@{ @"name" : row[0], @"values" : values }];
+    }
+    return @{ @"title" : _title, @"columns" : _columns, @"rows" : rows };
+}
+
+@end
+
+
+void YYBenchWriteReports(YYBenchOptions *options, NSString *mode, NSArray *reports) {
+    if (!options.JSONPath) return;
+    NSMutableArray *objects = [NSMutableArray new];
+    for (YYBenchReport *report in reports) [objects addObject:report.JSONObject];
+    NSDictionary *json = @{ @"mode" : mode,
+                            @"platform" : [NSProcessInfo processInfo].operatingSystemVersionString ?: @"",
+                            @"cpus" : @([NSProcessInfo processInfo].activeProcessorCount),
+                            @"scale" : @(options.scale),
+                            @"reports" : objects };
+    NSData *data = [NSJSONSerialization dataWithJSONObject:json options:NSJSONWritingPrettyPrinted error:NULL];
+    if (![data writeToFile:options.JSONPath atomically:YES]) {
+        fprintf(stderr, "error: can not write %s\n", options.JSONPath.UTF8String);
+    }
+}
@@ -0,0 +1,117 @@
+//
+//  YYBenchSynthetic.m
+//  ModelBenchmark
+//
+
+#import "YYBenchSupport.h"
+#import "YYBenchGenerator.h"
+#import "YYModel.h"
+
+/*
+ Decode and encode of generated models and payloads (see YYBenchGenerator), the payload
+ is the json bytes of an array of distinct root models with the given length. Decode is
+ timed from the bytes (including NSJSONSerialization), encode to the bytes, and MB/s is
+ computed from the real lengths. The iterations are reduced for the large payloads, every
+ size processes at least `--volume` bytes (default 64M).
+ */
+
+/// "64", "1K", "16M", "1G" to bytes, returns 0 if it's invalid.
+static NSUInteger YYBenchParseLength(NSString *string) {
+    string = [string stringByTrimmingCharactersInSet:[NSCharacterSet whitespaceCharacterSet]].uppercaseString;
+    if (string.length == 0) return 0;
+    double value = string.doubleValue;
+    unichar unit = [string characterAtIndex:string.length - 1];
+    if (unit == 'B' && string.length > 1) unit = [string characterAtIndex:string.length - 2];
+    switch (unit) {
+        case 'K': value *= 1024; break;
+        case 'M': value *= 1024 * 1024; break;
+        case 'G': value *= 1024 * 1024 * 1024; break;
+        default: break;
+    }
+    return value > 0 ? (NSUInteger)value : 0;
+}
+
+static NSString *YYBenchFormatLength(NSUInteger length) {
+    if (length >= 1024 * 1024 * 1024) return [NSString stringWithFormat:@"%.1fG", length / (1024.0 * 1024 * 1024)];
+    if (length >= 1024 * 1024) return [NSString stringWithFormat:@"%.1fM", length / (1024.0 * 1024)];
+    if (length >= 1024) return [NSString stringWithFormat:@"%.1fK", length / 1024.0];
+    return [NSString stringWithFormat:@"%lu", (unsigned long)length];
+}
+
+int YYBenchRunSynthetic(YYBenchOptions *options) {
+    YYBenchGenerator *generator = [[YYBenchGenerator alloc] initWithSeed:(uint32_t)[options integerForKey:@"seed" defaultValue:1]];
+    generator.width = (NSUInteger)MAX([options integerForKey:@"width" defaultValue:16], 1);
+    generator.depth = (NSUInteger)MAX([options integerForKey:@"depth" defaultValue:2], 0);
+    generator.collectionCount = (NSUInteger)MAX([options integerForKey:@"collection" defaultValue:4], 0);
+    generator.stringLength = (NSUInteger)MAX([options integerForKey:@"string-length" defaultValue:16], 0);
+    if ([options stringForKey:@"keypath"]) generator.keyPathRatio = [options stringForKey:@"keypath"].doubleValue;
+    if ([options stringForKey:@"coercion"]) generator.coercionRatio = [options stringForKey:@"coercion"].doubleValue;
+    if ([options stringForKey:@"types"]) {
+        NSArray *types = [YYBenchGenerator typesWithString:[options stringForKey:@"types"]];
+        if (!types) {
+            fprintf(stderr, "error: invalid --types %s\n", [options stringForKey:@"types"].UTF8String);
+            return 1;
+        }
+        generator.types = types;
+    }
+
+    Class cls = [generator generateClass];
+    if (!cls) {
+        fprintf(stderr, "error: can not create the model class\n");
+        return 1;
+    }
+
+    NSUInteger volume = YYBenchParseLength([options stringForKey:@"volume"] ?: @"64M");
+    NSString *sizes = [options stringForKey:@"sizes"] ?: @"1K,64K,1M,16M";
+    NSString *title = [NSString stringWithFormat:@"Synthetic (width %lu, depth %lu, collection %lu, key path %.2f, coercion %.2f)",
+                       (unsigned long)generator.width, (unsigned long)generator.depth, (unsigned long)generator.collectionCount,
+                       generator.keyPathRatio, generator.coercionRatio];
+    YYBenchReport *report = [[YYBenchReport alloc] initWithTitle:title
+                                                         columns:@[ @"models", @"iterations", @"decode ms", @"decode MB/s", @"allocs/model",
+                                                                    @"encode ms", @"encode MB/s" ]];
+    id none = [NSNull null];
+    for (NSString *size in [sizes componentsSeparatedByString:@","]) {
+        NSUInteger length = YYBenchParseLength(size);
+        if (length == 0) continue;
+        @autoreleasepool {
+            NSUInteger modelCount = 0;
+            NSData *json = [generator JSONDataForClass:cls length:length count:&modelCount];
+            NSUInteger count = [options iterations:MAX(volume / json.length, 1)];
+
+            // warm up (class metas) and check the result
+            NSArray *models = [NSArray yy_modelArrayWithClass:cls json:json];
+            if (models.count != modelCount) {
+                fprintf(stderr, "error: decoded %lu of %lu models\n", (unsigned long)models.count, (unsigned long)modelCount);
+                return 1;
+            }
+            NSUInteger encodedLength = [models yy_modelToJSONData].length;
+
+            YYBenchAllocBegin();
+            double begin = YYBenchNow();
+            for (NSUInteger i = 0; i < count; i++) {
+                @autoreleasepool {
+                    YYBenchUse([NSArray yy_modelArrayWithClass:cls json:json]);
+                }
+            }
+            double decode = (YYBenchNow() - begin) / count;
+            YYBenchAllocStats stats = YYBenchAllocEnd();
+
+            begin = YYBenchNow();
+            for (NSUInteger i = 0; i < count; i++) {
+                @autoreleasepool {
+                    YYBenchUse([models yy_modelToJSONData]);
+                }
+            }
+            double encode = (YYBenchNow() - begin) / count;
+
+            NSString *name = YYBenchFormatLength(length);
+            [report addRow:name values:@[ @(modelCount), @(count),
+                                          @(decode * 1000), @(json.length / (1024.0 * 1024) / decode),
+                                          YYBenchAllocIsAvailable() ? @((double)stats.count / count / modelCount) : none,
+                                          @(encode * 1000), @(encodedLength / (1024.0 * 1024) / encode) ]];
+        }
+    }
+    [report print];
+    YYBenchWriteReports(options, @"synthetic", @[ report ]);
+    return 0;
+}
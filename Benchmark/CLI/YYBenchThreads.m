@@ -0,0 +1,174 @@
+//
+//  YYBenchThreads.m
+//  ModelBenchmark
+//
+
+#import "YYBenchSupport.h"
+#import "GitHubUser.h"
+#import "YYWeiboModel.h"
+#import <objc/runtime.h>
+#import <pthread.h>
+
+/*
+ Every thread runs the same number of operations (weak scaling), so with perfect scaling
+ the wall time stays the same and the throughput grows linearly with the thread count.
+
+ The "distinct classes" cases use subclasses created at runtime (fresh ones for every
+ thread count), so the threads look up and build different class metas at the same time.
+ */
+
+typedef id (^YYBenchThreadOperation)(NSUInteger thread, NSUInteger index);
+
+typedef struct {
+    __unsafe_unretained YYBenchThreadOperation operation;
+    __unsafe_unretained dispatch_semaphore_t ready;
+    __unsafe_unretained dispatch_semaphore_t start;
+    NSUInteger thread;
+    NSUInteger count;
+} YYBenchThreadContext;
+
+static void *YYBenchThreadMain(void *arg) {
+    YYBenchThreadContext *context = arg;
+    dispatch_semaphore_signal(context->ready);
+    dispatch_semaphore_wait(context->start, DISPATCH_TIME_FOREVER);
+    for (NSUInteger i = 0; i < context->count;) {
+        @autoreleasepool {
+            for (NSUInteger end = MIN(i + 64, context->count); i < end; i++) {
+                YYBenchUse(context->operation(context->thread, i));
+            }
+        }
+    }
+    return NULL;
+}
+
+/// Run `count` operations on each of `threads` threads, returns the wall time in seconds.
+static double YYBenchRunOnThreads(NSUInteger threads, NSUInteger count, YYBenchThreadOperation operation) {
+    dispatch_semaphore_t ready = dispatch_semaphore_create(0);
+    dispatch_semaphore_t start = dispatch_semaphore_create(0);
+    YYBenchThreadContext *contexts = calloc(threads, sizeof(YYBenchThreadContext));
+    pthread_t *ids = calloc(threads, sizeof(pthread_t));
+    NSUInteger created = 0;
+    for (; created < threads; created++) {
+        YYBenchThreadContext *context = contexts + created;
+        context->operation = operation;
+        context->ready = ready;
+        context->start = start;
+        context->thread = created;
+        context->count = count;
+        if (pthread_create(ids + created, NULL, YYBenchThreadMain, context) != 0) break;
+    }
+    if (created < threads) fprintf(stderr, "warning: only %lu threads are created\n", (unsigned long)created);
+
+    for (NSUInteger i = 0; i < created; i++) dispatch_semaphore_wait(ready, DISPATCH_TIME_FOREVER);
+    double begin = YYBenchNow();
+    for (NSUInteger i = 0; i < created; i++) dispatch_semaphore_signal(start);
+    for (NSUInteger i = 0; i < created; i++) pthread_join(ids[i], NULL);
+    double end = YYBenchNow();
+
+    free(ids);
+    free(contexts);
+    return created ? (end - begin) : 0;
+}
+
+/// Create `count` empty subclasses of the class, named with a unique prefix.
+static NSArray *YYBenchCreateSubclasses(Class cls, NSUInteger count) {
+    static NSUInteger generation = 0;
+    generation++;
+    NSMutableArray *classes = [NSMutableArray arrayWithCapacity:count];
+    for (NSUInteger i = 0; i < count; i++) {
+        NSString *name = [NSString stringWithFormat:@"%@_Bench%lu_%lu", NSStringFromClass(cls), (unsigned long)generation, (unsigned long)i];
+        Class subclass = objc_allocateClassPair(cls, name.UTF8String, 0);
+        if (!subclass) continue;
+        objc_registerClassPair(subclass);
+        [classes addObject:subclass];
+    }
+    return classes;
+}
+
+static NSArray *YYBenchThreadCounts(YYBenchOptions *options) {
+    NSMutableArray *counts = [NSMutableArray new];
+    NSString *list = [options stringForKey:@"threads"];
+    if (list) {
+        for (NSString *one in [list componentsSeparatedByString:@","]) {
+            if (one.integerValue > 0) [counts addObject:@(one.integerValue)];
+        }
+    } else {
+        NSUInteger cpus = [NSProcessInfo processInfo].activeProcessorCount;
+        for (NSUInteger n = 1; n < cpus; n *= 2) [counts addObject:@(n)];
+        [counts addObject:@(MAX(cpus, 1))];
+    }
+    return counts;
+}
+
+static YYBenchReport *YYBenchThreadsCase(YYBenchOptions *options, NSString *title, NSUInteger count, NSUInteger classCount,
+                                         Class cls, id json, BOOL encode) {
+    YYBenchReport *report = [[YYBenchReport alloc] initWithTitle:title
+                                                         columns:@[ @"ops/thread", @"time ms", @"ops/s", @"speedup", @"efficiency %" ]];
+    // the speedup is relative to one thread, so it is always measured first, and only
+    // reported when it is one of the requested thread counts
+    NSMutableArray *counts = YYBenchThreadCounts(options).mutableCopy;
+    BOOL reportSingle = [counts containsObject:@1];
+    [counts removeObject:@1];
+    [counts insertObject:@1 atIndex:0];
+    double single = 0;
+    for (NSNumber *threadCount in counts) {
+        NSUInteger threads = threadCount.unsignedIntegerValue;
+        NSArray *classes = classCount ? YYBenchCreateSubclasses(cls, classCount) : @[ cls ];
+        if (classes.count == 0) classes = @[ cls ];
+        NSUInteger classesCount = classes.count;
+
+        YYBenchThreadOperation operation;
+        if (encode) {
+            // the models are decoded before the run, so the encode pass finds the metas in the cache
+            NSMutableArray *models = [NSMutableArray arrayWithCapacity:classesCount];
+            for (Class one in classes) [models addObject:[one yy_modelWithJSON:json]];
+            operation = ^id(NSUInteger thread, NSUInteger index) {
+                return [models[(thread + index) % classesCount] yy_modelToJSONObject];
+            };
+        } else {
+            operation = ^id(NSUInteger thread, NSUInteger index) {
+                return [classes[(thread + index) % classesCount] yy_modelWithJSON:json];
+            };
+        }
+
+        double time = YYBenchRunOnThreads(threads, count, operation);
+        double throughput = time > 0 ? threads * count / time : 0;
+        if (threads == 1) {
+            single = throughput;
+            if (!reportSingle) continue;
+        }
+        double speedup = single > 0 ? throughput / single : 0;
+        NSString *name = [NSString stringWithFormat:@"%lu thread%@", (unsigned long)threads, threads > 1 ? @"s" : @""];
+        [report addRow:name values:@[ @(count), @(time * 1000), @(round(throughput)), @(speedup), @(speedup / threads * 100) ]];
+    }
+    [report print];
+    return report;
+}
+
+int YYBenchRunThreads(YYBenchOptions *options) {
+    NSDictionary *user = [options JSONObjectOfFixture:@"user"];
+    NSDictionary *weibo = [options JSONObjectOfFixture:@"weibo"];
+    NSUInteger classCount = (NSUInteger)MAX([options integerForKey:@"classes" defaultValue:256], 1);
+    NSUInteger userCount = [options iterations:10000];
+    NSUInteger weiboCount = [options iterations:1000];
+
+    // warm up the shared metas and formatters
+    @autoreleasepool {
+        [[YYGHUser yy_modelWithJSON:user] yy_modelToJSONObject];
+        [[YYWeiboStatus yy_modelWithJSON:weibo] yy_modelToJSONObject];
+    }
+
+    NSString *distinct = [NSString stringWithFormat:@"%lu distinct classes", (unsigned long)classCount];
+    NSMutableArray *reports = [NSMutableArray new];
+    [reports addObject:YYBenchThreadsCase(options, @"GithubUser decode, same class", userCount, 0, [YYGHUser class], user, NO)];
+    [reports addObject:YYBenchThreadsCase(options, [@"GithubUser decode, " stringByAppendingString:distinct], userCount, classCount, [YYGHUser class], user, NO)];
+    [reports addObject:YYBenchThreadsCase(options, @"GithubUser encode, same class", userCount, 0, [YYGHUser class], user, YES)];
+    [reports addObject:YYBenchThreadsCase(options, [@"GithubUser encode, " stringByAppendingString:distinct], userCount, classCount, [YYGHUser class], user, YES)];
+    [reports addObject:YYBenchThreadsCase(options, @"WeiboStatus decode, same class", weiboCount, 0, [YYWeiboStatus class], weibo, NO)];
+    [reports addObject:YYBenchThreadsCase(options, [@"WeiboStatus decode, " stringByAppendingString:distinct], weiboCount, classCount, [YYWeiboStatus class], weibo, NO)];
+    [reports addObject:YYBenchThreadsCase(options, @"WeiboStatus encode, same class", weiboCount, 0, [YYWeiboStatus class], weibo, YES)];
+    [reports addObject:YYBenchThreadsCase(options, [@"WeiboStatus encode, " stringByAppendingString:distinct], weiboCount, classCount, [YYWeiboStatus class], weibo, YES)];
+
+    YYBenchWriteReports(options, @"threads", reports);
+    return 0;
+}
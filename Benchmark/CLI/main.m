@@ -0,0 +1,68 @@
+//
+//  main.m
+//  ModelBenchmark
+//
+
+#import "YYBenchSupport.h"
+
+/*
+ Command line benchmark, it runs without UI (macOS or Linux with GNUstep).
+
+ Usage: yybench <mode> [--fixtures dir] [--json file] [--scale n] [options of the mode]
+ */
+
+typedef struct {
+    const char *name;
+    int (*run)(YYBenchOptions *options);
+    const char *help;
+} YYBenchMode;
+
+static const YYBenchMode YYBenchModes[] = {
+    {"memory", YYBenchRunMemory, "allocations, bytes and peak memory of decode/encode/copy/archive\n"
+                                 "            --sizes 10,100,1000  sizes of the scaled weibo payloads"},
+    {"threads", YYBenchRunThreads, "decode/encode throughput and scaling efficiency on 1..N threads\n"
+                                   "            --threads 1,2,4,8    thread counts (default: powers of 2 up to the CPU count)\n"
+                                   "            --classes 256        number of runtime subclasses of the distinct class cases"},
+    {"compare", YYBenchRunCompare, "GHUser and WeiboStatus of Manually, YYModel and the vendor libraries (like the app)"},
+    {"synthetic", YYBenchRunSynthetic, "decode/encode of generated models from/to json bytes\n"
+                                       "            --sizes 1K,64K,1M,16M json length of the payloads (up to 1G)\n"
+                                       "            --volume 64M         minimum bytes processed for each size\n"
+                                       "            --width 16 --depth 2 --collection 4 --string-length 16\n"
+                                       "            --keypath 0.1        ratio of the properties mapped to key paths\n"
+                                       "            --coercion 0         ratio of the values with another json type\n"
+                                       "            --types int,double,bool,string,number,date,url,model,array,dict,strings\n"
+                                       "            --seed 1"},
+    {"convert", YYBenchRunConvert, "ns and allocations of every json value -> property type conversion\n"
+                                   "            --filter <name>      only the properties whose name contains the string"},
+};
+
+static void YYBenchPrintUsage(void) {
+    printf("usage: yybench <mode> [options]\n\n");
+    printf("modes:\n");
+    for (size_t i = 0; i < sizeof(YYBenchModes) / sizeof(YYBenchModes[0]); i++) {
+        printf("  %-9s %s\n", YYBenchModes[i].name, YYBenchModes[i].help);
+    }
+    printf("\noptions:\n");
+    printf("  --fixtures <dir>  directory of user.json and weibo.json\n");
+    printf("  --json <file>     write the results as json\n");
+    printf("  --scale <n>       multiplier of the iteration counts (default 1)\n");
+}
+
+int main(int argc, const char *argv[]) {
+    @autoreleasepool {
+        if (argc < 2 || !strcmp(argv[1], "help") || !strcmp(argv[1], "--help")) {
+            YYBenchPrintUsage();
+            return argc < 2 ? 1 : 0;
+        }
+        NSMutableArray *arguments = [NSMutableArray new];
+        for (int i = 2; i < argc; i++) [arguments addObject:@(argv[i])];
+        YYBenchOptions *options = [YYBenchOptions optionsWithArguments:arguments];
+
+        for (size_t i = 0; i < sizeof(YYBenchModes) / sizeof(YYBenchModes[0]); i++) {
+            if (!strcmp(argv[1], YYBenchModes[i].name)) return YYBenchModes[i].run(options);
+        }
+        fprintf(stderr, "unknown mode: %s\n\n", argv[1]);
+        YYBenchPrintUsage();
+        return 1;
+    }
+}
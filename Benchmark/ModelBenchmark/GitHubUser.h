@@ -7,10 +7,24 @@
 //
 
 #import "YYModel.h"
+
+/// The app builds all libraries, the command line benchmark may build YYModel only.
+/// FastEasyMapping and MJExtension need CoreData, they're built with YYBENCH_VENDOR_COREDATA.
+#ifndef YYBENCH_VENDOR
+#define YYBENCH_VENDOR 1
+#endif
+#ifndef YYBENCH_VENDOR_COREDATA
+#define YYBENCH_VENDOR_COREDATA YYBENCH_VENDOR
+#endif
+
+#if YYBENCH_VENDOR
 #import "Mantle.h"
 #import "JSONModelLib.h"
+#if YYBENCH_VENDOR_COREDATA
 #import "FastEasyMapping.h"
 #import "MJExtension.h"
+#endif
+#endif
 
 // https://api.github.com/users/facebook
 
@@ -86,6 +100,8 @@
 @property (nonatomic, strong) NSValue *test;
 @end
 
+#if YYBENCH_VENDOR
+
 /// JSONModel GHUser
 @interface JSGHUser : JSONModel
 @property (nonatomic, strong) NSString *login;
@@ -157,6 +173,8 @@
 @property (nonatomic, strong) NSValue *test;
 @end
 
+#if YYBENCH_VENDOR_COREDATA
+
 /// FastEasyMapping GHUser
 @interface FEGHUser : NSObject
 @property (nonatomic, strong) NSString *login;
@@ -226,4 +244,8 @@
 @property (nonatomic, strong) NSDate *createdAt;
 @property (nonatomic, strong) NSDate *updatedAt;
 @property (nonatomic, strong) NSValue *test;
-@end
\ No newline at end of file
+@end
+
+#endif // YYBENCH_VENDOR_COREDATA
+
+#endif // YYBENCH_VENDOR
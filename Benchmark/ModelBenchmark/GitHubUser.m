@@ -150,6 +150,8 @@ SET_NUM(_following, @"following");
 
 
 
+#if YYBENCH_VENDOR
+
 @implementation JSGHUser
 + (JSONKeyMapper *)keyMapper {
     return [[JSONKeyMapper alloc] initWithDictionary:@{
@@ -223,6 +225,7 @@ SET_NUM(_following, @"following");
 
 
 
+#if YYBENCH_VENDOR_COREDATA
 
 @implementation FEGHUser
 + (FEMMapping *)defaultMapping {
@@ -293,3 +296,7 @@ SET_NUM(_following, @"following");
 }
 MJExtensionCodingImplementation
 @end
+
+#endif // YYBENCH_VENDOR_COREDATA
+
+#endif // YYBENCH_VENDOR
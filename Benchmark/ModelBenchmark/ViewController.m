@@ -15,6 +15,7 @@
 #import "MTWeiboModel.h"
 #import "JSWeiboModel.h"
 #import "MJWeiboModel.h"
+#import "WideModel.h"
 //#import "ModelBenchmark-Swift.h"
 
 /*
@@ -34,6 +35,7 @@
     dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(1.0 * NSEC_PER_SEC)), dispatch_get_main_queue(), ^{
         [self benchmarkGithubUser];
         [self benchmarkWeiboStatus];
+        [self benchmarkDecodeStrategy];
         
         [self testRobustness];
     });
@@ -371,6 +373,45 @@
     printf("\n");
 }
 
+- (void)benchmarkDecodeStrategy {
+    printf("----------------------\n");
+    printf("Benchmark (10000 times):\n");
+    printf("YYWideModel (32 properties) decode strategy\n");
+    printf("mapped  unmapped   automatic   dictionary  mapped keys\n");
+    
+    int count = 10000;
+    int mappedCounts[] = {2, 8, 16, 32};
+    int unmappedCounts[] = {0, 8, 32, 128};
+    NSArray *classes = @[[YYWideModel class], [YYWideModelDictionary class], [YYWideModelMappedKeys class]];
+    
+    for (int m = 0; m < sizeof(mappedCounts) / sizeof(mappedCounts[0]); m++) {
+        for (int u = 0; u < sizeof(unmappedCounts) / sizeof(unmappedCounts[0]); u++) {
+            NSDictionary *json = [YYWideModel jsonWithMappedCount:mappedCounts[m] unmappedCount:unmappedCounts[u]];
+            printf("%6d  %8d ", mappedCounts[m], unmappedCounts[u]);
+            for (Class cls in classes) {
+                /// warm up (and let the automatic strategy collect statistics)
+                @autoreleasepool {
+                    for (int i = 0; i < 100; i++) {
+                        [cls yy_modelWithDictionary:json];
+                    }
+                }
+                NSTimeInterval begin, end;
+                begin = CACurrentMediaTime();
+                @autoreleasepool {
+                    for (int i = 0; i < count; i++) {
+                        [cls yy_modelWithDictionary:json];
+                    }
+                }
+                end = CACurrentMediaTime();
+                printf("  %10.2f ", (end - begin) * 1000);
+            }
+            printf("\n");
+        }
+    }
+    printf("----------------------\n");
+    printf("\n");
+}
+
 - (void)benchmarkWeiboStatus {
     printf("----------------------\n");
     printf("Benchmark (1000 times):\n");
@@ -0,0 +1,29 @@
+//
+//  WideModel.h
+//  ModelBenchmark
+//
+
+#import "YYModel.h"
+
+/// A wide model with 32 string properties (p0 ~ p31), mapped to the same json keys.
+@interface YYWideModel : NSObject
+@property (nonatomic, strong) NSString *p0, *p1, *p2, *p3, *p4, *p5, *p6, *p7;
+@property (nonatomic, strong) NSString *p8, *p9, *p10, *p11, *p12, *p13, *p14, *p15;
+@property (nonatomic, strong) NSString *p16, *p17, *p18, *p19, *p20, *p21, *p22, *p23;
+@property (nonatomic, strong) NSString *p24, *p25, *p26, *p27, *p28, *p29, *p30, *p31;
+
+/**
+ Creates a synthetic json dictionary.
+ @param mapped   The number of mapped keys (0 ~ 32), the values are strings.
+ @param unmapped The number of extra keys which are not mapped.
+ */
++ (NSDictionary *)jsonWithMappedCount:(int)mapped unmappedCount:(int)unmapped;
+@end
+
+/// YYWideModel which always iterates the json dictionary.
+@interface YYWideModelDictionary : YYWideModel
+@end
+
+/// YYWideModel which always looks up the mapped keys.
+@interface YYWideModelMappedKeys : YYWideModel
+@end
@@ -0,0 +1,33 @@
+//
+//  WideModel.m
+//  ModelBenchmark
+//
+
+#import "WideModel.h"
+
+@implementation YYWideModel
+
++ (NSDictionary *)jsonWithMappedCount:(int)mapped unmappedCount:(int)unmapped {
+    NSMutableDictionary *json = [NSMutableDictionary new];
+    for (int i = 0; i < mapped && i < 32; i++) {
+        json[[NSString stringWithFormat:@"p%d", i]] = [NSString stringWithFormat:@"value %d", i];
+    }
+    for (int i = 0; i < unmapped; i++) {
+        json[[NSString stringWithFormat:@"extra_key_%d", i]] = @(i);
+    }
+    return json;
+}
+
+@end
+
+@implementation YYWideModelDictionary
++ (YYModelDecodeStrategy)modelDecodeStrategy {
+    return YYModelDecodeStrategyDictionary;
+}
+@end
+
+@implementation YYWideModelMappedKeys
++ (YYModelDecodeStrategy)modelDecodeStrategy {
+    return YYModelDecodeStrategyMappedKeys;
+}
+@end
@@ -149,6 +149,54 @@ NS_ASSUME_NONNULL_BEGIN
  */
 - (nullable NSString *)yy_modelToJSONString;
 
+/**
+ 通过 receiver 的属性 生成一个规范化 (canonical) 的 json 字符串 data
+ @return json 字符串 data, 如果为 nil , 表示发生了错误.
+ 
+ @discussion 相等的 model 总是生成逐字节相同的结果, 可以直接用来做哈希或比较:
+ 对象的 key 按 UTF-16 码元排序 (model 的 key 顺序在创建 meta 时计算一次),
+ 没有空白字符, 字符串以 UTF-8 输出并且只转义必要的字符, 数字的格式与 locale 无关
+ (整数精确输出, 浮点数输出能还原出原值的最短形式, NaN 和 infinity 输出为 null).
+ NSSet 中的元素按输出的结果排序. 其他的转换规则与 `yy_modelToJSONData` 相同.
+ */
+- (nullable NSData *)yy_modelToCanonicalJSONData;
+
+/**
+ 通过 receiver 的属性 生成一个规范化 (canonical) 的 json 字符串
+ @return json 字符串, 如果为 nil , 表示发生了错误.
+ 
+ @discussion 参见 `yy_modelToCanonicalJSONData`.
+ */
+- (nullable NSString *)yy_modelToCanonicalJSONString;
+
+/**
+ 计算 receiver 的内容摘要 (128 位), 可以用作 ETag 或缓存的 key
+ @param digest 用于写入结果的 16 字节 buffer.
+ @return 是否成功, 如果为 NO, 表示发生了错误 (与 `yy_modelToCanonicalJSONData` 返回 nil 的情况相同).
+ 
+ @discussion 摘要是对规范化 json (见 `yy_modelToCanonicalJSONData`) 的字节流计算的
+ SipHash-2-4 (128 位输出, 固定的 key), 因此 canonical json 相同的对象摘要一定相同.
+ 计算时不生成 json data: 属性按 meta 中预先排好的顺序遍历, c 数值属性直接读取并格式化
+ (不包装为 NSNumber), NSString、NSURL 和 NSDate 的字节直接流入哈希.
+ 
+ 以下情况仍会创建临时对象:
+ - NSDictionary 的 key 排序和 NSSet 元素的排序.
+ - 有 enum mapper 或 transformer 的属性, 以及 Class、SEL 属性 (与 `yy_modelToJSONObject` 相同的转换).
+ - 有 baseURL 的 NSURL (使用 absoluteString), 以及年份不在 1900~9999 范围内的 NSDate (使用 date formatter).
+ - 如果 model 的属性映射到 key path (例如 "user.name"), 或者 model 实现了
+   `modelCustomTransformToDictionary:`, 则会先用 `yy_modelToJSONObject` 的方式生成完整的
+   json 对象树, 再对它计算摘要, 这时的开销与 `yy_modelToJSONObject` 相当.
+ */
+- (BOOL)yy_modelGetDigest:(uint8_t *)digest;
+
+/**
+ 计算 receiver 的内容摘要, 返回 32 个字符的十六进制字符串
+ @return 摘要字符串, 如果为 nil , 表示发生了错误.
+ 
+ @discussion 参见 `yy_modelGetDigest:`.
+ */
+- (nullable NSString *)yy_modelDigestString;
+
 /**
  连同属性拷贝实例
  @return 被拷贝的实例对象, 如果为 nil , 表示发生了错误.
@@ -157,13 +205,13 @@ NS_ASSUME_NONNULL_BEGIN
 
 /**
  Encode the receiver's properties to a coder.
- 将 receiver 的属性 归档
- @param aCoder  归档对象.
+ 将 receiver 的属性 归档, c 数值属性使用 encodeBool/encodeInt64/encodeDouble 直接归档, 不再包装为 NSNumber.
+ @param aCoder  归档对象, 应支持 keyed coding.
  */
 - (void)yy_modelEncodeWithCoder:(NSCoder *)aCoder;
 
 /**
- 将 receiver 的属性 解档
+ 将 receiver 的属性 解档, 兼容旧版本以 NSNumber 归档的 c 数值属性.
  @param aDecoder  解档对象.
  
  @return 自身
@@ -233,6 +281,134 @@ NS_ASSUME_NONNULL_BEGIN
 
 
 
+/**
+ A value transformer of a property, it's used to customize the conversion of one
+ property without implementing the whole-object transform methods.
+ 
+ @discussion The transformer is resolved into the property's meta when the model's
+ meta is created, and it's called with the raw value in the transform loops.
+ A transformer can be provided per property with `+modelPropertyTransformers`, or
+ registered for a property class with `+registerTransformer:forClass:`.
+ 
+ Example:
+ 
+     YYModelTransformer *timestamp = [YYModelTransformer transformerWithDecoder:^id(id value) {
+         if (![value isKindOfClass:[NSNumber class]]) return nil;
+         return [NSDate dateWithTimeIntervalSince1970:[value doubleValue] / 1000];
+     } encoder:^id(NSDate *date) {
+         return @((int64_t)(date.timeIntervalSince1970 * 1000));
+     }];
+ */
+@interface YYModelTransformer : NSObject
+
+/**
+ json value -> property value.
+ The result is set to the property with the default type conversion; return nil to
+ ignore the value, or NSNull to set nil.
+ */
+@property (nullable, nonatomic, copy, readonly) id _Nullable (^decoder)(id value);
+
+/**
+ property value -> json value.
+ The value of a c number property is passed as NSNumber; return nil to ignore the property.
+ */
+@property (nullable, nonatomic, copy, readonly) id _Nullable (^encoder)(id value);
+
+/**
+ Creates and returns a transformer.
+ @param decoder  json value -> property value, nil to use the default transform.
+ @param encoder  property value -> json value, nil to use the default transform.
+ */
++ (instancetype)transformerWithDecoder:(nullable id _Nullable (^)(id value))decoder
+                               encoder:(nullable id _Nullable (^)(id value))encoder;
+
+/**
+ Register a transformer for all properties whose class is `cls` (or its subclass).
+ Pass nil to remove the transformer. A transformer from `+modelPropertyTransformers`
+ has a higher priority. This method is thread-safe.
+ 
+ @discussion The transformer is resolved when a model's meta is created, so it
+ should be registered before the model class is used.
+ */
++ (void)registerTransformer:(nullable YYModelTransformer *)transformer forClass:(Class)cls;
+
+@end
+
+
+
+/**
+ Storage policy for strings created from raw bytes (such as an `NSData` value
+ which is set to an `NSString` property).
+ */
+typedef NS_ENUM (NSUInteger, YYModelStringStorage) {
+    /// Copy the bytes into a new string (default).
+    YYModelStringStorageCopy = 0,
+    /// Long ASCII strings reference the input buffer without copying it. The buffer is
+    /// retained (or copied once if it's mutable) and stays alive until the last string
+    /// referencing it is released. Short strings are always created in compact form.
+    YYModelStringStorageNoCopy,
+};
+
+
+/**
+ Memoization policy of `+yy_modelWithJSON:` for byte-identical json strings or data.
+ */
+typedef NS_ENUM (NSUInteger, YYModelDecodeCachePolicy) {
+    /// Decode every time (default).
+    YYModelDecodeCachePolicyNone = 0,
+    /// Returns a deep copy of the cached model: nested models and collections (and
+    /// mutable strings and data) are copied recursively, immutable values are shared.
+    /// A model referred more than once is copied once, weak properties are not followed.
+    YYModelDecodeCachePolicyCopy,
+    /// Returns the cached model itself, it's shared by all callers and should not be modified.
+    YYModelDecodeCachePolicyShared,
+};
+
+
+/**
+ How `-yy_modelSetWithDictionary:` finds the mapped keys in a json dictionary.
+ */
+typedef NS_ENUM (NSUInteger, YYModelDecodeStrategy) {
+    /// Choose the cheaper one for each json dictionary, with the model's running
+    /// statistics (default).
+    YYModelDecodeStrategyAutomatic = 0,
+    /// Iterate the json dictionary, and look up each key in the model's mapped keys.
+    /// It's cheaper for small dictionaries.
+    YYModelDecodeStrategyDictionary,
+    /// Look up each mapped key of the model in the json dictionary.
+    /// It's cheaper for dictionaries with many unmapped keys.
+    YYModelDecodeStrategyMappedKeys,
+};
+
+
+/**
+ The global cache used by `+yy_modelWithJSON:` for classes which returns a policy other
+ than `YYModelDecodeCachePolicyNone` in `+modelDecodeCachePolicy`.
+ 
+ @discussion The key is a hash of the json bytes and the model class (a hit is verified
+ by comparing the bytes), the cost of an entry is the length of the json bytes, and
+ the least recently used entries are evicted when the total cost exceeds the limit.
+ All methods are thread-safe.
+ */
+@interface YYModelDecodeCache : NSObject
+
+/// The maximum total cost (in bytes), default is 4MB. 0 disables the cache.
++ (NSUInteger)costLimit;
++ (void)setCostLimit:(NSUInteger)costLimit;
+
+/// The total cost (in bytes) of the cached entries.
++ (NSUInteger)totalCost;
+
+/// The number of the cached entries.
++ (NSUInteger)totalCount;
+
+/// Removes all cached entries.
++ (void)removeAllObjects;
+
+@end
+
+
+
 /**
  If the default model transform does not fit to your model class, implement one or
  more method in this protocol to change the default key-value transform process.
@@ -309,6 +485,71 @@ NS_ASSUME_NONNULL_BEGIN
  */
 + (nullable NSDictionary<NSString *, id> *)modelContainerPropertyGenericClass;
 
+/**
+ Per-property value transformers.
+ 
+ @discussion If the default conversion does not fit a property, implements this method
+ and returns a property->transformer mapper. The transformer is called with the raw
+ value in the transform loops, so there's no need to look up the key again in
+ `-modelCustomTransformFromDictionary:` or `-modelCustomTransformToDictionary:`.
+ 
+ Example:
+ 
+    @implementation YYStatus
+    + (NSDictionary *)modelPropertyTransformers {
+        return @{@"createdAt" : [YYModelTransformer transformerWithDecoder:^id(NSNumber *value) {
+            return [NSDate dateWithTimeIntervalSince1970:value.doubleValue / 1000];
+        } encoder:nil]};
+    }
+    @end
+ 
+ @return A property->transformer mapper.
+ */
++ (nullable NSDictionary<NSString *, YYModelTransformer *> *)modelPropertyTransformers;
+
+/**
+ The enum mapper for number properties.
+ 
+ @discussion If a number property is represented by a string in json (such as
+ "male"/"female"), implements this method and returns a property->{string:value}
+ mapper. The mapper is compiled into a lookup table when the model's meta is created,
+ and it's used in both json->model and model->json transform.
+ 
+ Example:
+ 
+    json:
+        {
+            "gender" : "female",
+            "type" : "video"
+        }
+ 
+    model:
+        typedef NS_ENUM (NSInteger, YYGender) {
+            YYGenderUnknown = 0,
+            YYGenderMale,
+            YYGenderFemale,
+        };
+ 
+        @interface YYUser : NSObject
+        @property YYGender gender;
+        @property int type;
+        @end
+ 
+        @implementation YYUser
+        + (NSDictionary *)modelEnumPropertyMapper {
+            return @{@"gender" : @{@"male" : @(YYGenderMale), @"female" : @(YYGenderFemale)},
+                     @"type" : @{@"photo" : @1, @"video" : @2}};
+        }
+        @end
+ 
+ If a string is not in the mapper, the default string->number transform is used.
+ If a value is not in the mapper, it's converted to json as a number. If multiple
+ strings are mapped to the same value, the first one in ascending order is used.
+ 
+ @return An enum mapper for properties.
+ */
++ (nullable NSDictionary<NSString *, NSDictionary<NSString *, NSNumber *> *> *)modelEnumPropertyMapper;
+
 /**
  If you need to create instances of different classes during json->object transform,
  use the method to choose custom class based on dictionary data.
@@ -359,6 +600,75 @@ NS_ASSUME_NONNULL_BEGIN
  */
 + (nullable NSArray<NSString *> *)modelPropertyWhitelist;
 
+/**
+ The storage policy for strings created from raw bytes.
+ 
+ @discussion By default, every string created from an `NSData` value is a copy of
+ the bytes. Large text fields (such as status bodies or HTML) can avoid the copy by
+ returning `YYModelStringStorageNoCopy`; the input buffer then stays alive as long
+ as any of these strings.
+ 
+ @return The string storage policy, default is `YYModelStringStorageCopy`.
+ */
++ (YYModelStringStorage)modelStringStorage;
+
+/**
+ Whether the `NSURL` properties are created lazily.
+ 
+ @discussion By default, an `NSURL` property is created (and the whole URL is parsed)
+ when the model is transformed from json. If this method returns YES, the property
+ stores the trimmed and validated URL string, and the `NSURL` is created on first
+ access. `-modelToJSONObject` emits the stored string directly. A string which is not
+ in the plain subset of the URL syntax (such as a bad percent escape, an IPv6 host or a
+ non-ASCII character) is still parsed by `NSURL` when the model is transformed, so an
+ invalid URL is nil as before.
+ 
+ The lazy URL is a proxy of `NSURL`: it responds to all `NSURL` methods, but it
+ should not be passed to CoreFoundation as a `CFURLRef`.
+ 
+ @return Whether the URL properties are created lazily, default is NO.
+ */
++ (BOOL)modelLazyURL;
+
+/**
+ Whether `+yy_modelWithJSON:` memoizes the decoded models.
+ 
+ @discussion Pollers often receive byte-identical payloads. If this method returns
+ a policy other than `YYModelDecodeCachePolicyNone`, `+yy_modelWithJSON:` looks up
+ the json string or data in `YYModelDecodeCache` first, and returns the cached model
+ (or its copy) without parsing the json again. A miss costs a hash of the json bytes.
+ 
+ Other methods (such as `+yy_modelWithDictionary:`) are not affected.
+ 
+ @return The decode cache policy, default is `YYModelDecodeCachePolicyNone`.
+ */
++ (YYModelDecodeCachePolicy)modelDecodeCachePolicy;
+
+/**
+ The strategy to find the mapped keys in a json dictionary.
+ 
+ @discussion By default, the model keeps lightweight running statistics of the json
+ dictionaries it's transformed from (the number of keys and the ratio of mapped keys),
+ and compares the estimated cost of each strategy with the dictionary's size. Implement
+ this method to pin a strategy if the payloads of the model are known to be dense or sparse.
+ 
+ @return The decode strategy, default is `YYModelDecodeStrategyAutomatic`.
+ */
++ (YYModelDecodeStrategy)modelDecodeStrategy;
+
+/**
+ The number of models decoded in one autorelease pool in a collection.
+
+ @discussion `+[NSArray yy_modelArrayWithClass:json:]`, `+[NSDictionary yy_modelDictionaryWithClass:json:]`
+ and the generic container properties (whose generic class is this class) decode
+ the elements in batches, and drain the temporary objects of each batch, so the
+ peak memory of a large collection does not grow with its size. A collection with
+ no more elements than the batch size is decoded without autorelease pool.
+
+ @return The batch size, default is 64. 0 disables the autorelease pools.
+ */
++ (NSUInteger)modelAutoreleaseBatchSize;
+
 /**
  This method's behavior is similar to `- (BOOL)modelCustomTransformFromDictionary:(NSDictionary *)dic;`, 
  but be called before the model transform.
@@ -11,29 +11,16 @@
 
 #import "NSObject+YYModel.h"
 #import "YYClassInfo.h"
+#import "YYModelMeta.h"
 #import <objc/message.h>
+#if __has_include(<xlocale.h>)
+#import <xlocale.h>
+#else
+#import <locale.h>
+#endif
 
 #define force_inline __inline__ __attribute__((always_inline))
 
-/// Foundation Class Type
-typedef NS_ENUM (NSUInteger, YYEncodingNSType) {
-    YYEncodingTypeNSUnknown = 0,
-    YYEncodingTypeNSString,
-    YYEncodingTypeNSMutableString,
-    YYEncodingTypeNSValue,
-    YYEncodingTypeNSNumber,
-    YYEncodingTypeNSDecimalNumber,
-    YYEncodingTypeNSData,
-    YYEncodingTypeNSMutableData,
-    YYEncodingTypeNSDate,
-    YYEncodingTypeNSURL,
-    YYEncodingTypeNSArray,
-    YYEncodingTypeNSMutableArray,
-    YYEncodingTypeNSDictionary,
-    YYEncodingTypeNSMutableDictionary,
-    YYEncodingTypeNSSet,
-    YYEncodingTypeNSMutableSet,
-};
 
 /// Get the Foundation class type from property info.
 static force_inline YYEncodingNSType YYClassGetNSType(Class cls) {
@@ -75,13 +62,230 @@ static force_inline BOOL YYEncodingTypeIsCNumber(YYEncodingType type) {
     }
 }
 
+/// A decimal number scanned from a string: (-1)^negative * mantissa * 10^exponent.
+typedef struct {
+    uint64_t mantissa;  ///< significant digits (up to 20 digits, no overflow)
+    int32_t exponent;   ///< decimal exponent
+    BOOL negative;      ///< has '-' sign
+    BOOL truncated;     ///< YES if some non-zero digits are dropped from mantissa
+    BOOL isInteger;     ///< YES if there's no fraction or exponent part
+} YYNumberScan;
+
+/**
+ Scan a decimal number in C string, such as " -12.34e5".
+ 
+ @discussion Leading white spaces and trailing characters are ignored (same as atof/atoll),
+ the scan is locale independent and never overflows.
+ 
+ @return The end of the number, or NULL if there's no digit.
+ */
+static const char *YYNumberScanCString(const char *cur, YYNumberScan *scan) {
+    #define IS_DIGIT(_c_) ((unsigned char)((_c_) - '0') < 10)
+    uint64_t mantissa = 0;
+    int32_t exponent = 0;
+    BOOL hasDigit = NO, full = NO, truncated = NO, isInteger = YES, negative = NO;
+    
+    while (*cur == ' ' || (*cur >= '\t' && *cur <= '\r')) cur++;
+    if (*cur == '-') { negative = YES; cur++; }
+    else if (*cur == '+') cur++;
+    
+    // integer part
+    while (*cur == '0') { hasDigit = YES; cur++; }
+    for (; IS_DIGIT(*cur); cur++) {
+        unsigned int d = *cur - '0';
+        hasDigit = YES;
+        if (!full && mantissa <= (UINT64_MAX - d) / 10) {
+            mantissa = mantissa * 10 + d;
+        } else {
+            full = YES;
+            exponent++;
+            if (d) truncated = YES;
+        }
+    }
+    
+    // fraction part
+    if (*cur == '.') {
+        cur++;
+        if (mantissa == 0) {
+            while (*cur == '0') { hasDigit = YES; exponent--; cur++; }
+        }
+        for (; IS_DIGIT(*cur); cur++) {
+            unsigned int d = *cur - '0';
+            hasDigit = YES;
+            isInteger = NO;
+            if (!full && mantissa <= (UINT64_MAX - d) / 10) {
+                mantissa = mantissa * 10 + d;
+                exponent--;
+            } else {
+                full = YES;
+                if (d) truncated = YES;
+            }
+        }
+    }
+    if (!hasDigit) return NULL;
+    
+    // exponent part
+    if (*cur == 'e' || *cur == 'E') {
+        const char *exp = cur + 1;
+        BOOL expNegative = NO;
+        if (*exp == '-') { expNegative = YES; exp++; }
+        else if (*exp == '+') exp++;
+        if (IS_DIGIT(*exp)) {
+            int32_t value = 0;
+            for (; IS_DIGIT(*exp); exp++) {
+                if (value < 100000) value = value * 10 + (*exp - '0');
+            }
+            exponent += expNegative ? -value : value;
+            isInteger = NO;
+            cur = exp;
+        }
+    }
+    if (mantissa == 0) exponent = 0;
+    if (exponent != 0) isInteger = NO;
+    
+    scan->mantissa = mantissa;
+    scan->exponent = exponent;
+    scan->negative = negative;
+    scan->truncated = truncated;
+    scan->isInteger = isInteger;
+    return cur;
+    #undef IS_DIGIT
+}
+
+/// Get the "C" locale, for locale independent strtod_l().
+static force_inline locale_t YYCLocale() {
+    static locale_t locale;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        locale = newlocale(LC_ALL_MASK, "C", NULL);
+    });
+    return locale;
+}
+
+/**
+ Convert a scanned number to double, the result is correctly rounded.
+ 
+ @discussion Most numbers take the exact fast path (mantissa <= 2^53 and small exponent,
+ both operands are exact doubles so the single multiply/divide is correctly rounded);
+ others fall back to a locale independent strtod_l() on the source string.
+ */
+static force_inline double YYNumberScanGetDouble(YYNumberScan *scan, const char *cstring) {
+    static const double kPow10[] = {
+        1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+    if (scan->mantissa == 0) return scan->negative ? -0.0 : 0.0;
+    if (!scan->truncated && scan->mantissa <= (1ULL << 53)) {
+        int32_t exponent = scan->exponent;
+        uint64_t mantissa = scan->mantissa;
+        // move extra exponent into mantissa if it's still exact: 123e25 -> 123000e22
+        while (exponent > 22 && mantissa <= (1ULL << 53) / 10) {
+            mantissa *= 10;
+            exponent--;
+        }
+        if (exponent >= -22 && exponent <= 22) {
+            double value = (double)mantissa;
+            value = (exponent < 0) ? value / kPow10[-exponent] : value * kPow10[exponent];
+            return scan->negative ? -value : value;
+        }
+    }
+    return strtod_l(cstring, NULL, YYCLocale());
+}
+
+/**
+ Create a number from C string, integers are parsed exactly (up to uint64).
+ @return A number, or nil if the number is NaN or infinity.
+ */
+static force_inline NSNumber *YYNSNumberCreateFromCString(const char *cstring) {
+    YYNumberScan scan;
+    if (!YYNumberScanCString(cstring, &scan)) return @(0);
+    if (scan.isInteger && !scan.truncated) {
+        if (scan.negative) {
+            if (scan.mantissa <= (uint64_t)INT64_MAX + 1) return @((long long)(0 - scan.mantissa));
+        } else {
+            if (scan.mantissa <= INT64_MAX) return @((long long)scan.mantissa);
+            return @((unsigned long long)scan.mantissa);
+        }
+    }
+    double num = YYNumberScanGetDouble(&scan, cstring);
+    if (isnan(num) || isinf(num)) return nil;
+    return @(num);
+}
+
+/**
+ Get a C string from string, use the buffer if the string is short.
+ This avoids the autoreleased buffer of `-[NSString UTF8String]`.
+ */
+static force_inline const char *YYCStringFromString(__unsafe_unretained NSString *string, char *buffer, size_t bufferSize) {
+    const char *cstring = CFStringGetCStringPtr((CFStringRef)string, kCFStringEncodingUTF8);
+    if (cstring) return cstring;
+    if (CFStringGetCString((CFStringRef)string, buffer, bufferSize, kCFStringEncodingUTF8)) return buffer;
+    return string.UTF8String;
+}
+
+/**
+ Create a decimal number from string with the exact decimal mantissa.
+ @return A decimal number, or nil if the string is not a number.
+ */
+static force_inline NSDecimalNumber *YYNSDecimalNumberCreateFromString(__unsafe_unretained NSString *string) {
+    char buffer[64];
+    const char *cstring = YYCStringFromString(string, buffer, sizeof(buffer));
+    YYNumberScan scan;
+    if (cstring && YYNumberScanCString(cstring, &scan) &&
+        !scan.truncated && scan.exponent >= -128 && scan.exponent <= 127) {
+        // a negative zero mantissa is NaN in NSDecimal, "-0" is zero
+        return [NSDecimalNumber decimalNumberWithMantissa:scan.mantissa
+                                                 exponent:(short)scan.exponent
+                                               isNegative:scan.negative && scan.mantissa != 0];
+    }
+    NSDecimalNumber *decNum = [NSDecimalNumber decimalNumberWithString:string];
+    NSDecimal dec = decNum.decimalValue;
+    if (dec._length == 0 && dec._isNegative) {
+        decNum = nil; // NaN
+    }
+    return decNum;
+}
+
+/**
+ Get the integer part of a decimal number as 64-bit integer bits (two's complement
+ for negative number), without precision loss.
+ */
+static force_inline uint64_t YYNSDecimalNumberGetInt64Bits(__unsafe_unretained NSDecimalNumber *num) {
+    NSDecimal dec = num.decimalValue;
+    unsigned short mantissa[8];
+    memcpy(mantissa, dec._mantissa, sizeof(mantissa));
+    int length = dec._length;
+    int exponent = dec._exponent;
+    if (length == 0) return 0; // zero or NaN
+    
+    // drop the fraction digits: mantissa /= 10
+    for (; exponent < 0 && length > 0; exponent++) {
+        uint32_t remainder = 0;
+        for (int i = length - 1; i >= 0; i--) {
+            uint32_t cur = (remainder << 16) | mantissa[i];
+            mantissa[i] = cur / 10;
+            remainder = cur % 10;
+        }
+        while (length > 0 && mantissa[length - 1] == 0) length--;
+    }
+    if (length > 4) return dec._isNegative ? (uint64_t)num.longLongValue : num.unsignedLongLongValue;
+    
+    uint64_t value = 0;
+    for (int i = length - 1; i >= 0; i--) {
+        value = (value << 16) | mantissa[i];
+    }
+    for (; exponent > 0; exponent--) {
+        if (value > UINT64_MAX / 10) return dec._isNegative ? (uint64_t)num.longLongValue : num.unsignedLongLongValue;
+        value *= 10;
+    }
+    return dec._isNegative ? 0 - value : value;
+}
+
 /// Parse a number value from 'id'.
 static force_inline NSNumber *YYNSNumberCreateFromID(__unsafe_unretained id value) {
-    static NSCharacterSet *dot;
     static NSDictionary *dic;
     static dispatch_once_t onceToken;
     dispatch_once(&onceToken, ^{
-        dot = [NSCharacterSet characterSetWithRange:NSMakeRange('.', 1)];
         dic = @{@"TRUE" :   @(YES),
                 @"True" :   @(YES),
                 @"true" :   @(YES),
@@ -116,21 +320,66 @@ static force_inline NSNumber *YYNSNumberCreateFromID(__unsafe_unretained id valu
             if (num == (id)kCFNull) return nil;
             return num;
         }
-        if ([(NSString *)value rangeOfCharacterFromSet:dot].location != NSNotFound) {
-            const char *cstring = ((NSString *)value).UTF8String;
-            if (!cstring) return nil;
-            double num = atof(cstring);
-            if (isnan(num) || isinf(num)) return nil;
-            return @(num);
-        } else {
-            const char *cstring = ((NSString *)value).UTF8String;
-            if (!cstring) return nil;
-            return @(atoll(cstring));
-        }
+        char buffer[64];
+        const char *cstring = YYCStringFromString(value, buffer, sizeof(buffer));
+        if (!cstring) return nil;
+        return YYNSNumberCreateFromCString(cstring);
     }
     return nil;
 }
 
+/// Whether the bytes are all 7-bit ASCII.
+static force_inline BOOL YYBytesIsASCII(const uint8_t *bytes, NSUInteger length) {
+    NSUInteger i = 0;
+    for (; i + 8 <= length; i += 8) {
+        uint64_t word;
+        memcpy(&word, bytes + i, 8);
+        if (word & 0x8080808080808080ULL) return NO;
+    }
+    for (; i < length; i++) {
+        if (bytes[i] & 0x80) return NO;
+    }
+    return YES;
+}
+
+/// The bytes are owned by the NSData in `info`, it's released with the allocator.
+static void YYDataAllocatorDeallocate(void *ptr, void *info) {}
+
+/**
+ Create an immutable string from UTF-8 data.
+ 
+ Short ASCII strings are created with CFStringCreateWithBytes, which returns a
+ compact (tagged pointer on 64-bit) string. If `noCopy` is YES, long ASCII strings
+ reference the data's bytes directly and retain the (immutable) data.
+ */
+static force_inline NSString *YYNSStringCreateFromData(__unsafe_unretained NSData *data, BOOL noCopy) {
+    #define kCompactMaxLength 15
+    const uint8_t *bytes = data.bytes;
+    NSUInteger length = data.length;
+    if (length == 0) return @"";
+    BOOL isASCII = (length <= kCompactMaxLength || noCopy) && YYBytesIsASCII(bytes, length);
+    if (!isASCII) {
+        return CFBridgingRelease(CFStringCreateWithBytes(kCFAllocatorDefault, bytes, length, kCFStringEncodingUTF8, false));
+    }
+    if (length <= kCompactMaxLength) {
+        return CFBridgingRelease(CFStringCreateWithBytes(kCFAllocatorDefault, bytes, length, kCFStringEncodingASCII, false));
+    }
+    
+    NSData *buffer = data.copy; // retain if immutable
+    CFAllocatorContext context = {0};
+    context.info = (__bridge void *)buffer;
+    context.retain = CFRetain;
+    context.release = CFRelease;
+    context.deallocate = YYDataAllocatorDeallocate;
+    CFAllocatorRef deallocator = CFAllocatorCreate(kCFAllocatorDefault, &context);
+    if (!deallocator) return nil;
+    CFStringRef string = CFStringCreateWithBytesNoCopy(kCFAllocatorDefault, buffer.bytes, length,
+                                                       kCFStringEncodingASCII, false, deallocator);
+    CFRelease(deallocator);
+    return CFBridgingRelease(string);
+    #undef kCompactMaxLength
+}
+
 /// Parse string to date.
 static force_inline NSDate *YYNSDateFromString(__unsafe_unretained NSString *string) {
     typedef NSDate* (^YYNSDateParseBlock)(NSString *string);
@@ -243,6 +492,159 @@ static force_inline NSDate *YYNSDateFromString(__unsafe_unretained NSString *str
 }
 
 
+/**
+ A URL proxy which holds the URL string, the real NSURL is created on first access.
+ Create it with YYLazyURLCreateFromString().
+ */
+@interface _YYLazyURL : NSProxy {
+    @package
+    NSString *_string; ///< trimmed and validated URL string
+    CFURLRef _url;     ///< the real url (retained), created lazily and set atomically
+}
+@end
+
+@implementation _YYLazyURL
+
+- (void)dealloc {
+    if (_url) CFRelease(_url);
+}
+
+- (NSURL *)_yy_url {
+    CFURLRef url = __atomic_load_n(&_url, __ATOMIC_ACQUIRE);
+    if (url) return (__bridge NSURL *)url;
+    CFURLRef newURL = CFURLCreateWithString(kCFAllocatorDefault, (__bridge CFStringRef)_string, NULL);
+    if (!newURL) return nil; // should not happen, the string is validated
+    if (__atomic_compare_exchange_n(&_url, &url, newURL, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+        return (__bridge NSURL *)newURL;
+    }
+    CFRelease(newURL); // another thread won, `url` is the stored one
+    return (__bridge NSURL *)url;
+}
+
+- (id)forwardingTargetForSelector:(SEL)selector {
+    return [self _yy_url];
+}
+
+- (void)forwardInvocation:(NSInvocation *)invocation {
+    [invocation invokeWithTarget:[self _yy_url]];
+}
+
+- (NSMethodSignature *)methodSignatureForSelector:(SEL)selector {
+    return [NSURL instanceMethodSignatureForSelector:selector];
+}
+
+- (BOOL)isEqual:(id)object {
+    if (object == self) return YES;
+    if (object_getClass(object) == object_getClass(self)) {
+        return [_string isEqualToString:((_YYLazyURL *)object)->_string];
+    }
+    return [[self _yy_url] isEqual:object];
+}
+
+- (NSUInteger)hash {
+    return [[self _yy_url] hash];
+}
+
+- (Class)superclass {
+    return [NSURL superclass];
+}
+
+- (Class)class {
+    return [NSURL class];
+}
+
+- (BOOL)isKindOfClass:(Class)aClass {
+    return [NSURL isSubclassOfClass:aClass];
+}
+
+- (BOOL)isMemberOfClass:(Class)aClass {
+    return [[self _yy_url] isMemberOfClass:aClass];
+}
+
+- (BOOL)respondsToSelector:(SEL)aSelector {
+    return [NSURL instancesRespondToSelector:aSelector];
+}
+
+- (BOOL)conformsToProtocol:(Protocol *)aProtocol {
+    return [NSURL conformsToProtocol:aProtocol];
+}
+
+- (BOOL)isProxy {
+    return YES;
+}
+
+- (NSString *)description {
+    return _string;
+}
+
+- (NSString *)debugDescription {
+    return [[self _yy_url] debugDescription];
+}
+
+@end
+
+/// Returns the value of a hex digit, or -1 if the character is not a hex digit.
+static force_inline int YYHexDigitValue(UniChar c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+/**
+ Create a URL from string.
+ 
+ @discussion The string is trimmed. If the result is in a conservative subset of the
+ URL syntax which NSURL always accepts (RFC 3986 characters except '[' and ']', every
+ '%' followed by two hex digits, and at most one '#'), a lazy URL proxy is returned.
+ Otherwise the NSURL is created directly, so an invalid string still results in nil.
+ @return A URL (or URL proxy), nil if the string is empty or invalid.
+ */
+static force_inline id YYLazyURLCreateFromString(__unsafe_unretained NSString *string) {
+    static BOOL table[128];
+    static NSCharacterSet *whitespace;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        const char *valid = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789"
+                            "-._~:/?#@!$&'()*+,;=%";
+        for (const char *c = valid; *c; c++) table[(int)*c] = YES;
+        whitespace = [NSCharacterSet whitespaceAndNewlineCharacterSet];
+    });
+    
+    NSString *str = string;
+    CFIndex length = CFStringGetLength((CFStringRef)str);
+    if (length == 0) return nil;
+    if ([whitespace characterIsMember:CFStringGetCharacterAtIndex((CFStringRef)str, 0)] ||
+        [whitespace characterIsMember:CFStringGetCharacterAtIndex((CFStringRef)str, length - 1)]) {
+        str = [str stringByTrimmingCharactersInSet:whitespace];
+        length = CFStringGetLength((CFStringRef)str);
+        if (length == 0) return nil;
+    }
+    
+    CFStringInlineBuffer buffer;
+    CFStringInitInlineBuffer((CFStringRef)str, &buffer, CFRangeMake(0, length));
+    BOOL hasFragment = NO;
+    for (CFIndex i = 0; i < length; i++) {
+        UniChar c = CFStringGetCharacterFromInlineBuffer(&buffer, i);
+        BOOL valid = (c < 128 && table[c]);
+        if (valid && c == '%') {
+            valid = (i + 2 < length &&
+                     YYHexDigitValue(CFStringGetCharacterFromInlineBuffer(&buffer, i + 1)) >= 0 &&
+                     YYHexDigitValue(CFStringGetCharacterFromInlineBuffer(&buffer, i + 2)) >= 0);
+            i += 2;
+        } else if (valid && c == '#') {
+            valid = !hasFragment;
+            hasFragment = YES;
+        }
+        if (!valid) return [[NSURL alloc] initWithString:str];
+    }
+    
+    _YYLazyURL *url = [_YYLazyURL alloc];
+    url->_string = str.copy;
+    return url;
+}
+
+
 /// Get the 'NSBlock' class.
 static force_inline Class YYNSBlockClass() {
     static Class cls;
@@ -280,70 +682,270 @@ static force_inline NSDateFormatter *YYISODateFormatter() {
     return formatter;
 }
 
-/// Get the value with key paths from dictionary
-/// The dic should be NSDictionary, and the keyPath should not be nil.
-static force_inline id YYValueForKeyPath(__unsafe_unretained NSDictionary *dic, __unsafe_unretained NSArray *keyPaths) {
-    id value = nil;
-    for (NSUInteger i = 0, max = keyPaths.count; i < max; i++) {
-        value = dic[keyPaths[i]];
-        if (i + 1 < max) {
-            if ([value isKindOfClass:[NSDictionary class]]) {
-                dic = value;
-            } else {
-                return nil;
+/// An entry in the enum lookup table.
+typedef struct {
+    const char *key;  ///< UTF-8 bytes of the string (not null-terminated), NULL for empty slot
+    uint32_t length;  ///< key length in bytes
+    int64_t value;    ///< enum value
+} YYEnumEntry;
+
+/// Seeded FNV-1a hash.
+static force_inline uint32_t YYEnumHash(const char *bytes, size_t length, uint32_t seed) {
+    uint32_t hash = 2166136261U ^ (seed * 0x9E3779B9U);
+    for (size_t i = 0; i < length; i++) {
+        hash ^= (uint8_t)bytes[i];
+        hash *= 16777619U;
+    }
+    return hash ^ (hash >> 16);
+}
+
+/// A string<->value lookup table, compiled from +modelEnumPropertyMapper.
+@interface _YYModelEnumMapper : NSObject {
+    @package
+    YYEnumEntry *_slots;  ///< perfect hash table of string->value, slot count is (_mask + 1)
+    CFDictionaryRef _dic; ///< string->value, used if no perfect hash table is found
+    uint32_t _mask;       ///< slot count - 1
+    uint32_t _seed;       ///< the hash seed which has no collision
+    uint32_t _maxLength;  ///< max key length in bytes
+    int64_t *_values;     ///< sorted unique values for value->string
+    CFArrayRef _names;    ///< strings of _values
+    CFIndex _count;       ///< count of _values
+    char *_storage;       ///< bytes of all keys
+}
+@end
+
+@implementation _YYModelEnumMapper
+
++ (instancetype)mapperWithDictionary:(NSDictionary *)dic {
+    #define kMaxKeyLength 255
+    #define kMaxTableGrowth 4
+    if (![dic isKindOfClass:[NSDictionary class]]) return nil;
+    
+    // sort the keys, so the string for duplicated values is stable
+    NSMutableArray *keys = [NSMutableArray new];
+    size_t storageLength = 0;
+    for (NSString *key in dic) {
+        if (![key isKindOfClass:[NSString class]]) continue;
+        if (![dic[key] isKindOfClass:[NSNumber class]]) continue;
+        // the full utf-8 length (including embedded NUL), skip the key if it can't be converted
+        CFIndex strLength = CFStringGetLength((CFStringRef)key);
+        CFIndex length = 0;
+        if (CFStringGetBytes((CFStringRef)key, CFRangeMake(0, strLength), kCFStringEncodingUTF8,
+                             0, false, NULL, 0, &length) != strLength) continue;
+        if (length > kMaxKeyLength) continue;
+        storageLength += length;
+        [keys addObject:key];
+    }
+    if (keys.count == 0) return nil;
+    [keys sortUsingSelector:@selector(compare:)];
+    
+    _YYModelEnumMapper *mapper = [self new];
+    uint32_t count = (uint32_t)keys.count;
+    YYEnumEntry *entries = calloc(count, sizeof(YYEnumEntry));
+    mapper->_storage = malloc(storageLength + 1);
+    char *cur = mapper->_storage;
+    for (uint32_t i = 0; i < count; i++) {
+        CFStringRef key = (__bridge CFStringRef)keys[i];
+        CFIndex length = 0;
+        CFStringGetBytes(key, CFRangeMake(0, CFStringGetLength(key)), kCFStringEncodingUTF8,
+                         0, false, (UInt8 *)cur, storageLength - (cur - mapper->_storage), &length);
+        entries[i].key = cur;
+        entries[i].length = (uint32_t)length;
+        entries[i].value = ((NSNumber *)dic[keys[i]]).longLongValue;
+        if (length > mapper->_maxLength) mapper->_maxLength = (uint32_t)length;
+        cur += length;
+    }
+    
+    // find a seed without collision, grow the table if it's too hard,
+    // and fall back to a dictionary if no seed is found in a reasonable size
+    uint32_t size = 4;
+    while (size < count * 2) size <<= 1;
+    uint32_t maxSize = size << kMaxTableGrowth;
+    while (!mapper->_slots && size <= maxSize) {
+        YYEnumEntry *slots = calloc(size, sizeof(YYEnumEntry));
+        for (uint32_t seed = 0; seed < 64; seed++) {
+            BOOL collision = NO;
+            for (uint32_t i = 0; i < count; i++) {
+                uint32_t index = YYEnumHash(entries[i].key, entries[i].length, seed) & (size - 1);
+                if (slots[index].key) {
+                    collision = YES;
+                    break;
+                }
+                slots[index] = entries[i];
+            }
+            if (!collision) {
+                mapper->_slots = slots;
+                mapper->_mask = size - 1;
+                mapper->_seed = seed;
+                break;
             }
+            memset(slots, 0, size * sizeof(YYEnumEntry));
+        }
+        if (!mapper->_slots) {
+            free(slots);
+            size <<= 1;
         }
     }
-    return value;
+    if (!mapper->_slots) {
+        NSMutableDictionary *lookup = [NSMutableDictionary new];
+        for (NSString *key in keys) lookup[key] = dic[key];
+        mapper->_dic = CFBridgingRetain(lookup.copy);
+    }
+    
+    // value->string, stable sorted by value
+    NSArray *sorted = [keys sortedArrayWithOptions:NSSortStable usingComparator:^NSComparisonResult(NSString *k1, NSString *k2) {
+        return [(NSNumber *)dic[k1] compare:(NSNumber *)dic[k2]];
+    }];
+    NSMutableArray *names = [NSMutableArray new];
+    mapper->_values = calloc(count, sizeof(int64_t));
+    for (NSString *key in sorted) {
+        int64_t value = ((NSNumber *)dic[key]).longLongValue;
+        if (mapper->_count > 0 && mapper->_values[mapper->_count - 1] == value) continue;
+        mapper->_values[mapper->_count++] = value;
+        [names addObject:key.copy];
+    }
+    mapper->_names = CFBridgingRetain(names.copy);
+    
+    free(entries);
+    return mapper;
+    #undef kMaxKeyLength
+    #undef kMaxTableGrowth
 }
 
-/// Get the value with multi key (or key path) from dictionary
-/// The dic should be NSDictionary
-static force_inline id YYValueForMultiKeys(__unsafe_unretained NSDictionary *dic, __unsafe_unretained NSArray *multiKeys) {
-    id value = nil;
-    for (NSString *key in multiKeys) {
-        if ([key isKindOfClass:[NSString class]]) {
-            value = dic[key];
-            if (value) break;
-        } else {
-            value = YYValueForKeyPath(dic, (NSArray *)key);
-            if (value) break;
-        }
+- (void)dealloc {
+    if (_slots) free(_slots);
+    if (_values) free(_values);
+    if (_storage) free(_storage);
+    if (_names) CFRelease(_names);
+    if (_dic) CFRelease(_dic);
+}
+
+@end
+
+/**
+ Get the value for string from enum mapper.
+ @return NO if the string is not in the mapper.
+ */
+static force_inline BOOL YYEnumMapperGetValue(__unsafe_unretained _YYModelEnumMapper *mapper,
+                                              __unsafe_unretained NSString *string,
+                                              int64_t *value) {
+    CFIndex length = CFStringGetLength((CFStringRef)string);
+    if (length > mapper->_maxLength) return NO; // utf-8 bytes is never less than utf-16 units
+    if (!mapper->_slots) {
+        NSNumber *num = (__bridge NSNumber *)CFDictionaryGetValue(mapper->_dic, (__bridge const void *)string);
+        if (!num) return NO;
+        *value = num.longLongValue;
+        return YES;
     }
-    return value;
+    
+    char buffer[256];
+    CFIndex used = 0;
+    const char *bytes = CFStringGetCStringPtr((CFStringRef)string, kCFStringEncodingUTF8);
+    if (bytes) {
+        used = length; // ascii, may contain NUL
+    } else {
+        CFIndex converted = CFStringGetBytes((CFStringRef)string, CFRangeMake(0, length), kCFStringEncodingUTF8,
+                                             0, false, (UInt8 *)buffer, sizeof(buffer), &used);
+        if (converted != length) return NO;
+        bytes = buffer;
+    }
+    if (used > mapper->_maxLength) return NO;
+    
+    YYEnumEntry *entry = mapper->_slots + (YYEnumHash(bytes, used, mapper->_seed) & mapper->_mask);
+    if (!entry->key || entry->length != used) return NO;
+    if (memcmp(entry->key, bytes, used) != 0) return NO;
+    *value = entry->value;
+    return YES;
+}
+
+/**
+ Get the string for value from enum mapper.
+ @return The string, or nil if the value is not in the mapper.
+ */
+static force_inline NSString *YYEnumMapperGetName(__unsafe_unretained _YYModelEnumMapper *mapper, int64_t value) {
+    CFIndex low = 0, high = mapper->_count - 1;
+    while (low <= high) {
+        CFIndex mid = (low + high) / 2;
+        int64_t cur = mapper->_values[mid];
+        if (cur == value) return (__bridge NSString *)CFArrayGetValueAtIndex(mapper->_names, mid);
+        if (cur < value) low = mid + 1;
+        else high = mid - 1;
+    }
+    return nil;
 }
 
 
 
+@interface YYModelTransformer ()
++ (YYModelTransformer *)_yy_transformerForClass:(Class)cls;
+@end
 
-/// A property info in object model.
-@interface _YYModelPropertyMeta : NSObject {
-    @package
-    NSString *_name;             ///< property's name
-    YYEncodingType _type;        ///< property's type
-    YYEncodingNSType _nsType;    ///< property's Foundation type
-    BOOL _isCNumber;             ///< is c number type
-    Class _cls;                  ///< property's class, or nil
-    Class _genericCls;           ///< container's generic class, or nil if threr's no generic class
-    SEL _getter;                 ///< getter, or nil if the instances cannot respond
-    SEL _setter;                 ///< setter, or nil if the instances cannot respond
-    BOOL _isKVCCompatible;       ///< YES if it can access with key-value coding
-    BOOL _isStructAvailableForKeyedArchiver; ///< YES if the struct can encoded with keyed archiver/unarchiver
-    BOOL _hasCustomClassFromDictionary; ///< class/generic class implements +modelCustomClassForDictionary:
-    
-    /*
-     property->key:       _mappedToKey:key     _mappedToKeyPath:nil            _mappedToKeyArray:nil
-     property->keyPath:   _mappedToKey:keyPath _mappedToKeyPath:keyPath(array) _mappedToKeyArray:nil
-     property->keys:      _mappedToKey:keys[0] _mappedToKeyPath:nil/keyPath    _mappedToKeyArray:keys(array)
-     */
-    NSString *_mappedToKey;      ///< the key mapped to
-    NSArray *_mappedToKeyPath;   ///< the key path mapped to (nil if the name is not key path)
-    NSArray *_mappedToKeyArray;  ///< the key(NSString) or keyPath(NSArray) array (nil if not mapped to multiple keys)
-    YYClassPropertyInfo *_info;  ///< property's info
-    _YYModelPropertyMeta *_next; ///< next meta if there are multiple properties mapped to the same key.
+@implementation YYModelTransformer
+
++ (instancetype)transformerWithDecoder:(id (^)(id))decoder encoder:(id (^)(id))encoder {
+    YYModelTransformer *transformer = [self new];
+    transformer->_decoder = [decoder copy];
+    transformer->_encoder = [encoder copy];
+    return transformer;
+}
+
+/// The registered transformers, key:Class, value:YYModelTransformer.
++ (CFMutableDictionaryRef)_yy_registry:(dispatch_semaphore_t *)lock {
+    static CFMutableDictionaryRef registry;
+    static dispatch_semaphore_t registryLock;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        registry = CFDictionaryCreateMutable(CFAllocatorGetDefault(), 0, &kCFTypeDictionaryKeyCallBacks, &kCFTypeDictionaryValueCallBacks);
+        registryLock = dispatch_semaphore_create(1);
+    });
+    *lock = registryLock;
+    return registry;
+}
+
++ (void)registerTransformer:(YYModelTransformer *)transformer forClass:(Class)cls {
+    if (!cls) return;
+    dispatch_semaphore_t lock;
+    CFMutableDictionaryRef registry = [self _yy_registry:&lock];
+    dispatch_semaphore_wait(lock, DISPATCH_TIME_FOREVER);
+    if (transformer) {
+        CFDictionarySetValue(registry, (__bridge const void *)(cls), (__bridge const void *)(transformer));
+    } else {
+        CFDictionaryRemoveValue(registry, (__bridge const void *)(cls));
+    }
+    dispatch_semaphore_signal(lock);
+}
+
+/// Returns the transformer registered for the class or its nearest super class.
++ (YYModelTransformer *)_yy_transformerForClass:(Class)cls {
+    if (!cls) return nil;
+    dispatch_semaphore_t lock;
+    CFMutableDictionaryRef registry = [self _yy_registry:&lock];
+    YYModelTransformer *transformer = nil;
+    dispatch_semaphore_wait(lock, DISPATCH_TIME_FOREVER);
+    if (CFDictionaryGetCount(registry) > 0) {
+        for (; cls && !transformer; cls = class_getSuperclass(cls)) {
+            transformer = CFDictionaryGetValue(registry, (__bridge const void *)(cls));
+        }
+    }
+    dispatch_semaphore_signal(lock);
+    return transformer;
 }
+
 @end
 
+
+
+/// Default of `+modelAutoreleaseBatchSize`.
+#define kYYModelAutoreleaseBatchSize 64
+
+/// Get the autorelease batch size of a model class.
+static NSUInteger YYClassGetAutoreleaseBatchSize(Class cls) {
+    if ([cls respondsToSelector:@selector(modelAutoreleaseBatchSize)]) {
+        return [(id<YYModel>)cls modelAutoreleaseBatchSize];
+    }
+    return kYYModelAutoreleaseBatchSize;
+}
+
 @implementation _YYModelPropertyMeta
 + (instancetype)metaWithClassInfo:(YYClassInfo *)classInfo propertyInfo:(YYClassPropertyInfo *)propertyInfo generic:(Class)generic {
     
@@ -401,6 +1003,7 @@ static force_inline id YYValueForMultiKeys(__unsafe_unretained NSDictionary *dic
     
     if (generic) {
         meta->_hasCustomClassFromDictionary = [generic respondsToSelector:@selector(modelCustomClassForDictionary:)];
+        meta->_autoreleaseBatchSize = YYClassGetAutoreleaseBatchSize(generic);
     } else if (meta->_cls && meta->_nsType == YYEncodingTypeNSUnknown) {
         meta->_hasCustomClassFromDictionary = [meta->_cls respondsToSelector:@selector(modelCustomClassForDictionary:)];
     }
@@ -450,47 +1053,155 @@ static force_inline id YYValueForMultiKeys(__unsafe_unretained NSDictionary *dic
 @end
 
 
-/// A class info in object model.
-@interface _YYModelMeta : NSObject {
+/// A property which takes the value of a key plan node.
+@interface _YYModelKeyPlanTarget : NSObject {
     @package
-    YYClassInfo *_classInfo;
-    /// Key:mapped key and key path, Value:_YYModelPropertyMeta.
-    NSDictionary *_mapper;
-    /// Array<_YYModelPropertyMeta>, all property meta of this model.
-    NSArray *_allPropertyMetas;
-    /// Array<_YYModelPropertyMeta>, property meta which is mapped to a key path.
-    NSArray *_keyPathPropertyMetas;
-    /// Array<_YYModelPropertyMeta>, property meta which is mapped to multi keys.
-    NSArray *_multiKeysPropertyMetas;
-    /// The number of mapped key (and key path), same to _mapper.count.
-    NSUInteger _keyMappedCount;
-    /// Model class type.
-    YYEncodingNSType _nsType;
-    
-    BOOL _hasCustomWillTransformFromDictionary;
-    BOOL _hasCustomTransformFromDictionary;
-    BOOL _hasCustomTransformToDictionary;
-    BOOL _hasCustomClassFromDictionary;
+    _YYModelPropertyMeta *_meta; ///< property meta
+    NSInteger _slot;             ///< index in the model's multi-key property metas, -1 if mapped to one key
+    NSUInteger _priority;        ///< index of the key in the property's keys, lower is preferred
 }
 @end
 
-@implementation _YYModelMeta
-- (instancetype)initWithClass:(Class)cls {
-    YYClassInfo *classInfo = [YYClassInfo classInfoWithClass:cls];
-    if (!classInfo) return nil;
-    self = [super init];
+@implementation _YYModelKeyPlanTarget
+@end
+
+
+/**
+ A node of the key plan, which is a key (or a key path component) of the json dictionary.
+ All the mapped keys, key paths and multi keys of a model are merged into one tree, so
+ the json dictionary (and the nested dictionary of a key path) is looked up once for each key.
+ */
+@interface _YYModelKeyPlanNode : NSObject {
+    @package
+    NSString *_key;     ///< the key in the json dictionary
+    NSArray *_targets;  ///< Array<_YYModelKeyPlanTarget>, properties which take the value, or nil
+    NSArray *_children; ///< Array<_YYModelKeyPlanNode>, keys in the value (key path), or nil
+}
+@end
+
+@implementation _YYModelKeyPlanNode
+
+/// Build the key plan, returns a key->root node mapper.
++ (NSDictionary *)planWithPropertyMetas:(NSArray *)allPropertyMetas multiKeysPropertyMetas:(NSArray *)multiKeysPropertyMetas {
+    NSMutableDictionary *roots = [NSMutableDictionary new];
+    NSMutableDictionary *childrenByNode = [NSMutableDictionary new]; // node pointer -> (key -> child)
+    NSMutableDictionary *targetsByNode = [NSMutableDictionary new];  // node pointer -> targets
     
-    // Get black list
-    NSSet *blacklist = nil;
-    if ([cls respondsToSelector:@selector(modelPropertyBlacklist)]) {
-        NSArray *properties = [(id<YYModel>)cls modelPropertyBlacklist];
-        if (properties) {
-            blacklist = [NSSet setWithArray:properties];
+    _YYModelKeyPlanNode *(^nodeForPath)(NSArray *) = ^(NSArray *path) {
+        NSMutableDictionary *siblings = roots;
+        _YYModelKeyPlanNode *node = nil;
+        for (NSString *key in path) {
+            node = siblings[key];
+            if (!node) {
+                node = [_YYModelKeyPlanNode new];
+                node->_key = key;
+                siblings[key] = node;
+            }
+            NSValue *nodeKey = [NSValue valueWithNonretainedObject:node];
+            siblings = childrenByNode[nodeKey];
+            if (!siblings) {
+                siblings = [NSMutableDictionary new];
+                childrenByNode[nodeKey] = siblings;
+            }
+        }
+        return node;
+    };
+    void (^addTarget)(NSArray *, _YYModelPropertyMeta *, NSInteger, NSUInteger) = ^(NSArray *path, _YYModelPropertyMeta *meta, NSInteger slot, NSUInteger priority) {
+        _YYModelKeyPlanNode *node = nodeForPath(path);
+        if (!node) return;
+        _YYModelKeyPlanTarget *target = [_YYModelKeyPlanTarget new];
+        target->_meta = meta;
+        target->_slot = slot;
+        target->_priority = priority;
+        NSValue *nodeKey = [NSValue valueWithNonretainedObject:node];
+        NSMutableArray *targets = targetsByNode[nodeKey];
+        if (!targets) {
+            targets = [NSMutableArray new];
+            targetsByNode[nodeKey] = targets;
+        }
+        [targets addObject:target];
+    };
+    
+    for (_YYModelPropertyMeta *meta in allPropertyMetas) {
+        if (meta->_mappedToKeyArray) {
+            NSInteger slot = [multiKeysPropertyMetas indexOfObjectIdenticalTo:meta];
+            if (slot == NSNotFound) continue;
+            [meta->_mappedToKeyArray enumerateObjectsUsingBlock:^(id key, NSUInteger idx, BOOL *stop) {
+                addTarget([key isKindOfClass:[NSString class]] ? @[key] : key, meta, slot, idx);
+            }];
+        } else if (meta->_mappedToKeyPath) {
+            addTarget(meta->_mappedToKeyPath, meta, -1, 0);
+        } else if (meta->_mappedToKey) {
+            addTarget(@[meta->_mappedToKey], meta, -1, 0);
         }
     }
     
-    // Get white list
-    NSSet *whitelist = nil;
+    // freeze the tree
+    NSMutableArray *pending = roots.allValues.mutableCopy;
+    while (pending.count) {
+        _YYModelKeyPlanNode *node = pending.lastObject;
+        [pending removeLastObject];
+        NSValue *nodeKey = [NSValue valueWithNonretainedObject:node];
+        NSArray *targets = targetsByNode[nodeKey];
+        NSDictionary *children = childrenByNode[nodeKey];
+        if (targets.count) node->_targets = targets.copy;
+        if (children.count) {
+            node->_children = children.allValues;
+            [pending addObjectsFromArray:node->_children];
+        }
+    }
+    return roots.count ? roots.copy : nil;
+}
+
+@end
+
+id YYModelGetValueFromDictionary(NSDictionary *dic, _YYModelPropertyMeta *meta) {
+    NSArray *multiKeys = meta->_mappedToKeyArray;
+    if (!multiKeys && !meta->_mappedToKeyPath) return meta->_mappedToKey ? dic[meta->_mappedToKey] : nil;
+    
+    // multi keys (or a single key path): the first key (or key path) with a value wins
+    NSUInteger count = multiKeys ? multiKeys.count : 1;
+    for (NSUInteger i = 0; i < count; i++) {
+        id key = multiKeys ? multiKeys[i] : meta->_mappedToKeyPath;
+        if ([key isKindOfClass:[NSString class]]) {
+            id value = dic[key];
+            if (value) return value;
+            continue;
+        }
+        id value = dic;
+        for (NSString *oneKey in (NSArray *)key) {
+            if (![value isKindOfClass:[NSDictionary class]]) {
+                value = nil;
+                break;
+            }
+            value = ((NSDictionary *)value)[oneKey];
+        }
+        if (value) return value;
+    }
+    return nil;
+}
+
+
+static void ModelCreateEncodePlan(_YYModelMeta *meta, NSArray *propertyMetas);
+static void ModelCreateCoderPlan(_YYModelMeta *meta);
+
+@implementation _YYModelMeta
+- (instancetype)initWithClass:(Class)cls {
+    YYClassInfo *classInfo = [YYClassInfo classInfoWithClass:cls];
+    if (!classInfo) return nil;
+    self = [super init];
+    
+    // Get black list
+    NSSet *blacklist = nil;
+    if ([cls respondsToSelector:@selector(modelPropertyBlacklist)]) {
+        NSArray *properties = [(id<YYModel>)cls modelPropertyBlacklist];
+        if (properties) {
+            blacklist = [NSSet setWithArray:properties];
+        }
+    }
+    
+    // Get white list
+    NSSet *whitelist = nil;
     if ([cls respondsToSelector:@selector(modelPropertyWhitelist)]) {
         NSArray *properties = [(id<YYModel>)cls modelPropertyWhitelist];
         if (properties) {
@@ -521,6 +1232,32 @@ static force_inline id YYValueForMultiKeys(__unsafe_unretained NSDictionary *dic
         }
     }
     
+    // Get string storage policy
+    YYModelStringStorage stringStorage = YYModelStringStorageCopy;
+    if ([cls respondsToSelector:@selector(modelStringStorage)]) {
+        stringStorage = [(id<YYModel>)cls modelStringStorage];
+    }
+    
+    // Get enum mapper
+    NSDictionary *enumMapper = nil;
+    if ([cls respondsToSelector:@selector(modelEnumPropertyMapper)]) {
+        enumMapper = [(id<YYModel>)cls modelEnumPropertyMapper];
+        if (![enumMapper isKindOfClass:[NSDictionary class]]) enumMapper = nil;
+    }
+    
+    // Get property transformers
+    NSDictionary *transformers = nil;
+    if ([cls respondsToSelector:@selector(modelPropertyTransformers)]) {
+        transformers = [(id<YYModel>)cls modelPropertyTransformers];
+        if (![transformers isKindOfClass:[NSDictionary class]]) transformers = nil;
+    }
+    
+    // Get lazy url option
+    BOOL lazyURL = NO;
+    if ([cls respondsToSelector:@selector(modelLazyURL)]) {
+        lazyURL = [(id<YYModel>)cls modelLazyURL];
+    }
+    
     // Create all property metas.
     NSMutableDictionary *allPropertyMetas = [NSMutableDictionary new];
     YYClassInfo *curClassInfo = classInfo;
@@ -535,6 +1272,17 @@ static force_inline id YYValueForMultiKeys(__unsafe_unretained NSDictionary *dic
             if (!meta || !meta->_name) continue;
             if (!meta->_getter || !meta->_setter) continue;
             if (allPropertyMetas[meta->_name]) continue;
+            meta->_isStringNoCopy = (stringStorage == YYModelStringStorageNoCopy);
+            meta->_isLazyURL = (lazyURL && meta->_nsType == YYEncodingTypeNSURL);
+            if (meta->_isCNumber && enumMapper[meta->_name]) {
+                meta->_enumMapper = [_YYModelEnumMapper mapperWithDictionary:enumMapper[meta->_name]];
+            }
+            YYModelTransformer *transformer = transformers[meta->_name];
+            if (![transformer isKindOfClass:[YYModelTransformer class]]) {
+                transformer = [YYModelTransformer _yy_transformerForClass:meta->_cls];
+            }
+            meta->_decoder = transformer.decoder;
+            meta->_encoder = transformer.encoder;
             allPropertyMetas[meta->_name] = meta;
         }
         curClassInfo = curClassInfo.superClassInfo;
@@ -610,9 +1358,28 @@ static force_inline id YYValueForMultiKeys(__unsafe_unretained NSDictionary *dic
     }];
     
     if (mapper.count) _mapper = mapper;
+    
+    // sort mapped property metas by key for canonical output
+    BOOL hasKeyPath = NO;
+    for (_YYModelPropertyMeta *propertyMeta in mapper.allValues) {
+        if (propertyMeta->_mappedToKeyPath) {
+            hasKeyPath = YES;
+            break;
+        }
+    }
+    NSArray *sortedPropertyMetas = [mapper.allValues sortedArrayUsingComparator:^NSComparisonResult(_YYModelPropertyMeta *meta1, _YYModelPropertyMeta *meta2) {
+        NSComparisonResult result = [meta1->_mappedToKey compare:meta2->_mappedToKey options:NSLiteralSearch];
+        if (result == NSOrderedSame) result = [meta1->_name compare:meta2->_name options:NSLiteralSearch];
+        return result;
+    }];
+    if (!hasKeyPath) _canonicalPropertyMetas = sortedPropertyMetas;
     if (keyPathPropertyMetas) _keyPathPropertyMetas = keyPathPropertyMetas;
     if (multiKeysPropertyMetas) _multiKeysPropertyMetas = multiKeysPropertyMetas;
     
+    _keyPlan = [_YYModelKeyPlanNode planWithPropertyMetas:_allPropertyMetas multiKeysPropertyMetas:_multiKeysPropertyMetas];
+    _keyPlanRoots = _keyPlan.allValues;
+    _keyPlanRootCount = _keyPlanRoots.count;
+    
     _classInfo = classInfo;
     _keyMappedCount = _allPropertyMetas.count;
     _nsType = YYClassGetNSType(cls);
@@ -620,10 +1387,24 @@ static force_inline id YYValueForMultiKeys(__unsafe_unretained NSDictionary *dic
     _hasCustomTransformFromDictionary = ([cls instancesRespondToSelector:@selector(modelCustomTransformFromDictionary:)]);
     _hasCustomTransformToDictionary = ([cls instancesRespondToSelector:@selector(modelCustomTransformToDictionary:)]);
     _hasCustomClassFromDictionary = ([cls respondsToSelector:@selector(modelCustomClassForDictionary:)]);
+    if ([cls respondsToSelector:@selector(modelDecodeCachePolicy)]) {
+        _decodeCachePolicy = [(id<YYModel>)cls modelDecodeCachePolicy];
+    }
+    if ([cls respondsToSelector:@selector(modelDecodeStrategy)]) {
+        _decodeStrategy = [(id<YYModel>)cls modelDecodeStrategy];
+    }
+    _autoreleaseBatchSize = YYClassGetAutoreleaseBatchSize(cls);
+    ModelCreateEncodePlan(self, sortedPropertyMetas);
+    ModelCreateCoderPlan(self);
     
     return self;
 }
 
+- (void)dealloc {
+    if (_encodePlan) free(_encodePlan);
+    if (_coderPlan) free(_coderPlan);
+}
+
 /// Returns the cached model class meta
 + (instancetype)metaWithClass:(Class)cls {
     if (!cls) return nil;
@@ -707,6 +1488,99 @@ static force_inline NSNumber *ModelCreateNumberFromProperty(__unsafe_unretained
     }
 }
 
+/**
+ Get integer from property without boxing.
+ @discussion Caller should hold strong reference to the parameters before this function returns.
+ @param model Should not be nil.
+ @param meta  Should not be nil, meta.isCNumber should be YES, meta.getter should not be nil.
+ @return An integer (the bits of uint64 for YYEncodingTypeUInt64).
+ */
+static force_inline int64_t ModelGetInt64FromProperty(__unsafe_unretained id model,
+                                                      __unsafe_unretained _YYModelPropertyMeta *meta) {
+    switch (meta->_type & YYEncodingTypeMask) {
+        case YYEncodingTypeBool: {
+            return ((bool (*)(id, SEL))(void *) objc_msgSend)((id)model, meta->_getter);
+        }
+        case YYEncodingTypeInt8: {
+            return ((int8_t (*)(id, SEL))(void *) objc_msgSend)((id)model, meta->_getter);
+        }
+        case YYEncodingTypeUInt8: {
+            return ((uint8_t (*)(id, SEL))(void *) objc_msgSend)((id)model, meta->_getter);
+        }
+        case YYEncodingTypeInt16: {
+            return ((int16_t (*)(id, SEL))(void *) objc_msgSend)((id)model, meta->_getter);
+        }
+        case YYEncodingTypeUInt16: {
+            return ((uint16_t (*)(id, SEL))(void *) objc_msgSend)((id)model, meta->_getter);
+        }
+        case YYEncodingTypeInt32: {
+            return ((int32_t (*)(id, SEL))(void *) objc_msgSend)((id)model, meta->_getter);
+        }
+        case YYEncodingTypeUInt32: {
+            return ((uint32_t (*)(id, SEL))(void *) objc_msgSend)((id)model, meta->_getter);
+        }
+        case YYEncodingTypeInt64: {
+            return ((int64_t (*)(id, SEL))(void *) objc_msgSend)((id)model, meta->_getter);
+        }
+        case YYEncodingTypeUInt64: {
+            return (int64_t)((uint64_t (*)(id, SEL))(void *) objc_msgSend)((id)model, meta->_getter);
+        }
+        case YYEncodingTypeFloat: {
+            return (int64_t)((float (*)(id, SEL))(void *) objc_msgSend)((id)model, meta->_getter);
+        }
+        case YYEncodingTypeDouble: {
+            return (int64_t)((double (*)(id, SEL))(void *) objc_msgSend)((id)model, meta->_getter);
+        }
+        case YYEncodingTypeLongDouble: {
+            return (int64_t)((long double (*)(id, SEL))(void *) objc_msgSend)((id)model, meta->_getter);
+        }
+        default: return 0;
+    }
+}
+
+/**
+ Set integer to property without boxing.
+ @discussion Caller should hold strong reference to the parameters before this function returns.
+ @param model Should not be nil.
+ @param num   The integer (the bits of uint64 for YYEncodingTypeUInt64).
+ @param meta  Should not be nil, meta.isCNumber should be YES, meta.setter should not be nil.
+ */
+static force_inline void ModelSetInt64ToProperty(__unsafe_unretained id model,
+                                                 int64_t num,
+                                                 __unsafe_unretained _YYModelPropertyMeta *meta) {
+    switch (meta->_type & YYEncodingTypeMask) {
+        case YYEncodingTypeBool: {
+            ((void (*)(id, SEL, bool))(void *) objc_msgSend)((id)model, meta->_setter, num != 0);
+        } break;
+        case YYEncodingTypeInt8:
+        case YYEncodingTypeUInt8: {
+            ((void (*)(id, SEL, uint8_t))(void *) objc_msgSend)((id)model, meta->_setter, (uint8_t)num);
+        } break;
+        case YYEncodingTypeInt16:
+        case YYEncodingTypeUInt16: {
+            ((void (*)(id, SEL, uint16_t))(void *) objc_msgSend)((id)model, meta->_setter, (uint16_t)num);
+        } break;
+        case YYEncodingTypeInt32:
+        case YYEncodingTypeUInt32: {
+            ((void (*)(id, SEL, uint32_t))(void *) objc_msgSend)((id)model, meta->_setter, (uint32_t)num);
+        } break;
+        case YYEncodingTypeInt64:
+        case YYEncodingTypeUInt64: {
+            ((void (*)(id, SEL, uint64_t))(void *) objc_msgSend)((id)model, meta->_setter, (uint64_t)num);
+        } break;
+        case YYEncodingTypeFloat: {
+            ((void (*)(id, SEL, float))(void *) objc_msgSend)((id)model, meta->_setter, (float)num);
+        } break;
+        case YYEncodingTypeDouble: {
+            ((void (*)(id, SEL, double))(void *) objc_msgSend)((id)model, meta->_setter, (double)num);
+        } break;
+        case YYEncodingTypeLongDouble: {
+            ((void (*)(id, SEL, long double))(void *) objc_msgSend)((id)model, meta->_setter, (long double)num);
+        } // break; commented for code coverage in next line
+        default: break;
+    }
+}
+
 /**
  Set number to property.
  @discussion Caller should hold strong reference to the parameters before this function returns.
@@ -741,14 +1615,14 @@ static force_inline void ModelSetNumberToProperty(__unsafe_unretained id model,
         } break;
         case YYEncodingTypeInt64: {
             if ([num isKindOfClass:[NSDecimalNumber class]]) {
-                ((void (*)(id, SEL, int64_t))(void *) objc_msgSend)((id)model, meta->_setter, (int64_t)num.stringValue.longLongValue);
+                ((void (*)(id, SEL, int64_t))(void *) objc_msgSend)((id)model, meta->_setter, (int64_t)YYNSDecimalNumberGetInt64Bits((id)num));
             } else {
                 ((void (*)(id, SEL, uint64_t))(void *) objc_msgSend)((id)model, meta->_setter, (uint64_t)num.longLongValue);
             }
         } break;
         case YYEncodingTypeUInt64: {
             if ([num isKindOfClass:[NSDecimalNumber class]]) {
-                ((void (*)(id, SEL, int64_t))(void *) objc_msgSend)((id)model, meta->_setter, (int64_t)num.stringValue.longLongValue);
+                ((void (*)(id, SEL, uint64_t))(void *) objc_msgSend)((id)model, meta->_setter, YYNSDecimalNumberGetInt64Bits((id)num));
             } else {
                 ((void (*)(id, SEL, uint64_t))(void *) objc_msgSend)((id)model, meta->_setter, (uint64_t)num.unsignedLongLongValue);
             }
@@ -772,6 +1646,68 @@ static force_inline void ModelSetNumberToProperty(__unsafe_unretained id model,
     }
 }
 
+/**
+ Convert a number to the int64 value of a c number integer property, with the same
+ conversion (and the same truncation to the property's width) as ModelSetNumberToProperty().
+ The bits of uint64 are returned for YYEncodingTypeUInt32 and YYEncodingTypeUInt64.
+ 
+ @param num  Should not be nil.
+ @param meta Should not be nil, meta.isCNumber should be YES.
+ */
+static force_inline int64_t ModelGetInt64FromNumber(__unsafe_unretained NSNumber *num,
+                                                   __unsafe_unretained _YYModelPropertyMeta *meta) {
+    switch (meta->_type & YYEncodingTypeMask) {
+        case YYEncodingTypeBool: return num.boolValue ? 1 : 0;
+        case YYEncodingTypeInt8: return (int8_t)num.charValue;
+        case YYEncodingTypeUInt8: return (uint8_t)num.unsignedCharValue;
+        case YYEncodingTypeInt16: return (int16_t)num.shortValue;
+        case YYEncodingTypeUInt16: return (uint16_t)num.unsignedShortValue;
+        case YYEncodingTypeInt32: return (int32_t)num.intValue;
+        case YYEncodingTypeUInt32: return (uint32_t)num.unsignedIntValue;
+        case YYEncodingTypeInt64:
+        case YYEncodingTypeUInt64: {
+            if ([num isKindOfClass:[NSDecimalNumber class]]) {
+                return (int64_t)YYNSDecimalNumberGetInt64Bits((id)num);
+            }
+            if ((meta->_type & YYEncodingTypeMask) == YYEncodingTypeUInt64) {
+                return (int64_t)num.unsignedLongLongValue;
+            }
+            return num.longLongValue;
+        }
+        default: return num.longLongValue;
+    }
+}
+
+/**
+ Call the block with the indexes from 0 to count-1. If there are more elements than
+ the batch size, the autoreleased objects are drained after each batch.
+ */
+static force_inline void YYModelForEachInBatches(NSUInteger count, NSUInteger batchSize,
+                                                 void (^block)(NSUInteger idx)) {
+    if (batchSize == 0 || count <= batchSize) {
+        for (NSUInteger i = 0; i < count; i++) block(i);
+        return;
+    }
+    for (NSUInteger i = 0; i < count;) {
+        @autoreleasepool {
+            for (NSUInteger end = MIN(i + batchSize, count); i < end; i++) block(i);
+        }
+    }
+}
+
+/// Create a model of the generic class of the container property from a json dictionary.
+static force_inline id ModelCreateGenericModel(__unsafe_unretained NSDictionary *dic,
+                                               __unsafe_unretained _YYModelPropertyMeta *meta) {
+    Class cls = meta->_genericCls;
+    if (meta->_hasCustomClassFromDictionary) {
+        cls = [cls modelCustomClassForDictionary:dic];
+        if (!cls) cls = meta->_genericCls; // for xcode code coverage
+    }
+    NSObject *one = [cls new];
+    [one yy_modelSetWithDictionary:dic];
+    return one;
+}
+
 /**
  Set value to model with a property meta.
  
@@ -785,9 +1721,15 @@ static void ModelSetValueForProperty(__unsafe_unretained id model,
                                      __unsafe_unretained id value,
                                      __unsafe_unretained _YYModelPropertyMeta *meta) {
     if (meta->_isCNumber) {
-        NSNumber *num = YYNSNumberCreateFromID(value);
-        ModelSetNumberToProperty(model, num, meta);
-        if (num) [num class]; // hold the number
+        int64_t enumValue = 0;
+        if (meta->_enumMapper && [value isKindOfClass:[NSString class]] &&
+            YYEnumMapperGetValue(meta->_enumMapper, value, &enumValue)) {
+            ModelSetInt64ToProperty(model, enumValue, meta);
+        } else {
+            NSNumber *num = YYNSNumberCreateFromID(value);
+            ModelSetNumberToProperty(model, num, meta);
+            if (num) [num class]; // hold the number
+        }
     } else if (meta->_nsType) {
         if (value == (id)kCFNull) {
             ((void (*)(id, SEL, id))(void *) objc_msgSend)((id)model, meta->_setter, (id)nil);
@@ -808,8 +1750,12 @@ static void ModelSetValueForProperty(__unsafe_unretained id model,
                                                                        ((NSNumber *)value).stringValue :
                                                                        ((NSNumber *)value).stringValue.mutableCopy);
                     } else if ([value isKindOfClass:[NSData class]]) {
-                        NSMutableString *string = [[NSMutableString alloc] initWithData:value encoding:NSUTF8StringEncoding];
-                        ((void (*)(id, SEL, id))(void *) objc_msgSend)((id)model, meta->_setter, string);
+                        NSString *string = YYNSStringCreateFromData(value, meta->_isStringNoCopy);
+                        ((void (*)(id, SEL, id))(void *) objc_msgSend)((id)model,
+                                                                       meta->_setter,
+                                                                       (meta->_nsType == YYEncodingTypeNSString) ?
+                                                                       string :
+                                                                       string.mutableCopy);
                     } else if ([value isKindOfClass:[NSURL class]]) {
                         ((void (*)(id, SEL, id))(void *) objc_msgSend)((id)model,
                                                                        meta->_setter,
@@ -837,11 +1783,7 @@ static void ModelSetValueForProperty(__unsafe_unretained id model,
                             NSDecimalNumber *decNum = [NSDecimalNumber decimalNumberWithDecimal:[((NSNumber *)value) decimalValue]];
                             ((void (*)(id, SEL, id))(void *) objc_msgSend)((id)model, meta->_setter, decNum);
                         } else if ([value isKindOfClass:[NSString class]]) {
-                            NSDecimalNumber *decNum = [NSDecimalNumber decimalNumberWithString:value];
-                            NSDecimal dec = decNum.decimalValue;
-                            if (dec._length == 0 && dec._isNegative) {
-                                decNum = nil; // NaN
-                            }
+                            NSDecimalNumber *decNum = YYNSDecimalNumberCreateFromString(value);
                             ((void (*)(id, SEL, id))(void *) objc_msgSend)((id)model, meta->_setter, decNum);
                         }
                     } else { // YYEncodingTypeNSValue
@@ -880,6 +1822,8 @@ static void ModelSetValueForProperty(__unsafe_unretained id model,
                 case YYEncodingTypeNSURL: {
                     if ([value isKindOfClass:[NSURL class]]) {
                         ((void (*)(id, SEL, id))(void *) objc_msgSend)((id)model, meta->_setter, value);
+                    } else if ([value isKindOfClass:[NSString class]] && meta->_isLazyURL) {
+                        ((void (*)(id, SEL, id))(void *) objc_msgSend)((id)model, meta->_setter, YYLazyURLCreateFromString(value));
                     } else if ([value isKindOfClass:[NSString class]]) {
                         NSCharacterSet *set = [NSCharacterSet whitespaceAndNewlineCharacterSet];
                         NSString *str = [value stringByTrimmingCharactersInSet:set];
@@ -899,20 +1843,15 @@ static void ModelSetValueForProperty(__unsafe_unretained id model,
                         else if ([value isKindOfClass:[NSSet class]]) valueArr = ((NSSet *)value).allObjects;
                         if (valueArr) {
                             NSMutableArray *objectArr = [NSMutableArray new];
-                            for (id one in valueArr) {
+                            YYModelForEachInBatches(valueArr.count, meta->_autoreleaseBatchSize, ^(NSUInteger idx) {
+                                id one = valueArr[idx];
                                 if ([one isKindOfClass:meta->_genericCls]) {
                                     [objectArr addObject:one];
                                 } else if ([one isKindOfClass:[NSDictionary class]]) {
-                                    Class cls = meta->_genericCls;
-                                    if (meta->_hasCustomClassFromDictionary) {
-                                        cls = [cls modelCustomClassForDictionary:one];
-                                        if (!cls) cls = meta->_genericCls; // for xcode code coverage
-                                    }
-                                    NSObject *newOne = [cls new];
-                                    [newOne yy_modelSetWithDictionary:one];
+                                    id newOne = ModelCreateGenericModel(one, meta);
                                     if (newOne) [objectArr addObject:newOne];
                                 }
-                            }
+                            });
                             ((void (*)(id, SEL, id))(void *) objc_msgSend)((id)model, meta->_setter, objectArr);
                         }
                     } else {
@@ -941,18 +1880,15 @@ static void ModelSetValueForProperty(__unsafe_unretained id model,
                     if ([value isKindOfClass:[NSDictionary class]]) {
                         if (meta->_genericCls) {
                             NSMutableDictionary *dic = [NSMutableDictionary new];
-                            [((NSDictionary *)value) enumerateKeysAndObjectsUsingBlock:^(NSString *oneKey, id oneValue, BOOL *stop) {
+                            NSArray *keys = ((NSDictionary *)value).allKeys;
+                            YYModelForEachInBatches(keys.count, meta->_autoreleaseBatchSize, ^(NSUInteger idx) {
+                                NSString *oneKey = keys[idx];
+                                id oneValue = ((NSDictionary *)value)[oneKey];
                                 if ([oneValue isKindOfClass:[NSDictionary class]]) {
-                                    Class cls = meta->_genericCls;
-                                    if (meta->_hasCustomClassFromDictionary) {
-                                        cls = [cls modelCustomClassForDictionary:oneValue];
-                                        if (!cls) cls = meta->_genericCls; // for xcode code coverage
-                                    }
-                                    NSObject *newOne = [cls new];
-                                    [newOne yy_modelSetWithDictionary:(id)oneValue];
+                                    id newOne = ModelCreateGenericModel(oneValue, meta);
                                     if (newOne) dic[oneKey] = newOne;
                                 }
-                            }];
+                            });
                             ((void (*)(id, SEL, id))(void *) objc_msgSend)((id)model, meta->_setter, dic);
                         } else {
                             if (meta->_nsType == YYEncodingTypeNSDictionary) {
@@ -974,20 +1910,16 @@ static void ModelSetValueForProperty(__unsafe_unretained id model,
                     
                     if (meta->_genericCls) {
                         NSMutableSet *set = [NSMutableSet new];
-                        for (id one in valueSet) {
+                        NSArray *valueArr = valueSet.allObjects;
+                        YYModelForEachInBatches(valueArr.count, meta->_autoreleaseBatchSize, ^(NSUInteger idx) {
+                            id one = valueArr[idx];
                             if ([one isKindOfClass:meta->_genericCls]) {
                                 [set addObject:one];
                             } else if ([one isKindOfClass:[NSDictionary class]]) {
-                                Class cls = meta->_genericCls;
-                                if (meta->_hasCustomClassFromDictionary) {
-                                    cls = [cls modelCustomClassForDictionary:one];
-                                    if (!cls) cls = meta->_genericCls; // for xcode code coverage
-                                }
-                                NSObject *newOne = [cls new];
-                                [newOne yy_modelSetWithDictionary:one];
+                                id newOne = ModelCreateGenericModel(one, meta);
                                 if (newOne) [set addObject:newOne];
                             }
-                        }
+                        });
                         ((void (*)(id, SEL, id))(void *) objc_msgSend)((id)model, meta->_setter, set);
                     } else {
                         if (meta->_nsType == YYEncodingTypeNSSet) {
@@ -1099,12 +2031,347 @@ static void ModelSetValueForProperty(__unsafe_unretained id model,
 }
 
 
+NSNumber *YYModelNumberForProperty(id value, _YYModelPropertyMeta *meta) {
+    if (!value) return nil;
+    if (meta->_decoder) {
+        value = meta->_decoder(value);
+        if (!value) return nil;
+    }
+    int64_t enumValue = 0;
+    if (meta->_enumMapper && [value isKindOfClass:[NSString class]] &&
+        YYEnumMapperGetValue(meta->_enumMapper, value, &enumValue)) {
+        return @(enumValue);
+    }
+    return YYNSNumberCreateFromID(value);
+}
+
+int64_t YYModelGetInt64FromProperty(id model, _YYModelPropertyMeta *meta) {
+    return ModelGetInt64FromProperty(model, meta);
+}
+
+void YYModelSetInt64ToProperty(id model, int64_t num, _YYModelPropertyMeta *meta) {
+    ModelSetInt64ToProperty(model, num, meta);
+}
+
+int64_t YYModelGetInt64FromNumber(NSNumber *num, _YYModelPropertyMeta *meta) {
+    return ModelGetInt64FromNumber(num, meta);
+}
+
+double YYModelGetDoubleFromProperty(id model, _YYModelPropertyMeta *meta) {
+    switch (meta->_type & YYEncodingTypeMask) {
+        case YYEncodingTypeFloat: {
+            return ((float (*)(id, SEL))(void *) objc_msgSend)((id)model, meta->_getter);
+        }
+        case YYEncodingTypeDouble: {
+            return ((double (*)(id, SEL))(void *) objc_msgSend)((id)model, meta->_getter);
+        }
+        case YYEncodingTypeLongDouble: {
+            return ((long double (*)(id, SEL))(void *) objc_msgSend)((id)model, meta->_getter);
+        }
+        case YYEncodingTypeUInt64: {
+            return (uint64_t)ModelGetInt64FromProperty(model, meta);
+        }
+        default: return ModelGetInt64FromProperty(model, meta);
+    }
+}
+
+void YYModelSetDoubleToProperty(id model, double num, _YYModelPropertyMeta *meta) {
+    switch (meta->_type & YYEncodingTypeMask) {
+        case YYEncodingTypeFloat: {
+            ((void (*)(id, SEL, float))(void *) objc_msgSend)((id)model, meta->_setter, (float)num);
+        } break;
+        case YYEncodingTypeDouble: {
+            ((void (*)(id, SEL, double))(void *) objc_msgSend)((id)model, meta->_setter, num);
+        } break;
+        case YYEncodingTypeLongDouble: {
+            ((void (*)(id, SEL, long double))(void *) objc_msgSend)((id)model, meta->_setter, (long double)num);
+        } break;
+        case YYEncodingTypeUInt64: {
+            if (isnan(num) || num < 0) num = 0;
+            ModelSetInt64ToProperty(model, num >= 18446744073709551615.0 ? (int64_t)UINT64_MAX : (int64_t)(uint64_t)num, meta);
+        } break;
+        default: {
+            if (isnan(num)) num = 0;
+            ModelSetInt64ToProperty(model, num >= 9223372036854775807.0 ? INT64_MAX : num <= -9223372036854775808.0 ? INT64_MIN : (int64_t)num, meta);
+        } break;
+    }
+}
+
+/// Key of the archive format of c number properties in `-yy_modelEncodeWithCoder:`,
+/// it's not a valid property name. Archives without this key store NSNumber objects.
+static NSString *const kYYModelCoderFormatKey = @"YYModel.format";
+/// C number properties are stored with the coder's primitives (see the coder plan's functions).
+#define kYYModelCoderFormatTyped 1
+
+/*
+ The encode and decode functions of the steps in model meta's _coderPlan, the archive is
+ the same as the one of the property meta loop before. The key is the property's name.
+ C number properties are stored with the coder's primitives without boxing: bool with
+ encodeBool:, integer with encodeInt64: (uint64 with the same bits), float, double and
+ long double with encodeDouble:. The NaN and Inf values are not encoded, same as the
+ NSNumber archive. The primitives return 0 for missing key, the decode functions check
+ the key only for 0, and the property is not changed if the key is not in the archive.
+ */
+
+#define YY_MODEL_CODER_INTEGER(_encode_, _decode_, _type_) \
+static void _encode_(__unsafe_unretained NSCoder *coder, __unsafe_unretained id model, const _YYModelCoderStep *step) { \
+    _type_ value = ((_type_ (*)(id, SEL))(void *) step->getter)((id)model, step->meta->_getter); \
+    [coder encodeInt64:(int64_t)value forKey:step->key]; \
+} \
+static void _decode_(__unsafe_unretained NSCoder *coder, __unsafe_unretained id model, const _YYModelCoderStep *step) { \
+    int64_t value = [coder decodeInt64ForKey:step->key]; \
+    if (value == 0 && ![coder containsValueForKey:step->key]) return; \
+    ((void (*)(id, SEL, _type_))(void *) step->setter)((id)model, step->meta->_setter, (_type_)value); \
+}
+YY_MODEL_CODER_INTEGER(ModelCoderEncodeInt8, ModelCoderDecodeInt8, int8_t)
+YY_MODEL_CODER_INTEGER(ModelCoderEncodeUInt8, ModelCoderDecodeUInt8, uint8_t)
+YY_MODEL_CODER_INTEGER(ModelCoderEncodeInt16, ModelCoderDecodeInt16, int16_t)
+YY_MODEL_CODER_INTEGER(ModelCoderEncodeUInt16, ModelCoderDecodeUInt16, uint16_t)
+YY_MODEL_CODER_INTEGER(ModelCoderEncodeInt32, ModelCoderDecodeInt32, int32_t)
+YY_MODEL_CODER_INTEGER(ModelCoderEncodeUInt32, ModelCoderDecodeUInt32, uint32_t)
+YY_MODEL_CODER_INTEGER(ModelCoderEncodeInt64, ModelCoderDecodeInt64, int64_t)
+YY_MODEL_CODER_INTEGER(ModelCoderEncodeUInt64, ModelCoderDecodeUInt64, uint64_t)
+#undef YY_MODEL_CODER_INTEGER
+
+#define YY_MODEL_CODER_FLOAT(_encode_, _decode_, _type_) \
+static void _encode_(__unsafe_unretained NSCoder *coder, __unsafe_unretained id model, const _YYModelCoderStep *step) { \
+    double value = ((_type_ (*)(id, SEL))(void *) step->getter)((id)model, step->meta->_getter); \
+    if (isnan(value) || isinf(value)) return; \
+    [coder encodeDouble:value forKey:step->key]; \
+} \
+static void _decode_(__unsafe_unretained NSCoder *coder, __unsafe_unretained id model, const _YYModelCoderStep *step) { \
+    double value = [coder decodeDoubleForKey:step->key]; \
+    if (value == 0 && ![coder containsValueForKey:step->key]) return; \
+    ((void (*)(id, SEL, _type_))(void *) step->setter)((id)model, step->meta->_setter, (_type_)value); \
+}
+YY_MODEL_CODER_FLOAT(ModelCoderEncodeFloat, ModelCoderDecodeFloat, float)
+YY_MODEL_CODER_FLOAT(ModelCoderEncodeDouble, ModelCoderDecodeDouble, double)
+YY_MODEL_CODER_FLOAT(ModelCoderEncodeLongDouble, ModelCoderDecodeLongDouble, long double)
+#undef YY_MODEL_CODER_FLOAT
+
+static void ModelCoderEncodeBool(__unsafe_unretained NSCoder *coder, __unsafe_unretained id model, const _YYModelCoderStep *step) {
+    bool value = ((bool (*)(id, SEL))(void *) step->getter)((id)model, step->meta->_getter);
+    [coder encodeBool:value forKey:step->key];
+}
+
+static void ModelCoderDecodeBool(__unsafe_unretained NSCoder *coder, __unsafe_unretained id model, const _YYModelCoderStep *step) {
+    BOOL value = [coder decodeBoolForKey:step->key];
+    if (!value && ![coder containsValueForKey:step->key]) return;
+    ((void (*)(id, SEL, bool))(void *) step->setter)((id)model, step->meta->_setter, value);
+}
+
+/// Object, NSValue (except NSNumber) is not encoded.
+static void ModelCoderEncodeObject(__unsafe_unretained NSCoder *coder, __unsafe_unretained id model, const _YYModelCoderStep *step) {
+    id value = ((id (*)(id, SEL))(void *) step->getter)((id)model, step->meta->_getter);
+    if (!value) return;
+    if (!step->meta->_nsType && ![value respondsToSelector:@selector(encodeWithCoder:)]) return;
+    if ([value isKindOfClass:[NSValue class]] && ![value isKindOfClass:[NSNumber class]]) return;
+    [coder encodeObject:value forKey:step->key];
+}
+
+static void ModelCoderDecodeObject(__unsafe_unretained NSCoder *coder, __unsafe_unretained id model, const _YYModelCoderStep *step) {
+    id value = [coder decodeObjectForKey:step->key];
+    ((void (*)(id, SEL, id))(void *) step->setter)((id)model, step->meta->_setter, value);
+}
+
+/// SEL, stored as string.
+static void ModelCoderEncodeSEL(__unsafe_unretained NSCoder *coder, __unsafe_unretained id model, const _YYModelCoderStep *step) {
+    SEL value = ((SEL (*)(id, SEL))(void *) step->getter)((id)model, step->meta->_getter);
+    if (value) [coder encodeObject:NSStringFromSelector(value) forKey:step->key];
+}
+
+static void ModelCoderDecodeSEL(__unsafe_unretained NSCoder *coder, __unsafe_unretained id model, const _YYModelCoderStep *step) {
+    NSString *str = [coder decodeObjectForKey:step->key];
+    if (![str isKindOfClass:[NSString class]]) return;
+    SEL sel = NSSelectorFromString(str);
+    ((void (*)(id, SEL, SEL))(void *) step->setter)((id)model, step->meta->_setter, sel);
+}
+
+/// Struct and union with key-value coding, stored as NSValue.
+static void ModelCoderEncodeStruct(__unsafe_unretained NSCoder *coder, __unsafe_unretained id model, const _YYModelCoderStep *step) {
+    @try {
+        NSValue *value = [model valueForKey:NSStringFromSelector(step->meta->_getter)];
+        [coder encodeObject:value forKey:step->key];
+    } @catch (NSException *exception) {}
+}
+
+static void ModelCoderDecodeStruct(__unsafe_unretained NSCoder *coder, __unsafe_unretained id model, const _YYModelCoderStep *step) {
+    @try {
+        NSValue *value = [coder decodeObjectForKey:step->key];
+        if (value) [model setValue:value forKey:step->key];
+    } @catch (NSException *exception) {}
+}
+
+/**
+ Build the coder plan of a model meta, it's called once when the meta is created.
+ 
+ @discussion There's a step for each property (in _allPropertyMetas) which can be encoded
+ or decoded. The getter and setter IMP are looked up from the class at this time, a method
+ which is replaced later (such as swizzling) is not called by the plan. A method which is
+ not found (such as a dynamic or forwarded method) is sent with objc_msgSend.
+ 
+ @param meta The model meta, its _classInfo and _allPropertyMetas should be set.
+ */
+static void ModelCreateCoderPlan(_YYModelMeta *meta) {
+    NSUInteger count = meta->_allPropertyMetas.count;
+    if (count == 0) return;
+    
+    _YYModelCoderStep *plan = calloc(count, sizeof(_YYModelCoderStep));
+    NSUInteger planCount = 0;
+    Class cls = meta->_classInfo.cls;
+    for (_YYModelPropertyMeta *propertyMeta in meta->_allPropertyMetas) {
+        YYModelCoderFunction encode = NULL, decode = NULL;
+        switch (propertyMeta->_type & YYEncodingTypeMask) {
+            case YYEncodingTypeBool: encode = ModelCoderEncodeBool; decode = ModelCoderDecodeBool; break;
+            case YYEncodingTypeInt8: encode = ModelCoderEncodeInt8; decode = ModelCoderDecodeInt8; break;
+            case YYEncodingTypeUInt8: encode = ModelCoderEncodeUInt8; decode = ModelCoderDecodeUInt8; break;
+            case YYEncodingTypeInt16: encode = ModelCoderEncodeInt16; decode = ModelCoderDecodeInt16; break;
+            case YYEncodingTypeUInt16: encode = ModelCoderEncodeUInt16; decode = ModelCoderDecodeUInt16; break;
+            case YYEncodingTypeInt32: encode = ModelCoderEncodeInt32; decode = ModelCoderDecodeInt32; break;
+            case YYEncodingTypeUInt32: encode = ModelCoderEncodeUInt32; decode = ModelCoderDecodeUInt32; break;
+            case YYEncodingTypeInt64: encode = ModelCoderEncodeInt64; decode = ModelCoderDecodeInt64; break;
+            case YYEncodingTypeUInt64: encode = ModelCoderEncodeUInt64; decode = ModelCoderDecodeUInt64; break;
+            case YYEncodingTypeFloat: encode = ModelCoderEncodeFloat; decode = ModelCoderDecodeFloat; break;
+            case YYEncodingTypeDouble: encode = ModelCoderEncodeDouble; decode = ModelCoderDecodeDouble; break;
+            case YYEncodingTypeLongDouble: encode = ModelCoderEncodeLongDouble; decode = ModelCoderDecodeLongDouble; break;
+            case YYEncodingTypeObject: encode = ModelCoderEncodeObject; decode = ModelCoderDecodeObject; break;
+            case YYEncodingTypeSEL: encode = ModelCoderEncodeSEL; decode = ModelCoderDecodeSEL; break;
+            case YYEncodingTypeStruct:
+            case YYEncodingTypeUnion: {
+                if (!propertyMeta->_isKVCCompatible) break;
+                if (propertyMeta->_isStructAvailableForKeyedArchiver) encode = ModelCoderEncodeStruct;
+                decode = ModelCoderDecodeStruct;
+            } break;
+            default: break;
+        }
+        if (!propertyMeta->_getter) encode = NULL;
+        if (!propertyMeta->_setter) decode = NULL;
+        if (!encode && !decode) continue;
+        
+        _YYModelCoderStep *step = plan + planCount++;
+        step->meta = propertyMeta;
+        step->key = propertyMeta->_name;
+        step->encode = encode;
+        step->decode = decode;
+        if (encode) {
+            Method method = class_getInstanceMethod(cls, propertyMeta->_getter);
+            step->getter = method ? method_getImplementation(method) : (IMP)objc_msgSend;
+        }
+        if (decode) {
+            Method method = class_getInstanceMethod(cls, propertyMeta->_setter);
+            step->setter = method ? method_getImplementation(method) : (IMP)objc_msgSend;
+        }
+    }
+    meta->_coderPlan = plan;
+    meta->_coderPlanCount = planCount;
+}
+
+/**
+ Set value to model with a property meta, the value is transformed with the
+ property's decoder first (if any).
+ 
+ @discussion Caller should hold strong reference to the parameters before this function returns.
+ 
+ @param model Should not be nil.
+ @param value Should not be nil, but can be NSNull.
+ @param meta  Should not be nil, and meta->_setter should not be nil.
+ */
+static force_inline void ModelSetTransformedValueForProperty(__unsafe_unretained id model,
+                                                             __unsafe_unretained id value,
+                                                             __unsafe_unretained _YYModelPropertyMeta *meta) {
+    if (meta->_decoder) {
+        id transformed = meta->_decoder(value);
+        if (transformed) ModelSetValueForProperty(model, transformed, meta);
+    } else {
+        ModelSetValueForProperty(model, value, meta);
+    }
+}
+
+void YYModelSetValueForProperty(id model, id value, _YYModelPropertyMeta *meta) {
+    ModelSetTransformedValueForProperty(model, value, meta);
+}
+
+void YYModelSetNumberCStringToProperty(id model, const char *cstring, _YYModelPropertyMeta *meta) {
+    YYNumberScan scan;
+    if (!YYNumberScanCString(cstring, &scan)) {
+        ModelSetInt64ToProperty(model, 0, meta);
+        return;
+    }
+    YYEncodingType type = meta->_type & YYEncodingTypeMask;
+    BOOL isFloat = (type == YYEncodingTypeFloat || type == YYEncodingTypeDouble || type == YYEncodingTypeLongDouble);
+    if (scan.isInteger && !scan.truncated && !isFloat) {
+        if (scan.negative) {
+            if (scan.mantissa <= (uint64_t)INT64_MAX + 1) {
+                ModelSetInt64ToProperty(model, (int64_t)(0 - scan.mantissa), meta);
+                return;
+            }
+        } else {
+            ModelSetInt64ToProperty(model, (int64_t)scan.mantissa, meta);
+            return;
+        }
+    }
+    double num = YYNumberScanGetDouble(&scan, cstring);
+    if (isnan(num) || isinf(num)) num = 0;
+    if (type == YYEncodingTypeBool) {
+        ModelSetInt64ToProperty(model, num != 0, meta);
+    } else {
+        YYModelSetDoubleToProperty(model, num, meta);
+    }
+}
+
+
+
+/// The value of a multi-key property found in the json dictionary.
+typedef struct {
+    __unsafe_unretained id value; ///< the value of the preferred key found so far
+    NSUInteger priority;          ///< index of the key in the property's keys
+} ModelMultiKeysSlot;
+
 typedef struct {
     void *modelMeta;  ///< _YYModelMeta
     void *model;      ///< id (self)
     void *dictionary; ///< NSDictionary (json)
+    ModelMultiKeysSlot *multiKeysSlots; ///< one slot for each of modelMeta->_multiKeysPropertyMetas
+    CFIndex hits;     ///< the number of json keys which are mapped
 } ModelSetContext;
 
+/**
+ Set the value of a key plan node to the model, and continue with the node's children
+ if the value is a dictionary.
+ 
+ @param node    should not be nil.
+ @param value   should not be nil.
+ @param context context.model should not be nil.
+ */
+static void ModelSetWithKeyPlanNode(__unsafe_unretained _YYModelKeyPlanNode *node,
+                                    __unsafe_unretained id value,
+                                    ModelSetContext *context) {
+    if (node->_targets) {
+        __unsafe_unretained id model = (__bridge id)(context->model);
+        CFArrayRef targets = (__bridge CFArrayRef)node->_targets;
+        for (CFIndex i = 0, max = CFArrayGetCount(targets); i < max; i++) {
+            __unsafe_unretained _YYModelKeyPlanTarget *target = CFArrayGetValueAtIndex(targets, i);
+            if (target->_slot < 0) {
+                if (target->_meta->_setter) ModelSetTransformedValueForProperty(model, value, target->_meta);
+            } else {
+                ModelMultiKeysSlot *slot = context->multiKeysSlots + target->_slot;
+                if (target->_priority < slot->priority) {
+                    slot->value = value;
+                    slot->priority = target->_priority;
+                }
+            }
+        }
+    }
+    if (node->_children && [value isKindOfClass:[NSDictionary class]]) {
+        CFArrayRef children = (__bridge CFArrayRef)node->_children;
+        for (CFIndex i = 0, max = CFArrayGetCount(children); i < max; i++) {
+            __unsafe_unretained _YYModelKeyPlanNode *child = CFArrayGetValueAtIndex(children, i);
+            __unsafe_unretained id childValue = CFDictionaryGetValue((CFDictionaryRef)value, (__bridge const void *)(child->_key));
+            if (childValue) ModelSetWithKeyPlanNode(child, childValue, context);
+        }
+    }
+}
+
 /**
  Apply function for dictionary, to set the key-value pair to model.
  
@@ -1115,40 +2382,215 @@ typedef struct {
 static void ModelSetWithDictionaryFunction(const void *_key, const void *_value, void *_context) {
     ModelSetContext *context = _context;
     __unsafe_unretained _YYModelMeta *meta = (__bridge _YYModelMeta *)(context->modelMeta);
-    __unsafe_unretained _YYModelPropertyMeta *propertyMeta = [meta->_mapper objectForKey:(__bridge id)(_key)];
-    __unsafe_unretained id model = (__bridge id)(context->model);
-    while (propertyMeta) {
-        if (propertyMeta->_setter) {
-            ModelSetValueForProperty(model, (__bridge __unsafe_unretained id)_value, propertyMeta);
-        }
-        propertyMeta = propertyMeta->_next;
-    };
+    __unsafe_unretained _YYModelKeyPlanNode *node = CFDictionaryGetValue((CFDictionaryRef)meta->_keyPlan, _key);
+    if (node) {
+        context->hits++;
+        ModelSetWithKeyPlanNode(node, (__bridge __unsafe_unretained id)_value, context);
+    }
 }
 
+/// Relative cost of iterating a json entry: the enumeration callback, hashing the json key
+/// and probing the key plan.
+#define kYYDecodeIterateCost 5
+/// Relative cost of looking up a mapped key: hashing the key and probing the json dictionary.
+#define kYYDecodeLookupCost 4
+/// The statistics are updated once every (mask + 1) decodes.
+#define kYYDecodeStatSampleMask 7
+
 /**
- Apply function for model property meta, to set dictionary to model.
+ Whether to iterate the json dictionary (or look up the mapped keys in it).
  
- @param _propertyMeta should not be nil, _YYModelPropertyMeta.
- @param _context      _context.model and _context.dictionary should not be nil.
+ @discussion Both strategies set every mapped key which exists in the json, the
+ difference is the misses: iterating visits every json key, looking up probes the root
+ keys of the plan, and stops when all json keys have been found. The json dictionaries
+ of a model usually contain the same mapped keys, so the running averages of the json
+ size and the hit ratio give the expected number of mapped keys: if the dictionary has
+ no more keys than that, all of them are expected to be mapped, and the lookup is
+ expected to stop at about count * (roots + 1) / (count + 1) of the roots.
+ 
+ @param modelMeta Should not be nil.
+ @param count     The number of json keys.
  */
-static void ModelSetWithPropertyMetaArrayFunction(const void *_propertyMeta, void *_context) {
-    ModelSetContext *context = _context;
-    __unsafe_unretained NSDictionary *dictionary = (__bridge NSDictionary *)(context->dictionary);
-    __unsafe_unretained _YYModelPropertyMeta *propertyMeta = (__bridge _YYModelPropertyMeta *)(_propertyMeta);
-    if (!propertyMeta->_setter) return;
-    id value = nil;
+static force_inline BOOL ModelShouldIterateDictionary(__unsafe_unretained _YYModelMeta *modelMeta, CFIndex count) {
+    switch (modelMeta->_decodeStrategy) {
+        case YYModelDecodeStrategyDictionary: return YES;
+        case YYModelDecodeStrategyMappedKeys: return NO;
+        default: break;
+    }
+    CFIndex roots = modelMeta->_keyPlanRootCount;
+    CFIndex lookups = roots;
+    uint64_t keyCount = __atomic_load_n(&modelMeta->_statKeyCount, __ATOMIC_RELAXED); // 24.8
+    uint64_t hitRatio = __atomic_load_n(&modelMeta->_statHitRatio, __ATOMIC_RELAXED); // 16.16
+    CFIndex expectedHits = (CFIndex)((keyCount * hitRatio + (1 << 23)) >> 24);
+    if (count < roots && count <= expectedHits) {
+        lookups = count * (roots + 1) / (count + 1);
+    }
+    return count * kYYDecodeIterateCost <= lookups * kYYDecodeLookupCost;
+}
+
+/**
+ Update the running averages of the json size and hit ratio (1/8 weight for the new sample).
+ 
+ @discussion The meta is shared by all threads: one decode in (kYYDecodeStatSampleMask + 1)
+ is sampled, and the fields are read and written with relaxed atomics. A lost update
+ between threads only drops a sample.
+ */
+static force_inline void ModelUpdateDecodeStatistics(__unsafe_unretained _YYModelMeta *modelMeta, CFIndex hits, CFIndex count) {
+    if (modelMeta->_decodeStrategy != YYModelDecodeStrategyAutomatic || count <= 0) return;
+    uint32_t decodes = __atomic_load_n(&modelMeta->_statDecodes, __ATOMIC_RELAXED);
+    __atomic_store_n(&modelMeta->_statDecodes, decodes + 1, __ATOMIC_RELAXED);
+    if (decodes & kYYDecodeStatSampleMask) return;
     
-    if (propertyMeta->_mappedToKeyArray) {
-        value = YYValueForMultiKeys(dictionary, propertyMeta->_mappedToKeyArray);
-    } else if (propertyMeta->_mappedToKeyPath) {
-        value = YYValueForKeyPath(dictionary, propertyMeta->_mappedToKeyPath);
+    int64_t sampleCount = (int64_t)MIN(count, 0xFFFFFF) << 8;
+    int64_t sampleRatio = (int64_t)hits * 0x10000 / count;
+    int64_t keyCount = __atomic_load_n(&modelMeta->_statKeyCount, __ATOMIC_RELAXED);
+    int64_t hitRatio = __atomic_load_n(&modelMeta->_statHitRatio, __ATOMIC_RELAXED);
+    if (keyCount == 0) { // the first sample
+        keyCount = sampleCount;
+        hitRatio = sampleRatio;
     } else {
-        value = [dictionary objectForKey:propertyMeta->_mappedToKey];
+        keyCount += (sampleCount - keyCount) / 8;
+        hitRatio += (sampleRatio - hitRatio) / 8;
     }
-    
-    if (value) {
-        __unsafe_unretained id model = (__bridge id)(context->model);
-        ModelSetValueForProperty(model, value, propertyMeta);
+    __atomic_store_n(&modelMeta->_statKeyCount, (uint32_t)keyCount, __ATOMIC_RELAXED);
+    __atomic_store_n(&modelMeta->_statHitRatio, (uint32_t)hitRatio, __ATOMIC_RELAXED);
+}
+
+BOOL YYModelShouldIterateDictionary(_YYModelMeta *modelMeta, CFIndex count) {
+    return ModelShouldIterateDictionary(modelMeta, count);
+}
+
+static id ModelToJSONObjectRecursive(NSObject *model);
+
+/**
+ Get the json value of a property.
+ 
+ @param model        Should not be nil.
+ @param propertyMeta Should not be nil, and propertyMeta->_getter should not be nil.
+ @param convert      YES to convert object values to JSON objects, NO to return them
+                     as is (c values are always converted).
+ @return The json value, or nil if the property should be ignored.
+ */
+static force_inline id ModelCreateJSONValueForProperty(__unsafe_unretained id model,
+                                                       __unsafe_unretained _YYModelPropertyMeta *propertyMeta,
+                                                       BOOL convert) {
+    id value = nil;
+    if (propertyMeta->_encoder) {
+        id v = nil;
+        if (propertyMeta->_isCNumber) {
+            v = ModelCreateNumberFromProperty(model, propertyMeta);
+        } else if ((propertyMeta->_type & YYEncodingTypeMask) == YYEncodingTypeObject) {
+            v = ((id (*)(id, SEL))(void *) objc_msgSend)((id)model, propertyMeta->_getter);
+        }
+        if (v) {
+            value = propertyMeta->_encoder(v);
+            if (convert) value = ModelToJSONObjectRecursive(value);
+            if (value == (id)kCFNull) value = nil;
+        }
+    } else if (propertyMeta->_isCNumber) {
+        if (propertyMeta->_enumMapper) {
+            value = YYEnumMapperGetName(propertyMeta->_enumMapper, ModelGetInt64FromProperty(model, propertyMeta));
+        }
+        if (!value) value = ModelCreateNumberFromProperty(model, propertyMeta);
+    } else if (propertyMeta->_nsType) {
+        id v = ((id (*)(id, SEL))(void *) objc_msgSend)((id)model, propertyMeta->_getter);
+        value = convert ? ModelToJSONObjectRecursive(v) : v;
+    } else {
+        switch (propertyMeta->_type & YYEncodingTypeMask) {
+            case YYEncodingTypeObject: {
+                id v = ((id (*)(id, SEL))(void *) objc_msgSend)((id)model, propertyMeta->_getter);
+                value = convert ? ModelToJSONObjectRecursive(v) : v;
+                if (value == (id)kCFNull) value = nil;
+            } break;
+            case YYEncodingTypeClass: {
+                Class v = ((Class (*)(id, SEL))(void *) objc_msgSend)((id)model, propertyMeta->_getter);
+                value = v ? NSStringFromClass(v) : nil;
+            } break;
+            case YYEncodingTypeSEL: {
+                SEL v = ((SEL (*)(id, SEL))(void *) objc_msgSend)((id)model, propertyMeta->_getter);
+                value = v ? NSStringFromSelector(v) : nil;
+            } break;
+            default: break;
+        }
+    }
+    return value;
+}
+
+/*
+ The encode functions of the steps in model meta's _encodePlan, the result is same as
+ `ModelCreateJSONValueForProperty()`. The getter IMP is called directly, and the type
+ of the property is not checked again.
+ */
+
+/// Property with encoder or enum mapper, Class, SEL, or the getter IMP is unknown.
+static id ModelEncodeGeneric(__unsafe_unretained id model, const _YYModelEncodeStep *step, BOOL convert) {
+    return ModelCreateJSONValueForProperty(model, step->meta, convert);
+}
+
+#define YY_MODEL_ENCODE_INTEGER(_name_, _type_) \
+static id _name_(__unsafe_unretained id model, const _YYModelEncodeStep *step, BOOL convert) { \
+    return @(((_type_ (*)(id, SEL))(void *) step->getter)((id)model, step->meta->_getter)); \
+}
+YY_MODEL_ENCODE_INTEGER(ModelEncodeBool, bool)
+YY_MODEL_ENCODE_INTEGER(ModelEncodeInt8, int8_t)
+YY_MODEL_ENCODE_INTEGER(ModelEncodeUInt8, uint8_t)
+YY_MODEL_ENCODE_INTEGER(ModelEncodeInt16, int16_t)
+YY_MODEL_ENCODE_INTEGER(ModelEncodeUInt16, uint16_t)
+YY_MODEL_ENCODE_INTEGER(ModelEncodeInt32, int32_t)
+YY_MODEL_ENCODE_INTEGER(ModelEncodeUInt32, uint32_t)
+YY_MODEL_ENCODE_INTEGER(ModelEncodeInt64, int64_t)
+YY_MODEL_ENCODE_INTEGER(ModelEncodeUInt64, uint64_t)
+#undef YY_MODEL_ENCODE_INTEGER
+
+static id ModelEncodeFloat(__unsafe_unretained id model, const _YYModelEncodeStep *step, BOOL convert) {
+    float num = ((float (*)(id, SEL))(void *) step->getter)((id)model, step->meta->_getter);
+    if (isnan(num) || isinf(num)) return nil;
+    return @(num);
+}
+
+static id ModelEncodeDouble(__unsafe_unretained id model, const _YYModelEncodeStep *step, BOOL convert) {
+    double num = ((double (*)(id, SEL))(void *) step->getter)((id)model, step->meta->_getter);
+    if (isnan(num) || isinf(num)) return nil;
+    return @(num);
+}
+
+static id ModelEncodeLongDouble(__unsafe_unretained id model, const _YYModelEncodeStep *step, BOOL convert) {
+    double num = ((long double (*)(id, SEL))(void *) step->getter)((id)model, step->meta->_getter);
+    if (isnan(num) || isinf(num)) return nil;
+    return @(num);
+}
+
+/// Foundation object (NSString, NSArray...).
+static id ModelEncodeFoundationObject(__unsafe_unretained id model, const _YYModelEncodeStep *step, BOOL convert) {
+    id value = ((id (*)(id, SEL))(void *) step->getter)((id)model, step->meta->_getter);
+    return convert ? ModelToJSONObjectRecursive(value) : value;
+}
+
+/// Other object (model, id).
+static id ModelEncodeObject(__unsafe_unretained id model, const _YYModelEncodeStep *step, BOOL convert) {
+    id value = ((id (*)(id, SEL))(void *) step->getter)((id)model, step->meta->_getter);
+    if (convert) value = ModelToJSONObjectRecursive(value);
+    return value == (id)kCFNull ? nil : value;
+}
+
+/// Select the encode function of a property.
+static YYModelEncodeFunction ModelEncodeFunctionForProperty(_YYModelPropertyMeta *meta, IMP getter) {
+    if (!getter || meta->_encoder || meta->_enumMapper) return ModelEncodeGeneric;
+    switch (meta->_type & YYEncodingTypeMask) {
+        case YYEncodingTypeBool: return ModelEncodeBool;
+        case YYEncodingTypeInt8: return ModelEncodeInt8;
+        case YYEncodingTypeUInt8: return ModelEncodeUInt8;
+        case YYEncodingTypeInt16: return ModelEncodeInt16;
+        case YYEncodingTypeUInt16: return ModelEncodeUInt16;
+        case YYEncodingTypeInt32: return ModelEncodeInt32;
+        case YYEncodingTypeUInt32: return ModelEncodeUInt32;
+        case YYEncodingTypeInt64: return ModelEncodeInt64;
+        case YYEncodingTypeUInt64: return ModelEncodeUInt64;
+        case YYEncodingTypeFloat: return ModelEncodeFloat;
+        case YYEncodingTypeDouble: return ModelEncodeDouble;
+        case YYEncodingTypeLongDouble: return ModelEncodeLongDouble;
+        case YYEncodingTypeObject: return meta->_nsType ? ModelEncodeFoundationObject : ModelEncodeObject;
+        default: return ModelEncodeGeneric;
     }
 }
 
@@ -1161,6 +2603,7 @@ static void ModelSetWithPropertyMetaArrayFunction(const void *_propertyMeta, voi
  */
 static id ModelToJSONObjectRecursive(NSObject *model) {
     if (!model || model == (id)kCFNull) return model;
+    if (object_getClass(model) == [_YYLazyURL class]) return ((_YYLazyURL *)model)->_string;
     if ([model isKindOfClass:[NSString class]]) return model;
     if ([model isKindOfClass:[NSNumber class]]) return model;
     if ([model isKindOfClass:[NSDictionary class]]) {
@@ -1189,95 +2632,591 @@ static id ModelToJSONObjectRecursive(NSObject *model) {
         }
         return newArray;
     }
-    if ([model isKindOfClass:[NSArray class]]) {
-        if ([NSJSONSerialization isValidJSONObject:model]) return model;
-        NSMutableArray *newArray = [NSMutableArray new];
-        for (id obj in (NSArray *)model) {
-            if ([obj isKindOfClass:[NSString class]] || [obj isKindOfClass:[NSNumber class]]) {
-                [newArray addObject:obj];
-            } else {
-                id jsonObj = ModelToJSONObjectRecursive(obj);
-                if (jsonObj && jsonObj != (id)kCFNull) [newArray addObject:jsonObj];
-            }
-        }
-        return newArray;
+    if ([model isKindOfClass:[NSArray class]]) {
+        if ([NSJSONSerialization isValidJSONObject:model]) return model;
+        NSMutableArray *newArray = [NSMutableArray new];
+        for (id obj in (NSArray *)model) {
+            if ([obj isKindOfClass:[NSString class]] || [obj isKindOfClass:[NSNumber class]]) {
+                [newArray addObject:obj];
+            } else {
+                id jsonObj = ModelToJSONObjectRecursive(obj);
+                if (jsonObj && jsonObj != (id)kCFNull) [newArray addObject:jsonObj];
+            }
+        }
+        return newArray;
+    }
+    if ([model isKindOfClass:[NSURL class]]) return ((NSURL *)model).absoluteString;
+    if ([model isKindOfClass:[NSAttributedString class]]) return ((NSAttributedString *)model).string;
+    if ([model isKindOfClass:[NSDate class]]) return [YYISODateFormatter() stringFromDate:(id)model];
+    if ([model isKindOfClass:[NSData class]]) return nil;
+    
+    
+    _YYModelMeta *modelMeta = [_YYModelMeta metaWithClass:[model class]];
+    if (!modelMeta || modelMeta->_keyMappedCount == 0) return nil;
+    NSMutableDictionary *result = [[NSMutableDictionary alloc] initWithCapacity:modelMeta->_encodePlanCount];
+    __unsafe_unretained NSMutableDictionary *dic = result;
+    for (NSUInteger i = 0, max = modelMeta->_encodePlanCount; i < max; i++) {
+        const _YYModelEncodeStep *step = modelMeta->_encodePlan + i;
+        __unsafe_unretained _YYModelPropertyMeta *propertyMeta = step->meta;
+        id value = step->encode(model, step, YES);
+        if (!value) continue;
+        
+        if (propertyMeta->_mappedToKeyPath) {
+            NSMutableDictionary *superDic = dic;
+            NSMutableDictionary *subDic = nil;
+            for (NSUInteger i = 0, max = propertyMeta->_mappedToKeyPath.count; i < max; i++) {
+                NSString *key = propertyMeta->_mappedToKeyPath[i];
+                if (i + 1 == max) { // end
+                    if (!superDic[key]) superDic[key] = value;
+                    break;
+                }
+                
+                subDic = superDic[key];
+                if (subDic) {
+                    if ([subDic isKindOfClass:[NSDictionary class]]) {
+                        subDic = subDic.mutableCopy;
+                        superDic[key] = subDic;
+                    } else {
+                        break;
+                    }
+                } else {
+                    subDic = [NSMutableDictionary new];
+                    superDic[key] = subDic;
+                }
+                superDic = subDic;
+                subDic = nil;
+            }
+        } else {
+            if (!step->isSharedKey || !dic[step->key]) {
+                dic[step->key] = value;
+            }
+        }
+    }
+    
+    if (modelMeta->_hasCustomTransformToDictionary) {
+        BOOL suc = [((id<YYModel>)model) modelCustomTransformToDictionary:dic];
+        if (!suc) return nil;
+    }
+    return result;
+}
+
+/// SipHash-2-4 state with 128-bit output, the input can be fed in pieces.
+typedef struct {
+    uint64_t v0, v1, v2, v3;
+    uint64_t tail;   ///< pending bytes (little endian)
+    uint64_t length; ///< total input length
+} YYSipHash;
+
+#define YY_SIP_ROTL(x, b) (uint64_t)(((x) << (b)) | ((x) >> (64 - (b))))
+#define YY_SIP_ROUND(s) do { \
+    (s)->v0 += (s)->v1; (s)->v1 = YY_SIP_ROTL((s)->v1, 13); (s)->v1 ^= (s)->v0; (s)->v0 = YY_SIP_ROTL((s)->v0, 32); \
+    (s)->v2 += (s)->v3; (s)->v3 = YY_SIP_ROTL((s)->v3, 16); (s)->v3 ^= (s)->v2; \
+    (s)->v0 += (s)->v3; (s)->v3 = YY_SIP_ROTL((s)->v3, 21); (s)->v3 ^= (s)->v0; \
+    (s)->v2 += (s)->v1; (s)->v1 = YY_SIP_ROTL((s)->v1, 17); (s)->v1 ^= (s)->v2; (s)->v2 = YY_SIP_ROTL((s)->v2, 32); \
+} while (0)
+
+static force_inline void YYSipHashInit(YYSipHash *sip, uint64_t k0, uint64_t k1) {
+    sip->v0 = 0x736f6d6570736575ULL ^ k0;
+    sip->v1 = 0x646f72616e646f6dULL ^ k1 ^ 0xee;
+    sip->v2 = 0x6c7967656e657261ULL ^ k0;
+    sip->v3 = 0x7465646279746573ULL ^ k1;
+    sip->tail = 0;
+    sip->length = 0;
+}
+
+static force_inline void YYSipHashCompress(YYSipHash *sip, uint64_t m) {
+    sip->v3 ^= m;
+    YY_SIP_ROUND(sip);
+    YY_SIP_ROUND(sip);
+    sip->v0 ^= m;
+}
+
+static void YYSipHashUpdate(YYSipHash *sip, const UInt8 *bytes, size_t length) {
+    unsigned used = (unsigned)(sip->length & 7);
+    sip->length += length;
+    if (used) {
+        for (; used < 8 && length; used++, length--) sip->tail |= (uint64_t)*bytes++ << (used * 8);
+        if (used < 8) return;
+        YYSipHashCompress(sip, sip->tail);
+        sip->tail = 0;
+    }
+    for (; length >= 8; bytes += 8, length -= 8) {
+        uint64_t m;
+        memcpy(&m, bytes, 8);
+        YYSipHashCompress(sip, CFSwapInt64LittleToHost(m));
+    }
+    for (unsigned i = 0; i < length; i++) sip->tail |= (uint64_t)bytes[i] << (i * 8);
+}
+
+static void YYSipHashFinal(YYSipHash *sip, UInt8 digest[16]) {
+    YYSipHashCompress(sip, (sip->length << 56) | sip->tail);
+    sip->v2 ^= 0xee;
+    for (int i = 0; i < 4; i++) YY_SIP_ROUND(sip);
+    uint64_t h0 = sip->v0 ^ sip->v1 ^ sip->v2 ^ sip->v3;
+    sip->v1 ^= 0xdd;
+    for (int i = 0; i < 4; i++) YY_SIP_ROUND(sip);
+    uint64_t h1 = sip->v0 ^ sip->v1 ^ sip->v2 ^ sip->v3;
+    for (int i = 0; i < 8; i++) {
+        digest[i] = (UInt8)(h0 >> (i * 8));
+        digest[i + 8] = (UInt8)(h1 >> (i * 8));
+    }
+}
+
+#undef YY_SIP_ROUND
+#undef YY_SIP_ROTL
+
+void YYModelSipHash128(const void *bytes, size_t length, const uint8_t key[16], uint8_t digest[16]) {
+    uint64_t k0 = 0, k1 = 0;
+    for (int i = 0; i < 8; i++) {
+        k0 |= (uint64_t)key[i] << (i * 8);
+        k1 |= (uint64_t)key[i + 8] << (i * 8);
+    }
+    YYSipHash sip;
+    YYSipHashInit(&sip, k0, k1);
+    YYSipHashUpdate(&sip, bytes, length);
+    YYSipHashFinal(&sip, digest);
+}
+
+
+/// Output of the canonical json writer, bytes are appended to the data and fed to the digest.
+typedef struct {
+    CFMutableDataRef data; ///< output buffer, or NULL
+    YYSipHash *sip;        ///< digest state, or NULL
+} ModelCanonicalJSONWriter;
+
+static force_inline void ModelCanonicalJSONAppend(ModelCanonicalJSONWriter *writer, const void *bytes, CFIndex length) {
+    if (writer->data) CFDataAppendBytes(writer->data, bytes, length);
+    if (writer->sip) YYSipHashUpdate(writer->sip, bytes, length);
+}
+
+/// Write a json string with minimal escaping.
+static void ModelWriteCanonicalJSONString(ModelCanonicalJSONWriter *writer, __unsafe_unretained NSString *string) {
+    static const char hex[] = "0123456789abcdef";
+    CFStringRef str = (__bridge CFStringRef)string;
+    CFIndex length = CFStringGetLength(str);
+    CFIndex location = 0;
+    UInt8 buffer[256];
+    ModelCanonicalJSONAppend(writer, "\"", 1);
+    while (location < length) {
+        CFIndex used = 0;
+        CFIndex converted = CFStringGetBytes(str, CFRangeMake(location, length - location), kCFStringEncodingUTF8, '?', false, buffer, sizeof(buffer), &used);
+        if (converted <= 0) break;
+        location += converted;
+        
+        const UInt8 *run = buffer, *cur = buffer, *end = buffer + used;
+        for (; cur < end; cur++) {
+            UInt8 c = *cur;
+            if (c >= 0x20 && c != '"' && c != '\\') continue;
+            if (cur > run) ModelCanonicalJSONAppend(writer, run, cur - run);
+            run = cur + 1;
+            UInt8 escape[6] = {'\\', 0, '0', '0', 0, 0};
+            switch (c) {
+                case '"': escape[1] = '"'; break;
+                case '\\': escape[1] = '\\'; break;
+                case '\b': escape[1] = 'b'; break;
+                case '\f': escape[1] = 'f'; break;
+                case '\n': escape[1] = 'n'; break;
+                case '\r': escape[1] = 'r'; break;
+                case '\t': escape[1] = 't'; break;
+                default: {
+                    escape[1] = 'u';
+                    escape[4] = hex[c >> 4];
+                    escape[5] = hex[c & 0xF];
+                    ModelCanonicalJSONAppend(writer, escape, 6);
+                } continue;
+            }
+            ModelCanonicalJSONAppend(writer, escape, 2);
+        }
+        if (cur > run) ModelCanonicalJSONAppend(writer, run, cur - run);
+    }
+    ModelCanonicalJSONAppend(writer, "\"", 1);
+}
+
+/**
+ Build the encode plan of a model meta, it's called once when the meta is created.
+ 
+ @discussion The getter IMP is looked up from the class at this time, a method which
+ is replaced later (such as swizzling) is not called by the plan.
+ 
+ @param meta          The model meta, its _classInfo should be set.
+ @param propertyMetas The mapped property metas (values of _mapper) sorted by mapped key.
+ */
+static void ModelCreateEncodePlan(_YYModelMeta *meta, NSArray *propertyMetas) {
+    NSUInteger count = propertyMetas.count;
+    if (count == 0) return;
+    
+    NSCountedSet *topKeys = [NSCountedSet new];
+    for (_YYModelPropertyMeta *propertyMeta in propertyMetas) {
+        [topKeys addObject:propertyMeta->_mappedToKeyPath ? propertyMeta->_mappedToKeyPath.firstObject : propertyMeta->_mappedToKey];
+    }
+    
+    NSMutableData *keyBytes = [NSMutableData new];
+    ModelCanonicalJSONWriter writer = {(__bridge CFMutableDataRef)keyBytes, NULL};
+    CFIndex *keyOffsets = malloc(sizeof(CFIndex) * (count + 1));
+    _YYModelEncodeStep *plan = calloc(count, sizeof(_YYModelEncodeStep));
+    Class cls = meta->_classInfo.cls;
+    for (NSUInteger i = 0; i < count; i++) {
+        _YYModelPropertyMeta *propertyMeta = propertyMetas[i];
+        _YYModelEncodeStep *step = plan + i;
+        step->meta = propertyMeta;
+        step->key = propertyMeta->_mappedToKey;
+        Method method = propertyMeta->_getter ? class_getInstanceMethod(cls, propertyMeta->_getter) : NULL;
+        step->getter = method ? method_getImplementation(method) : NULL;
+        step->encode = ModelEncodeFunctionForProperty(propertyMeta, step->getter);
+        step->keyGroup = (i > 0 && [plan[i - 1].key isEqualToString:step->key]) ? plan[i - 1].keyGroup : i;
+        step->isSharedKey = !propertyMeta->_mappedToKeyPath && [topKeys countForObject:step->key] > 1;
+        
+        keyOffsets[i] = keyBytes.length;
+        ModelWriteCanonicalJSONString(&writer, step->key);
+        ModelCanonicalJSONAppend(&writer, ":", 1);
+    }
+    keyOffsets[count] = keyBytes.length;
+    // the bytes do not move after all keys are appended
+    for (NSUInteger i = 0; i < count; i++) {
+        plan[i].keyBytes = (const char *)keyBytes.bytes + keyOffsets[i];
+        plan[i].keyLength = keyOffsets[i + 1] - keyOffsets[i];
+    }
+    free(keyOffsets);
+    
+    meta->_encodeKeyBytes = keyBytes;
+    meta->_encodePlan = plan;
+    meta->_encodePlanCount = count;
+}
+
+/// Format an integer as json, the buffer should have 32 bytes.
+static force_inline int ModelFormatCanonicalJSONInt64(char *buffer, int64_t value) {
+    return snprintf(buffer, 32, "%lld", (long long)value);
+}
+
+/// Format an unsigned integer as json, the buffer should have 32 bytes.
+static force_inline int ModelFormatCanonicalJSONUInt64(char *buffer, uint64_t value) {
+    return snprintf(buffer, 32, "%llu", (unsigned long long)value);
+}
+
+/// Format a finite double as json, the buffer should have 32 bytes.
+static int ModelFormatCanonicalJSONDouble(char *buffer, double d) {
+    int length = 0;
+    if (d == trunc(d) && fabs(d) < 9007199254740992.0) { // 2^53, exact integer
+        length = snprintf(buffer, 32, "%lld", (long long)d);
+    } else {
+        // the shortest representation that round-trips, in "C" locale
+        // (uselocale() is per-thread, and snprintf_l() is not available on glibc)
+        locale_t oldLocale = uselocale(YYCLocale());
+        for (int precision = 15; precision <= 17; precision++) {
+            length = snprintf(buffer, 32, "%.*g", precision, d);
+            if (strtod(buffer, NULL) == d) break;
+        }
+        uselocale(oldLocale);
+    }
+    return length;
+}
+
+/// Write a json number, the format is independent of locale.
+static void ModelWriteCanonicalJSONNumber(ModelCanonicalJSONWriter *writer, __unsafe_unretained NSNumber *number) {
+    CFNumberRef num = (__bridge CFNumberRef)number;
+    if (CFGetTypeID(num) == CFBooleanGetTypeID()) {
+        if (CFBooleanGetValue((CFBooleanRef)num)) ModelCanonicalJSONAppend(writer, "true", 4);
+        else ModelCanonicalJSONAppend(writer, "false", 5);
+        return;
+    }
+    if ([number isKindOfClass:[NSDecimalNumber class]]) {
+        if ([number isEqualToNumber:[NSDecimalNumber notANumber]]) {
+            ModelCanonicalJSONAppend(writer, "null", 4);
+        } else {
+            const char *cstring = [[(NSDecimalNumber *)number descriptionWithLocale:nil] UTF8String];
+            if (cstring) ModelCanonicalJSONAppend(writer, cstring, strlen(cstring));
+        }
+        return;
+    }
+    
+    char buffer[32];
+    int length = 0;
+    if (CFNumberIsFloatType(num)) {
+        double d = number.doubleValue;
+        if (!isfinite(d)) {
+            ModelCanonicalJSONAppend(writer, "null", 4);
+            return;
+        }
+        length = ModelFormatCanonicalJSONDouble(buffer, d);
+    } else if (strcmp(number.objCType, @encode(unsigned long long)) == 0) {
+        length = ModelFormatCanonicalJSONUInt64(buffer, number.unsignedLongLongValue);
+    } else {
+        length = ModelFormatCanonicalJSONInt64(buffer, number.longLongValue);
+    }
+    if (length > 0) ModelCanonicalJSONAppend(writer, buffer, MIN(length, (int)sizeof(buffer) - 1));
+}
+
+/**
+ Format the value of a c number property as json without boxing, the result is same
+ as the number returned by the step's encode function.
+ 
+ @param buffer Should have 32 bytes.
+ @return The length of the output, 0 if the property should be ignored (NaN or infinity),
+ or -1 if the property is not a c number with a specialized encode function.
+ */
+static int ModelFormatCanonicalJSONNumberStep(__unsafe_unretained id model, const _YYModelEncodeStep *step, char *buffer) {
+    if (step->encode == ModelEncodeGeneric || !step->meta->_isCNumber) return -1;
+    IMP getter = step->getter;
+    SEL sel = step->meta->_getter;
+    switch (step->meta->_type & YYEncodingTypeMask) {
+        case YYEncodingTypeBool: {
+            bool value = ((bool (*)(id, SEL))(void *) getter)((id)model, sel);
+            memcpy(buffer, value ? "true" : "false", value ? 4 : 5);
+            return value ? 4 : 5;
+        }
+        case YYEncodingTypeInt8:
+            return ModelFormatCanonicalJSONInt64(buffer, ((int8_t (*)(id, SEL))(void *) getter)((id)model, sel));
+        case YYEncodingTypeUInt8:
+            return ModelFormatCanonicalJSONUInt64(buffer, ((uint8_t (*)(id, SEL))(void *) getter)((id)model, sel));
+        case YYEncodingTypeInt16:
+            return ModelFormatCanonicalJSONInt64(buffer, ((int16_t (*)(id, SEL))(void *) getter)((id)model, sel));
+        case YYEncodingTypeUInt16:
+            return ModelFormatCanonicalJSONUInt64(buffer, ((uint16_t (*)(id, SEL))(void *) getter)((id)model, sel));
+        case YYEncodingTypeInt32:
+            return ModelFormatCanonicalJSONInt64(buffer, ((int32_t (*)(id, SEL))(void *) getter)((id)model, sel));
+        case YYEncodingTypeUInt32:
+            return ModelFormatCanonicalJSONUInt64(buffer, ((uint32_t (*)(id, SEL))(void *) getter)((id)model, sel));
+        case YYEncodingTypeInt64:
+            return ModelFormatCanonicalJSONInt64(buffer, ((int64_t (*)(id, SEL))(void *) getter)((id)model, sel));
+        case YYEncodingTypeUInt64:
+            return ModelFormatCanonicalJSONUInt64(buffer, ((uint64_t (*)(id, SEL))(void *) getter)((id)model, sel));
+        case YYEncodingTypeFloat: {
+            double d = ((float (*)(id, SEL))(void *) getter)((id)model, sel);
+            return isfinite(d) ? ModelFormatCanonicalJSONDouble(buffer, d) : 0;
+        }
+        case YYEncodingTypeDouble: {
+            double d = ((double (*)(id, SEL))(void *) getter)((id)model, sel);
+            return isfinite(d) ? ModelFormatCanonicalJSONDouble(buffer, d) : 0;
+        }
+        case YYEncodingTypeLongDouble: {
+            double d = ((long double (*)(id, SEL))(void *) getter)((id)model, sel);
+            return isfinite(d) ? ModelFormatCanonicalJSONDouble(buffer, d) : 0;
+        }
+        default: return -1;
+    }
+}
+
+/**
+ Format a date as the json string of `YYISODateFormatter()` (without quotes), without
+ creating the string.
+ 
+ @param buffer Should have 32 bytes.
+ @return The length of the output, or 0 if the date should be formatted by the formatter
+ (the year is out of 1900...9999, or the time zone offset is not in whole minutes).
+ */
+static int ModelFormatCanonicalJSONDate(__unsafe_unretained NSDate *date, char *buffer) {
+    NSTimeInterval interval = floor(date.timeIntervalSince1970);
+    if (!(interval >= -2208988800.0 && interval < 253402300800.0)) return 0; // 1900-01-01 ... 10000-01-01
+    NSInteger offset = [YYISODateFormatter().timeZone secondsFromGMTForDate:date];
+    if (offset % 60 != 0) return 0;
+    if (sizeof(time_t) < sizeof(int64_t) && (interval + offset > INT32_MAX || interval + offset < INT32_MIN)) return 0;
+    time_t time = (time_t)interval + (time_t)offset;
+    struct tm tm;
+    if (!gmtime_r(&time, &tm) || tm.tm_year < 0 || tm.tm_year > 8099) return 0;
+    NSInteger minutes = offset / 60;
+    char sign = minutes < 0 ? '-' : '+';
+    if (minutes < 0) minutes = -minutes;
+    return snprintf(buffer, 32, "%04d-%02d-%02dT%02d:%02d:%02d%c%02d%02d",
+                    tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday, tm.tm_hour, tm.tm_min, tm.tm_sec,
+                    sign, (int)(minutes / 60), (int)(minutes % 60));
+}
+
+/**
+ Resolve a value for the canonical json writer, the conversion is same as
+ `ModelToJSONObjectRecursive`.
+ 
+ @param value The value, can be nil.
+ @return The value (or its json object if it should be converted first),
+ nil if the value can not be converted to json.
+ */
+static id ModelCanonicalJSONResolve(__unsafe_unretained id value) {
+    if (!value || value == (id)kCFNull) return value;
+    if (object_getClass(value) == [_YYLazyURL class]) return value;
+    if ([value isKindOfClass:[NSString class]] ||
+        [value isKindOfClass:[NSNumber class]] ||
+        [value isKindOfClass:[NSDictionary class]] ||
+        [value isKindOfClass:[NSSet class]] ||
+        [value isKindOfClass:[NSArray class]] ||
+        [value isKindOfClass:[NSDate class]]) return value;
+    if ([value isKindOfClass:[NSURL class]]) {
+        return ((NSURL *)value).baseURL ? ((NSURL *)value).absoluteString : value;
+    }
+    if ([value isKindOfClass:[NSAttributedString class]] ||
+        [value isKindOfClass:[NSData class]]) {
+        id json = ModelToJSONObjectRecursive(value);
+        return [json isKindOfClass:[NSString class]] ? json : nil;
     }
-    if ([model isKindOfClass:[NSURL class]]) return ((NSURL *)model).absoluteString;
-    if ([model isKindOfClass:[NSAttributedString class]]) return ((NSAttributedString *)model).string;
-    if ([model isKindOfClass:[NSDate class]]) return [YYISODateFormatter() stringFromDate:(id)model];
-    if ([model isKindOfClass:[NSData class]]) return nil;
     
-    
-    _YYModelMeta *modelMeta = [_YYModelMeta metaWithClass:[model class]];
+    _YYModelMeta *modelMeta = [_YYModelMeta metaWithClass:[value class]];
     if (!modelMeta || modelMeta->_keyMappedCount == 0) return nil;
-    NSMutableDictionary *result = [[NSMutableDictionary alloc] initWithCapacity:64];
-    __unsafe_unretained NSMutableDictionary *dic = result; // avoid retain and release in block
-    [modelMeta->_mapper enumerateKeysAndObjectsUsingBlock:^(NSString *propertyMappedKey, _YYModelPropertyMeta *propertyMeta, BOOL *stop) {
-        if (!propertyMeta->_getter) return;
-        
-        id value = nil;
-        if (propertyMeta->_isCNumber) {
-            value = ModelCreateNumberFromProperty(model, propertyMeta);
-        } else if (propertyMeta->_nsType) {
-            id v = ((id (*)(id, SEL))(void *) objc_msgSend)((id)model, propertyMeta->_getter);
-            value = ModelToJSONObjectRecursive(v);
+    if (!modelMeta->_canonicalPropertyMetas || modelMeta->_hasCustomTransformToDictionary) {
+        id json = ModelToJSONObjectRecursive(value);
+        return [json isKindOfClass:[NSDictionary class]] ? json : nil;
+    }
+    return value;
+}
+
+/**
+ Write a canonical json value.
+ 
+ @param writer The output.
+ @param value  A resolved value, see `ModelCanonicalJSONResolve()`, should not be nil.
+ */
+static void ModelWriteCanonicalJSON(ModelCanonicalJSONWriter *writer, __unsafe_unretained id value) {
+    if (value == (id)kCFNull) {
+        ModelCanonicalJSONAppend(writer, "null", 4);
+        return;
+    }
+    if (object_getClass(value) == [_YYLazyURL class]) {
+        ModelWriteCanonicalJSONString(writer, ((_YYLazyURL *)value)->_string);
+        return;
+    }
+    if ([value isKindOfClass:[NSString class]]) {
+        ModelWriteCanonicalJSONString(writer, value);
+        return;
+    }
+    if ([value isKindOfClass:[NSNumber class]]) {
+        ModelWriteCanonicalJSONNumber(writer, value);
+        return;
+    }
+    if ([value isKindOfClass:[NSURL class]]) {
+        // without base url, the original string is the absolute string
+        ModelWriteCanonicalJSONString(writer, (__bridge NSString *)CFURLGetString((__bridge CFURLRef)value));
+        return;
+    }
+    if ([value isKindOfClass:[NSDate class]]) {
+        char buffer[32];
+        int length = ModelFormatCanonicalJSONDate(value, buffer);
+        if (length > 0 && length < (int)sizeof(buffer)) {
+            ModelCanonicalJSONAppend(writer, "\"", 1);
+            ModelCanonicalJSONAppend(writer, buffer, length);
+            ModelCanonicalJSONAppend(writer, "\"", 1);
         } else {
-            switch (propertyMeta->_type & YYEncodingTypeMask) {
-                case YYEncodingTypeObject: {
-                    id v = ((id (*)(id, SEL))(void *) objc_msgSend)((id)model, propertyMeta->_getter);
-                    value = ModelToJSONObjectRecursive(v);
-                    if (value == (id)kCFNull) value = nil;
-                } break;
-                case YYEncodingTypeClass: {
-                    Class v = ((Class (*)(id, SEL))(void *) objc_msgSend)((id)model, propertyMeta->_getter);
-                    value = v ? NSStringFromClass(v) : nil;
-                } break;
-                case YYEncodingTypeSEL: {
-                    SEL v = ((SEL (*)(id, SEL))(void *) objc_msgSend)((id)model, propertyMeta->_getter);
-                    value = v ? NSStringFromSelector(v) : nil;
-                } break;
-                default: break;
-            }
+            ModelWriteCanonicalJSONString(writer, [YYISODateFormatter() stringFromDate:value]);
         }
-        if (!value) return;
-        
-        if (propertyMeta->_mappedToKeyPath) {
-            NSMutableDictionary *superDic = dic;
-            NSMutableDictionary *subDic = nil;
-            for (NSUInteger i = 0, max = propertyMeta->_mappedToKeyPath.count; i < max; i++) {
-                NSString *key = propertyMeta->_mappedToKeyPath[i];
-                if (i + 1 == max) { // end
-                    if (!superDic[key]) superDic[key] = value;
-                    break;
-                }
-                
-                subDic = superDic[key];
-                if (subDic) {
-                    if ([subDic isKindOfClass:[NSDictionary class]]) {
-                        subDic = subDic.mutableCopy;
-                        superDic[key] = subDic;
-                    } else {
-                        break;
-                    }
-                } else {
-                    subDic = [NSMutableDictionary new];
-                    superDic[key] = subDic;
-                }
-                superDic = subDic;
-                subDic = nil;
-            }
-        } else {
-            if (!dic[propertyMeta->_mappedToKey]) {
-                dic[propertyMeta->_mappedToKey] = value;
+        return;
+    }
+    if ([value isKindOfClass:[NSDictionary class]]) {
+        NSDictionary *dic = value;
+        for (id key in dic) {
+            if (![key isKindOfClass:[NSString class]]) {
+                NSMutableDictionary *stringDic = [NSMutableDictionary new];
+                [(NSDictionary *)value enumerateKeysAndObjectsUsingBlock:^(id oneKey, id obj, BOOL *stop) {
+                    NSString *stringKey = [oneKey isKindOfClass:[NSString class]] ? oneKey : [oneKey description];
+                    if (stringKey) stringDic[stringKey] = obj;
+                }];
+                dic = stringDic;
+                break;
             }
         }
-    }];
+        NSArray *keys = [dic.allKeys sortedArrayUsingComparator:^NSComparisonResult(NSString *key1, NSString *key2) {
+            return [key1 compare:key2 options:NSLiteralSearch];
+        }];
+        ModelCanonicalJSONAppend(writer, "{", 1);
+        BOOL first = YES;
+        for (NSString *key in keys) {
+            if (!first) ModelCanonicalJSONAppend(writer, ",", 1);
+            first = NO;
+            ModelWriteCanonicalJSONString(writer, key);
+            ModelCanonicalJSONAppend(writer, ":", 1);
+            id obj = ModelCanonicalJSONResolve(dic[key]);
+            if (obj) ModelWriteCanonicalJSON(writer, obj);
+            else ModelCanonicalJSONAppend(writer, "null", 4);
+        }
+        ModelCanonicalJSONAppend(writer, "}", 1);
+        return;
+    }
+    if ([value isKindOfClass:[NSSet class]]) {
+        // sort the elements by their output
+        NSMutableArray *elements = [NSMutableArray new];
+        for (id one in (NSSet *)value) {
+            id obj = ModelCanonicalJSONResolve(one);
+            if (!obj) continue;
+            NSMutableData *element = [NSMutableData new];
+            ModelCanonicalJSONWriter elementWriter = {(__bridge CFMutableDataRef)element, NULL};
+            ModelWriteCanonicalJSON(&elementWriter, obj);
+            [elements addObject:element];
+        }
+        [elements sortUsingComparator:^NSComparisonResult(NSData *data1, NSData *data2) {
+            int result = memcmp(data1.bytes, data2.bytes, MIN(data1.length, data2.length));
+            if (result == 0) return data1.length < data2.length ? NSOrderedAscending : (data1.length > data2.length ? NSOrderedDescending : NSOrderedSame);
+            return result < 0 ? NSOrderedAscending : NSOrderedDescending;
+        }];
+        ModelCanonicalJSONAppend(writer, "[", 1);
+        for (NSUInteger i = 0, max = elements.count; i < max; i++) {
+            if (i) ModelCanonicalJSONAppend(writer, ",", 1);
+            NSData *element = elements[i];
+            ModelCanonicalJSONAppend(writer, element.bytes, element.length);
+        }
+        ModelCanonicalJSONAppend(writer, "]", 1);
+        return;
+    }
+    if ([value isKindOfClass:[NSArray class]]) {
+        ModelCanonicalJSONAppend(writer, "[", 1);
+        BOOL first = YES;
+        for (id one in (NSArray *)value) {
+            id obj = ModelCanonicalJSONResolve(one);
+            if (!obj) continue;
+            if (!first) ModelCanonicalJSONAppend(writer, ",", 1);
+            first = NO;
+            ModelWriteCanonicalJSON(writer, obj);
+        }
+        ModelCanonicalJSONAppend(writer, "]", 1);
+        return;
+    }
     
-    if (modelMeta->_hasCustomTransformToDictionary) {
-        BOOL suc = [((id<YYModel>)model) modelCustomTransformToDictionary:dic];
-        if (!suc) return nil;
+    // model with precomputed key order and escaped keys
+    _YYModelMeta *modelMeta = [_YYModelMeta metaWithClass:[value class]];
+    ModelCanonicalJSONAppend(writer, "{", 1);
+    const _YYModelEncodeStep *last = NULL;
+    for (NSUInteger i = 0, max = modelMeta->_encodePlanCount; i < max; i++) {
+        const _YYModelEncodeStep *step = modelMeta->_encodePlan + i;
+        if (last && last->keyGroup == step->keyGroup) continue;
+        char buffer[32];
+        int length = ModelFormatCanonicalJSONNumberStep(value, step, buffer);
+        if (length >= 0) {
+            if (length == 0 || length >= (int)sizeof(buffer)) continue;
+            if (last) ModelCanonicalJSONAppend(writer, ",", 1);
+            last = step;
+            ModelCanonicalJSONAppend(writer, step->keyBytes, step->keyLength);
+            ModelCanonicalJSONAppend(writer, buffer, length);
+            continue;
+        }
+        id obj = ModelCanonicalJSONResolve(step->encode(value, step, NO));
+        if (!obj || obj == (id)kCFNull) continue;
+        if (last) ModelCanonicalJSONAppend(writer, ",", 1);
+        last = step;
+        ModelCanonicalJSONAppend(writer, step->keyBytes, step->keyLength);
+        ModelWriteCanonicalJSON(writer, obj);
     }
-    return result;
+    ModelCanonicalJSONAppend(writer, "}", 1);
+}
+
+/**
+ Write the receiver as canonical json, the top level object should be an array
+ or a dictionary.
+ 
+ @return NO if the object can not be converted to json.
+ */
+static BOOL ModelWriteCanonicalJSONObject(ModelCanonicalJSONWriter *writer, __unsafe_unretained id object) {
+    id obj = ModelCanonicalJSONResolve(object);
+    if (!obj || obj == (id)kCFNull) return NO;
+    if (object_getClass(obj) == [_YYLazyURL class]) return NO;
+    if ([obj isKindOfClass:[NSString class]] || [obj isKindOfClass:[NSNumber class]] ||
+        [obj isKindOfClass:[NSURL class]] || [obj isKindOfClass:[NSDate class]]) return NO;
+    ModelWriteCanonicalJSON(writer, obj);
+    return YES;
+}
+
+id YYModelGetJSONValueForProperty(id model, _YYModelPropertyMeta *meta, BOOL convert) {
+    return ModelCreateJSONValueForProperty(model, meta, convert);
+}
+
+void YYModelAppendCanonicalJSON(NSMutableData *data, id value) {
+    ModelCanonicalJSONWriter writer = {(__bridge CFMutableDataRef)data, NULL};
+    id obj = ModelCanonicalJSONResolve(value);
+    if (obj) ModelWriteCanonicalJSON(&writer, obj);
+    else ModelCanonicalJSONAppend(&writer, "null", 4);
 }
 
 /// Add indent to string (exclude first line)
@@ -1430,6 +3369,278 @@ static NSString *ModelDescription(NSObject *model) {
 }
 
 
+static id ModelCreateDeepCopyModel(__unsafe_unretained id model, CFMutableDictionaryRef copies);
+
+/**
+ Copy a property value (or an element of a collection) for `ModelCreateDeepCopy()`.
+ 
+ @discussion Models and collections are copied recursively, mutable Foundation values
+ are copied with `mutableCopy`, and other values (immutable strings, numbers, dates...)
+ are shared.
+ 
+ @param value  The value, can be nil.
+ @param nsType The Foundation type of the property, or YYEncodingTypeNSUnknown for an element.
+ @param copies Key:original model (not retained), Value:copied model.
+ */
+static id ModelCreateDeepCopyValue(__unsafe_unretained id value, YYEncodingNSType nsType, CFMutableDictionaryRef copies) {
+    if (!value || value == (id)kCFNull) return value;
+    if ([value isKindOfClass:[NSArray class]]) {
+        NSMutableArray *array = [[NSMutableArray alloc] initWithCapacity:((NSArray *)value).count];
+        for (id one in (NSArray *)value) {
+            id copied = ModelCreateDeepCopyValue(one, YYEncodingTypeNSUnknown, copies);
+            if (copied) [array addObject:copied];
+        }
+        return nsType == YYEncodingTypeNSMutableArray ? array : array.copy;
+    }
+    if ([value isKindOfClass:[NSDictionary class]]) {
+        NSMutableDictionary *dic = [[NSMutableDictionary alloc] initWithCapacity:((NSDictionary *)value).count];
+        [((NSDictionary *)value) enumerateKeysAndObjectsUsingBlock:^(id key, id obj, BOOL *stop) {
+            id copied = ModelCreateDeepCopyValue(obj, YYEncodingTypeNSUnknown, copies);
+            if (copied) dic[key] = copied;
+        }];
+        return nsType == YYEncodingTypeNSMutableDictionary ? dic : dic.copy;
+    }
+    if ([value isKindOfClass:[NSSet class]]) {
+        NSMutableSet *set = [[NSMutableSet alloc] initWithCapacity:((NSSet *)value).count];
+        for (id one in (NSSet *)value) {
+            id copied = ModelCreateDeepCopyValue(one, YYEncodingTypeNSUnknown, copies);
+            if (copied) [set addObject:copied];
+        }
+        return nsType == YYEncodingTypeNSMutableSet ? set : set.copy;
+    }
+    if (nsType == YYEncodingTypeNSMutableString ||
+        nsType == YYEncodingTypeNSMutableData) return [value mutableCopy];
+    if (nsType != YYEncodingTypeNSUnknown) return value;
+    
+    _YYModelMeta *modelMeta = [_YYModelMeta metaWithClass:[value class]];
+    if (!modelMeta || modelMeta->_nsType) return value;
+    return ModelCreateDeepCopyModel(value, copies);
+}
+
+/**
+ Copy a model for `ModelCreateDeepCopy()`, a model which is referred more than once
+ (or refers to itself) is copied once.
+ 
+ @discussion A weak property (such as a parent) is not followed: it refers to the copy
+ of the model if the model is copied before (an ancestor), otherwise to the original model.
+ 
+ @param model  A model (not a Foundation object), should not be nil.
+ @param copies Key:original model (not retained), Value:copied model.
+ */
+static id ModelCreateDeepCopyModel(__unsafe_unretained id model, CFMutableDictionaryRef copies) {
+    id found = (__bridge id)CFDictionaryGetValue(copies, (__bridge const void *)model);
+    if (found) return found;
+    NSObject *one = [model yy_modelCopy];
+    if (!one) return nil;
+    CFDictionarySetValue(copies, (__bridge const void *)model, (__bridge const void *)one);
+    _YYModelMeta *modelMeta = [_YYModelMeta metaWithClass:[one class]];
+    for (_YYModelPropertyMeta *propertyMeta in modelMeta->_allPropertyMetas) {
+        if (!propertyMeta->_getter || !propertyMeta->_setter) continue;
+        if ((propertyMeta->_type & YYEncodingTypeMask) != YYEncodingTypeObject) continue;
+        id value = ((id (*)(id, SEL))(void *) objc_msgSend)((id)one, propertyMeta->_getter);
+        if (!value) continue;
+        id copied = nil;
+        if (propertyMeta->_type & YYEncodingTypePropertyWeak) {
+            copied = (__bridge id)CFDictionaryGetValue(copies, (__bridge const void *)value);
+            if (!copied) continue;
+        } else {
+            copied = ModelCreateDeepCopyValue(value, propertyMeta->_nsType, copies);
+        }
+        if (copied != value) {
+            ((void (*)(id, SEL, id))(void *) objc_msgSend)((id)one, propertyMeta->_setter, copied);
+        }
+    }
+    return one;
+}
+
+/**
+ Create a deep copy of a model: a `-yy_modelCopy`, with the models and collections
+ in its (strong) object properties copied recursively.
+ 
+ @param model A model (not a Foundation object), should not be nil.
+ */
+static id ModelCreateDeepCopy(__unsafe_unretained id model) {
+    CFMutableDictionaryRef copies = CFDictionaryCreateMutable(CFAllocatorGetDefault(), 0, NULL, &kCFTypeDictionaryValueCallBacks);
+    id one = ModelCreateDeepCopyModel(model, copies);
+    CFRelease(copies);
+    return one;
+}
+
+
+/// An entry in the decode cache, it's also a node of the LRU list.
+@interface _YYModelDecodeCacheNode : NSObject {
+    @package
+    __unsafe_unretained _YYModelDecodeCacheNode *_prev; // retained by dic
+    __unsafe_unretained _YYModelDecodeCacheNode *_next; // retained by dic
+    uint64_t _key;
+    Class _cls;
+    NSData *_data;
+    id _model;
+}
+@end
+
+@implementation _YYModelDecodeCacheNode
+@end
+
+
+@interface YYModelDecodeCache ()
++ (instancetype)_yy_sharedCache;
+- (id)_yy_modelForClass:(Class)cls data:(NSData *)data key:(uint64_t)key;
+- (void)_yy_setModel:(id)model forClass:(Class)cls data:(NSData *)data key:(uint64_t)key;
+@end
+
+@implementation YYModelDecodeCache {
+    CFMutableDictionaryRef _dic; ///< key:uint64_t (not retained), value:_YYModelDecodeCacheNode
+    _YYModelDecodeCacheNode *_head; ///< most recently used, retained by dic
+    _YYModelDecodeCacheNode *_tail; ///< least recently used, retained by dic
+    NSUInteger _totalCost;
+    NSUInteger _costLimit;
+    dispatch_semaphore_t _lock;
+}
+
++ (instancetype)_yy_sharedCache {
+    static YYModelDecodeCache *cache;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        cache = [self new];
+    });
+    return cache;
+}
+
+- (instancetype)init {
+    self = [super init];
+    _dic = CFDictionaryCreateMutable(CFAllocatorGetDefault(), 0, NULL, &kCFTypeDictionaryValueCallBacks);
+    _costLimit = 4 * 1024 * 1024;
+    _lock = dispatch_semaphore_create(1);
+    return self;
+}
+
+- (void)dealloc {
+    CFRelease(_dic);
+}
+
++ (NSUInteger)costLimit {
+    YYModelDecodeCache *cache = [self _yy_sharedCache];
+    dispatch_semaphore_wait(cache->_lock, DISPATCH_TIME_FOREVER);
+    NSUInteger costLimit = cache->_costLimit;
+    dispatch_semaphore_signal(cache->_lock);
+    return costLimit;
+}
+
++ (void)setCostLimit:(NSUInteger)costLimit {
+    YYModelDecodeCache *cache = [self _yy_sharedCache];
+    dispatch_semaphore_wait(cache->_lock, DISPATCH_TIME_FOREVER);
+    cache->_costLimit = costLimit;
+    [cache _yy_trim];
+    dispatch_semaphore_signal(cache->_lock);
+}
+
++ (NSUInteger)totalCost {
+    YYModelDecodeCache *cache = [self _yy_sharedCache];
+    dispatch_semaphore_wait(cache->_lock, DISPATCH_TIME_FOREVER);
+    NSUInteger totalCost = cache->_totalCost;
+    dispatch_semaphore_signal(cache->_lock);
+    return totalCost;
+}
+
++ (NSUInteger)totalCount {
+    YYModelDecodeCache *cache = [self _yy_sharedCache];
+    dispatch_semaphore_wait(cache->_lock, DISPATCH_TIME_FOREVER);
+    NSUInteger totalCount = CFDictionaryGetCount(cache->_dic);
+    dispatch_semaphore_signal(cache->_lock);
+    return totalCount;
+}
+
++ (void)removeAllObjects {
+    YYModelDecodeCache *cache = [self _yy_sharedCache];
+    dispatch_semaphore_wait(cache->_lock, DISPATCH_TIME_FOREVER);
+    cache->_head = cache->_tail = nil;
+    cache->_totalCost = 0;
+    CFDictionaryRemoveAllValues(cache->_dic);
+    dispatch_semaphore_signal(cache->_lock);
+}
+
+/// The cache key of the json bytes and the class.
+static force_inline uint64_t YYModelDecodeCacheKey(Class cls, NSData *data) {
+    YYSipHash sip;
+    YYSipHashInit(&sip, (uint64_t)(uintptr_t)(__bridge void *)cls, 0);
+    YYSipHashUpdate(&sip, data.bytes, data.length);
+    UInt8 digest[16];
+    YYSipHashFinal(&sip, digest);
+    uint64_t key;
+    memcpy(&key, digest, sizeof(key));
+    return key;
+}
+
+/// Unlink a node from the list, the caller should hold the lock.
+- (void)_yy_unlinkNode:(_YYModelDecodeCacheNode *)node {
+    if (node->_prev) node->_prev->_next = node->_next;
+    if (node->_next) node->_next->_prev = node->_prev;
+    if (_head == node) _head = node->_next;
+    if (_tail == node) _tail = node->_prev;
+    node->_prev = node->_next = nil;
+}
+
+/// Insert a node at head, the caller should hold the lock.
+- (void)_yy_insertNodeAtHead:(_YYModelDecodeCacheNode *)node {
+    node->_prev = nil;
+    node->_next = _head;
+    if (_head) _head->_prev = node;
+    _head = node;
+    if (!_tail) _tail = node;
+}
+
+/// Evict the least recently used nodes, the caller should hold the lock.
+- (void)_yy_trim {
+    while (_totalCost > _costLimit && _tail) {
+        _YYModelDecodeCacheNode *node = _tail;
+        [self _yy_unlinkNode:node];
+        _totalCost -= node->_data.length;
+        CFDictionaryRemoveValue(_dic, (const void *)(uintptr_t)node->_key);
+    }
+}
+
+- (id)_yy_modelForClass:(Class)cls data:(NSData *)data key:(uint64_t)key {
+    id model = nil;
+    dispatch_semaphore_wait(_lock, DISPATCH_TIME_FOREVER);
+    _YYModelDecodeCacheNode *node = CFDictionaryGetValue(_dic, (const void *)(uintptr_t)key);
+    if (node && node->_cls == cls && [node->_data isEqualToData:data]) {
+        if (_head != node) {
+            [self _yy_unlinkNode:node];
+            [self _yy_insertNodeAtHead:node];
+        }
+        model = node->_model;
+    }
+    dispatch_semaphore_signal(_lock);
+    return model;
+}
+
+- (void)_yy_setModel:(id)model forClass:(Class)cls data:(NSData *)data key:(uint64_t)key {
+    dispatch_semaphore_wait(_lock, DISPATCH_TIME_FOREVER);
+    if (data.length <= _costLimit) {
+        _YYModelDecodeCacheNode *node = CFDictionaryGetValue(_dic, (const void *)(uintptr_t)key);
+        if (node) { // replace the old (or colliding) entry
+            [self _yy_unlinkNode:node];
+            _totalCost -= node->_data.length;
+        } else {
+            node = [_YYModelDecodeCacheNode new];
+            node->_key = key;
+            CFDictionarySetValue(_dic, (const void *)(uintptr_t)key, (__bridge const void *)node);
+        }
+        node->_cls = cls;
+        node->_data = data;
+        node->_model = model;
+        _totalCost += data.length;
+        [self _yy_insertNodeAtHead:node];
+        [self _yy_trim];
+    }
+    dispatch_semaphore_signal(_lock);
+}
+
+@end
+
+
+
 @implementation NSObject (YYModel)
 
 + (NSDictionary *)_yy_dictionaryWithJSON:(id)json {
@@ -1451,10 +3662,36 @@ static NSString *ModelDescription(NSObject *model) {
 }
 
 + (instancetype)yy_modelWithJSON:(id)json {
+    // most classes don't implement the policy, skip the meta lookup for them
+    if ([self respondsToSelector:@selector(modelDecodeCachePolicy)] &&
+        ([json isKindOfClass:[NSString class]] || [json isKindOfClass:[NSData class]])) {
+        _YYModelMeta *modelMeta = [_YYModelMeta metaWithClass:[self class]];
+        if (modelMeta->_decodeCachePolicy != YYModelDecodeCachePolicyNone) {
+            return [self _yy_modelWithJSON:json decodeCachePolicy:modelMeta->_decodeCachePolicy];
+        }
+    }
     NSDictionary *dic = [self _yy_dictionaryWithJSON:json];
     return [self yy_modelWithDictionary:dic];
 }
 
++ (instancetype)_yy_modelWithJSON:(id)json decodeCachePolicy:(YYModelDecodeCachePolicy)policy {
+    NSData *data = [json isKindOfClass:[NSString class]] ? [(NSString *)json dataUsingEncoding:NSUTF8StringEncoding] : [json copy];
+    if (!data) return nil;
+    Class cls = [self class];
+    YYModelDecodeCache *cache = [YYModelDecodeCache _yy_sharedCache];
+    uint64_t key = YYModelDecodeCacheKey(cls, data);
+    id model = [cache _yy_modelForClass:cls data:data key:key];
+    if (model) {
+        return policy == YYModelDecodeCachePolicyCopy ? ModelCreateDeepCopy(model) : model;
+    }
+    
+    model = [self yy_modelWithDictionary:[self _yy_dictionaryWithJSON:data]];
+    if (!model) return nil;
+    // the returned model (and its nested models) may be modified by the caller if the policy is copy
+    [cache _yy_setModel:(policy == YYModelDecodeCachePolicyCopy ? ModelCreateDeepCopy(model) : model) forClass:cls data:data key:key];
+    return model;
+}
+
 + (instancetype)yy_modelWithDictionary:(NSDictionary *)dictionary {
     if (!dictionary || dictionary == (id)kCFNull) return nil;
     if (![dictionary isKindOfClass:[NSDictionary class]]) return nil;
@@ -1488,32 +3725,46 @@ static NSString *ModelDescription(NSObject *model) {
         if (![dic isKindOfClass:[NSDictionary class]]) return NO;
     }
     
+    // multi-key properties take the value of the preferred key after the traversal
+    CFIndex multiKeysCount = CFArrayGetCount((CFArrayRef)modelMeta->_multiKeysPropertyMetas);
+    ModelMultiKeysSlot stackSlots[16];
+    ModelMultiKeysSlot *slots = multiKeysCount <= 16 ? stackSlots : calloc(multiKeysCount, sizeof(ModelMultiKeysSlot));
+    for (CFIndex i = 0; i < multiKeysCount; i++) {
+        slots[i].value = nil;
+        slots[i].priority = NSUIntegerMax;
+    }
+    
     ModelSetContext context = {0};
     context.modelMeta = (__bridge void *)(modelMeta);
     context.model = (__bridge void *)(self);
     context.dictionary = (__bridge void *)(dic);
+    context.multiKeysSlots = slots;
     
     
-    if (modelMeta->_keyMappedCount >= CFDictionaryGetCount((CFDictionaryRef)dic)) {
+    CFIndex count = CFDictionaryGetCount((CFDictionaryRef)dic);
+    if (!modelMeta->_keyPlan || count == 0) {
+        // nothing to look up
+    } else if (ModelShouldIterateDictionary(modelMeta, count)) {
         CFDictionaryApplyFunction((CFDictionaryRef)dic, ModelSetWithDictionaryFunction, &context);
-        if (modelMeta->_keyPathPropertyMetas) {
-            CFArrayApplyFunction((CFArrayRef)modelMeta->_keyPathPropertyMetas,
-                                 CFRangeMake(0, CFArrayGetCount((CFArrayRef)modelMeta->_keyPathPropertyMetas)),
-                                 ModelSetWithPropertyMetaArrayFunction,
-                                 &context);
-        }
-        if (modelMeta->_multiKeysPropertyMetas) {
-            CFArrayApplyFunction((CFArrayRef)modelMeta->_multiKeysPropertyMetas,
-                                 CFRangeMake(0, CFArrayGetCount((CFArrayRef)modelMeta->_multiKeysPropertyMetas)),
-                                 ModelSetWithPropertyMetaArrayFunction,
-                                 &context);
-        }
+        ModelUpdateDecodeStatistics(modelMeta, context.hits, count);
     } else {
-        CFArrayApplyFunction((CFArrayRef)modelMeta->_allPropertyMetas,
-                             CFRangeMake(0, modelMeta->_keyMappedCount),
-                             ModelSetWithPropertyMetaArrayFunction,
-                             &context);
+        CFArrayRef roots = (__bridge CFArrayRef)modelMeta->_keyPlanRoots;
+        for (CFIndex i = 0; i < modelMeta->_keyPlanRootCount; i++) {
+            __unsafe_unretained _YYModelKeyPlanNode *node = CFArrayGetValueAtIndex(roots, i);
+            __unsafe_unretained id value = CFDictionaryGetValue((CFDictionaryRef)dic, (__bridge const void *)(node->_key));
+            if (!value) continue;
+            ModelSetWithKeyPlanNode(node, value, &context);
+            if (++context.hits == count) break; // all json keys are found
+        }
+        ModelUpdateDecodeStatistics(modelMeta, context.hits, count);
+    }
+    
+    for (CFIndex i = 0; i < multiKeysCount; i++) {
+        if (!slots[i].value) continue;
+        __unsafe_unretained _YYModelPropertyMeta *propertyMeta = CFArrayGetValueAtIndex((CFArrayRef)modelMeta->_multiKeysPropertyMetas, i);
+        if (propertyMeta->_setter) ModelSetTransformedValueForProperty(self, slots[i].value, propertyMeta);
     }
+    if (slots != stackSlots) free(slots);
     
     if (modelMeta->_hasCustomTransformFromDictionary) {
         return [((id<YYModel>)self) modelCustomTransformFromDictionary:dic];
@@ -1547,6 +3798,37 @@ static NSString *ModelDescription(NSObject *model) {
     return [[NSString alloc] initWithData:jsonData encoding:NSUTF8StringEncoding];
 }
 
+- (NSData *)yy_modelToCanonicalJSONData {
+    NSMutableData *data = [NSMutableData new];
+    ModelCanonicalJSONWriter writer = {(__bridge CFMutableDataRef)data, NULL};
+    if (!ModelWriteCanonicalJSONObject(&writer, self)) return nil;
+    return data;
+}
+
+- (NSString *)yy_modelToCanonicalJSONString {
+    NSData *jsonData = [self yy_modelToCanonicalJSONData];
+    if (jsonData.length == 0) return nil;
+    return [[NSString alloc] initWithData:jsonData encoding:NSUTF8StringEncoding];
+}
+
+- (BOOL)yy_modelGetDigest:(uint8_t *)digest {
+    if (!digest) return NO;
+    YYSipHash sip;
+    YYSipHashInit(&sip, 0x5959204d6f64656cULL, 0x2044696765737400ULL); // fixed key, "YY Model Digest"
+    ModelCanonicalJSONWriter writer = {NULL, &sip};
+    if (!ModelWriteCanonicalJSONObject(&writer, self)) return NO;
+    YYSipHashFinal(&sip, digest);
+    return YES;
+}
+
+- (NSString *)yy_modelDigestString {
+    uint8_t digest[16];
+    if (![self yy_modelGetDigest:digest]) return nil;
+    char hex[33];
+    for (int i = 0; i < 16; i++) snprintf(hex + i * 2, 3, "%02x", digest[i]);
+    return [NSString stringWithUTF8String:hex];
+}
+
 - (id)yy_modelCopy{
     if (self == (id)kCFNull) return self;
     _YYModelMeta *modelMeta = [_YYModelMeta metaWithClass:self.class];
@@ -1639,47 +3921,15 @@ static NSString *ModelDescription(NSObject *model) {
         return;
     }
     
-    for (_YYModelPropertyMeta *propertyMeta in modelMeta->_allPropertyMetas) {
-        if (!propertyMeta->_getter) return;
-        
-        if (propertyMeta->_isCNumber) {
-            NSNumber *value = ModelCreateNumberFromProperty(self, propertyMeta);
-            if (value) [aCoder encodeObject:value forKey:propertyMeta->_name];
-        } else {
-            switch (propertyMeta->_type & YYEncodingTypeMask) {
-                case YYEncodingTypeObject: {
-                    id value = ((id (*)(id, SEL))(void *)objc_msgSend)((id)self, propertyMeta->_getter);
-                    if (value && (propertyMeta->_nsType || [value respondsToSelector:@selector(encodeWithCoder:)])) {
-                        if ([value isKindOfClass:[NSValue class]]) {
-                            if ([value isKindOfClass:[NSNumber class]]) {
-                                [aCoder encodeObject:value forKey:propertyMeta->_name];
-                            }
-                        } else {
-                            [aCoder encodeObject:value forKey:propertyMeta->_name];
-                        }
-                    }
-                } break;
-                case YYEncodingTypeSEL: {
-                    SEL value = ((SEL (*)(id, SEL))(void *)objc_msgSend)((id)self, propertyMeta->_getter);
-                    if (value) {
-                        NSString *str = NSStringFromSelector(value);
-                        [aCoder encodeObject:str forKey:propertyMeta->_name];
-                    }
-                } break;
-                case YYEncodingTypeStruct:
-                case YYEncodingTypeUnion: {
-                    if (propertyMeta->_isKVCCompatible && propertyMeta->_isStructAvailableForKeyedArchiver) {
-                        @try {
-                            NSValue *value = [self valueForKey:NSStringFromSelector(propertyMeta->_getter)];
-                            [aCoder encodeObject:value forKey:propertyMeta->_name];
-                        } @catch (NSException *exception) {}
-                    }
-                } break;
-                    
-                default:
-                    break;
-            }
+    BOOL typed = NO;
+    for (NSUInteger i = 0, max = modelMeta->_coderPlanCount; i < max; i++) {
+        const _YYModelCoderStep *step = modelMeta->_coderPlan + i;
+        if (!step->encode) continue;
+        if (step->meta->_isCNumber && !typed) {
+            [aCoder encodeInt32:kYYModelCoderFormatTyped forKey:kYYModelCoderFormatKey];
+            typed = YES;
         }
+        step->encode(aCoder, self, step);
     }
 }
 
@@ -1689,43 +3939,22 @@ static NSString *ModelDescription(NSObject *model) {
     _YYModelMeta *modelMeta = [_YYModelMeta metaWithClass:self.class];
     if (modelMeta->_nsType) return self;
     
-    for (_YYModelPropertyMeta *propertyMeta in modelMeta->_allPropertyMetas) {
-        if (!propertyMeta->_setter) continue;
-        
-        if (propertyMeta->_isCNumber) {
-            NSNumber *value = [aDecoder decodeObjectForKey:propertyMeta->_name];
-            if ([value isKindOfClass:[NSNumber class]]) {
-                ModelSetNumberToProperty(self, value, propertyMeta);
-                [value class];
-            }
-        } else {
-            YYEncodingType type = propertyMeta->_type & YYEncodingTypeMask;
-            switch (type) {
-                case YYEncodingTypeObject: {
-                    id value = [aDecoder decodeObjectForKey:propertyMeta->_name];
-                    ((void (*)(id, SEL, id))(void *) objc_msgSend)((id)self, propertyMeta->_setter, value);
-                } break;
-                case YYEncodingTypeSEL: {
-                    NSString *str = [aDecoder decodeObjectForKey:propertyMeta->_name];
-                    if ([str isKindOfClass:[NSString class]]) {
-                        SEL sel = NSSelectorFromString(str);
-                        ((void (*)(id, SEL, SEL))(void *) objc_msgSend)((id)self, propertyMeta->_setter, sel);
-                    }
-                } break;
-                case YYEncodingTypeStruct:
-                case YYEncodingTypeUnion: {
-                    if (propertyMeta->_isKVCCompatible) {
-                        @try {
-                            NSValue *value = [aDecoder decodeObjectForKey:propertyMeta->_name];
-                            if (value) [self setValue:value forKey:propertyMeta->_name];
-                        } @catch (NSException *exception) {}
-                    }
-                } break;
-                    
-                default:
-                    break;
+    int32_t format = -1; // read with the first c number property
+    for (NSUInteger i = 0, max = modelMeta->_coderPlanCount; i < max; i++) {
+        const _YYModelCoderStep *step = modelMeta->_coderPlan + i;
+        if (!step->decode) continue;
+        if (step->meta->_isCNumber) {
+            if (format < 0) format = [aDecoder decodeInt32ForKey:kYYModelCoderFormatKey];
+            if (format < kYYModelCoderFormatTyped) {
+                NSNumber *value = [aDecoder decodeObjectForKey:step->key];
+                if ([value isKindOfClass:[NSNumber class]]) {
+                    ModelSetNumberToProperty(self, value, step->meta);
+                    [value class];
+                }
+                continue;
             }
         }
+        step->decode(aDecoder, self, step);
     }
     return self;
 }
@@ -1795,11 +4024,14 @@ static NSString *ModelDescription(NSObject *model) {
 + (NSArray *)yy_modelArrayWithClass:(Class)cls array:(NSArray *)arr {
     if (!cls || !arr) return nil;
     NSMutableArray *result = [NSMutableArray new];
-    for (NSDictionary *dic in arr) {
-        if (![dic isKindOfClass:[NSDictionary class]]) continue;
+    _YYModelMeta *modelMeta = [_YYModelMeta metaWithClass:cls];
+    NSUInteger batchSize = modelMeta ? modelMeta->_autoreleaseBatchSize : 0;
+    YYModelForEachInBatches(arr.count, batchSize, ^(NSUInteger idx) {
+        NSDictionary *dic = arr[idx];
+        if (![dic isKindOfClass:[NSDictionary class]]) return;
         NSObject *obj = [cls yy_modelWithDictionary:dic];
         if (obj) [result addObject:obj];
-    }
+    });
     return result;
 }
 
@@ -1829,11 +4061,15 @@ static NSString *ModelDescription(NSObject *model) {
 + (NSDictionary *)yy_modelDictionaryWithClass:(Class)cls dictionary:(NSDictionary *)dic {
     if (!cls || !dic) return nil;
     NSMutableDictionary *result = [NSMutableDictionary new];
-    for (NSString *key in dic.allKeys) {
-        if (![key isKindOfClass:[NSString class]]) continue;
+    _YYModelMeta *modelMeta = [_YYModelMeta metaWithClass:cls];
+    NSUInteger batchSize = modelMeta ? modelMeta->_autoreleaseBatchSize : 0;
+    NSArray *keys = dic.allKeys;
+    YYModelForEachInBatches(keys.count, batchSize, ^(NSUInteger idx) {
+        NSString *key = keys[idx];
+        if (![key isKindOfClass:[NSString class]]) return;
         NSObject *obj = [cls yy_modelWithDictionary:dic[key]];
         if (obj) result[key] = obj;
-    }
+    });
     return result;
 }
 
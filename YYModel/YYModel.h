@@ -16,7 +16,21 @@ FOUNDATION_EXPORT double YYModelVersionNumber;
 FOUNDATION_EXPORT const unsigned char YYModelVersionString[];
 #import <YYModel/NSObject+YYModel.h>
 #import <YYModel/YYClassInfo.h>
+#import <YYModel/YYModelColumnarBatch.h>
+#import <YYModel/YYModelArrow.h>
+#import <YYModel/YYModelCSV.h>
+#import <YYModel/YYModelBinaryPlist.h>
+#import <YYModel/YYModelSQLite.h>
+#import <YYModel/YYModelFootprint.h>
+#import <YYModel/YYModelReconcile.h>
 #else
 #import "NSObject+YYModel.h"
 #import "YYClassInfo.h"
+#import "YYModelColumnarBatch.h"
+#import "YYModelArrow.h"
+#import "YYModelCSV.h"
+#import "YYModelBinaryPlist.h"
+#import "YYModelSQLite.h"
+#import "YYModelFootprint.h"
+#import "YYModelReconcile.h"
 #endif
@@ -0,0 +1,206 @@
+//
+//  YYModelArrow.h
+//  YYModel <https://github.com/ibireme/YYModel>
+//
+//  This source code is licensed under the MIT-style license found in the
+//  LICENSE file in the root directory of this source tree.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ Arrow IPC format.
+ */
+typedef NS_ENUM (NSUInteger, YYModelArrowFormat) {
+    YYModelArrowFormatStream = 0, ///< IPC streaming format (schema, record batches, end-of-stream marker).
+    YYModelArrowFormatFile,       ///< IPC file format ("ARROW1" magic, stream and footer), for random access.
+};
+
+/**
+ Arrow data type of a column.
+ */
+typedef NS_ENUM (NSUInteger, YYModelArrowType) {
+    YYModelArrowTypeUnknown = 0, ///< A type not supported by YYModel, the buffers are not exposed.
+    YYModelArrowTypeBool,        ///< bit-packed values.
+    YYModelArrowTypeInt8,
+    YYModelArrowTypeInt16,
+    YYModelArrowTypeInt32,
+    YYModelArrowTypeInt64,
+    YYModelArrowTypeUInt8,
+    YYModelArrowTypeUInt16,
+    YYModelArrowTypeUInt32,
+    YYModelArrowTypeUInt64,
+    YYModelArrowTypeFloat,
+    YYModelArrowTypeDouble,
+    YYModelArrowTypeUtf8,        ///< int32 offsets and UTF-8 bytes.
+    YYModelArrowTypeBinary,      ///< int32 offsets and bytes.
+    YYModelArrowTypeTimestamp,   ///< int64 values since 1970, in `timeUnit`.
+    YYModelArrowTypeStruct,      ///< no values, see `children`.
+    YYModelArrowTypeList,        ///< int32 offsets into the only child.
+};
+
+/**
+ Arrow time unit of a timestamp column.
+ */
+typedef NS_ENUM (NSUInteger, YYModelArrowTimeUnit) {
+    YYModelArrowTimeUnitSecond = 0,
+    YYModelArrowTimeUnitMillisecond,
+    YYModelArrowTimeUnitMicrosecond,
+    YYModelArrowTimeUnitNanosecond,
+};
+
+
+/**
+ Writes arrays of model into Arrow IPC data, and reads them back.
+
+ @discussion The schema is derived from the model class's properties (sorted by name):
+
+     bool                                        -> Bool
+     int8/16/32/64, uint8/16/32/64               -> Int (same bit width and sign)
+     float                                       -> FloatingPoint (single)
+     double, long double, NSNumber, NSDecimalNumber -> FloatingPoint (double)
+     NSString, NSMutableString, NSURL            -> Utf8
+     NSData, NSMutableData                       -> Binary
+     NSDate                                      -> Timestamp (microsecond, UTC)
+     NSArray with generic class                  -> List (of Struct, Utf8, Double, Timestamp or Binary)
+     other model object                          -> Struct (of the model's properties)
+
+ Properties of other types (containers without generic class, structs, blocks...) and
+ nested models which refer back to a class being converted are not written. All rows
+ are written in one record batch. The model's custom transform methods are not called.
+ */
+@interface YYModelArrow : NSObject
+
+/**
+ Creates Arrow IPC data from an array of model. This method is thread-safe.
+
+ @param models  An array of `cls` instances, other objects are ignored.
+ @param cls     The model class.
+ @param format  The IPC format.
+ @return The data, or nil if an error occurs (such as the class has no supported property).
+ */
++ (nullable NSData *)dataWithModels:(NSArray *)models class:(Class)cls format:(YYModelArrowFormat)format;
+
+/**
+ Writes an array of model to a file in Arrow IPC file format. This method is thread-safe.
+
+ @return Whether succeed.
+ */
++ (BOOL)writeModels:(NSArray *)models class:(Class)cls toFile:(NSString *)path;
+
+/**
+ Creates an array of model from Arrow IPC data (stream or file format). This method is thread-safe.
+
+ @discussion The columns are matched to the properties by name, a column whose type can
+ not be set to the property is ignored.
+
+ @return An array of `cls` instances, or nil if the data is invalid.
+ */
++ (nullable NSArray *)modelsWithClass:(Class)cls data:(NSData *)data;
+
+/**
+ Creates an array of model from an Arrow IPC file, the file is memory-mapped.
+ This method is thread-safe.
+ */
++ (nullable NSArray *)modelsWithClass:(Class)cls file:(NSString *)path;
+
+@end
+
+
+/**
+ A column of a record batch in Arrow IPC data. The buffers point into the data of
+ the reader (the mapped file) without copying, and stay valid while the column is alive.
+ */
+@interface YYModelArrowColumn : NSObject
+
+/// The field name.
+@property (nonatomic, strong, readonly) NSString *name;
+
+/// The data type.
+@property (nonatomic, assign, readonly) YYModelArrowType type;
+
+/// The time unit of a timestamp column.
+@property (nonatomic, assign, readonly) YYModelArrowTimeUnit timeUnit;
+
+/// The number of rows.
+@property (nonatomic, assign, readonly) NSUInteger length;
+
+/// The number of null rows.
+@property (nonatomic, assign, readonly) NSUInteger nullCount;
+
+/// The validity bitmap (LSB first), NULL if there's no null.
+@property (nullable, nonatomic, assign, readonly) const uint8_t *validity NS_RETURNS_INNER_POINTER;
+
+/// The values of a fixed-width column (a bitmap for bool), or NULL.
+@property (nullable, nonatomic, assign, readonly) const void *values NS_RETURNS_INNER_POINTER;
+
+/// The `length + 1` offsets of a utf8, binary or list column, or NULL.
+@property (nullable, nonatomic, assign, readonly) const int32_t *offsets NS_RETURNS_INNER_POINTER;
+
+/// The bytes of a utf8 or binary column, or NULL.
+@property (nullable, nonatomic, assign, readonly) const uint8_t *bytes NS_RETURNS_INNER_POINTER;
+
+/// The length of `bytes`.
+@property (nonatomic, assign, readonly) NSUInteger byteLength;
+
+/// The child columns of a struct or list column.
+@property (nonatomic, strong, readonly) NSArray<YYModelArrowColumn *> *children;
+
+/// Whether the value at index is null (or the index is out of bounds).
+- (BOOL)isNullAtIndex:(NSUInteger)index;
+
+/// The value at index of a bool, int, float or timestamp column converted to int64_t, or 0.
+- (int64_t)int64AtIndex:(NSUInteger)index;
+
+/// The value at index of a bool, int, float or timestamp column converted to double, or 0.
+- (double)doubleAtIndex:(NSUInteger)index;
+
+/// The string at index of a utf8 column, or nil.
+- (nullable NSString *)stringAtIndex:(NSUInteger)index;
+
+/// A copy of the bytes at index of a binary or utf8 column, or nil.
+- (nullable NSData *)dataAtIndex:(NSUInteger)index;
+
+/// The date at index of a timestamp column, or nil.
+- (nullable NSDate *)dateAtIndex:(NSUInteger)index;
+
+@end
+
+
+/**
+ Reader of Arrow IPC data (stream or file format), it provides zero-copy access to
+ the columns of each record batch. This class is thread-safe.
+
+ @discussion Dictionary-encoded fields and compressed record batches are not supported.
+ */
+@interface YYModelArrowReader : NSObject
+
+/// Creates a reader, returns nil if the data is not valid Arrow IPC data.
++ (nullable instancetype)readerWithData:(NSData *)data;
+
+/// Creates a reader with a memory-mapped file, returns nil if the file is not valid Arrow IPC data.
++ (nullable instancetype)readerWithFile:(NSString *)path;
+
+/// The top-level field names of the schema.
+@property (nonatomic, strong, readonly) NSArray<NSString *> *fieldNames;
+
+/// The number of record batches.
+@property (nonatomic, assign, readonly) NSUInteger recordBatchCount;
+
+/// The number of rows in all record batches.
+@property (nonatomic, assign, readonly) NSUInteger length;
+
+/// The top-level columns of a record batch, or nil if the record batch is invalid.
+- (nullable NSArray<YYModelArrowColumn *> *)columnsInRecordBatch:(NSUInteger)index;
+
+/// The top-level column with the field name in a record batch, or nil.
+- (nullable YYModelArrowColumn *)columnWithName:(NSString *)name inRecordBatch:(NSUInteger)index;
+
+/// Creates models of all record batches, or nil if some record batch is invalid.
+- (nullable NSArray *)modelsWithClass:(Class)cls;
+
+@end
+
+NS_ASSUME_NONNULL_END
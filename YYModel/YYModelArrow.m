@@ -0,0 +1,1580 @@
+//
+//  YYModelArrow.m
+//  YYModel <https://github.com/ibireme/YYModel>
+//
+//  This source code is licensed under the MIT-style license found in the
+//  LICENSE file in the root directory of this source tree.
+//
+
+#import "YYModelArrow.h"
+#import "YYModelMeta.h"
+#import <objc/message.h>
+
+#define force_inline __inline__ __attribute__((always_inline))
+
+/*
+ Arrow IPC is little-endian (as all the Apple platforms), so the values are copied as is.
+ The metadata is flatbuffers, see Schema.fbs, Message.fbs and File.fbs in the Arrow format.
+ */
+
+/// MetadataVersion.V5
+#define kYYArrowMetadataVersion 4
+/// MetadataVersion.V4, the oldest version which can be read.
+#define kYYArrowMetadataVersionMin 3
+/// Alignment of the messages and the buffers in a message body.
+#define kYYArrowAlignment 8
+/// Max nesting depth of struct and list.
+#define kYYArrowMaxDepth 64
+
+/// Type union of Field.
+typedef NS_ENUM (uint8_t, YYArrowTypeId) {
+    YYArrowTypeIdNull = 1,
+    YYArrowTypeIdInt = 2,
+    YYArrowTypeIdFloatingPoint = 3,
+    YYArrowTypeIdBinary = 4,
+    YYArrowTypeIdUtf8 = 5,
+    YYArrowTypeIdBool = 6,
+    YYArrowTypeIdDecimal = 7,
+    YYArrowTypeIdDate = 8,
+    YYArrowTypeIdTime = 9,
+    YYArrowTypeIdTimestamp = 10,
+    YYArrowTypeIdInterval = 11,
+    YYArrowTypeIdList = 12,
+    YYArrowTypeIdStruct = 13,
+    YYArrowTypeIdUnion = 14,
+    YYArrowTypeIdFixedSizeBinary = 15,
+    YYArrowTypeIdFixedSizeList = 16,
+    YYArrowTypeIdMap = 17,
+    YYArrowTypeIdDuration = 18,
+    YYArrowTypeIdLargeBinary = 19,
+    YYArrowTypeIdLargeUtf8 = 20,
+    YYArrowTypeIdLargeList = 21,
+};
+
+/// Header union of Message.
+typedef NS_ENUM (uint8_t, YYArrowMessageType) {
+    YYArrowMessageTypeSchema = 1,
+    YYArrowMessageTypeDictionaryBatch = 2,
+    YYArrowMessageTypeRecordBatch = 3,
+};
+
+/// struct FieldNode
+typedef struct {
+    int64_t length;
+    int64_t nullCount;
+} YYArrowFieldNode;
+
+/// struct Buffer
+typedef struct {
+    int64_t offset;
+    int64_t length;
+} YYArrowBuffer;
+
+/// struct Block
+typedef struct {
+    int64_t offset;
+    int32_t metaDataLength;
+    int32_t padding;
+    int64_t bodyLength;
+} YYArrowBlock;
+
+static const uint8_t YYArrowMagic[8] = {'A', 'R', 'R', 'O', 'W', '1', 0, 0};
+static const uint8_t YYArrowZeros[kYYArrowAlignment] = {0};
+
+static force_inline uint16_t YYArrowReadUInt16(const uint8_t *p) { uint16_t v; memcpy(&v, p, 2); return v; }
+static force_inline uint32_t YYArrowReadUInt32(const uint8_t *p) { uint32_t v; memcpy(&v, p, 4); return v; }
+static force_inline int64_t YYArrowReadInt64(const uint8_t *p) { int64_t v; memcpy(&v, p, 8); return v; }
+
+/// Get the bit width of an int type, 0 if it's not int.
+static force_inline int YYArrowTypeGetIntWidth(YYModelArrowType type, BOOL *isSigned) {
+    if (isSigned) *isSigned = (type >= YYModelArrowTypeInt8 && type <= YYModelArrowTypeInt64);
+    switch (type) {
+        case YYModelArrowTypeInt8: case YYModelArrowTypeUInt8: return 8;
+        case YYModelArrowTypeInt16: case YYModelArrowTypeUInt16: return 16;
+        case YYModelArrowTypeInt32: case YYModelArrowTypeUInt32: return 32;
+        case YYModelArrowTypeInt64: case YYModelArrowTypeUInt64: return 64;
+        default: return 0;
+    }
+}
+
+/// Get the byte width of a fixed-width value, 0 for other types (and bool).
+static force_inline size_t YYArrowTypeGetWidth(YYModelArrowType type) {
+    switch (type) {
+        case YYModelArrowTypeFloat: return 4;
+        case YYModelArrowTypeDouble: case YYModelArrowTypeTimestamp: return 8;
+        default: return YYArrowTypeGetIntWidth(type, NULL) / 8;
+    }
+}
+
+/// Whether the type has number values.
+static force_inline BOOL YYArrowTypeIsNumber(YYModelArrowType type) {
+    return (type >= YYModelArrowTypeBool && type <= YYModelArrowTypeDouble) || type == YYModelArrowTypeTimestamp;
+}
+
+
+
+#pragma mark - Flatbuffers Builder
+
+/**
+ A minimal flatbuffers builder. Like the official one, the buffer is built back to
+ front, so an object is always written before the objects which refer to it, and an
+ offset is the distance from the end of the buffer.
+ */
+typedef struct {
+    uint8_t *buf;         ///< the data is in [buf + cap - used, buf + cap)
+    size_t cap;
+    size_t used;
+    size_t minAlign;
+    size_t tableStart;
+    uint32_t fields[8];   ///< offsets of the fields of the current table, 0 if absent
+    int fieldCount;
+} YYFlatBuilder;
+
+static void YYFlatBuilderRelease(YYFlatBuilder *b) {
+    free(b->buf);
+    memset(b, 0, sizeof(YYFlatBuilder));
+}
+
+static void YYFlatBuilderReserve(YYFlatBuilder *b, size_t size) {
+    if (b->cap - b->used >= size) return;
+    size_t cap = b->cap ? b->cap * 2 : 256;
+    while (cap - b->used < size) cap *= 2;
+    uint8_t *buf = malloc(cap);
+    if (b->used) memcpy(buf + cap - b->used, b->buf + b->cap - b->used, b->used);
+    free(b->buf);
+    b->buf = buf;
+    b->cap = cap;
+}
+
+static void YYFlatBuilderPush(YYFlatBuilder *b, const void *bytes, size_t size) {
+    YYFlatBuilderReserve(b, size);
+    b->used += size;
+    if (size) memcpy(b->buf + b->cap - b->used, bytes, size);
+}
+
+static void YYFlatBuilderPad(YYFlatBuilder *b, size_t size) {
+    YYFlatBuilderReserve(b, size);
+    b->used += size;
+    if (size) memset(b->buf + b->cap - b->used, 0, size);
+}
+
+/// Pad so that the next `extra` bytes end at a multiple of `align`.
+static void YYFlatBuilderAlign(YYFlatBuilder *b, size_t align, size_t extra) {
+    if (align > b->minAlign) b->minAlign = align;
+    YYFlatBuilderPad(b, (~(b->used + extra) + 1) & (align - 1));
+}
+
+static void YYFlatBuilderPushScalar(YYFlatBuilder *b, const void *value, size_t size) {
+    YYFlatBuilderAlign(b, size, 0);
+    YYFlatBuilderPush(b, value, size);
+}
+
+static void YYFlatBuilderPushOffset(YYFlatBuilder *b, uint32_t ref) {
+    YYFlatBuilderAlign(b, 4, 0);
+    uint32_t offset = (uint32_t)(b->used + 4 - ref);
+    YYFlatBuilderPush(b, &offset, 4);
+}
+
+static void YYFlatBuilderStartTable(YYFlatBuilder *b) {
+    memset(b->fields, 0, sizeof(b->fields));
+    b->fieldCount = 0;
+    b->tableStart = b->used;
+}
+
+static void YYFlatBuilderAddField(YYFlatBuilder *b, int field) {
+    b->fields[field] = (uint32_t)b->used;
+    if (field >= b->fieldCount) b->fieldCount = field + 1;
+}
+
+static void YYFlatBuilderAddScalar(YYFlatBuilder *b, int field, const void *value, size_t size) {
+    YYFlatBuilderPushScalar(b, value, size);
+    YYFlatBuilderAddField(b, field);
+}
+
+#define YYFlatBuilderAdd(b, field, type, value) do { \
+    type _v = (type)(value); YYFlatBuilderAddScalar(b, field, &_v, sizeof(type)); \
+} while (0)
+
+static void YYFlatBuilderAddOffset(YYFlatBuilder *b, int field, uint32_t ref) {
+    if (!ref) return;
+    YYFlatBuilderPushOffset(b, ref);
+    YYFlatBuilderAddField(b, field);
+}
+
+static uint32_t YYFlatBuilderEndTable(YYFlatBuilder *b) {
+    int32_t vtableOffset = 0;
+    YYFlatBuilderPushScalar(b, &vtableOffset, 4);
+    size_t table = b->used;
+    for (int i = b->fieldCount - 1; i >= 0; i--) {
+        uint16_t offset = b->fields[i] ? (uint16_t)(table - b->fields[i]) : 0;
+        YYFlatBuilderPush(b, &offset, 2);
+    }
+    uint16_t tableSize = (uint16_t)(table - b->tableStart);
+    uint16_t vtableSize = (uint16_t)(4 + 2 * b->fieldCount);
+    YYFlatBuilderPush(b, &tableSize, 2);
+    YYFlatBuilderPush(b, &vtableSize, 2);
+    vtableOffset = (int32_t)(b->used - table); // the vtable is placed before the table
+    memcpy(b->buf + b->cap - table, &vtableOffset, 4);
+    return (uint32_t)table;
+}
+
+static uint32_t YYFlatBuilderCreateString(YYFlatBuilder *b, NSString *string) {
+    NSData *data = [string dataUsingEncoding:NSUTF8StringEncoding];
+    YYFlatBuilderAlign(b, 4, data.length + 1);
+    YYFlatBuilderPad(b, 1);
+    YYFlatBuilderPush(b, data.bytes, data.length);
+    uint32_t length = (uint32_t)data.length;
+    YYFlatBuilderPush(b, &length, 4);
+    return (uint32_t)b->used;
+}
+
+static uint32_t YYFlatBuilderCreateOffsetVector(YYFlatBuilder *b, const uint32_t *refs, NSUInteger count) {
+    YYFlatBuilderAlign(b, 4, count * 4);
+    for (NSUInteger i = count; i > 0; i--) YYFlatBuilderPushOffset(b, refs[i - 1]);
+    uint32_t length = (uint32_t)count;
+    YYFlatBuilderPush(b, &length, 4);
+    return (uint32_t)b->used;
+}
+
+/// Creates a vector of structs with 8-byte alignment.
+static uint32_t YYFlatBuilderCreateStructVector(YYFlatBuilder *b, const void *bytes, size_t size, NSUInteger count) {
+    YYFlatBuilderAlign(b, 8, size * count);
+    YYFlatBuilderPush(b, bytes, size * count);
+    uint32_t length = (uint32_t)count;
+    YYFlatBuilderPush(b, &length, 4);
+    return (uint32_t)b->used;
+}
+
+static void YYFlatBuilderFinish(YYFlatBuilder *b, uint32_t root) {
+    YYFlatBuilderAlign(b, b->minAlign, 4);
+    YYFlatBuilderPushOffset(b, root);
+}
+
+
+
+#pragma mark - Flatbuffers Reader
+
+/// A flatbuffers table, all accesses are checked with the bounds of the buffer.
+typedef struct {
+    const uint8_t *base;
+    size_t size;
+    size_t pos;
+    size_t vtable;
+    uint16_t vtableSize;
+    uint16_t tableSize;
+} YYFlatTable;
+
+static BOOL YYFlatTableInit(YYFlatTable *t, const uint8_t *base, size_t size, size_t pos) {
+    if (size < 4 || pos > size - 4) return NO;
+    int64_t vtable = (int64_t)pos - (int32_t)YYArrowReadUInt32(base + pos);
+    if (vtable < 0 || (uint64_t)vtable > size - 4) return NO;
+    uint16_t vtableSize = YYArrowReadUInt16(base + vtable);
+    uint16_t tableSize = YYArrowReadUInt16(base + vtable + 2);
+    if (vtableSize < 4 || vtableSize > size - vtable || tableSize < 4 || tableSize > size - pos) return NO;
+    t->base = base;
+    t->size = size;
+    t->pos = pos;
+    t->vtable = (size_t)vtable;
+    t->vtableSize = vtableSize;
+    t->tableSize = tableSize;
+    return YES;
+}
+
+/// Returns the position of a field with `length` bytes, or 0 if the field is absent.
+static size_t YYFlatTableField(const YYFlatTable *t, int field, size_t length) {
+    size_t entry = 4 + 2 * (size_t)field;
+    if (entry + 2 > t->vtableSize) return 0;
+    uint16_t offset = YYArrowReadUInt16(t->base + t->vtable + entry);
+    if (!offset || offset + length > t->tableSize) return 0;
+    return t->pos + offset;
+}
+
+static uint8_t YYFlatTableGetUInt8(const YYFlatTable *t, int field, uint8_t def) {
+    size_t pos = YYFlatTableField(t, field, 1);
+    return pos ? t->base[pos] : def;
+}
+
+static int16_t YYFlatTableGetInt16(const YYFlatTable *t, int field, int16_t def) {
+    size_t pos = YYFlatTableField(t, field, 2);
+    return pos ? (int16_t)YYArrowReadUInt16(t->base + pos) : def;
+}
+
+static int32_t YYFlatTableGetInt32(const YYFlatTable *t, int field, int32_t def) {
+    size_t pos = YYFlatTableField(t, field, 4);
+    return pos ? (int32_t)YYArrowReadUInt32(t->base + pos) : def;
+}
+
+static int64_t YYFlatTableGetInt64(const YYFlatTable *t, int field, int64_t def) {
+    size_t pos = YYFlatTableField(t, field, 8);
+    return pos ? YYArrowReadInt64(t->base + pos) : def;
+}
+
+/// Get the position an offset field refers to, returns NO if the field is absent or invalid.
+static BOOL YYFlatTableGetOffset(const YYFlatTable *t, int field, size_t *target) {
+    size_t pos = YYFlatTableField(t, field, 4);
+    if (!pos) return NO;
+    uint32_t offset = YYArrowReadUInt32(t->base + pos);
+    if (offset >= t->size - pos) return NO;
+    *target = pos + offset;
+    return YES;
+}
+
+static BOOL YYFlatTableGetTable(const YYFlatTable *t, int field, YYFlatTable *table) {
+    size_t pos;
+    if (!YYFlatTableGetOffset(t, field, &pos)) return NO;
+    return YYFlatTableInit(table, t->base, t->size, pos);
+}
+
+/// Get a vector, an absent vector is empty. Returns NO if the vector is invalid.
+static BOOL YYFlatTableGetVector(const YYFlatTable *t, int field, size_t elementSize, size_t *start, size_t *count) {
+    *start = 0;
+    *count = 0;
+    if (!YYFlatTableField(t, field, 4)) return YES;
+    size_t pos;
+    if (!YYFlatTableGetOffset(t, field, &pos) || pos > t->size - 4) return NO;
+    size_t length = YYArrowReadUInt32(t->base + pos);
+    if (length > (t->size - pos - 4) / elementSize) return NO;
+    *start = pos + 4;
+    *count = length;
+    return YES;
+}
+
+/// Get a table in a vector of tables.
+static BOOL YYFlatTableGetVectorTable(const YYFlatTable *t, size_t element, YYFlatTable *table) {
+    uint32_t offset = YYArrowReadUInt32(t->base + element);
+    if (offset >= t->size - element) return NO;
+    return YYFlatTableInit(table, t->base, t->size, element + offset);
+}
+
+static NSString *YYFlatTableGetString(const YYFlatTable *t, int field) {
+    size_t start, count;
+    if (!YYFlatTableGetVector(t, field, 1, &start, &count) || !start) return nil;
+    return [[NSString alloc] initWithBytes:t->base + start length:count encoding:NSUTF8StringEncoding];
+}
+
+
+
+#pragma mark - Schema
+
+/// A field of the schema written from a model class.
+@interface _YYModelArrowField : NSObject {
+    @package
+    NSString *_name;
+    _YYModelPropertyMeta *_meta; ///< property meta, nil for list item
+    YYModelArrowType _type;
+    Class _cls;                  ///< model class of struct
+    NSArray *_children;          ///< Array<_YYModelArrowField>
+}
+@end
+
+@implementation _YYModelArrowField
+@end
+
+
+/// A field of the schema read from Arrow data.
+@interface _YYModelArrowSchemaField : NSObject {
+    @package
+    NSString *_name;
+    YYModelArrowType _type;
+    YYModelArrowTimeUnit _timeUnit;
+    NSUInteger _bufferCount;
+    NSArray *_children;          ///< Array<_YYModelArrowSchemaField>
+}
+@end
+
+@implementation _YYModelArrowSchemaField
+@end
+
+
+static NSArray *YYArrowFieldsForClass(Class cls, NSMutableSet *classes);
+
+/// Creates a field for the objects of a class (a list item, or a nested model).
+static _YYModelArrowField *YYArrowFieldForClass(Class cls, NSMutableSet *classes) {
+    if (!cls) return nil;
+    _YYModelArrowField *field = [_YYModelArrowField new];
+    field->_name = @"item";
+    field->_cls = cls;
+    if ([cls isSubclassOfClass:[NSString class]] || [cls isSubclassOfClass:[NSURL class]]) {
+        field->_type = YYModelArrowTypeUtf8;
+    } else if ([cls isSubclassOfClass:[NSNumber class]]) {
+        field->_type = YYModelArrowTypeDouble;
+    } else if ([cls isSubclassOfClass:[NSDate class]]) {
+        field->_type = YYModelArrowTypeTimestamp;
+    } else if ([cls isSubclassOfClass:[NSData class]]) {
+        field->_type = YYModelArrowTypeBinary;
+    } else if ([cls isSubclassOfClass:[NSValue class]] ||
+               [cls isSubclassOfClass:[NSArray class]] ||
+               [cls isSubclassOfClass:[NSDictionary class]] ||
+               [cls isSubclassOfClass:[NSSet class]]) {
+        return nil;
+    } else {
+        if ([classes containsObject:cls]) return nil; // recursive model
+        field->_type = YYModelArrowTypeStruct;
+        field->_children = YYArrowFieldsForClass(cls, classes);
+        if (!field->_children.count) return nil;
+    }
+    return field;
+}
+
+/// Creates a field for a property, or nil if the property is not supported.
+static _YYModelArrowField *YYArrowFieldForProperty(_YYModelPropertyMeta *meta, NSMutableSet *classes) {
+    _YYModelArrowField *field = nil;
+    if (meta->_isCNumber) {
+        field = [_YYModelArrowField new];
+        switch (meta->_type & YYEncodingTypeMask) {
+            case YYEncodingTypeBool: field->_type = YYModelArrowTypeBool; break;
+            case YYEncodingTypeInt8: field->_type = YYModelArrowTypeInt8; break;
+            case YYEncodingTypeUInt8: field->_type = YYModelArrowTypeUInt8; break;
+            case YYEncodingTypeInt16: field->_type = YYModelArrowTypeInt16; break;
+            case YYEncodingTypeUInt16: field->_type = YYModelArrowTypeUInt16; break;
+            case YYEncodingTypeInt32: field->_type = YYModelArrowTypeInt32; break;
+            case YYEncodingTypeUInt32: field->_type = YYModelArrowTypeUInt32; break;
+            case YYEncodingTypeInt64: field->_type = YYModelArrowTypeInt64; break;
+            case YYEncodingTypeUInt64: field->_type = YYModelArrowTypeUInt64; break;
+            case YYEncodingTypeFloat: field->_type = YYModelArrowTypeFloat; break;
+            case YYEncodingTypeDouble:
+            case YYEncodingTypeLongDouble: field->_type = YYModelArrowTypeDouble; break;
+            default: return nil;
+        }
+    } else {
+        switch (meta->_nsType) {
+            case YYEncodingTypeNSString:
+            case YYEncodingTypeNSMutableString:
+            case YYEncodingTypeNSURL: {
+                field = [_YYModelArrowField new];
+                field->_type = YYModelArrowTypeUtf8;
+            } break;
+            case YYEncodingTypeNSNumber:
+            case YYEncodingTypeNSDecimalNumber: {
+                field = [_YYModelArrowField new];
+                field->_type = YYModelArrowTypeDouble;
+            } break;
+            case YYEncodingTypeNSData:
+            case YYEncodingTypeNSMutableData: {
+                field = [_YYModelArrowField new];
+                field->_type = YYModelArrowTypeBinary;
+            } break;
+            case YYEncodingTypeNSDate: {
+                field = [_YYModelArrowField new];
+                field->_type = YYModelArrowTypeTimestamp;
+            } break;
+            case YYEncodingTypeNSArray:
+            case YYEncodingTypeNSMutableArray: {
+                _YYModelArrowField *item = YYArrowFieldForClass(meta->_genericCls, classes);
+                if (!item) return nil;
+                field = [_YYModelArrowField new];
+                field->_type = YYModelArrowTypeList;
+                field->_children = @[item];
+            } break;
+            case YYEncodingTypeNSUnknown: {
+                if ((meta->_type & YYEncodingTypeMask) != YYEncodingTypeObject || !meta->_cls) return nil;
+                field = YYArrowFieldForClass(meta->_cls, classes);
+                if (!field || field->_type != YYModelArrowTypeStruct) return nil;
+            } break;
+            default: return nil;
+        }
+    }
+    field->_name = meta->_name;
+    field->_meta = meta;
+    return field;
+}
+
+/// Creates the fields of a model class (sorted by name).
+static NSArray *YYArrowFieldsForClass(Class cls, NSMutableSet *classes) {
+    _YYModelMeta *modelMeta = [_YYModelMeta metaWithClass:cls];
+    if (!modelMeta) return nil;
+    [classes addObject:cls];
+    NSArray *metas = [modelMeta->_allPropertyMetas sortedArrayUsingComparator:^NSComparisonResult(_YYModelPropertyMeta *p1, _YYModelPropertyMeta *p2) {
+        return [p1->_name compare:p2->_name options:NSLiteralSearch];
+    }];
+    NSMutableArray *fields = [NSMutableArray new];
+    for (_YYModelPropertyMeta *meta in metas) {
+        _YYModelArrowField *field = YYArrowFieldForProperty(meta, classes);
+        if (field) [fields addObject:field];
+    }
+    [classes removeObject:cls];
+    return fields;
+}
+
+/// Parse a Field table.
+static _YYModelArrowSchemaField *YYArrowParseField(const YYFlatTable *t, int depth) {
+    if (depth > kYYArrowMaxDepth) return nil;
+    if (YYFlatTableField(t, 4, 4)) return nil; // dictionary-encoded
+    _YYModelArrowSchemaField *field = [_YYModelArrowSchemaField new];
+    field->_name = YYFlatTableGetString(t, 0) ?: @"";
+
+    YYFlatTable type;
+    BOOL hasType = YYFlatTableGetTable(t, 3, &type);
+    NSUInteger childCount = 0;
+    switch (YYFlatTableGetUInt8(t, 2, 0)) {
+        case YYArrowTypeIdNull: {
+            field->_bufferCount = 0;
+        } break;
+        case YYArrowTypeIdInt: {
+            if (!hasType) return nil;
+            BOOL isSigned = YYFlatTableGetUInt8(&type, 1, 0) != 0;
+            switch (YYFlatTableGetInt32(&type, 0, 0)) {
+                case 8: field->_type = isSigned ? YYModelArrowTypeInt8 : YYModelArrowTypeUInt8; break;
+                case 16: field->_type = isSigned ? YYModelArrowTypeInt16 : YYModelArrowTypeUInt16; break;
+                case 32: field->_type = isSigned ? YYModelArrowTypeInt32 : YYModelArrowTypeUInt32; break;
+                case 64: field->_type = isSigned ? YYModelArrowTypeInt64 : YYModelArrowTypeUInt64; break;
+                default: return nil;
+            }
+            field->_bufferCount = 2;
+        } break;
+        case YYArrowTypeIdFloatingPoint: {
+            if (!hasType) return nil;
+            switch (YYFlatTableGetInt16(&type, 0, 0)) {
+                case 1: field->_type = YYModelArrowTypeFloat; break;
+                case 2: field->_type = YYModelArrowTypeDouble; break;
+                default: break; // half float
+            }
+            field->_bufferCount = 2;
+        } break;
+        case YYArrowTypeIdBinary: {
+            field->_type = YYModelArrowTypeBinary;
+            field->_bufferCount = 3;
+        } break;
+        case YYArrowTypeIdUtf8: {
+            field->_type = YYModelArrowTypeUtf8;
+            field->_bufferCount = 3;
+        } break;
+        case YYArrowTypeIdBool: {
+            field->_type = YYModelArrowTypeBool;
+            field->_bufferCount = 2;
+        } break;
+        case YYArrowTypeIdTimestamp: {
+            if (!hasType) return nil;
+            int16_t unit = YYFlatTableGetInt16(&type, 0, 0);
+            if (unit < 0 || unit > YYModelArrowTimeUnitNanosecond) return nil;
+            field->_type = YYModelArrowTypeTimestamp;
+            field->_timeUnit = unit;
+            field->_bufferCount = 2;
+        } break;
+        case YYArrowTypeIdDecimal:
+        case YYArrowTypeIdDate:
+        case YYArrowTypeIdTime:
+        case YYArrowTypeIdInterval:
+        case YYArrowTypeIdFixedSizeBinary:
+        case YYArrowTypeIdDuration: {
+            field->_bufferCount = 2;
+        } break;
+        case YYArrowTypeIdLargeBinary:
+        case YYArrowTypeIdLargeUtf8: {
+            field->_bufferCount = 3;
+        } break;
+        case YYArrowTypeIdList: {
+            field->_type = YYModelArrowTypeList;
+            field->_bufferCount = 2;
+            childCount = 1;
+        } break;
+        case YYArrowTypeIdLargeList:
+        case YYArrowTypeIdMap: {
+            field->_bufferCount = 2;
+            childCount = 1;
+        } break;
+        case YYArrowTypeIdFixedSizeList: {
+            field->_bufferCount = 1;
+            childCount = 1;
+        } break;
+        case YYArrowTypeIdStruct: {
+            field->_type = YYModelArrowTypeStruct;
+            field->_bufferCount = 1;
+            childCount = NSUIntegerMax;
+        } break;
+        default: return nil; // union, view types...
+    }
+
+    size_t start, count;
+    if (!YYFlatTableGetVector(t, 5, 4, &start, &count)) return nil;
+    if (childCount != NSUIntegerMax && count != childCount) return nil;
+    NSMutableArray *children = [NSMutableArray new];
+    for (size_t i = 0; i < count; i++) {
+        YYFlatTable child;
+        if (!YYFlatTableGetVectorTable(t, start + i * 4, &child)) return nil;
+        _YYModelArrowSchemaField *childField = YYArrowParseField(&child, depth + 1);
+        if (!childField) return nil;
+        [children addObject:childField];
+    }
+    field->_children = children;
+    return field;
+}
+
+/// Parse a Schema table.
+static NSArray *YYArrowParseSchema(const YYFlatTable *t) {
+    if (YYFlatTableGetInt16(t, 0, 0) != 0) return nil; // big endian
+    size_t start, count;
+    if (!YYFlatTableGetVector(t, 1, 4, &start, &count)) return nil;
+    NSMutableArray *fields = [NSMutableArray new];
+    for (size_t i = 0; i < count; i++) {
+        YYFlatTable table;
+        if (!YYFlatTableGetVectorTable(t, start + i * 4, &table)) return nil;
+        _YYModelArrowSchemaField *field = YYArrowParseField(&table, 0);
+        if (!field) return nil;
+        [fields addObject:field];
+    }
+    return fields;
+}
+
+
+
+#pragma mark - Writer
+
+/// The body, field nodes and buffers of a record batch.
+typedef struct {
+    CFMutableDataRef body;
+    CFMutableDataRef nodes;   ///< YYArrowFieldNode array
+    CFMutableDataRef buffers; ///< YYArrowBuffer array
+} YYArrowBatchWriter;
+
+static void YYArrowWriterAppendNode(YYArrowBatchWriter *w, NSUInteger length, NSUInteger nullCount) {
+    YYArrowFieldNode node = {(int64_t)length, (int64_t)nullCount};
+    CFDataAppendBytes(w->nodes, (const UInt8 *)&node, sizeof(node));
+}
+
+static void YYArrowWriterAppendBuffer(YYArrowBatchWriter *w, const void *bytes, size_t length) {
+    YYArrowBuffer buffer = {CFDataGetLength(w->body), (int64_t)length};
+    if (length) CFDataAppendBytes(w->body, bytes, length);
+    size_t padding = (kYYArrowAlignment - length % kYYArrowAlignment) % kYYArrowAlignment;
+    if (padding) CFDataAppendBytes(w->body, YYArrowZeros, padding);
+    CFDataAppendBytes(w->buffers, (const UInt8 *)&buffer, sizeof(buffer));
+}
+
+/// Append the UTF-8 bytes of a string.
+static void YYArrowAppendString(CFMutableDataRef data, CFStringRef string) {
+    CFIndex length = CFStringGetLength(string);
+    const char *cstring = CFStringGetCStringPtr(string, kCFStringEncodingUTF8);
+    if (cstring) {
+        CFDataAppendBytes(data, (const UInt8 *)cstring, strlen(cstring));
+        return;
+    }
+    CFIndex dataLength = CFDataGetLength(data);
+    CFIndex maxSize = CFStringGetMaximumSizeForEncoding(length, kCFStringEncodingUTF8);
+    CFDataSetLength(data, dataLength + maxSize);
+    CFIndex used = 0;
+    CFStringGetBytes(string, CFRangeMake(0, length), kCFStringEncodingUTF8, 0, false,
+                     CFDataGetMutableBytePtr(data) + dataLength, maxSize, &used);
+    CFDataSetLength(data, dataLength + used);
+}
+
+/// Get the object of a field in a row (a model, or a list item), or nil.
+static force_inline id YYArrowFieldGetObject(__unsafe_unretained _YYModelArrowField *field, __unsafe_unretained id row) {
+    if (row == (id)kCFNull) return nil;
+    if (!field->_meta) return row;
+    return ((id (*)(id, SEL))(void *) objc_msgSend)((id)row, field->_meta->_getter);
+}
+
+/**
+ Write the field node and buffers of a field (and its children) to the record batch.
+
+ @param rows The models (or list items) of the rows, NSNull for null row.
+ @return NO if the data overflows the 32-bit offsets.
+ */
+static BOOL YYArrowWriteField(YYArrowBatchWriter *w, _YYModelArrowField *field, NSArray *rows) {
+    NSUInteger count = rows.count;
+    size_t bitmapLength = (count + 7) / 8;
+    uint8_t *validity = calloc(bitmapLength ? bitmapLength : 1, 1);
+    NSUInteger nullCount = 0;
+    BOOL succeed = YES;
+    _YYModelPropertyMeta *meta = field->_meta;
+
+#define YYArrowSetBit(bitmap, i) ((bitmap)[(i) >> 3] |= (uint8_t)(1 << ((i) & 7)))
+
+    switch (field->_type) {
+        case YYModelArrowTypeBool: {
+            uint8_t *values = calloc(bitmapLength ? bitmapLength : 1, 1);
+            for (NSUInteger i = 0; i < count; i++) {
+                id row = rows[i];
+                if (row == (id)kCFNull) { nullCount++; continue; }
+                YYArrowSetBit(validity, i);
+                if (YYModelGetInt64FromProperty(row, meta)) YYArrowSetBit(values, i);
+            }
+            YYArrowWriterAppendNode(w, count, nullCount);
+            YYArrowWriterAppendBuffer(w, validity, nullCount ? bitmapLength : 0);
+            YYArrowWriterAppendBuffer(w, values, bitmapLength);
+            free(values);
+        } break;
+
+        case YYModelArrowTypeInt8:
+        case YYModelArrowTypeInt16:
+        case YYModelArrowTypeInt32:
+        case YYModelArrowTypeInt64:
+        case YYModelArrowTypeUInt8:
+        case YYModelArrowTypeUInt16:
+        case YYModelArrowTypeUInt32:
+        case YYModelArrowTypeUInt64:
+        case YYModelArrowTypeFloat:
+        case YYModelArrowTypeDouble:
+        case YYModelArrowTypeTimestamp: {
+            size_t width = YYArrowTypeGetWidth(field->_type);
+            uint8_t *values = calloc(count ? count : 1, width);
+            for (NSUInteger i = 0; i < count; i++) {
+                id row = rows[i];
+                uint8_t *value = values + i * width;
+                if (row == (id)kCFNull) { nullCount++; continue; }
+                if (meta && meta->_isCNumber) {
+                    if (field->_type == YYModelArrowTypeFloat) {
+                        float f = YYModelGetDoubleFromProperty(row, meta);
+                        memcpy(value, &f, 4);
+                    } else if (field->_type == YYModelArrowTypeDouble) {
+                        double d = YYModelGetDoubleFromProperty(row, meta);
+                        memcpy(value, &d, 8);
+                    } else {
+                        int64_t v = YYModelGetInt64FromProperty(row, meta); // little-endian truncation
+                        memcpy(value, &v, width);
+                    }
+                } else {
+                    id obj = YYArrowFieldGetObject(field, row);
+                    if (field->_type == YYModelArrowTypeTimestamp && [obj isKindOfClass:[NSDate class]]) {
+                        int64_t v = llround(((NSDate *)obj).timeIntervalSince1970 * 1000000);
+                        memcpy(value, &v, 8);
+                    } else if (field->_type == YYModelArrowTypeDouble && [obj isKindOfClass:[NSNumber class]]) {
+                        double d = ((NSNumber *)obj).doubleValue;
+                        memcpy(value, &d, 8);
+                    } else {
+                        nullCount++;
+                        continue;
+                    }
+                }
+                YYArrowSetBit(validity, i);
+            }
+            YYArrowWriterAppendNode(w, count, nullCount);
+            YYArrowWriterAppendBuffer(w, validity, nullCount ? bitmapLength : 0);
+            YYArrowWriterAppendBuffer(w, values, count * width);
+            free(values);
+        } break;
+
+        case YYModelArrowTypeUtf8:
+        case YYModelArrowTypeBinary: {
+            int32_t *offsets = malloc((count + 1) * sizeof(int32_t));
+            CFMutableDataRef bytes = CFDataCreateMutable(CFAllocatorGetDefault(), 0);
+            offsets[0] = 0;
+            for (NSUInteger i = 0; i < count; i++) {
+                id obj = YYArrowFieldGetObject(field, rows[i]);
+                if (field->_type == YYModelArrowTypeUtf8 && [obj isKindOfClass:[NSURL class]]) {
+                    obj = ((NSURL *)obj).absoluteString;
+                }
+                if (field->_type == YYModelArrowTypeUtf8 && [obj isKindOfClass:[NSString class]]) {
+                    YYArrowAppendString(bytes, (__bridge CFStringRef)obj);
+                    YYArrowSetBit(validity, i);
+                } else if (field->_type == YYModelArrowTypeBinary && [obj isKindOfClass:[NSData class]]) {
+                    CFDataAppendBytes(bytes, ((NSData *)obj).bytes, ((NSData *)obj).length);
+                    YYArrowSetBit(validity, i);
+                } else {
+                    nullCount++;
+                }
+                if (CFDataGetLength(bytes) > INT32_MAX) {
+                    succeed = NO;
+                    break;
+                }
+                offsets[i + 1] = (int32_t)CFDataGetLength(bytes);
+            }
+            if (succeed) {
+                YYArrowWriterAppendNode(w, count, nullCount);
+                YYArrowWriterAppendBuffer(w, validity, nullCount ? bitmapLength : 0);
+                YYArrowWriterAppendBuffer(w, offsets, (count + 1) * sizeof(int32_t));
+                YYArrowWriterAppendBuffer(w, CFDataGetBytePtr(bytes), CFDataGetLength(bytes));
+            }
+            free(offsets);
+            CFRelease(bytes);
+        } break;
+
+        case YYModelArrowTypeStruct: {
+            NSMutableArray *children = [NSMutableArray arrayWithCapacity:count];
+            for (NSUInteger i = 0; i < count; i++) {
+                id obj = YYArrowFieldGetObject(field, rows[i]);
+                if ([obj isKindOfClass:field->_cls]) {
+                    YYArrowSetBit(validity, i);
+                    [children addObject:obj];
+                } else {
+                    nullCount++;
+                    [children addObject:(id)kCFNull];
+                }
+            }
+            YYArrowWriterAppendNode(w, count, nullCount);
+            YYArrowWriterAppendBuffer(w, validity, nullCount ? bitmapLength : 0);
+            for (_YYModelArrowField *child in field->_children) {
+                if (!YYArrowWriteField(w, child, children)) {
+                    succeed = NO;
+                    break;
+                }
+            }
+        } break;
+
+        case YYModelArrowTypeList: {
+            int32_t *offsets = malloc((count + 1) * sizeof(int32_t));
+            NSMutableArray *items = [NSMutableArray new];
+            offsets[0] = 0;
+            for (NSUInteger i = 0; i < count; i++) {
+                id obj = YYArrowFieldGetObject(field, rows[i]);
+                if ([obj isKindOfClass:[NSArray class]]) {
+                    YYArrowSetBit(validity, i);
+                    [items addObjectsFromArray:obj];
+                } else {
+                    nullCount++;
+                }
+                if (items.count > INT32_MAX) {
+                    succeed = NO;
+                    break;
+                }
+                offsets[i + 1] = (int32_t)items.count;
+            }
+            if (succeed) {
+                YYArrowWriterAppendNode(w, count, nullCount);
+                YYArrowWriterAppendBuffer(w, validity, nullCount ? bitmapLength : 0);
+                YYArrowWriterAppendBuffer(w, offsets, (count + 1) * sizeof(int32_t));
+                succeed = YYArrowWriteField(w, field->_children.firstObject, items);
+            }
+            free(offsets);
+        } break;
+
+        default: break;
+    }
+
+#undef YYArrowSetBit
+
+    free(validity);
+    return succeed;
+}
+
+/// Build a Field table.
+static uint32_t YYArrowBuildField(YYFlatBuilder *b, _YYModelArrowField *field) {
+    NSUInteger childCount = field->_children.count;
+    uint32_t *childRefs = malloc((childCount ? childCount : 1) * sizeof(uint32_t));
+    for (NSUInteger i = 0; i < childCount; i++) {
+        childRefs[i] = YYArrowBuildField(b, field->_children[i]);
+    }
+    uint32_t children = YYFlatBuilderCreateOffsetVector(b, childRefs, childCount);
+    free(childRefs);
+
+    YYArrowTypeId typeId;
+    uint32_t type;
+    BOOL isSigned;
+    int bitWidth = YYArrowTypeGetIntWidth(field->_type, &isSigned);
+    if (bitWidth) {
+        YYFlatBuilderStartTable(b);
+        YYFlatBuilderAdd(b, 0, int32_t, bitWidth);
+        YYFlatBuilderAdd(b, 1, uint8_t, isSigned);
+        type = YYFlatBuilderEndTable(b);
+        typeId = YYArrowTypeIdInt;
+    } else if (field->_type == YYModelArrowTypeFloat || field->_type == YYModelArrowTypeDouble) {
+        YYFlatBuilderStartTable(b);
+        YYFlatBuilderAdd(b, 0, int16_t, field->_type == YYModelArrowTypeFloat ? 1 : 2); // SINGLE, DOUBLE
+        type = YYFlatBuilderEndTable(b);
+        typeId = YYArrowTypeIdFloatingPoint;
+    } else if (field->_type == YYModelArrowTypeTimestamp) {
+        uint32_t timezone = YYFlatBuilderCreateString(b, @"UTC");
+        YYFlatBuilderStartTable(b);
+        YYFlatBuilderAddOffset(b, 1, timezone);
+        YYFlatBuilderAdd(b, 0, int16_t, YYModelArrowTimeUnitMicrosecond);
+        type = YYFlatBuilderEndTable(b);
+        typeId = YYArrowTypeIdTimestamp;
+    } else {
+        switch (field->_type) {
+            case YYModelArrowTypeBool: typeId = YYArrowTypeIdBool; break;
+            case YYModelArrowTypeUtf8: typeId = YYArrowTypeIdUtf8; break;
+            case YYModelArrowTypeBinary: typeId = YYArrowTypeIdBinary; break;
+            case YYModelArrowTypeList: typeId = YYArrowTypeIdList; break;
+            default: typeId = YYArrowTypeIdStruct; break;
+        }
+        YYFlatBuilderStartTable(b);
+        type = YYFlatBuilderEndTable(b);
+    }
+
+    uint32_t name = YYFlatBuilderCreateString(b, field->_name);
+    YYFlatBuilderStartTable(b);
+    YYFlatBuilderAddOffset(b, 0, name);
+    YYFlatBuilderAddOffset(b, 3, type);
+    YYFlatBuilderAddOffset(b, 5, children);
+    YYFlatBuilderAdd(b, 1, uint8_t, 1); // nullable
+    YYFlatBuilderAdd(b, 2, uint8_t, typeId);
+    return YYFlatBuilderEndTable(b);
+}
+
+/// Build a Schema table.
+static uint32_t YYArrowBuildSchema(YYFlatBuilder *b, NSArray *fields) {
+    NSUInteger count = fields.count;
+    uint32_t *refs = malloc((count ? count : 1) * sizeof(uint32_t));
+    for (NSUInteger i = 0; i < count; i++) refs[i] = YYArrowBuildField(b, fields[i]);
+    uint32_t vector = YYFlatBuilderCreateOffsetVector(b, refs, count);
+    free(refs);
+    YYFlatBuilderStartTable(b);
+    YYFlatBuilderAddOffset(b, 1, vector);
+    YYFlatBuilderAdd(b, 0, int16_t, 0); // little endian
+    return YYFlatBuilderEndTable(b);
+}
+
+/// Finish a Message with the header and append it (with the body) to the output.
+static void YYArrowAppendMessage(CFMutableDataRef output, YYFlatBuilder *b, YYArrowMessageType headerType,
+                                 uint32_t header, CFDataRef body, YYArrowBlock *block) {
+    int64_t bodyLength = body ? CFDataGetLength(body) : 0;
+    YYFlatBuilderStartTable(b);
+    YYFlatBuilderAdd(b, 3, int64_t, bodyLength);
+    YYFlatBuilderAddOffset(b, 2, header);
+    YYFlatBuilderAdd(b, 0, int16_t, kYYArrowMetadataVersion);
+    YYFlatBuilderAdd(b, 1, uint8_t, headerType);
+    YYFlatBuilderFinish(b, YYFlatBuilderEndTable(b));
+
+    uint32_t metaLength = (uint32_t)((b->used + kYYArrowAlignment - 1) / kYYArrowAlignment * kYYArrowAlignment);
+    uint32_t prefix[2] = {0xFFFFFFFF, metaLength};
+    block->offset = CFDataGetLength(output);
+    block->metaDataLength = (int32_t)(sizeof(prefix) + metaLength);
+    block->padding = 0;
+    block->bodyLength = bodyLength;
+    CFDataAppendBytes(output, (const UInt8 *)prefix, sizeof(prefix));
+    CFDataAppendBytes(output, b->buf + b->cap - b->used, b->used);
+    if (metaLength > b->used) CFDataAppendBytes(output, YYArrowZeros, metaLength - b->used);
+    if (bodyLength) CFDataAppendBytes(output, CFDataGetBytePtr(body), bodyLength);
+}
+
+
+
+#pragma mark - Reader
+
+/// A record batch in the data.
+typedef struct {
+    size_t metaPos;     ///< position of the message flatbuffer
+    size_t metaLength;
+    size_t headerPos;   ///< position of the RecordBatch table in the flatbuffer
+    size_t bodyPos;
+    size_t bodyLength;
+    int64_t length;
+} YYArrowBatchInfo;
+
+/// The state of reading the columns of a record batch.
+typedef struct {
+    const uint8_t *nodes;
+    size_t nodeCount;
+    size_t nodeIndex;
+    const uint8_t *buffers;
+    size_t bufferCount;
+    size_t bufferIndex;
+    const uint8_t *body;
+    size_t bodyLength;
+} YYArrowBatchReader;
+
+/**
+ Read an encapsulated message.
+ @return 1 if succeed, 0 for the end of stream, -1 if the data is invalid.
+ */
+static int YYArrowReadMessage(const uint8_t *bytes, size_t length, size_t pos, YYArrowMessageType *headerType,
+                              YYFlatTable *header, size_t *bodyPos, size_t *bodyLength) {
+    if (pos == length) return 0;
+    if (pos > length || length - pos < 4) return -1;
+    uint32_t metaLength = YYArrowReadUInt32(bytes + pos);
+    pos += 4;
+    if (metaLength == 0xFFFFFFFF) { // continuation marker, or a legacy message without it
+        if (length - pos < 4) return -1;
+        metaLength = YYArrowReadUInt32(bytes + pos);
+        pos += 4;
+    }
+    if (metaLength == 0) return 0;
+    if (metaLength < 4 || metaLength > length - pos) return -1;
+
+    const uint8_t *meta = bytes + pos;
+    YYFlatTable message;
+    if (!YYFlatTableInit(&message, meta, metaLength, YYArrowReadUInt32(meta))) return -1;
+    if (YYFlatTableGetInt16(&message, 0, 0) < kYYArrowMetadataVersionMin) return -1;
+    *headerType = YYFlatTableGetUInt8(&message, 1, 0);
+    if (!YYFlatTableGetTable(&message, 2, header)) return -1;
+    int64_t body = YYFlatTableGetInt64(&message, 3, 0);
+    size_t start = pos + metaLength;
+    if (body < 0 || (uint64_t)body > length - start) return -1;
+    *bodyPos = start;
+    *bodyLength = (size_t)body;
+    return 1;
+}
+
+
+
+@interface YYModelArrowColumn () {
+    @package
+    NSData *_data; ///< holds the buffers
+    NSString *_name;
+    YYModelArrowType _type;
+    YYModelArrowTimeUnit _timeUnit;
+    NSUInteger _length;
+    NSUInteger _nullCount;
+    const uint8_t *_validity;
+    const void *_values;
+    const int32_t *_offsets;
+    const uint8_t *_bytes;
+    NSUInteger _byteLength;
+    NSArray *_children;
+}
+@end
+
+/// Get the range of a row of utf8, binary or list column, returns NO if the offsets are invalid.
+static force_inline BOOL YYArrowColumnGetRange(__unsafe_unretained YYModelArrowColumn *column, NSUInteger index,
+                                               NSUInteger limit, NSUInteger *start, NSUInteger *end) {
+    if (!column->_offsets || index >= column->_length) return NO;
+    int32_t s = column->_offsets[index], e = column->_offsets[index + 1];
+    if (s < 0 || e < s || (NSUInteger)e > limit) return NO;
+    *start = (NSUInteger)s;
+    *end = (NSUInteger)e;
+    return YES;
+}
+
+static force_inline BOOL YYArrowColumnIsNull(__unsafe_unretained YYModelArrowColumn *column, NSUInteger index) {
+    if (index >= column->_length) return YES;
+    if (!column->_validity) return NO;
+    return (column->_validity[index >> 3] & (1 << (index & 7))) == 0;
+}
+
+static force_inline int64_t YYArrowColumnGetInt64(__unsafe_unretained YYModelArrowColumn *column, NSUInteger index) {
+    const void *v = column->_values;
+    switch (column->_type) {
+        case YYModelArrowTypeBool: return (((const uint8_t *)v)[index >> 3] >> (index & 7)) & 1;
+        case YYModelArrowTypeInt8: return ((const int8_t *)v)[index];
+        case YYModelArrowTypeInt16: return ((const int16_t *)v)[index];
+        case YYModelArrowTypeInt32: return ((const int32_t *)v)[index];
+        case YYModelArrowTypeInt64: return ((const int64_t *)v)[index];
+        case YYModelArrowTypeUInt8: return ((const uint8_t *)v)[index];
+        case YYModelArrowTypeUInt16: return ((const uint16_t *)v)[index];
+        case YYModelArrowTypeUInt32: return ((const uint32_t *)v)[index];
+        case YYModelArrowTypeUInt64: return (int64_t)((const uint64_t *)v)[index];
+        case YYModelArrowTypeTimestamp: return ((const int64_t *)v)[index];
+        case YYModelArrowTypeFloat: {
+            float f = ((const float *)v)[index];
+            return (isnan(f) || fabsf(f) >= 9.2e18f) ? 0 : (int64_t)f;
+        }
+        case YYModelArrowTypeDouble: {
+            double d = ((const double *)v)[index];
+            return (isnan(d) || fabs(d) >= 9.2e18) ? 0 : (int64_t)d;
+        }
+        default: return 0;
+    }
+}
+
+static force_inline double YYArrowColumnGetDouble(__unsafe_unretained YYModelArrowColumn *column, NSUInteger index) {
+    switch (column->_type) {
+        case YYModelArrowTypeFloat: return ((const float *)column->_values)[index];
+        case YYModelArrowTypeDouble: return ((const double *)column->_values)[index];
+        case YYModelArrowTypeUInt64: return ((const uint64_t *)column->_values)[index];
+        default: return YYArrowColumnGetInt64(column, index);
+    }
+}
+
+static force_inline NSDate *YYArrowColumnGetDate(__unsafe_unretained YYModelArrowColumn *column, NSUInteger index) {
+    static const double divisors[] = {1, 1e3, 1e6, 1e9};
+    int64_t value = ((const int64_t *)column->_values)[index];
+    return [NSDate dateWithTimeIntervalSince1970:value / divisors[column->_timeUnit]];
+}
+
+@implementation YYModelArrowColumn
+
+- (const uint8_t *)validity {
+    return _validity;
+}
+
+- (const void *)values {
+    return _values;
+}
+
+- (const int32_t *)offsets {
+    return _offsets;
+}
+
+- (const uint8_t *)bytes {
+    return _bytes;
+}
+
+- (BOOL)isNullAtIndex:(NSUInteger)index {
+    return YYArrowColumnIsNull(self, index);
+}
+
+- (int64_t)int64AtIndex:(NSUInteger)index {
+    if (!_values || YYArrowColumnIsNull(self, index)) return 0;
+    return YYArrowColumnGetInt64(self, index);
+}
+
+- (double)doubleAtIndex:(NSUInteger)index {
+    if (!_values || YYArrowColumnIsNull(self, index)) return 0;
+    return YYArrowColumnGetDouble(self, index);
+}
+
+- (NSString *)stringAtIndex:(NSUInteger)index {
+    if (_type != YYModelArrowTypeUtf8 || YYArrowColumnIsNull(self, index)) return nil;
+    NSUInteger start, end;
+    if (!YYArrowColumnGetRange(self, index, _byteLength, &start, &end)) return nil;
+    return [[NSString alloc] initWithBytes:_bytes + start length:end - start encoding:NSUTF8StringEncoding];
+}
+
+- (NSData *)dataAtIndex:(NSUInteger)index {
+    if ((_type != YYModelArrowTypeBinary && _type != YYModelArrowTypeUtf8) || YYArrowColumnIsNull(self, index)) return nil;
+    NSUInteger start, end;
+    if (!YYArrowColumnGetRange(self, index, _byteLength, &start, &end)) return nil;
+    return [NSData dataWithBytes:_bytes + start length:end - start];
+}
+
+- (NSDate *)dateAtIndex:(NSUInteger)index {
+    if (_type != YYModelArrowTypeTimestamp || YYArrowColumnIsNull(self, index)) return nil;
+    return YYArrowColumnGetDate(self, index);
+}
+
+- (NSString *)description {
+    return [NSString stringWithFormat:@"<%@: %p> %@ (%lu rows, %lu null)", self.class, self, _name, (unsigned long)_length, (unsigned long)_nullCount];
+}
+
+@end
+
+
+/// Read the column of a field (and its children), returns nil if the record batch is invalid.
+static YYModelArrowColumn *YYArrowReadColumn(YYArrowBatchReader *r, _YYModelArrowSchemaField *field, NSData *data) {
+    if (r->nodeIndex >= r->nodeCount) return nil;
+    const uint8_t *node = r->nodes + r->nodeIndex++ * sizeof(YYArrowFieldNode);
+    int64_t length = YYArrowReadInt64(node);
+    int64_t nullCount = YYArrowReadInt64(node + 8);
+    if (length < 0 || length >= INT32_MAX || nullCount < 0 || nullCount > length) return nil;
+
+    if (field->_bufferCount > r->bufferCount - r->bufferIndex) return nil;
+    const uint8_t *buffers[3] = {0};
+    size_t bufferLengths[3] = {0};
+    for (NSUInteger i = 0; i < field->_bufferCount; i++) {
+        const uint8_t *buffer = r->buffers + r->bufferIndex++ * sizeof(YYArrowBuffer);
+        int64_t offset = YYArrowReadInt64(buffer);
+        int64_t bufferLength = YYArrowReadInt64(buffer + 8);
+        if (offset < 0 || bufferLength < 0 || (uint64_t)offset > r->bodyLength ||
+            (uint64_t)bufferLength > r->bodyLength - offset) return nil;
+        if (i < 3) {
+            buffers[i] = r->body + offset;
+            bufferLengths[i] = (size_t)bufferLength;
+        }
+    }
+
+    YYModelArrowColumn *column = [YYModelArrowColumn new];
+    column->_data = data;
+    column->_name = field->_name;
+    column->_type = field->_type;
+    column->_timeUnit = field->_timeUnit;
+    column->_length = (NSUInteger)length;
+    column->_nullCount = (NSUInteger)nullCount;
+
+    size_t bitmapLength = ((size_t)length + 7) / 8;
+    if (field->_type != YYModelArrowTypeUnknown && nullCount > 0) {
+        if (bufferLengths[0] < bitmapLength) return nil;
+        column->_validity = buffers[0];
+    }
+    switch (field->_type) {
+        case YYModelArrowTypeBool: {
+            if (bufferLengths[1] < bitmapLength) return nil;
+            column->_values = buffers[1];
+        } break;
+        case YYModelArrowTypeUtf8:
+        case YYModelArrowTypeBinary:
+        case YYModelArrowTypeList: {
+            if (length > 0) {
+                if (bufferLengths[1] < ((size_t)length + 1) * sizeof(int32_t)) return nil;
+                column->_offsets = (const int32_t *)buffers[1];
+            }
+            if (field->_type != YYModelArrowTypeList) {
+                column->_bytes = buffers[2];
+                column->_byteLength = bufferLengths[2];
+            }
+        } break;
+        case YYModelArrowTypeStruct:
+        case YYModelArrowTypeUnknown: break;
+        default: { // fixed-width
+            if (bufferLengths[1] < (size_t)length * YYArrowTypeGetWidth(field->_type)) return nil;
+            column->_values = buffers[1];
+        } break;
+    }
+
+    NSMutableArray *children = [NSMutableArray new];
+    for (_YYModelArrowSchemaField *childField in field->_children) {
+        YYModelArrowColumn *child = YYArrowReadColumn(r, childField, data);
+        if (!child) return nil;
+        [children addObject:child];
+    }
+    column->_children = children;
+    return column;
+}
+
+
+static void YYArrowSetColumnsToModels(NSArray *columns, Class cls, NSArray *models, NSUInteger start, int depth);
+
+/// Creates the objects of rows [start, start + count) of a column, NSNull for null row.
+static NSArray *YYArrowCreateObjects(YYModelArrowColumn *column, Class cls, NSUInteger start, NSUInteger count, int depth) {
+    NSMutableArray *objects = [NSMutableArray arrayWithCapacity:count];
+    if (column->_type == YYModelArrowTypeStruct) {
+        if (!cls || depth > kYYArrowMaxDepth) return nil;
+        for (NSUInteger i = 0; i < count; i++) {
+            [objects addObject:YYArrowColumnIsNull(column, start + i) ? (id)kCFNull : [cls new]];
+        }
+        YYArrowSetColumnsToModels(column->_children, cls, objects, start, depth + 1);
+        return objects;
+    }
+    for (NSUInteger i = 0; i < count; i++) {
+        NSUInteger row = start + i;
+        id obj = nil;
+        if (!YYArrowColumnIsNull(column, row)) {
+            switch (column->_type) {
+                case YYModelArrowTypeUtf8: obj = [column stringAtIndex:row]; break;
+                case YYModelArrowTypeBinary: obj = [column dataAtIndex:row]; break;
+                case YYModelArrowTypeTimestamp: obj = YYArrowColumnGetDate(column, row); break;
+                case YYModelArrowTypeFloat:
+                case YYModelArrowTypeDouble: obj = @(YYArrowColumnGetDouble(column, row)); break;
+                case YYModelArrowTypeUInt64: obj = @((uint64_t)YYArrowColumnGetInt64(column, row)); break;
+                default: {
+                    if (YYArrowTypeIsNumber(column->_type)) obj = @(YYArrowColumnGetInt64(column, row));
+                } break;
+            }
+        }
+        [objects addObject:obj ?: (id)kCFNull];
+    }
+    return objects;
+}
+
+/// Set the rows [start, start + models.count) of a column to a property of the models (NSNull is skipped).
+static void YYArrowSetColumnToModels(YYModelArrowColumn *column, _YYModelPropertyMeta *meta, NSArray *models, NSUInteger start, int depth) {
+    NSUInteger count = models.count;
+    if (start > column->_length || count > column->_length - start) return;
+    YYModelArrowType type = column->_type;
+
+    if (meta->_isCNumber) {
+        if (!YYArrowTypeIsNumber(type)) return;
+        BOOL floating = (type == YYModelArrowTypeFloat || type == YYModelArrowTypeDouble);
+        for (NSUInteger i = 0; i < count; i++) {
+            id model = models[i];
+            NSUInteger row = start + i;
+            if (model == (id)kCFNull || YYArrowColumnIsNull(column, row)) continue;
+            if (floating) {
+                YYModelSetDoubleToProperty(model, YYArrowColumnGetDouble(column, row), meta);
+            } else {
+                YYModelSetInt64ToProperty(model, YYArrowColumnGetInt64(column, row), meta);
+            }
+        }
+        return;
+    }
+
+    NSArray *objects = nil;
+    NSArray *lists = nil;
+    switch (meta->_nsType) {
+        case YYEncodingTypeNSNumber:
+        case YYEncodingTypeNSDecimalNumber: {
+            if (YYArrowTypeIsNumber(type) && type != YYModelArrowTypeTimestamp) {
+                objects = YYArrowCreateObjects(column, nil, start, count, depth);
+            }
+        } break;
+        case YYEncodingTypeNSString:
+        case YYEncodingTypeNSMutableString:
+        case YYEncodingTypeNSURL: {
+            if (type == YYModelArrowTypeUtf8) objects = YYArrowCreateObjects(column, nil, start, count, depth);
+        } break;
+        case YYEncodingTypeNSData:
+        case YYEncodingTypeNSMutableData: {
+            if (type == YYModelArrowTypeBinary) objects = YYArrowCreateObjects(column, nil, start, count, depth);
+        } break;
+        case YYEncodingTypeNSDate: {
+            if (type == YYModelArrowTypeTimestamp) objects = YYArrowCreateObjects(column, nil, start, count, depth);
+        } break;
+        case YYEncodingTypeNSArray:
+        case YYEncodingTypeNSMutableArray: {
+            if (type != YYModelArrowTypeList || count == 0) break;
+            YYModelArrowColumn *child = column->_children.firstObject;
+            NSUInteger first, last, s, e;
+            if (!YYArrowColumnGetRange(column, start, child->_length, &first, &e)) break;
+            if (!YYArrowColumnGetRange(column, start + count - 1, child->_length, &s, &last) || last < first) break;
+            NSArray *items = YYArrowCreateObjects(child, meta->_genericCls, first, last - first, depth + 1);
+            if (!items) break;
+            NSMutableArray *result = [NSMutableArray arrayWithCapacity:count];
+            for (NSUInteger i = 0; i < count; i++) {
+                NSUInteger row = start + i;
+                if (YYArrowColumnIsNull(column, row) || !YYArrowColumnGetRange(column, row, child->_length, &s, &e) ||
+                    s < first || e > last) {
+                    [result addObject:(id)kCFNull];
+                    continue;
+                }
+                NSMutableArray *list = [NSMutableArray arrayWithCapacity:e - s];
+                for (NSUInteger j = s; j < e; j++) {
+                    id item = items[j - first];
+                    if (item != (id)kCFNull) [list addObject:item];
+                }
+                [result addObject:list];
+            }
+            lists = result;
+        } break;
+        case YYEncodingTypeNSUnknown: {
+            if (type == YYModelArrowTypeStruct && meta->_cls) {
+                objects = YYArrowCreateObjects(column, meta->_cls, start, count, depth);
+            }
+        } break;
+        default: break;
+    }
+    if (lists) objects = lists;
+    if (!objects) return;
+
+    for (NSUInteger i = 0; i < count; i++) {
+        id model = models[i];
+        id obj = objects[i];
+        if (model == (id)kCFNull || obj == (id)kCFNull) continue;
+        switch (meta->_nsType) {
+            case YYEncodingTypeNSDecimalNumber: {
+                obj = [NSDecimalNumber decimalNumberWithDecimal:((NSNumber *)obj).decimalValue];
+            } break;
+            case YYEncodingTypeNSURL: {
+                obj = [NSURL URLWithString:obj];
+            } break;
+            case YYEncodingTypeNSMutableString:
+            case YYEncodingTypeNSMutableData: {
+                obj = [obj mutableCopy];
+            } break;
+            case YYEncodingTypeNSArray: {
+                obj = [obj copy];
+            } break;
+            default: break;
+        }
+        if (!obj) continue;
+        ((void (*)(id, SEL, id))(void *) objc_msgSend)((id)model, meta->_setter, obj);
+    }
+}
+
+/// Set the rows [start, start + models.count) of the columns to the models (NSNull is skipped).
+static void YYArrowSetColumnsToModels(NSArray *columns, Class cls, NSArray *models, NSUInteger start, int depth) {
+    _YYModelMeta *modelMeta = [_YYModelMeta metaWithClass:cls];
+    if (!modelMeta || !models.count) return;
+    NSMutableDictionary *propertyMetas = [NSMutableDictionary new];
+    for (_YYModelPropertyMeta *meta in modelMeta->_allPropertyMetas) {
+        propertyMetas[meta->_name] = meta;
+    }
+    for (YYModelArrowColumn *column in columns) {
+        _YYModelPropertyMeta *meta = propertyMetas[column->_name];
+        if (!meta || !meta->_setter) continue;
+        YYArrowSetColumnToModels(column, meta, models, start, depth);
+    }
+}
+
+
+
+@implementation YYModelArrowReader {
+    NSData *_data;
+    NSArray *_fields;   ///< Array<_YYModelArrowSchemaField>
+    NSData *_batches;   ///< YYArrowBatchInfo array
+}
+
+/// Add a record batch, returns NO if the record batch is invalid or not supported.
+static BOOL YYArrowAddBatch(NSMutableData *batches, const uint8_t *bytes, const YYFlatTable *header, size_t bodyPos, size_t bodyLength) {
+    YYArrowBatchInfo info;
+    info.metaPos = (size_t)(header->base - bytes);
+    info.metaLength = header->size;
+    info.headerPos = header->pos;
+    info.bodyPos = bodyPos;
+    info.bodyLength = bodyLength;
+    info.length = YYFlatTableGetInt64(header, 0, 0);
+    if (info.length < 0 || info.length >= INT32_MAX) return NO;
+    if (YYFlatTableField(header, 3, 4)) return NO; // compressed
+    [batches appendBytes:&info length:sizeof(info)];
+    return YES;
+}
+
++ (instancetype)readerWithData:(NSData *)data {
+    if (![data isKindOfClass:[NSData class]]) return nil;
+    const uint8_t *bytes = data.bytes;
+    size_t length = data.length;
+    NSArray *fields = nil;
+    NSMutableData *batches = [NSMutableData new];
+    YYArrowMessageType headerType;
+    YYFlatTable header;
+    size_t bodyPos, bodyLength;
+
+    if (length >= sizeof(YYArrowMagic) && memcmp(bytes, YYArrowMagic, 6) == 0) {
+        // file format: magic, stream, footer, footer length, magic
+        if (length < sizeof(YYArrowMagic) + 10 || memcmp(bytes + length - 6, YYArrowMagic, 6) != 0) return nil;
+        uint32_t footerLength = YYArrowReadUInt32(bytes + length - 10);
+        if (footerLength < 4 || footerLength > length - sizeof(YYArrowMagic) - 10) return nil;
+        const uint8_t *footerBytes = bytes + length - 10 - footerLength;
+        YYFlatTable footer, schema;
+        if (!YYFlatTableInit(&footer, footerBytes, footerLength, YYArrowReadUInt32(footerBytes))) return nil;
+        if (!YYFlatTableGetTable(&footer, 1, &schema)) return nil;
+        fields = YYArrowParseSchema(&schema);
+        if (!fields) return nil;
+
+        size_t start, count;
+        if (!YYFlatTableGetVector(&footer, 2, sizeof(YYArrowBlock), &start, &count) || count) return nil; // dictionaries
+        if (!YYFlatTableGetVector(&footer, 3, sizeof(YYArrowBlock), &start, &count)) return nil;
+        for (size_t i = 0; i < count; i++) {
+            int64_t offset = YYArrowReadInt64(footerBytes + start + i * sizeof(YYArrowBlock));
+            if (offset < 0 || (uint64_t)offset >= length) return nil;
+            if (YYArrowReadMessage(bytes, length, (size_t)offset, &headerType, &header, &bodyPos, &bodyLength) != 1) return nil;
+            if (headerType != YYArrowMessageTypeRecordBatch) return nil;
+            if (!YYArrowAddBatch(batches, bytes, &header, bodyPos, bodyLength)) return nil;
+        }
+    } else {
+        // stream format: schema, record batches, end of stream
+        if (YYArrowReadMessage(bytes, length, 0, &headerType, &header, &bodyPos, &bodyLength) != 1) return nil;
+        if (headerType != YYArrowMessageTypeSchema) return nil;
+        fields = YYArrowParseSchema(&header);
+        if (!fields) return nil;
+        for (;;) {
+            int result = YYArrowReadMessage(bytes, length, bodyPos + bodyLength, &headerType, &header, &bodyPos, &bodyLength);
+            if (result == 0) break;
+            if (result < 0 || headerType != YYArrowMessageTypeRecordBatch) return nil;
+            if (!YYArrowAddBatch(batches, bytes, &header, bodyPos, bodyLength)) return nil;
+        }
+    }
+
+    YYModelArrowReader *reader = [self new];
+    reader->_data = data;
+    reader->_fields = fields;
+    reader->_batches = batches;
+    return reader;
+}
+
++ (instancetype)readerWithFile:(NSString *)path {
+    if (!path) return nil;
+    NSData *data = [NSData dataWithContentsOfFile:path options:NSDataReadingMappedAlways error:NULL];
+    return [self readerWithData:data];
+}
+
+- (NSArray *)fieldNames {
+    NSMutableArray *names = [NSMutableArray new];
+    for (_YYModelArrowSchemaField *field in _fields) [names addObject:field->_name];
+    return names;
+}
+
+- (NSUInteger)recordBatchCount {
+    return _batches.length / sizeof(YYArrowBatchInfo);
+}
+
+- (NSUInteger)length {
+    const YYArrowBatchInfo *infos = _batches.bytes;
+    NSUInteger length = 0;
+    for (NSUInteger i = 0, max = self.recordBatchCount; i < max; i++) length += (NSUInteger)infos[i].length;
+    return length;
+}
+
+- (NSArray *)columnsInRecordBatch:(NSUInteger)index {
+    if (index >= self.recordBatchCount) return nil;
+    YYArrowBatchInfo info = ((const YYArrowBatchInfo *)_batches.bytes)[index];
+    const uint8_t *bytes = _data.bytes;
+    YYFlatTable header;
+    if (!YYFlatTableInit(&header, bytes + info.metaPos, info.metaLength, info.headerPos)) return nil;
+
+    YYArrowBatchReader r = {0};
+    size_t start;
+    if (!YYFlatTableGetVector(&header, 1, sizeof(YYArrowFieldNode), &start, &r.nodeCount)) return nil;
+    r.nodes = header.base + start;
+    if (!YYFlatTableGetVector(&header, 2, sizeof(YYArrowBuffer), &start, &r.bufferCount)) return nil;
+    r.buffers = header.base + start;
+    r.body = bytes + info.bodyPos;
+    r.bodyLength = info.bodyLength;
+
+    NSMutableArray *columns = [NSMutableArray new];
+    for (_YYModelArrowSchemaField *field in _fields) {
+        YYModelArrowColumn *column = YYArrowReadColumn(&r, field, _data);
+        if (!column || column->_length != (NSUInteger)info.length) return nil;
+        [columns addObject:column];
+    }
+    return columns;
+}
+
+- (YYModelArrowColumn *)columnWithName:(NSString *)name inRecordBatch:(NSUInteger)index {
+    for (YYModelArrowColumn *column in [self columnsInRecordBatch:index]) {
+        if ([column->_name isEqualToString:name]) return column;
+    }
+    return nil;
+}
+
+- (NSArray *)modelsWithClass:(Class)cls {
+    if (!cls) return nil;
+    NSMutableArray *result = [NSMutableArray new];
+    for (NSUInteger i = 0, max = self.recordBatchCount; i < max; i++) {
+        NSArray *columns = [self columnsInRecordBatch:i];
+        if (!columns) return nil;
+        NSUInteger length = (NSUInteger)((const YYArrowBatchInfo *)_batches.bytes)[i].length;
+        NSMutableArray *models = [NSMutableArray arrayWithCapacity:length];
+        for (NSUInteger j = 0; j < length; j++) [models addObject:[cls new]];
+        YYArrowSetColumnsToModels(columns, cls, models, 0, 0);
+        [result addObjectsFromArray:models];
+    }
+    return result;
+}
+
+@end
+
+
+
+@implementation YYModelArrow
+
++ (NSData *)dataWithModels:(NSArray *)models class:(Class)cls format:(YYModelArrowFormat)format {
+    if (!cls || ![models isKindOfClass:[NSArray class]]) return nil;
+    NSArray *fields = YYArrowFieldsForClass(cls, [NSMutableSet new]);
+    if (!fields.count) return nil;
+    NSMutableArray *rows = [NSMutableArray arrayWithCapacity:models.count];
+    for (id model in models) {
+        if ([model isKindOfClass:cls]) [rows addObject:model];
+    }
+
+    YYArrowBatchWriter w;
+    w.body = CFDataCreateMutable(CFAllocatorGetDefault(), 0);
+    w.nodes = CFDataCreateMutable(CFAllocatorGetDefault(), 0);
+    w.buffers = CFDataCreateMutable(CFAllocatorGetDefault(), 0);
+    BOOL succeed = YES;
+    for (_YYModelArrowField *field in fields) {
+        if (!YYArrowWriteField(&w, field, rows)) {
+            succeed = NO;
+            break;
+        }
+    }
+
+    CFMutableDataRef output = NULL;
+    if (succeed) {
+        output = CFDataCreateMutable(CFAllocatorGetDefault(), 0);
+        if (format == YYModelArrowFormatFile) CFDataAppendBytes(output, YYArrowMagic, sizeof(YYArrowMagic));
+        YYFlatBuilder b = {0};
+        YYArrowBlock schemaBlock, batchBlock;
+
+        YYArrowAppendMessage(output, &b, YYArrowMessageTypeSchema, YYArrowBuildSchema(&b, fields), NULL, &schemaBlock);
+        YYFlatBuilderRelease(&b);
+
+        uint32_t nodes = YYFlatBuilderCreateStructVector(&b, CFDataGetBytePtr(w.nodes), sizeof(YYArrowFieldNode),
+                                                         CFDataGetLength(w.nodes) / sizeof(YYArrowFieldNode));
+        uint32_t buffers = YYFlatBuilderCreateStructVector(&b, CFDataGetBytePtr(w.buffers), sizeof(YYArrowBuffer),
+                                                           CFDataGetLength(w.buffers) / sizeof(YYArrowBuffer));
+        YYFlatBuilderStartTable(&b);
+        YYFlatBuilderAdd(&b, 0, int64_t, rows.count);
+        YYFlatBuilderAddOffset(&b, 1, nodes);
+        YYFlatBuilderAddOffset(&b, 2, buffers);
+        uint32_t batch = YYFlatBuilderEndTable(&b);
+        YYArrowAppendMessage(output, &b, YYArrowMessageTypeRecordBatch, batch, w.body, &batchBlock);
+        YYFlatBuilderRelease(&b);
+
+        uint32_t endOfStream[2] = {0xFFFFFFFF, 0};
+        CFDataAppendBytes(output, (const UInt8 *)endOfStream, sizeof(endOfStream));
+
+        if (format == YYModelArrowFormatFile) {
+            uint32_t schema = YYArrowBuildSchema(&b, fields);
+            uint32_t blocks = YYFlatBuilderCreateStructVector(&b, &batchBlock, sizeof(YYArrowBlock), 1);
+            YYFlatBuilderStartTable(&b);
+            YYFlatBuilderAddOffset(&b, 1, schema);
+            YYFlatBuilderAddOffset(&b, 3, blocks);
+            YYFlatBuilderAdd(&b, 0, int16_t, kYYArrowMetadataVersion);
+            YYFlatBuilderFinish(&b, YYFlatBuilderEndTable(&b));
+            uint32_t footerLength = (uint32_t)b.used;
+            CFDataAppendBytes(output, b.buf + b.cap - b.used, b.used);
+            CFDataAppendBytes(output, (const UInt8 *)&footerLength, 4);
+            CFDataAppendBytes(output, YYArrowMagic, 6);
+            YYFlatBuilderRelease(&b);
+        }
+    }
+    CFRelease(w.body);
+    CFRelease(w.nodes);
+    CFRelease(w.buffers);
+    return output ? CFBridgingRelease(output) : nil;
+}
+
++ (BOOL)writeModels:(NSArray *)models class:(Class)cls toFile:(NSString *)path {
+    if (!path) return NO;
+    NSData *data = [self dataWithModels:models class:cls format:YYModelArrowFormatFile];
+    return [data writeToFile:path atomically:YES];
+}
+
++ (NSArray *)modelsWithClass:(Class)cls data:(NSData *)data {
+    return [[YYModelArrowReader readerWithData:data] modelsWithClass:cls];
+}
+
++ (NSArray *)modelsWithClass:(Class)cls file:(NSString *)path {
+    return [[YYModelArrowReader readerWithFile:path] modelsWithClass:cls];
+}
+
+@end
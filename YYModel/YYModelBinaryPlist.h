@@ -0,0 +1,80 @@
+//
+//  YYModelBinaryPlist.h
+//  YYModel <https://github.com/ibireme/YYModel>
+//
+//  This source code is licensed under the MIT-style license found in the
+//  LICENSE file in the root directory of this source tree.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ Writes models to binary property list ("bplist00") data, and reads them back,
+ without the intermediate json objects.
+
+ @discussion A model is written as a dictionary with the same keys as `-yy_modelToJSONObject`,
+ but the values keep their plist types:
+
+     bool                                 -> boolean
+     int8/16/32/64, uint8/16/32/64        -> integer
+     float, double, long double           -> real
+     NSNumber                             -> boolean, integer or real
+     NSDecimalNumber                      -> string (without loss of precision)
+     NSString, NSURL, NSAttributedString  -> string
+     NSData                               -> data
+     NSDate                               -> date
+     NSArray, NSSet                       -> array
+     NSDictionary, other model            -> dictionary
+
+ Equal strings (such as the keys of models) and a model which is referred more than once
+ are written once and shared. NSNull and
+ values which can not be converted are omitted. A model class which has key path mapping
+ or implements `modelCustomTransformToDictionary:` is written with its `-yy_modelToJSONObject`.
+
+ When reading, dictionary keys are matched with the mapper of the model class, and the
+ values are set to the properties with the same conversion as `-yy_modelSetWithDictionary:`.
+ Numbers are set to c number properties without boxing, and nested models are created
+ directly from the plist. A model class which has key path or multi keys mapping, or
+ implements custom transform methods, is set with `-yy_modelSetWithDictionary:` instead.
+ An object which is referred more than once in the plist is decoded once and shared,
+ and an object which refers to itself is ignored.
+ */
+@interface YYModelBinaryPlist : NSObject
+
+/**
+ Creates binary property list data. This method is thread-safe.
+
+ @param object A model, or an array/dictionary/set of models and plist objects.
+ @return The data, or nil if the object can not be converted.
+ */
++ (nullable NSData *)dataWithObject:(id)object;
+
+/**
+ Writes binary property list data to a file, see `dataWithObject:`. This method is thread-safe.
+
+ @return Whether succeed.
+ */
++ (BOOL)writeObject:(id)object toFile:(NSString *)path;
+
+/**
+ Creates models from binary property list data. This method is thread-safe.
+
+ @param cls  The model class.
+ @param data The binary property list data, the top object should be a dictionary
+             or an array of dictionaries.
+ @return A `cls` instance (for a dictionary) or an array of `cls` instances (for an array),
+ or nil if the data is invalid.
+ */
++ (nullable id)modelWithClass:(Class)cls data:(NSData *)data;
+
+/**
+ Creates models from a binary property list file, the file is memory-mapped.
+ This method is thread-safe.
+ */
++ (nullable id)modelWithClass:(Class)cls file:(NSString *)path;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,938 @@
+//
+//  YYModelBinaryPlist.m
+//  YYModel <https://github.com/ibireme/YYModel>
+//
+//  This source code is licensed under the MIT-style license found in the
+//  LICENSE file in the root directory of this source tree.
+//
+
+#import "YYModelBinaryPlist.h"
+#import "YYModelMeta.h"
+#import <objc/message.h>
+
+#define force_inline __inline__ __attribute__((always_inline))
+
+/*
+ Binary property list, see CFBinaryPList.c in CoreFoundation:
+
+     "bplist00" | objects | offset table | trailer (32 bytes)
+
+ All integers are big-endian. An object starts with a marker byte (type in the high 4 bits),
+ a count which doesn't fit in the low 4 bits is followed as an integer object. Arrays and
+ dictionaries refer to other objects with their index in the offset table.
+ */
+
+/// Max nesting depth of arrays, dictionaries and models (a plist may contain cycles).
+#define kYYPlistMaxDepth 512
+/// Length of the trailer.
+#define kYYPlistTrailerLength 32
+
+/// Object type, the high 4 bits of the marker byte.
+typedef NS_ENUM (uint8_t, YYPlistType) {
+    YYPlistTypeSimple = 0x0, ///< null (0x00), false (0x08), true (0x09)
+    YYPlistTypeInt    = 0x1,
+    YYPlistTypeReal   = 0x2,
+    YYPlistTypeDate   = 0x3,
+    YYPlistTypeData   = 0x4,
+    YYPlistTypeASCII  = 0x5,
+    YYPlistTypeUTF16  = 0x6,
+    YYPlistTypeUID    = 0x8,
+    YYPlistTypeArray  = 0xA,
+    YYPlistTypeSet    = 0xC,
+    YYPlistTypeDict   = 0xD,
+};
+
+/// Get the byte count (1, 2, 4 or 8) to store an unsigned integer.
+static force_inline uint8_t YYPlistIntSize(uint64_t value) {
+    if (value <= UINT8_MAX) return 1;
+    if (value <= UINT16_MAX) return 2;
+    if (value <= UINT32_MAX) return 4;
+    return 8;
+}
+
+/// Read a big-endian unsigned integer.
+static force_inline uint64_t YYPlistReadUInt(const uint8_t *bytes, uint8_t size) {
+    uint64_t value = 0;
+    for (uint8_t i = 0; i < size; i++) value = (value << 8) | bytes[i];
+    return value;
+}
+
+
+
+#pragma mark - Writer
+
+/// Object of the writer.
+typedef struct {
+    YYPlistType type;
+    uint8_t size;         ///< byte count of int or real
+    union {
+        int64_t i;        ///< int value (uint64 if size is 16), or the bool value
+        double d;         ///< real or date value
+    } value;
+    CFTypeRef object;     ///< string or data, retained by writer->_objects
+    CFIndex refStart;     ///< first ref of array or dictionary in writer->_refs
+    CFIndex refCount;     ///< number of refs (a dictionary has keys then values)
+} YYPlistEntry;
+
+/// Flattens objects into the object table, and writes the table.
+@interface _YYPlistWriter : NSObject {
+    @package
+    YYPlistEntry *_entries;
+    CFIndex _entryCount, _entryCapacity;
+    CFIndex *_refs;        ///< refs of all arrays and dictionaries
+    CFIndex _refCount, _refCapacity;
+    CFIndex *_stack;       ///< refs of the containers being flattened
+    CFIndex _stackCount, _stackCapacity;
+    NSMutableArray *_objects;        ///< holds the strings and data
+    CFMutableDictionaryRef _strings; ///< string -> entry index, for deduplication
+    CFMutableDictionaryRef _models;  ///< model (compared by pointer) -> entry index, for sharing
+    NSUInteger _depth;
+
+    uint8_t *_bytes;       ///< output
+    size_t _length, _capacity;
+    BOOL _failed;          ///< out of memory
+}
+@end
+
+@implementation _YYPlistWriter
+
+- (instancetype)init {
+    self = [super init];
+    _objects = [NSMutableArray new];
+    _strings = CFDictionaryCreateMutable(kCFAllocatorDefault, 0, &kCFTypeDictionaryKeyCallBacks, NULL);
+    CFDictionaryKeyCallBacks modelCallBacks = kCFTypeDictionaryKeyCallBacks;
+    modelCallBacks.equal = NULL;
+    modelCallBacks.hash = NULL;
+    _models = CFDictionaryCreateMutable(kCFAllocatorDefault, 0, &modelCallBacks, NULL);
+    return self;
+}
+
+- (void)dealloc {
+    free(_entries);
+    free(_refs);
+    free(_stack);
+    free(_bytes);
+    if (_strings) CFRelease(_strings);
+    if (_models) CFRelease(_models);
+}
+
+/// Grow a buffer to hold `count` elements.
+static BOOL YYPlistGrow(void **buffer, CFIndex *capacity, CFIndex count, size_t elementSize) {
+    if (count <= *capacity) return YES;
+    CFIndex newCapacity = MAX(*capacity * 2, MAX(count, 64));
+    void *newBuffer = realloc(*buffer, newCapacity * elementSize);
+    if (!newBuffer) return NO;
+    *buffer = newBuffer;
+    *capacity = newCapacity;
+    return YES;
+}
+
+/// Add an object, returns the index, or -1 if an error occurs.
+static CFIndex YYPlistAddEntry(__unsafe_unretained _YYPlistWriter *writer, YYPlistEntry entry) {
+    if (!YYPlistGrow((void **)&writer->_entries, &writer->_entryCapacity, writer->_entryCount + 1, sizeof(YYPlistEntry))) {
+        writer->_failed = YES;
+        return -1;
+    }
+    writer->_entries[writer->_entryCount] = entry;
+    return writer->_entryCount++;
+}
+
+static force_inline void YYPlistPushRef(__unsafe_unretained _YYPlistWriter *writer, CFIndex ref) {
+    if (!YYPlistGrow((void **)&writer->_stack, &writer->_stackCapacity, writer->_stackCount + 1, sizeof(CFIndex))) {
+        writer->_failed = YES;
+        return;
+    }
+    writer->_stack[writer->_stackCount++] = ref;
+}
+
+/**
+ Move the refs pushed after `mark` to the container.
+ @param isDict YES if the refs are key-value pairs, they're stored as keys then values.
+ */
+static void YYPlistFinishContainer(__unsafe_unretained _YYPlistWriter *writer, CFIndex index, CFIndex mark, BOOL isDict) {
+    CFIndex count = writer->_stackCount - mark;
+    if (!YYPlistGrow((void **)&writer->_refs, &writer->_refCapacity, writer->_refCount + count, sizeof(CFIndex))) {
+        writer->_failed = YES;
+        writer->_stackCount = mark;
+        return;
+    }
+    CFIndex *refs = writer->_refs + writer->_refCount, *stack = writer->_stack + mark;
+    if (isDict) {
+        CFIndex pairs = count / 2;
+        for (CFIndex i = 0; i < pairs; i++) {
+            refs[i] = stack[i * 2];
+            refs[pairs + i] = stack[i * 2 + 1];
+        }
+    } else {
+        memcpy(refs, stack, count * sizeof(CFIndex));
+    }
+    writer->_entries[index].refStart = writer->_refCount;
+    writer->_entries[index].refCount = count;
+    writer->_refCount += count;
+    writer->_stackCount = mark;
+}
+
+static CFIndex YYPlistAddString(__unsafe_unretained _YYPlistWriter *writer, __unsafe_unretained NSString *string) {
+    const void *index = NULL;
+    if (CFDictionaryGetValueIfPresent(writer->_strings, (__bridge CFStringRef)string, &index)) return (CFIndex)index;
+    NSString *copied = [string copy];
+    YYPlistEntry entry = {YYPlistTypeASCII};
+    entry.object = (__bridge CFTypeRef)copied;
+    CFIndex result = YYPlistAddEntry(writer, entry);
+    if (result < 0) return -1;
+    [writer->_objects addObject:copied];
+    CFDictionarySetValue(writer->_strings, (__bridge CFStringRef)copied, (const void *)result);
+    return result;
+}
+
+static force_inline CFIndex YYPlistAddBool(__unsafe_unretained _YYPlistWriter *writer, BOOL value) {
+    YYPlistEntry entry = {YYPlistTypeSimple};
+    entry.value.i = value ? 1 : 0;
+    return YYPlistAddEntry(writer, entry);
+}
+
+static force_inline CFIndex YYPlistAddInt(__unsafe_unretained _YYPlistWriter *writer, int64_t value, BOOL isUnsigned) {
+    YYPlistEntry entry = {YYPlistTypeInt};
+    entry.value.i = value;
+    entry.size = (isUnsigned && value < 0) ? 16 : 8; // uint64 which doesn't fit in int64
+    return YYPlistAddEntry(writer, entry);
+}
+
+static force_inline CFIndex YYPlistAddReal(__unsafe_unretained _YYPlistWriter *writer, double value, BOOL isFloat) {
+    YYPlistEntry entry = {YYPlistTypeReal};
+    entry.value.d = value;
+    entry.size = isFloat ? 4 : 8;
+    return YYPlistAddEntry(writer, entry);
+}
+
+static CFIndex YYPlistAddNumber(__unsafe_unretained _YYPlistWriter *writer, __unsafe_unretained NSNumber *number) {
+    CFNumberRef num = (__bridge CFNumberRef)number;
+    if (CFGetTypeID(num) == CFBooleanGetTypeID()) return YYPlistAddBool(writer, CFBooleanGetValue((CFBooleanRef)num));
+    // a real can't hold the 38 digits of a decimal, the string is parsed back without loss
+    if ([number isKindOfClass:[NSDecimalNumber class]]) return YYPlistAddString(writer, number.stringValue);
+    if (CFGetTypeID(num) != CFNumberGetTypeID() || CFNumberIsFloatType(num)) {
+        double value = number.doubleValue;
+        if (isnan(value) || isinf(value)) return -1;
+        return YYPlistAddReal(writer, value, strcmp(number.objCType, @encode(float)) == 0);
+    }
+    const char *type = number.objCType;
+    if (strcmp(type, @encode(unsigned long long)) == 0 || strcmp(type, @encode(unsigned long)) == 0) {
+        return YYPlistAddInt(writer, (int64_t)number.unsignedLongLongValue, YES);
+    }
+    return YYPlistAddInt(writer, number.longLongValue, NO);
+}
+
+static CFIndex YYPlistAddValue(__unsafe_unretained _YYPlistWriter *writer, __unsafe_unretained id value);
+
+/// A dictionary key and the index of its value.
+typedef struct {
+    __unsafe_unretained NSString *key;
+    NSUInteger index;
+} YYPlistKeyOrder;
+
+static int YYPlistKeyOrderCompare(const void *a, const void *b) {
+    return (int)CFStringCompare((__bridge CFStringRef)((const YYPlistKeyOrder *)a)->key,
+                                (__bridge CFStringRef)((const YYPlistKeyOrder *)b)->key, 0);
+}
+
+/// Add a dictionary, the keys are sorted for a stable output.
+static CFIndex YYPlistAddDictionary(__unsafe_unretained _YYPlistWriter *writer, __unsafe_unretained NSDictionary *dic) {
+    NSMutableArray *keys = [NSMutableArray arrayWithCapacity:dic.count];
+    NSMutableArray *objects = [NSMutableArray arrayWithCapacity:dic.count];
+    [dic enumerateKeysAndObjectsUsingBlock:^(id key, id obj, BOOL *stop) {
+        NSString *stringKey = [key isKindOfClass:[NSString class]] ? key : [key description];
+        if (!stringKey) return;
+        [keys addObject:stringKey];
+        [objects addObject:obj];
+    }];
+    NSUInteger count = keys.count;
+    YYPlistKeyOrder *order = malloc(MAX(count, 1) * sizeof(YYPlistKeyOrder));
+    if (!order) return -1;
+    for (NSUInteger i = 0; i < count; i++) order[i] = (YYPlistKeyOrder){keys[i], i};
+    qsort(order, count, sizeof(YYPlistKeyOrder), YYPlistKeyOrderCompare);
+
+    CFIndex index = YYPlistAddEntry(writer, (YYPlistEntry){YYPlistTypeDict});
+    CFIndex mark = writer->_stackCount;
+    for (NSUInteger i = 0; i < count && index >= 0; i++) {
+        CFIndex valueIndex = YYPlistAddValue(writer, objects[order[i].index]);
+        if (valueIndex < 0) continue;
+        CFIndex keyIndex = YYPlistAddString(writer, order[i].key);
+        if (keyIndex < 0) break;
+        YYPlistPushRef(writer, keyIndex);
+        YYPlistPushRef(writer, valueIndex);
+    }
+    free(order);
+    if (index >= 0) YYPlistFinishContainer(writer, index, mark, YES);
+    return index;
+}
+
+/// Add the value of a property, returns -1 if the value should be ignored.
+static CFIndex YYPlistAddProperty(__unsafe_unretained _YYPlistWriter *writer, __unsafe_unretained id model,
+                                  __unsafe_unretained _YYModelPropertyMeta *meta) {
+    if (meta->_isCNumber && !meta->_encoder && !meta->_enumMapper) {
+        switch (meta->_type & YYEncodingTypeMask) {
+            case YYEncodingTypeBool: return YYPlistAddBool(writer, YYModelGetInt64FromProperty(model, meta) != 0);
+            case YYEncodingTypeFloat:
+            case YYEncodingTypeDouble:
+            case YYEncodingTypeLongDouble: {
+                double value = YYModelGetDoubleFromProperty(model, meta);
+                if (isnan(value) || isinf(value)) return -1;
+                return YYPlistAddReal(writer, value, (meta->_type & YYEncodingTypeMask) == YYEncodingTypeFloat);
+            }
+            case YYEncodingTypeUInt64: return YYPlistAddInt(writer, YYModelGetInt64FromProperty(model, meta), YES);
+            default: return YYPlistAddInt(writer, YYModelGetInt64FromProperty(model, meta), NO);
+        }
+    }
+    id value = YYModelGetJSONValueForProperty(model, meta, NO);
+    if (!value || value == (id)kCFNull) return -1;
+    return YYPlistAddValue(writer, value);
+}
+
+/// Add a model as dictionary, with the same keys as `-yy_modelToJSONObject`.
+static CFIndex YYPlistAddModel(__unsafe_unretained _YYPlistWriter *writer, __unsafe_unretained id model,
+                               __unsafe_unretained _YYModelMeta *modelMeta) {
+    if (!modelMeta->_canonicalPropertyMetas || modelMeta->_hasCustomTransformToDictionary) {
+        // key paths need nested dictionaries, and the custom transform needs the json dictionary
+        id json = [model yy_modelToJSONObject];
+        return [json isKindOfClass:[NSDictionary class]] ? YYPlistAddDictionary(writer, json) : -1;
+    }
+
+    CFIndex index = YYPlistAddEntry(writer, (YYPlistEntry){YYPlistTypeDict});
+    if (index < 0) return -1;
+    CFIndex mark = writer->_stackCount;
+    __unsafe_unretained NSString *lastKey = nil;
+    for (_YYModelPropertyMeta *propertyMeta in modelMeta->_canonicalPropertyMetas) {
+        if (!propertyMeta->_getter) continue;
+        if (lastKey && [lastKey isEqualToString:propertyMeta->_mappedToKey]) continue;
+        CFIndex valueIndex = YYPlistAddProperty(writer, model, propertyMeta);
+        if (valueIndex < 0) continue;
+        CFIndex keyIndex = YYPlistAddString(writer, propertyMeta->_mappedToKey);
+        if (keyIndex < 0) break;
+        lastKey = propertyMeta->_mappedToKey;
+        YYPlistPushRef(writer, keyIndex);
+        YYPlistPushRef(writer, valueIndex);
+    }
+    YYPlistFinishContainer(writer, index, mark, YES);
+    return index;
+}
+
+/// Add a value, returns -1 if the value can not be converted.
+static CFIndex YYPlistAddValue(__unsafe_unretained _YYPlistWriter *writer, __unsafe_unretained id value) {
+    if (!value || value == (id)kCFNull || writer->_failed) return -1;
+    if ([value isKindOfClass:[NSString class]]) return YYPlistAddString(writer, value);
+    if ([value isKindOfClass:[NSNumber class]]) return YYPlistAddNumber(writer, value);
+    if ([value isKindOfClass:[NSData class]]) {
+        NSData *data = [value copy];
+        YYPlistEntry entry = {YYPlistTypeData};
+        entry.object = (__bridge CFTypeRef)data;
+        CFIndex index = YYPlistAddEntry(writer, entry);
+        if (index >= 0) [writer->_objects addObject:data];
+        return index;
+    }
+    if ([value isKindOfClass:[NSDate class]]) {
+        YYPlistEntry entry = {YYPlistTypeDate};
+        entry.value.d = ((NSDate *)value).timeIntervalSinceReferenceDate;
+        return YYPlistAddEntry(writer, entry);
+    }
+    if ([value isKindOfClass:[NSURL class]]) return YYPlistAddString(writer, ((NSURL *)value).absoluteString);
+    if ([value isKindOfClass:[NSAttributedString class]]) return YYPlistAddString(writer, ((NSAttributedString *)value).string);
+
+    if (writer->_depth >= kYYPlistMaxDepth) return -1;
+    writer->_depth++;
+    CFIndex index = -1;
+    if ([value isKindOfClass:[NSDictionary class]]) {
+        index = YYPlistAddDictionary(writer, value);
+    } else if ([value isKindOfClass:[NSArray class]] || [value isKindOfClass:[NSSet class]] ||
+               [value isKindOfClass:[NSOrderedSet class]]) {
+        index = YYPlistAddEntry(writer, (YYPlistEntry){YYPlistTypeArray});
+        if (index >= 0) {
+            CFIndex mark = writer->_stackCount;
+            for (id one in value) {
+                CFIndex oneIndex = YYPlistAddValue(writer, one);
+                if (oneIndex >= 0) YYPlistPushRef(writer, oneIndex);
+            }
+            YYPlistFinishContainer(writer, index, mark, NO);
+        }
+    } else {
+        // a model which is referred more than once is written once, it's added to the table
+        // after its properties, so a model which refers to itself is not shared (no cycle)
+        const void *found = NULL;
+        if (CFDictionaryGetValueIfPresent(writer->_models, (__bridge const void *)value, &found)) {
+            index = (CFIndex)found;
+        } else {
+            _YYModelMeta *modelMeta = [_YYModelMeta metaWithClass:[value class]];
+            if (modelMeta && modelMeta->_keyMappedCount > 0 && !modelMeta->_nsType) {
+                index = YYPlistAddModel(writer, value, modelMeta);
+                if (index >= 0) CFDictionarySetValue(writer->_models, (__bridge const void *)value, (const void *)index);
+            }
+        }
+    }
+    writer->_depth--;
+    return index;
+}
+
+static force_inline void YYPlistAppend(__unsafe_unretained _YYPlistWriter *writer, const void *bytes, size_t length) {
+    if (writer->_length + length > writer->_capacity) {
+        size_t capacity = MAX(writer->_capacity * 2, writer->_length + length + 256);
+        uint8_t *newBytes = realloc(writer->_bytes, capacity);
+        if (!newBytes) {
+            writer->_failed = YES;
+            return;
+        }
+        writer->_bytes = newBytes;
+        writer->_capacity = capacity;
+    }
+    memcpy(writer->_bytes + writer->_length, bytes, length);
+    writer->_length += length;
+}
+
+/// Append a big-endian unsigned integer.
+static force_inline void YYPlistAppendUInt(__unsafe_unretained _YYPlistWriter *writer, uint64_t value, uint8_t size) {
+    uint8_t buffer[8];
+    for (uint8_t i = 0; i < size; i++) buffer[i] = (uint8_t)(value >> ((size - 1 - i) * 8));
+    YYPlistAppend(writer, buffer, size);
+}
+
+/// Append a marker with count, a large count is followed as an int object.
+static force_inline void YYPlistAppendMarker(__unsafe_unretained _YYPlistWriter *writer, YYPlistType type, uint64_t count) {
+    if (count < 0xF) {
+        uint8_t marker = (type << 4) | (uint8_t)count;
+        YYPlistAppend(writer, &marker, 1);
+    } else {
+        uint8_t size = YYPlistIntSize(count);
+        uint8_t marker[2] = {(type << 4) | 0xF, (YYPlistTypeInt << 4) | (size == 1 ? 0 : size == 2 ? 1 : size == 4 ? 2 : 3)};
+        YYPlistAppend(writer, marker, 2);
+        YYPlistAppendUInt(writer, count, size);
+    }
+}
+
+static void YYPlistAppendString(__unsafe_unretained _YYPlistWriter *writer, CFStringRef string) {
+    CFIndex length = CFStringGetLength(string);
+    const char *ascii = CFStringGetCStringPtr(string, kCFStringEncodingASCII);
+    for (CFIndex i = 0; ascii && i < length; i++) {
+        if ((uint8_t)ascii[i] >= 0x80) ascii = NULL; // the internal 8-bit encoding may not be ASCII
+    }
+    if (ascii) {
+        YYPlistAppendMarker(writer, YYPlistTypeASCII, length);
+        YYPlistAppend(writer, ascii, length);
+        return;
+    }
+    UniChar stackBuffer[256];
+    UniChar *chars = length <= 256 ? stackBuffer : malloc(length * sizeof(UniChar));
+    if (!chars) {
+        writer->_failed = YES;
+        return;
+    }
+    CFStringGetCharacters(string, CFRangeMake(0, length), chars);
+    BOOL isASCII = YES;
+    for (CFIndex i = 0; i < length && isASCII; i++) isASCII = chars[i] < 0x80;
+    if (isASCII) {
+        YYPlistAppendMarker(writer, YYPlistTypeASCII, length);
+        for (CFIndex i = 0; i < length; i++) ((uint8_t *)chars)[i] = (uint8_t)chars[i]; // in place, front to back
+        YYPlistAppend(writer, chars, length);
+    } else {
+        YYPlistAppendMarker(writer, YYPlistTypeUTF16, length);
+        for (CFIndex i = 0; i < length; i++) chars[i] = CFSwapInt16HostToBig(chars[i]);
+        YYPlistAppend(writer, chars, length * sizeof(UniChar));
+    }
+    if (chars != stackBuffer) free(chars);
+}
+
+/// Write the objects, offset table and trailer.
+static NSData *YYPlistWriterCreateData(__unsafe_unretained _YYPlistWriter *writer, CFIndex topIndex) {
+    if (writer->_failed || topIndex < 0) return nil;
+    CFIndex count = writer->_entryCount;
+    uint8_t refSize = YYPlistIntSize(count - 1);
+    uint64_t *offsets = malloc(count * sizeof(uint64_t));
+    if (!offsets) return nil;
+
+    YYPlistAppend(writer, "bplist00", 8);
+    for (CFIndex i = 0; i < count && !writer->_failed; i++) {
+        YYPlistEntry *entry = writer->_entries + i;
+        offsets[i] = writer->_length;
+        switch (entry->type) {
+            case YYPlistTypeSimple: {
+                uint8_t marker = entry->value.i ? 0x09 : 0x08;
+                YYPlistAppend(writer, &marker, 1);
+            } break;
+            case YYPlistTypeInt: {
+                int64_t value = entry->value.i;
+                if (entry->size == 16) {
+                    uint8_t marker = (YYPlistTypeInt << 4) | 4;
+                    YYPlistAppend(writer, &marker, 1);
+                    YYPlistAppendUInt(writer, 0, 8);
+                    YYPlistAppendUInt(writer, (uint64_t)value, 8);
+                } else {
+                    uint8_t size = value < 0 ? 8 : YYPlistIntSize(value);
+                    uint8_t marker = (YYPlistTypeInt << 4) | (size == 1 ? 0 : size == 2 ? 1 : size == 4 ? 2 : 3);
+                    YYPlistAppend(writer, &marker, 1);
+                    YYPlistAppendUInt(writer, (uint64_t)value, size);
+                }
+            } break;
+            case YYPlistTypeReal:
+            case YYPlistTypeDate: {
+                if (entry->type == YYPlistTypeReal && entry->size == 4) {
+                    float f = entry->value.d;
+                    uint32_t bits;
+                    memcpy(&bits, &f, 4);
+                    uint8_t marker = (YYPlistTypeReal << 4) | 2;
+                    YYPlistAppend(writer, &marker, 1);
+                    YYPlistAppendUInt(writer, bits, 4);
+                } else {
+                    uint64_t bits;
+                    memcpy(&bits, &entry->value.d, 8);
+                    uint8_t marker = (entry->type << 4) | 3;
+                    YYPlistAppend(writer, &marker, 1);
+                    YYPlistAppendUInt(writer, bits, 8);
+                }
+            } break;
+            case YYPlistTypeData: {
+                CFDataRef data = entry->object;
+                YYPlistAppendMarker(writer, YYPlistTypeData, CFDataGetLength(data));
+                YYPlistAppend(writer, CFDataGetBytePtr(data), CFDataGetLength(data));
+            } break;
+            case YYPlistTypeASCII: {
+                YYPlistAppendString(writer, entry->object);
+            } break;
+            case YYPlistTypeArray:
+            case YYPlistTypeDict: {
+                CFIndex refCount = entry->refCount;
+                YYPlistAppendMarker(writer, entry->type, entry->type == YYPlistTypeDict ? refCount / 2 : refCount);
+                for (CFIndex r = 0; r < refCount; r++) {
+                    YYPlistAppendUInt(writer, writer->_refs[entry->refStart + r], refSize);
+                }
+            } break;
+            default: break;
+        }
+    }
+
+    uint64_t offsetTableOffset = writer->_length;
+    uint8_t offsetSize = YYPlistIntSize(count ? offsets[count - 1] : 0);
+    for (CFIndex i = 0; i < count; i++) YYPlistAppendUInt(writer, offsets[i], offsetSize);
+    free(offsets);
+
+    uint8_t trailer[kYYPlistTrailerLength] = {0};
+    trailer[6] = offsetSize;
+    trailer[7] = refSize;
+    for (int i = 0; i < 8; i++) {
+        trailer[8 + i] = (uint8_t)((uint64_t)count >> ((7 - i) * 8));
+        trailer[16 + i] = (uint8_t)((uint64_t)topIndex >> ((7 - i) * 8));
+        trailer[24 + i] = (uint8_t)(offsetTableOffset >> ((7 - i) * 8));
+    }
+    YYPlistAppend(writer, trailer, kYYPlistTrailerLength);
+    if (writer->_failed) return nil;
+
+    NSData *data = [NSData dataWithBytesNoCopy:writer->_bytes length:writer->_length freeWhenDone:YES];
+    writer->_bytes = NULL;
+    writer->_length = writer->_capacity = 0;
+    return data;
+}
+
+@end
+
+
+
+#pragma mark - Reader
+
+/// A parsed object header.
+typedef struct {
+    YYPlistType type;
+    uint8_t info;          ///< low 4 bits of the marker
+    uint64_t count;        ///< byte count of int/real/date, or the element count
+    const uint8_t *bytes;  ///< the value, or the content
+} YYPlistObject;
+
+typedef struct {
+    const uint8_t *bytes;
+    uint64_t objectsEnd;   ///< objects are in [8, objectsEnd)
+    const uint8_t *offsetTable;
+    uint8_t offsetSize;
+    uint8_t refSize;
+    uint64_t objectCount;
+    uint64_t topObject;
+    CFTypeRef *objects;    ///< decoded Foundation objects (retained), indexed by object
+    CFTypeRef *models;     ///< decoded models (retained), indexed by object
+    uint8_t *visiting;     ///< 1 if the container is being decoded, to break cycles
+} YYPlistReader;
+
+static BOOL YYPlistReaderInit(YYPlistReader *reader, NSData *data) {
+    memset(reader, 0, sizeof(YYPlistReader));
+    const uint8_t *bytes = data.bytes;
+    uint64_t length = data.length;
+    if (length < 8 + kYYPlistTrailerLength || memcmp(bytes, "bplist0", 7) != 0) return NO;
+    const uint8_t *trailer = bytes + length - kYYPlistTrailerLength;
+    uint8_t offsetSize = trailer[6], refSize = trailer[7];
+    uint64_t objectCount = YYPlistReadUInt(trailer + 8, 8);
+    uint64_t topObject = YYPlistReadUInt(trailer + 16, 8);
+    uint64_t offsetTableOffset = YYPlistReadUInt(trailer + 24, 8);
+    if (offsetSize < 1 || offsetSize > 8 || refSize < 1 || refSize > 8) return NO;
+    if (objectCount == 0 || topObject >= objectCount) return NO;
+    if (offsetTableOffset < 9 || offsetTableOffset > length - kYYPlistTrailerLength) return NO;
+    if (objectCount > (length - kYYPlistTrailerLength - offsetTableOffset) / offsetSize) return NO;
+
+    reader->bytes = bytes;
+    reader->objectsEnd = offsetTableOffset;
+    reader->offsetTable = bytes + offsetTableOffset;
+    reader->offsetSize = offsetSize;
+    reader->refSize = refSize;
+    reader->objectCount = objectCount;
+    reader->topObject = topObject;
+    reader->objects = calloc(objectCount, sizeof(CFTypeRef));
+    reader->models = calloc(objectCount, sizeof(CFTypeRef));
+    reader->visiting = calloc(objectCount, sizeof(uint8_t));
+    return reader->objects && reader->models && reader->visiting;
+}
+
+static void YYPlistReaderFree(YYPlistReader *reader) {
+    for (uint64_t i = 0; i < reader->objectCount; i++) {
+        if (reader->objects && reader->objects[i]) CFRelease(reader->objects[i]);
+        if (reader->models && reader->models[i]) CFRelease(reader->models[i]);
+    }
+    free(reader->objects);
+    free(reader->models);
+    free(reader->visiting);
+    memset(reader, 0, sizeof(YYPlistReader));
+}
+
+/// Parse an object header, returns NO if the object is invalid.
+static BOOL YYPlistGetObject(YYPlistReader *reader, uint64_t index, YYPlistObject *object) {
+    if (index >= reader->objectCount) return NO;
+    uint64_t offset = YYPlistReadUInt(reader->offsetTable + index * reader->offsetSize, reader->offsetSize);
+    if (offset < 8 || offset >= reader->objectsEnd) return NO;
+    const uint8_t *cur = reader->bytes + offset, *end = reader->bytes + reader->objectsEnd;
+    uint8_t marker = *cur++;
+    object->type = marker >> 4;
+    object->info = marker & 0xF;
+
+    uint64_t unit = 0;
+    switch (object->type) {
+        case YYPlistTypeSimple: {
+            object->count = 0;
+            object->bytes = cur;
+            return object->info == 0x0 || object->info == 0x8 || object->info == 0x9;
+        }
+        case YYPlistTypeInt: {
+            if (object->info > 4) return NO;
+            object->count = 1ULL << object->info;
+        } break;
+        case YYPlistTypeReal: {
+            if (object->info != 2 && object->info != 3) return NO;
+            object->count = 1ULL << object->info;
+        } break;
+        case YYPlistTypeDate: {
+            if (object->info != 3) return NO;
+            object->count = 8;
+        } break;
+        case YYPlistTypeUID: {
+            object->count = object->info + 1;
+        } break;
+        case YYPlistTypeData:
+        case YYPlistTypeASCII: unit = 1; break;
+        case YYPlistTypeUTF16: unit = 2; break;
+        case YYPlistTypeArray:
+        case YYPlistTypeSet: unit = reader->refSize; break;
+        case YYPlistTypeDict: unit = reader->refSize * 2; break;
+        default: return NO;
+    }
+    if (unit) {
+        uint64_t count = object->info;
+        if (count == 0xF) {
+            if (cur >= end || (*cur >> 4) != YYPlistTypeInt || (*cur & 0xF) > 3) return NO;
+            uint8_t size = 1 << (*cur & 0xF);
+            cur++;
+            if ((uint64_t)(end - cur) < size) return NO;
+            count = YYPlistReadUInt(cur, size);
+            cur += size;
+        }
+        if (count > (uint64_t)(end - cur) / unit) return NO;
+        object->count = count;
+        object->bytes = cur;
+        return YES;
+    }
+    if ((uint64_t)(end - cur) < object->count) return NO;
+    object->bytes = cur;
+    return YES;
+}
+
+static force_inline uint64_t YYPlistGetRef(YYPlistReader *reader, const YYPlistObject *object, uint64_t i) {
+    return YYPlistReadUInt(object->bytes + i * reader->refSize, reader->refSize);
+}
+
+/// Get the value of an int object, `isUnsigned` is YES for a 16-byte int which doesn't fit in int64.
+static force_inline int64_t YYPlistGetInt(const YYPlistObject *object, BOOL *isUnsigned) {
+    if (object->count == 16) {
+        uint64_t value = YYPlistReadUInt(object->bytes + 8, 8);
+        *isUnsigned = (int64_t)value < 0;
+        return (int64_t)value;
+    }
+    *isUnsigned = NO;
+    uint64_t value = YYPlistReadUInt(object->bytes, (uint8_t)object->count);
+    return (int64_t)value; // 1, 2, 4 bytes are unsigned, 8 bytes is signed
+}
+
+static force_inline double YYPlistGetReal(const YYPlistObject *object) {
+    if (object->count == 4) {
+        uint32_t bits = (uint32_t)YYPlistReadUInt(object->bytes, 4);
+        float f;
+        memcpy(&f, &bits, 4);
+        return f;
+    }
+    uint64_t bits = YYPlistReadUInt(object->bytes, 8);
+    double d;
+    memcpy(&d, &bits, 8);
+    return d;
+}
+
+static CFStringRef YYPlistCreateString(const YYPlistObject *object) {
+    if (object->type == YYPlistTypeASCII) {
+        CFStringRef string = CFStringCreateWithBytes(kCFAllocatorDefault, object->bytes, object->count, kCFStringEncodingASCII, false);
+        if (!string) string = CFStringCreateWithBytes(kCFAllocatorDefault, object->bytes, object->count, kCFStringEncodingUTF8, false);
+        return string;
+    }
+    if (object->type == YYPlistTypeUTF16) {
+        return CFStringCreateWithBytes(kCFAllocatorDefault, object->bytes, object->count * 2, kCFStringEncodingUTF16BE, false);
+    }
+    return NULL;
+}
+
+static id YYPlistDecodeObject(YYPlistReader *reader, uint64_t index, NSUInteger depth);
+
+/// Get a dictionary key, the key is decoded once and shared by all the dictionaries.
+static force_inline NSString *YYPlistGetKey(YYPlistReader *reader, uint64_t index) {
+    if (index < reader->objectCount && reader->objects[index]) {
+        id key = (__bridge id)reader->objects[index];
+        return [key isKindOfClass:[NSString class]] ? key : nil;
+    }
+    YYPlistObject object;
+    if (!YYPlistGetObject(reader, index, &object)) return nil;
+    if (object.type != YYPlistTypeASCII && object.type != YYPlistTypeUTF16) return nil;
+    CFStringRef key = YYPlistCreateString(&object);
+    if (!key) return nil;
+    reader->objects[index] = key;
+    return (__bridge NSString *)key;
+}
+
+/**
+ Create a Foundation object, returns nil if the object is invalid or not supported.
+
+ @discussion An object is decoded once and shared (the keys of all dictionaries,
+ a shared array...), a container which refers to itself is invalid.
+ */
+static id YYPlistCreateObject(YYPlistReader *reader, uint64_t index, NSUInteger depth) {
+    if (index >= reader->objectCount) return nil;
+    if (reader->objects[index]) return (__bridge id)reader->objects[index];
+    if (reader->visiting[index] || depth >= kYYPlistMaxDepth) return nil;
+    reader->visiting[index] = 1;
+    id result = YYPlistDecodeObject(reader, index, depth);
+    reader->visiting[index] = 0;
+    if (result) reader->objects[index] = CFBridgingRetain(result);
+    return result;
+}
+
+static id YYPlistDecodeObject(YYPlistReader *reader, uint64_t index, NSUInteger depth) {
+    YYPlistObject object;
+    if (!YYPlistGetObject(reader, index, &object)) return nil;
+    switch (object.type) {
+        case YYPlistTypeSimple: {
+            if (object.info == 0x8) return (id)kCFBooleanFalse;
+            if (object.info == 0x9) return (id)kCFBooleanTrue;
+            return (id)kCFNull;
+        }
+        case YYPlistTypeInt: {
+            BOOL isUnsigned = NO;
+            int64_t value = YYPlistGetInt(&object, &isUnsigned);
+            return isUnsigned ? @((unsigned long long)value) : @((long long)value);
+        }
+        case YYPlistTypeReal: {
+            double value = YYPlistGetReal(&object);
+            return object.count == 4 ? @((float)value) : @(value);
+        }
+        case YYPlistTypeDate: {
+            return [NSDate dateWithTimeIntervalSinceReferenceDate:YYPlistGetReal(&object)];
+        }
+        case YYPlistTypeData: {
+            return [NSData dataWithBytes:object.bytes length:(NSUInteger)object.count];
+        }
+        case YYPlistTypeASCII:
+        case YYPlistTypeUTF16: {
+            return CFBridgingRelease(YYPlistCreateString(&object));
+        }
+        case YYPlistTypeArray:
+        case YYPlistTypeSet: {
+            NSMutableArray *array = [NSMutableArray arrayWithCapacity:(NSUInteger)object.count];
+            for (uint64_t i = 0; i < object.count; i++) {
+                id one = YYPlistCreateObject(reader, YYPlistGetRef(reader, &object, i), depth + 1);
+                if (one) [array addObject:one];
+            }
+            return object.type == YYPlistTypeSet ? [NSSet setWithArray:array] : array;
+        }
+        case YYPlistTypeDict: {
+            NSMutableDictionary *dic = [NSMutableDictionary dictionaryWithCapacity:(NSUInteger)object.count];
+            for (uint64_t i = 0; i < object.count; i++) {
+                NSString *key = YYPlistGetKey(reader, YYPlistGetRef(reader, &object, i));
+                if (!key) continue;
+                id value = YYPlistCreateObject(reader, YYPlistGetRef(reader, &object, object.count + i), depth + 1);
+                if (value) dic[key] = value;
+            }
+            return dic;
+        }
+        default: return nil;
+    }
+}
+
+static id YYPlistCreateModel(YYPlistReader *reader, uint64_t index, Class cls, NSUInteger depth);
+
+/// Set a plist object to a property, same as the conversion of `-yy_modelSetWithDictionary:`.
+static void YYPlistSetProperty(YYPlistReader *reader, __unsafe_unretained id model, uint64_t index,
+                               __unsafe_unretained _YYModelPropertyMeta *meta, NSUInteger depth) {
+    YYPlistObject object;
+    if (!YYPlistGetObject(reader, index, &object)) return;
+
+    if (meta->_isCNumber && !meta->_decoder && !meta->_enumMapper) {
+        YYEncodingType type = meta->_type & YYEncodingTypeMask;
+        BOOL isFloat = (type == YYEncodingTypeFloat || type == YYEncodingTypeDouble || type == YYEncodingTypeLongDouble);
+        switch (object.type) {
+            case YYPlistTypeSimple: {
+                YYModelSetInt64ToProperty(model, object.info == 0x9, meta);
+            } return;
+            case YYPlistTypeInt: {
+                BOOL isUnsigned = NO;
+                int64_t value = YYPlistGetInt(&object, &isUnsigned);
+                if (isFloat) YYModelSetDoubleToProperty(model, isUnsigned ? (double)(uint64_t)value : (double)value, meta);
+                else YYModelSetInt64ToProperty(model, value, meta);
+            } return;
+            case YYPlistTypeReal: {
+                double value = YYPlistGetReal(&object);
+                if (isnan(value) || isinf(value)) value = 0;
+                if (type == YYEncodingTypeBool) YYModelSetInt64ToProperty(model, value != 0, meta);
+                else YYModelSetDoubleToProperty(model, value, meta);
+            } return;
+            default: break;
+        }
+    }
+
+    if (!meta->_decoder && !meta->_hasCustomClassFromDictionary) {
+        if (object.type == YYPlistTypeDict && meta->_nsType == YYEncodingTypeNSUnknown &&
+            (meta->_type & YYEncodingTypeMask) == YYEncodingTypeObject && meta->_cls &&
+            !(meta->_getter && ((id (*)(id, SEL))(void *) objc_msgSend)((id)model, meta->_getter))) {
+            // an existing model is updated with the dictionary, see below
+            id value = YYPlistCreateModel(reader, index, meta->_cls, depth + 1);
+            if (value) ((void (*)(id, SEL, id))(void *) objc_msgSend)((id)model, meta->_setter, value);
+            return;
+        }
+        if (object.type == YYPlistTypeArray && meta->_genericCls &&
+            (meta->_nsType == YYEncodingTypeNSArray || meta->_nsType == YYEncodingTypeNSMutableArray)) {
+            if (depth >= kYYPlistMaxDepth) return;
+            NSMutableArray *array = [NSMutableArray arrayWithCapacity:(NSUInteger)object.count];
+            for (uint64_t i = 0; i < object.count; i++) {
+                uint64_t ref = YYPlistGetRef(reader, &object, i);
+                YYPlistObject element;
+                if (!YYPlistGetObject(reader, ref, &element)) continue;
+                id one = nil;
+                if (element.type == YYPlistTypeDict) {
+                    one = YYPlistCreateModel(reader, ref, meta->_genericCls, depth + 1);
+                } else {
+                    one = YYPlistCreateObject(reader, ref, depth + 1);
+                    if (![one isKindOfClass:meta->_genericCls]) one = nil;
+                }
+                if (one) [array addObject:one];
+            }
+            ((void (*)(id, SEL, id))(void *) objc_msgSend)((id)model, meta->_setter, array);
+            return;
+        }
+    }
+
+    id value = YYPlistCreateObject(reader, index, depth + 1);
+    if (value) YYModelSetValueForProperty(model, value, meta);
+}
+
+/**
+ Create a model from a dictionary object, returns nil if the object is not a dictionary.
+
+ @discussion A dictionary which is referred more than once is decoded to one shared model,
+ a dictionary which refers to itself (with a model property) is invalid.
+ */
+static id YYPlistCreateModel(YYPlistReader *reader, uint64_t index, Class cls, NSUInteger depth) {
+    if (index >= reader->objectCount || depth >= kYYPlistMaxDepth) return nil;
+    id cached = (__bridge id)reader->models[index];
+    if (cached && object_getClass(cached) == cls) return cached;
+    YYPlistObject object;
+    if (!YYPlistGetObject(reader, index, &object) || object.type != YYPlistTypeDict) return nil;
+    _YYModelMeta *modelMeta = [_YYModelMeta metaWithClass:cls];
+    if (!modelMeta) return nil;
+
+    if (modelMeta->_keyPathPropertyMetas.count || modelMeta->_multiKeysPropertyMetas.count ||
+        modelMeta->_hasCustomWillTransformFromDictionary || modelMeta->_hasCustomTransformFromDictionary ||
+        modelMeta->_hasCustomClassFromDictionary) {
+        NSDictionary *dic = YYPlistCreateObject(reader, index, depth);
+        return [dic isKindOfClass:[NSDictionary class]] ? [cls yy_modelWithDictionary:dic] : nil;
+    }
+    if (reader->visiting[index]) return nil;
+
+    id model = [cls new];
+    CFDictionaryRef mapper = (__bridge CFDictionaryRef)modelMeta->_mapper;
+    if (!mapper) return model;
+    reader->visiting[index] = 1;
+    for (uint64_t i = 0; i < object.count; i++) {
+        NSString *key = YYPlistGetKey(reader, YYPlistGetRef(reader, &object, i));
+        if (!key) continue;
+        __unsafe_unretained _YYModelPropertyMeta *propertyMeta = CFDictionaryGetValue(mapper, (__bridge CFStringRef)key);
+        if (!propertyMeta) continue;
+        uint64_t valueIndex = YYPlistGetRef(reader, &object, object.count + i);
+        for (; propertyMeta; propertyMeta = propertyMeta->_next) {
+            if (propertyMeta->_setter) YYPlistSetProperty(reader, model, valueIndex, propertyMeta, depth);
+        }
+    }
+    reader->visiting[index] = 0;
+    if (!cached) reader->models[index] = CFBridgingRetain(model);
+    return model;
+}
+
+
+
+@implementation YYModelBinaryPlist
+
++ (NSData *)dataWithObject:(id)object {
+    if (!object) return nil;
+    _YYPlistWriter *writer = [_YYPlistWriter new];
+    return YYPlistWriterCreateData(writer, YYPlistAddValue(writer, object));
+}
+
++ (BOOL)writeObject:(id)object toFile:(NSString *)path {
+    if (!path) return NO;
+    NSData *data = [self dataWithObject:object];
+    return data ? [data writeToFile:path atomically:YES] : NO;
+}
+
++ (id)modelWithClass:(Class)cls data:(NSData *)data {
+    if (!cls || !data) return nil;
+    YYPlistReader reader;
+    if (!YYPlistReaderInit(&reader, data)) return nil;
+    id result = nil;
+    YYPlistObject top;
+    if (YYPlistGetObject(&reader, reader.topObject, &top)) {
+        if (top.type == YYPlistTypeDict) {
+            result = YYPlistCreateModel(&reader, reader.topObject, cls, 0);
+        } else if (top.type == YYPlistTypeArray) {
+            NSMutableArray *models = [NSMutableArray arrayWithCapacity:(NSUInteger)top.count];
+            for (uint64_t i = 0; i < top.count; i++) {
+                @autoreleasepool {
+                    id model = YYPlistCreateModel(&reader, YYPlistGetRef(&reader, &top, i), cls, 1);
+                    if (model) [models addObject:model];
+                }
+            }
+            result = models;
+        }
+    }
+    YYPlistReaderFree(&reader);
+    return result;
+}
+
++ (id)modelWithClass:(Class)cls file:(NSString *)path {
+    if (!path) return nil;
+    NSData *data = [NSData dataWithContentsOfFile:path options:NSDataReadingMappedAlways error:NULL];
+    if (!data) return nil;
+    return [self modelWithClass:cls data:data];
+}
+
+@end
@@ -0,0 +1,106 @@
+//
+//  YYModelCSV.h
+//  YYModel <https://github.com/ibireme/YYModel>
+//
+//  This source code is licensed under the MIT-style license found in the
+//  LICENSE file in the root directory of this source tree.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ Reads CSV/TSV (RFC 4180) data into models, and writes models to CSV/TSV data.
+
+ @discussion The first record is the header. Each header column is matched to the
+ properties once, the same as the keys of a json dictionary: a column named with the
+ property's mapped key (or key path such as "user.name", or one of its multi keys)
+ is set to the property. The fields of each row are then parsed directly into the
+ properties, with the same type conversion as `-yy_modelSetWithDictionary:` (number
+ strings, "true"/"false", dates, urls, enum names, property transformers...), an
+ object or container property accepts a field of json text. An empty field is ignored,
+ and a quoted empty field ("") is an empty string.
+
+ Fields may be quoted with '"', a quote in a quoted field is written as two quotes,
+ and a quoted field may contain delimiters and line breaks. Records are separated by
+ LF, CRLF or CR, empty lines and a leading UTF-8 BOM are ignored. The data should
+ be encoded in UTF-8.
+
+ Large data (more than twice `parallelChunkSize`) is split into chunks at record
+ boundaries, and the chunks are parsed concurrently, the models are returned in the
+ order of records. The model's custom transform methods are not called.
+
+ An instance should not be modified while it is in use, the methods are thread-safe.
+ */
+@interface YYModelCSV : NSObject
+
+/// A comma-separated values codec.
++ (instancetype)CSV;
+
+/// A tab-separated values codec.
++ (instancetype)TSV;
+
+/// Creates a codec with the field delimiter, returns nil if the delimiter is not an ASCII
+/// character other than '"', CR and LF.
+- (nullable instancetype)initWithDelimiter:(char)delimiter NS_DESIGNATED_INITIALIZER;
+
+/// Same as `initWithDelimiter:','`.
+- (instancetype)init;
+
+/// The field delimiter.
+@property (nonatomic, assign, readonly) char delimiter;
+
+/// The size of data parsed by one thread, 0 to parse on the calling thread only. Default is 1MB.
+@property (nonatomic, assign) NSUInteger parallelChunkSize;
+
+/**
+ Creates an array of model from CSV data.
+
+ @param cls  The model class.
+ @param data The CSV data with a header.
+ @return An array of `cls` instances (one for each record after the header),
+ or nil if the data has no header or an error occurs.
+ */
+- (nullable NSArray *)modelsWithClass:(Class)cls data:(NSData *)data;
+
+/**
+ Creates an array of model from a CSV file, the file is memory-mapped.
+ */
+- (nullable NSArray *)modelsWithClass:(Class)cls file:(NSString *)path;
+
+/**
+ Reads a CSV file record by record with a small buffer, and creates the models one by one.
+ It's suitable for files which are too large to be loaded at once.
+
+ @param cls   The model class.
+ @param path  The file path.
+ @param block The block to receive each model in order, set `*stop` to YES to stop reading.
+ @return NO if the file can not be read, has no header, or an error occurs.
+ */
+- (BOOL)enumerateModelsWithClass:(Class)cls file:(NSString *)path usingBlock:(void (^)(id model, BOOL *stop))block;
+
+/**
+ Creates CSV data from an array of model.
+
+ @discussion The columns are the mapped keys of the properties (a property mapped to
+ multiple keys uses the first key), sorted by name. String values are written as is,
+ other values are written as canonical json text (such as 12, 1.5, true, [1,2]),
+ nil values are written as empty fields.
+
+ @param models An array of `cls` instances, other objects are ignored.
+ @param cls    The model class.
+ @return The data, or nil if the class has no property to write.
+ */
+- (nullable NSData *)dataWithModels:(NSArray *)models class:(Class)cls;
+
+/**
+ Writes an array of model to a CSV file, the data is written in pieces.
+
+ @return Whether succeed.
+ */
+- (BOOL)writeModels:(NSArray *)models class:(Class)cls toFile:(NSString *)path;
+
+@end
+
+NS_ASSUME_NONNULL_END
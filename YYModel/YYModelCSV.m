@@ -0,0 +1,676 @@
+//
+//  YYModelCSV.m
+//  YYModel <https://github.com/ibireme/YYModel>
+//
+//  This source code is licensed under the MIT-style license found in the
+//  LICENSE file in the root directory of this source tree.
+//
+
+#import "YYModelCSV.h"
+#import "YYModelMeta.h"
+
+#define force_inline __inline__ __attribute__((always_inline))
+
+/// Size of the read buffer when reading a file record by record (grows for a larger record).
+#define kYYCSVReadBufferSize (64 * 1024)
+/// Size of the pending output when writing a file.
+#define kYYCSVWriteBufferSize (256 * 1024)
+/// Number of records between two autorelease pool drains.
+#define kYYCSVPoolBatchSize 256
+
+/// A field of a record, the bytes point into the parsed data.
+typedef struct {
+    const uint8_t *bytes; ///< the content, without the enclosing quotes
+    size_t length;        ///< length of the content
+    BOOL quoted;          ///< YES if the field is enclosed in quotes
+    BOOL escaped;         ///< YES if the content has doubled quotes
+} YYCSVField;
+
+/// Reusable state of a parser, it's not shared between threads.
+typedef struct {
+    YYCSVField *fields;   ///< fields of the last record
+    size_t fieldCount;
+    size_t fieldCapacity;
+    uint8_t *scratch;     ///< buffer to unescape a field
+    size_t scratchCapacity;
+} YYCSVParser;
+
+typedef NS_ENUM (NSUInteger, YYCSVParseResult) {
+    YYCSVParseResultRecord = 0, ///< a record is parsed
+    YYCSVParseResultEnd,        ///< no more record in the data
+    YYCSVParseResultIncomplete, ///< the record may continue after the data
+    YYCSVParseResultError,      ///< failed to allocate memory
+};
+
+static void YYCSVParserFree(YYCSVParser *parser) {
+    free(parser->fields);
+    free(parser->scratch);
+    memset(parser, 0, sizeof(YYCSVParser));
+}
+
+static force_inline BOOL YYCSVParserAddField(YYCSVParser *parser, YYCSVField field) {
+    if (parser->fieldCount == parser->fieldCapacity) {
+        size_t capacity = parser->fieldCapacity ? parser->fieldCapacity * 2 : 32;
+        YYCSVField *fields = realloc(parser->fields, capacity * sizeof(YYCSVField));
+        if (!fields) return NO;
+        parser->fields = fields;
+        parser->fieldCapacity = capacity;
+    }
+    parser->fields[parser->fieldCount++] = field;
+    return YES;
+}
+
+/// Skip the UTF-8 BOM.
+static force_inline const uint8_t *YYCSVSkipBOM(const uint8_t *cur, const uint8_t *end) {
+    if (end - cur >= 3 && cur[0] == 0xEF && cur[1] == 0xBB && cur[2] == 0xBF) return cur + 3;
+    return cur;
+}
+
+/**
+ Parse a record, the fields are stored in parser->fields.
+
+ @param cur       In: the position to parse, out: the start of the next record.
+                  It's not changed if the result is YYCSVParseResultIncomplete.
+ @param end       The end of the data.
+ @param delimiter The field delimiter.
+ @param final     NO if more data may follow, a record which reaches the end of data
+                  is incomplete (the line break is not seen yet).
+ @param parser    The parser.
+ */
+static YYCSVParseResult YYCSVParseRecord(const uint8_t **cur, const uint8_t *end, uint8_t delimiter, BOOL final, YYCSVParser *parser) {
+    const uint8_t *p = *cur;
+    while (p < end && (*p == '\n' || *p == '\r')) p++; // empty lines
+    if (p == end) {
+        *cur = p;
+        return YYCSVParseResultEnd;
+    }
+
+    parser->fieldCount = 0;
+    for (;;) {
+        YYCSVField field = {0};
+        if (p < end && *p == '"') {
+            field.quoted = YES;
+            field.bytes = ++p;
+            for (;;) {
+                const uint8_t *quote = memchr(p, '"', end - p);
+                if (!quote) { // unterminated, take the rest
+                    if (!final) return YYCSVParseResultIncomplete;
+                    field.length = end - field.bytes;
+                    p = end;
+                    break;
+                }
+                if (quote + 1 == end && !final) return YYCSVParseResultIncomplete;
+                if (quote + 1 < end && quote[1] == '"') {
+                    field.escaped = YES;
+                    p = quote + 2;
+                    continue;
+                }
+                field.length = quote - field.bytes;
+                p = quote + 1;
+                break;
+            }
+            // ignore the characters between the closing quote and the delimiter
+            while (p < end && *p != delimiter && *p != '\n' && *p != '\r') p++;
+        } else {
+            field.bytes = p;
+            while (p < end && *p != delimiter && *p != '\n' && *p != '\r') p++;
+            field.length = p - field.bytes;
+        }
+        if (!YYCSVParserAddField(parser, field)) return YYCSVParseResultError;
+
+        if (p == end) {
+            if (!final) return YYCSVParseResultIncomplete;
+            break;
+        }
+        if (*p == delimiter) {
+            p++;
+            if (p == end && !final) return YYCSVParseResultIncomplete;
+            continue;
+        }
+        if (*p == '\r') {
+            p++;
+            if (p < end && *p == '\n') p++; // a split CRLF leaves an empty line for the next read
+        } else {
+            p++;
+        }
+        break;
+    }
+    *cur = p;
+    return YYCSVParseResultRecord;
+}
+
+/**
+ Get the content of a field, doubled quotes are unescaped into the parser's scratch buffer.
+ @return The content, or NULL if an error occurs.
+ */
+static force_inline const uint8_t *YYCSVFieldGetBytes(const YYCSVField *field, YYCSVParser *parser, size_t *length) {
+    if (!field->escaped) {
+        *length = field->length;
+        return field->bytes;
+    }
+    if (parser->scratchCapacity < field->length) {
+        size_t capacity = MAX(field->length, parser->scratchCapacity * 2);
+        uint8_t *scratch = realloc(parser->scratch, capacity);
+        if (!scratch) return NULL;
+        parser->scratch = scratch;
+        parser->scratchCapacity = capacity;
+    }
+    const uint8_t *src = field->bytes, *srcEnd = field->bytes + field->length;
+    uint8_t *dst = parser->scratch;
+    while (src < srcEnd) {
+        uint8_t c = *src++;
+        *dst++ = c;
+        if (c == '"' && src < srcEnd && *src == '"') src++;
+    }
+    *length = dst - parser->scratch;
+    return parser->scratch;
+}
+
+/// Whether the field of a property may be json text.
+static force_inline BOOL YYCSVPropertyAcceptsJSON(_YYModelPropertyMeta *meta) {
+    switch (meta->_nsType) {
+        case YYEncodingTypeNSArray:
+        case YYEncodingTypeNSMutableArray:
+        case YYEncodingTypeNSDictionary:
+        case YYEncodingTypeNSMutableDictionary:
+        case YYEncodingTypeNSSet:
+        case YYEncodingTypeNSMutableSet: return YES;
+        case YYEncodingTypeNSUnknown: return (meta->_type & YYEncodingTypeMask) == YYEncodingTypeObject;
+        default: return NO;
+    }
+}
+
+/// Whether the character may start a number.
+static force_inline BOOL YYCSVIsNumberStart(uint8_t c) {
+    return (c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.';
+}
+
+/**
+ Set a field to a property, the conversion is same as the json value of a string.
+
+ @param model  Should not be nil.
+ @param bytes  The unescaped content of the field.
+ @param length The length of content.
+ @param meta   Should not be nil, and meta->_setter should not be nil.
+ */
+static void YYCSVSetFieldToProperty(__unsafe_unretained id model, const uint8_t *bytes, size_t length,
+                                    __unsafe_unretained _YYModelPropertyMeta *meta) {
+    if (meta->_isCNumber && !meta->_decoder && !meta->_enumMapper &&
+        length > 0 && length < 64 && YYCSVIsNumberStart(bytes[0])) {
+        char buffer[64];
+        memcpy(buffer, bytes, length);
+        buffer[length] = '\0';
+        YYModelSetNumberCStringToProperty(model, buffer, meta);
+        return;
+    }
+
+    id value = nil;
+    if (length > 0 && (bytes[0] == '[' || bytes[0] == '{') && YYCSVPropertyAcceptsJSON(meta)) {
+        NSData *data = [[NSData alloc] initWithBytesNoCopy:(void *)bytes length:length freeWhenDone:NO];
+        value = [NSJSONSerialization JSONObjectWithData:data options:kNilOptions error:NULL];
+    }
+    if (!value) {
+        value = CFBridgingRelease(CFStringCreateWithBytes(kCFAllocatorDefault, bytes, length, kCFStringEncodingUTF8, false));
+        if (!value) return;
+    }
+    YYModelSetValueForProperty(model, value, meta);
+}
+
+
+
+/// A property set from a column.
+typedef struct {
+    NSUInteger column;
+    __unsafe_unretained _YYModelPropertyMeta *meta; ///< retained by the model meta
+} YYCSVBinding;
+
+/// The properties matched to the header columns.
+@interface _YYModelCSVMapping : NSObject {
+    @package
+    _YYModelMeta *_modelMeta;
+    YYCSVBinding *_bindings; ///< sorted by column
+    NSUInteger _bindingCount;
+}
+@end
+
+@implementation _YYModelCSVMapping
+
+- (void)dealloc {
+    free(_bindings);
+}
+
+static int YYCSVBindingCompare(const void *a, const void *b) {
+    NSUInteger column1 = ((const YYCSVBinding *)a)->column, column2 = ((const YYCSVBinding *)b)->column;
+    return column1 < column2 ? -1 : (column1 > column2 ? 1 : 0);
+}
+
+/// Match the header to the properties, same as the keys of json dictionary.
++ (instancetype)mappingWithModelMeta:(_YYModelMeta *)modelMeta header:(YYCSVParser *)parser {
+    NSMutableDictionary *columns = [NSMutableDictionary new];
+    for (NSUInteger i = 0; i < parser->fieldCount; i++) {
+        size_t length = 0;
+        const uint8_t *bytes = YYCSVFieldGetBytes(parser->fields + i, parser, &length);
+        if (!bytes) return nil;
+        NSString *name = CFBridgingRelease(CFStringCreateWithBytes(kCFAllocatorDefault, bytes, length, kCFStringEncodingUTF8, false));
+        if (name.length && !columns[name]) columns[name] = @(i);
+    }
+
+    _YYModelCSVMapping *mapping = [self new];
+    mapping->_modelMeta = modelMeta;
+    mapping->_bindings = calloc(MAX(modelMeta->_allPropertyMetas.count, 1), sizeof(YYCSVBinding));
+    if (!mapping->_bindings) return nil;
+
+    // key and key path (the mapper key is "a.b" for a key path)
+    [modelMeta->_mapper enumerateKeysAndObjectsUsingBlock:^(id key, _YYModelPropertyMeta *propertyMeta, BOOL *stop) {
+        if (![key isKindOfClass:[NSString class]]) return;
+        NSNumber *column = columns[key];
+        if (!column) return;
+        for (; propertyMeta; propertyMeta = propertyMeta->_next) {
+            if (!propertyMeta->_setter || propertyMeta->_mappedToKeyArray) continue;
+            mapping->_bindings[mapping->_bindingCount++] = (YYCSVBinding){column.unsignedIntegerValue, propertyMeta};
+        }
+    }];
+
+    // multi keys, the first key in header is used
+    for (_YYModelPropertyMeta *propertyMeta in modelMeta->_multiKeysPropertyMetas) {
+        if (!propertyMeta->_setter) continue;
+        for (id key in propertyMeta->_mappedToKeyArray) {
+            NSString *name = [key isKindOfClass:[NSString class]] ? key : [(NSArray *)key componentsJoinedByString:@"."];
+            NSNumber *column = columns[name];
+            if (!column) continue;
+            mapping->_bindings[mapping->_bindingCount++] = (YYCSVBinding){column.unsignedIntegerValue, propertyMeta};
+            break;
+        }
+    }
+
+    qsort(mapping->_bindings, mapping->_bindingCount, sizeof(YYCSVBinding), YYCSVBindingCompare);
+    return mapping;
+}
+
+/// Create a model with the fields of the last parsed record.
+- (id)modelWithClass:(Class)cls parser:(YYCSVParser *)parser {
+    id model = [cls new];
+    for (NSUInteger i = 0; i < _bindingCount; i++) {
+        YYCSVBinding *binding = _bindings + i;
+        if (binding->column >= parser->fieldCount) break;
+        YYCSVField *field = parser->fields + binding->column;
+        if (field->length == 0 && !field->quoted) continue; // empty field is ignored
+        size_t length = 0;
+        const uint8_t *bytes = YYCSVFieldGetBytes(field, parser, &length);
+        if (bytes) YYCSVSetFieldToProperty(model, bytes, length, binding->meta);
+    }
+    return model;
+}
+
+@end
+
+
+/**
+ Parse the records in data to models.
+
+ @param models The output.
+ @return NO if an error occurs.
+ */
+static BOOL YYCSVParseModels(Class cls, _YYModelCSVMapping *mapping, const uint8_t *cur, const uint8_t *end,
+                             uint8_t delimiter, NSMutableArray *models) {
+    YYCSVParser parser = {0};
+    YYCSVParseResult result = YYCSVParseResultRecord;
+    while (result == YYCSVParseResultRecord) {
+        @autoreleasepool {
+            for (NSUInteger i = 0; i < kYYCSVPoolBatchSize; i++) {
+                result = YYCSVParseRecord(&cur, end, delimiter, YES, &parser);
+                if (result != YYCSVParseResultRecord) break;
+                [models addObject:[mapping modelWithClass:cls parser:&parser]];
+            }
+        }
+    }
+    YYCSVParserFree(&parser);
+    return result != YYCSVParseResultError;
+}
+
+/// The state of a position in a record, same as YYCSVParseRecord().
+typedef NS_ENUM (NSUInteger, YYCSVScanState) {
+    YYCSVScanStateFieldStart = 0, ///< at the start of a field or a record
+    YYCSVScanStateUnquoted,       ///< in an unquoted field, a quote is a normal character
+    YYCSVScanStateQuoted,         ///< in a quoted field
+    YYCSVScanStateQuote,          ///< after a quote in a quoted field (closed, or the first of two quotes)
+    YYCSVScanStateQuoteClosed,    ///< after a closed quoted field, ignored until the delimiter
+};
+
+/**
+ Scan the data with the same rules as YYCSVParseRecord(): a quote only starts a quoted
+ field at the start of the field, so a stray quote such as `5'11"` doesn't change the state.
+
+ @param cur          The position to scan.
+ @param end          The end of the data.
+ @param delimiter    The field delimiter.
+ @param untilRecord  YES to stop after the first line break which ends a record.
+ @param state        In/out: the state of `cur`.
+ @return The position after the line break which ends a record, or `end`.
+ */
+static const uint8_t *YYCSVScan(const uint8_t *cur, const uint8_t *end, uint8_t delimiter,
+                                BOOL untilRecord, YYCSVScanState *state) {
+    YYCSVScanState s = *state;
+    while (cur < end) {
+        if (s == YYCSVScanStateQuoted) {
+            const uint8_t *quote = memchr(cur, '"', end - cur);
+            if (!quote) {
+                cur = end;
+                break;
+            }
+            cur = quote + 1;
+            s = YYCSVScanStateQuote;
+            continue;
+        }
+        uint8_t c = *cur++;
+        if (c == delimiter) {
+            s = YYCSVScanStateFieldStart;
+        } else if (c == '\n' || c == '\r') {
+            s = YYCSVScanStateFieldStart;
+            if (untilRecord) break;
+        } else if (c == '"') {
+            if (s == YYCSVScanStateFieldStart || s == YYCSVScanStateQuote) s = YYCSVScanStateQuoted;
+        } else {
+            if (s == YYCSVScanStateFieldStart) s = YYCSVScanStateUnquoted;
+            else if (s == YYCSVScanStateQuote) s = YYCSVScanStateQuoteClosed;
+        }
+    }
+    *state = s;
+    return cur;
+}
+
+/**
+ Split data into chunks at record boundaries.
+
+ @param start  The start of a record.
+ @param bounds Output, the first is `start` and the last is `end`, the capacity should
+               be at least `(end - start) / chunkSize + 2`.
+ @return The number of chunks.
+ */
+static size_t YYCSVSplitChunks(const uint8_t *start, const uint8_t *end, uint8_t delimiter,
+                               size_t chunkSize, const uint8_t **bounds) {
+    size_t count = 0;
+    bounds[0] = start;
+    const uint8_t *cur = start;
+    while ((size_t)(end - cur) > chunkSize * 2) {
+        YYCSVScanState state = YYCSVScanStateFieldStart;
+        cur = YYCSVScan(cur, cur + chunkSize, delimiter, NO, &state);
+        cur = YYCSVScan(cur, end, delimiter, YES, &state);
+        if (cur == end) break;
+        bounds[++count] = cur;
+    }
+    bounds[++count] = end;
+    return count;
+}
+
+
+
+@implementation YYModelCSV
+
++ (instancetype)CSV {
+    return [[self alloc] initWithDelimiter:','];
+}
+
++ (instancetype)TSV {
+    return [[self alloc] initWithDelimiter:'\t'];
+}
+
+- (instancetype)init {
+    return [self initWithDelimiter:','];
+}
+
+- (instancetype)initWithDelimiter:(char)delimiter {
+    self = [super init];
+    if (!self) return nil;
+    if (delimiter == '"' || delimiter == '\r' || delimiter == '\n' || (uint8_t)delimiter >= 0x80) return nil;
+    _delimiter = delimiter;
+    _parallelChunkSize = 1024 * 1024;
+    return self;
+}
+
+- (NSArray *)modelsWithClass:(Class)cls data:(NSData *)data {
+    if (!cls || !data) return nil;
+    _YYModelMeta *modelMeta = [_YYModelMeta metaWithClass:cls];
+    if (!modelMeta) return nil;
+
+    const uint8_t *end = (const uint8_t *)data.bytes + data.length;
+    const uint8_t *cur = YYCSVSkipBOM(data.bytes, end);
+    YYCSVParser parser = {0};
+    _YYModelCSVMapping *mapping = nil;
+    if (YYCSVParseRecord(&cur, end, _delimiter, YES, &parser) == YYCSVParseResultRecord) {
+        mapping = [_YYModelCSVMapping mappingWithModelMeta:modelMeta header:&parser];
+    }
+    YYCSVParserFree(&parser);
+    if (!mapping) return nil;
+
+    size_t chunkSize = _parallelChunkSize;
+    if (chunkSize == 0 || (size_t)(end - cur) <= chunkSize * 2) {
+        NSMutableArray *models = [NSMutableArray new];
+        return YYCSVParseModels(cls, mapping, cur, end, _delimiter, models) ? models : nil;
+    }
+
+    uint8_t delimiter = _delimiter;
+    const uint8_t **bounds = malloc(((end - cur) / chunkSize + 2) * sizeof(uint8_t *));
+    if (!bounds) return nil;
+    size_t chunkCount = YYCSVSplitChunks(cur, end, delimiter, chunkSize, bounds);
+    BOOL *succeeded = calloc(chunkCount, sizeof(BOOL)); ///< one for each chunk, written by its own thread
+    if (!succeeded) {
+        free(bounds);
+        return nil;
+    }
+    NSMutableArray *chunks = [NSMutableArray new];
+    for (size_t i = 0; i < chunkCount; i++) [chunks addObject:[NSMutableArray new]];
+    dispatch_apply(chunkCount, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t i) {
+        succeeded[i] = YYCSVParseModels(cls, mapping, bounds[i], bounds[i + 1], delimiter, chunks[i]);
+    });
+    free(bounds);
+    BOOL failed = NO;
+    for (size_t i = 0; i < chunkCount; i++) failed |= !succeeded[i];
+    free(succeeded);
+    if (failed) return nil;
+    NSUInteger count = 0;
+    for (NSArray *chunk in chunks) count += chunk.count;
+    NSMutableArray *models = [NSMutableArray arrayWithCapacity:count];
+    for (NSArray *chunk in chunks) [models addObjectsFromArray:chunk];
+    return models;
+}
+
+- (NSArray *)modelsWithClass:(Class)cls file:(NSString *)path {
+    if (!path) return nil;
+    NSData *data = [NSData dataWithContentsOfFile:path options:NSDataReadingMappedIfSafe error:NULL];
+    if (!data) return nil;
+    return [self modelsWithClass:cls data:data];
+}
+
+- (BOOL)enumerateModelsWithClass:(Class)cls file:(NSString *)path usingBlock:(void (^)(id model, BOOL *stop))block {
+    if (!cls || !path || !block) return NO;
+    _YYModelMeta *modelMeta = [_YYModelMeta metaWithClass:cls];
+    if (!modelMeta) return NO;
+    FILE *file = fopen(path.fileSystemRepresentation, "rb");
+    if (!file) return NO;
+
+    size_t capacity = kYYCSVReadBufferSize, length = 0;
+    uint8_t *buffer = malloc(capacity);
+    YYCSVParser parser = {0};
+    _YYModelCSVMapping *mapping = nil;
+    BOOL eof = NO, stop = NO, failed = !buffer, atStart = YES;
+    while (!stop && !failed) {
+        if (length == capacity) { // a record is larger than the buffer
+            uint8_t *newBuffer = realloc(buffer, capacity * 2);
+            if (!newBuffer) {
+                failed = YES;
+                break;
+            }
+            buffer = newBuffer;
+            capacity *= 2;
+        }
+        size_t read = fread(buffer + length, 1, capacity - length, file);
+        length += read;
+        if (read == 0) {
+            if (ferror(file)) {
+                failed = YES;
+                break;
+            }
+            eof = YES;
+        }
+
+        const uint8_t *cur = buffer, *end = buffer + length;
+        if (atStart) {
+            if (length < 3 && !eof) continue;
+            cur = YYCSVSkipBOM(cur, end);
+            atStart = NO;
+        }
+        YYCSVParseResult result = YYCSVParseResultRecord;
+        @autoreleasepool {
+            while (!stop) {
+                result = YYCSVParseRecord(&cur, end, _delimiter, eof, &parser);
+                if (result == YYCSVParseResultError) failed = YES;
+                if (result != YYCSVParseResultRecord) break;
+                if (!mapping) {
+                    mapping = [_YYModelCSVMapping mappingWithModelMeta:modelMeta header:&parser];
+                    if (!mapping) {
+                        failed = YES;
+                        break;
+                    }
+                } else {
+                    block([mapping modelWithClass:cls parser:&parser], &stop);
+                }
+            }
+        }
+        length = end - cur;
+        if (length) memmove(buffer, cur, length);
+        if (eof && result == YYCSVParseResultEnd) break;
+    }
+    YYCSVParserFree(&parser);
+    free(buffer);
+    fclose(file);
+    return !failed && mapping;
+}
+
+/// Get the properties to write, one for each mapped key, sorted by the key.
+static NSArray *YYCSVWritablePropertyMetas(_YYModelMeta *modelMeta) {
+    NSMutableArray *metas = [NSMutableArray new];
+    for (_YYModelPropertyMeta *propertyMeta in modelMeta->_allPropertyMetas) {
+        if (propertyMeta->_getter && propertyMeta->_mappedToKey.length) [metas addObject:propertyMeta];
+    }
+    [metas sortUsingComparator:^NSComparisonResult(_YYModelPropertyMeta *meta1, _YYModelPropertyMeta *meta2) {
+        NSComparisonResult result = [meta1->_mappedToKey compare:meta2->_mappedToKey options:NSLiteralSearch];
+        if (result == NSOrderedSame) result = [meta1->_name compare:meta2->_name options:NSLiteralSearch];
+        return result;
+    }];
+    for (NSUInteger i = metas.count; i > 1; i--) {
+        _YYModelPropertyMeta *meta1 = metas[i - 2], *meta2 = metas[i - 1];
+        if ([meta1->_mappedToKey isEqualToString:meta2->_mappedToKey]) [metas removeObjectAtIndex:i - 1];
+    }
+    return metas;
+}
+
+/// Append a field, it's quoted if it contains the delimiter, quote or line break, or is empty.
+static void YYCSVAppendField(NSMutableData *data, const uint8_t *bytes, size_t length, uint8_t delimiter) {
+    BOOL needsQuote = (length == 0);
+    for (size_t i = 0; i < length && !needsQuote; i++) {
+        uint8_t c = bytes[i];
+        needsQuote = (c == delimiter || c == '"' || c == '\r' || c == '\n');
+    }
+    if (!needsQuote) {
+        [data appendBytes:bytes length:length];
+        return;
+    }
+    [data appendBytes:"\"" length:1];
+    const uint8_t *run = bytes, *end = bytes + length;
+    for (const uint8_t *quote; run < end && (quote = memchr(run, '"', end - run)); run = quote + 1) {
+        [data appendBytes:run length:quote + 1 - run];
+        [data appendBytes:"\"" length:1];
+    }
+    if (run < end) [data appendBytes:run length:end - run];
+    [data appendBytes:"\"" length:1];
+}
+
+static force_inline void YYCSVAppendStringField(NSMutableData *data, NSString *string, uint8_t delimiter) {
+    const char *cstring = string.UTF8String;
+    if (cstring) YYCSVAppendField(data, (const uint8_t *)cstring, strlen(cstring), delimiter);
+}
+
+/// Append a record of model, `buffer` is used to write the non-string values.
+static void YYCSVAppendModel(NSMutableData *data, id model, NSArray *metas, uint8_t delimiter, NSMutableData *buffer) {
+    BOOL first = YES;
+    for (_YYModelPropertyMeta *propertyMeta in metas) {
+        if (!first) [data appendBytes:&delimiter length:1];
+        first = NO;
+        id value = YYModelGetJSONValueForProperty(model, propertyMeta, YES);
+        if (!value || value == (id)kCFNull) continue;
+        if ([value isKindOfClass:[NSString class]]) {
+            YYCSVAppendStringField(data, value, delimiter);
+        } else {
+            buffer.length = 0;
+            YYModelAppendCanonicalJSON(buffer, value);
+            YYCSVAppendField(data, buffer.bytes, buffer.length, delimiter);
+        }
+    }
+    [data appendBytes:"\n" length:1];
+}
+
+static void YYCSVAppendHeader(NSMutableData *data, NSArray *metas, uint8_t delimiter) {
+    BOOL first = YES;
+    for (_YYModelPropertyMeta *propertyMeta in metas) {
+        if (!first) [data appendBytes:&delimiter length:1];
+        first = NO;
+        YYCSVAppendStringField(data, propertyMeta->_mappedToKey, delimiter);
+    }
+    [data appendBytes:"\n" length:1];
+}
+
+- (NSData *)dataWithModels:(NSArray *)models class:(Class)cls {
+    if (!cls || ![models isKindOfClass:[NSArray class]]) return nil;
+    _YYModelMeta *modelMeta = [_YYModelMeta metaWithClass:cls];
+    NSArray *metas = modelMeta ? YYCSVWritablePropertyMetas(modelMeta) : nil;
+    if (metas.count == 0) return nil;
+
+    NSMutableData *data = [NSMutableData new];
+    NSMutableData *buffer = [NSMutableData new];
+    YYCSVAppendHeader(data, metas, _delimiter);
+    NSUInteger i = 0;
+    while (i < models.count) {
+        @autoreleasepool {
+            for (NSUInteger max = MIN(i + kYYCSVPoolBatchSize, models.count); i < max; i++) {
+                id model = models[i];
+                if ([model isKindOfClass:cls]) YYCSVAppendModel(data, model, metas, _delimiter, buffer);
+            }
+        }
+    }
+    return data;
+}
+
+- (BOOL)writeModels:(NSArray *)models class:(Class)cls toFile:(NSString *)path {
+    if (!cls || !path || ![models isKindOfClass:[NSArray class]]) return NO;
+    _YYModelMeta *modelMeta = [_YYModelMeta metaWithClass:cls];
+    NSArray *metas = modelMeta ? YYCSVWritablePropertyMetas(modelMeta) : nil;
+    if (metas.count == 0) return NO;
+    FILE *file = fopen(path.fileSystemRepresentation, "wb");
+    if (!file) return NO;
+
+    NSMutableData *data = [NSMutableData new];
+    NSMutableData *buffer = [NSMutableData new];
+    YYCSVAppendHeader(data, metas, _delimiter);
+    BOOL failed = NO;
+    NSUInteger i = 0;
+    while (!failed) {
+        @autoreleasepool {
+            for (NSUInteger max = MIN(i + kYYCSVPoolBatchSize, models.count); i < max; i++) {
+                id model = models[i];
+                if ([model isKindOfClass:cls]) YYCSVAppendModel(data, model, metas, _delimiter, buffer);
+            }
+        }
+        BOOL finished = (i == models.count);
+        if (data.length >= kYYCSVWriteBufferSize || finished) {
+            if (fwrite(data.bytes, 1, data.length, file) != data.length) failed = YES;
+            data.length = 0;
+        }
+        if (finished) break;
+    }
+    if (fclose(file) != 0) failed = YES;
+    if (failed) unlink(path.fileSystemRepresentation);
+    return !failed;
+}
+
+@end
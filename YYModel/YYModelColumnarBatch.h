@@ -0,0 +1,147 @@
+//
+//  YYModelColumnarBatch.h
+//  YYModel <https://github.com/ibireme/YYModel>
+//
+//  This source code is licensed under the MIT-style license found in the
+//  LICENSE file in the root directory of this source tree.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ Value type of a column.
+ */
+typedef NS_ENUM (NSUInteger, YYModelColumnType) {
+    YYModelColumnTypeBool = 0, ///< uint8_t (0 or 1), for bool.
+    YYModelColumnTypeInt32,    ///< int32_t, for int8/uint8/int16/uint16/int32.
+    YYModelColumnTypeInt64,    ///< int64_t, for uint32/int64.
+    YYModelColumnTypeUInt64,   ///< uint64_t, for uint64.
+    YYModelColumnTypeDouble,   ///< double, for float/double/long double, NSNumber and NSDecimalNumber.
+    YYModelColumnTypeString,   ///< int32_t offsets and UTF-8 bytes, for NSString, NSMutableString and NSURL.
+};
+
+
+/**
+ A column of a `YYModelColumnarBatch`, the values of one property in contiguous buffers.
+
+ @discussion All buffers are 64-byte aligned and owned by the column.
+
+ A fixed-width column stores `count` values in `values`; a string column stores
+ `count + 1` offsets in `offsets`, the bytes of row i are `bytes[offsets[i]..<offsets[i+1]]`.
+ The bit `i` (LSB first) of `validity` is 1 if the value of row i is not null, and a
+ null slot is filled with 0 (or an empty string).
+ */
+@interface YYModelColumn : NSObject
+
+/// The property name.
+@property (nonatomic, strong, readonly) NSString *name;
+
+/// The value type.
+@property (nonatomic, assign, readonly) YYModelColumnType type;
+
+/// The number of rows.
+@property (nonatomic, assign, readonly) NSUInteger count;
+
+/// The number of null rows.
+@property (nonatomic, assign, readonly) NSUInteger nullCount;
+
+/// The fixed-width values, NULL for string column.
+@property (nullable, nonatomic, assign, readonly) const void *values NS_RETURNS_INNER_POINTER;
+
+/// The validity bitmap, (count + 7) / 8 bytes.
+@property (nonatomic, assign, readonly) const uint8_t *validity NS_RETURNS_INNER_POINTER;
+
+/// The string offsets (count + 1), NULL for fixed-width column.
+@property (nullable, nonatomic, assign, readonly) const int32_t *offsets NS_RETURNS_INNER_POINTER;
+
+/// The UTF-8 bytes of strings, NULL for fixed-width column.
+@property (nullable, nonatomic, assign, readonly) const uint8_t *bytes NS_RETURNS_INNER_POINTER;
+
+/// The length of `bytes`.
+@property (nonatomic, assign, readonly) NSUInteger byteLength;
+
+/// Whether the value at index is null (or the index is out of bounds).
+- (BOOL)isNullAtIndex:(NSUInteger)index;
+
+/// The value at index converted to int64_t, 0 for null or string.
+- (int64_t)int64AtIndex:(NSUInteger)index;
+
+/// The value at index converted to double, 0 for null or string.
+- (double)doubleAtIndex:(NSUInteger)index;
+
+/// The string at index, nil for null or fixed-width column.
+- (nullable NSString *)stringAtIndex:(NSUInteger)index;
+
+@end
+
+
+/**
+ Struct-of-arrays decode of a json array with a model class: one typed column per
+ property instead of one model object per record.
+
+ @discussion The columns are driven by the model's property mapper, the rows are the
+ json dictionaries in the array (other objects are skipped). A property's transformer
+ decoder and enum mapper are applied to the json value, the values are converted with
+ the same rules as `-yy_modelSetWithDictionary:`, a missing key, NSNull or a value which
+ can not be converted is null.
+
+ Properties of other types (NSDate, NSData, containers, nested models, structs...) have
+ no column. No model object is created, so the model's custom transform methods
+ (`-modelCustomWillTransformFromDictionary:`, `-modelCustomTransformFromDictionary:`
+ and `+modelCustomClassForDictionary:`) are not called.
+
+ Example:
+
+     YYModelColumnarBatch *batch = [YYModelColumnarBatch batchWithClass:[Order class] json:data];
+     YYModelColumn *price = [batch columnForProperty:@"price"];
+     const double *values = price.values;
+     double sum = 0;
+     for (NSUInteger i = 0; i < batch.count; i++) sum += values[i]; // null is 0
+ */
+@interface YYModelColumnarBatch : NSObject
+
+/// The number of rows.
+@property (nonatomic, assign, readonly) NSUInteger count;
+
+/// Array<YYModelColumn>, sorted by the property name.
+@property (nonatomic, strong, readonly) NSArray<YYModelColumn *> *columns;
+
+/// The column of a property, or nil if the property has no column.
+- (nullable YYModelColumn *)columnForProperty:(NSString *)name;
+
+/**
+ Creates and returns a batch from a json array. This method is thread-safe.
+
+ @param cls   The model class.
+ @param json  A json array of object, in NSArray, NSString or NSData.
+ @return A batch, or nil if an error occurs.
+ */
++ (nullable instancetype)batchWithClass:(Class)cls json:(id)json;
+
+/**
+ Creates and returns a batch from an array of json dictionary. This method is thread-safe.
+
+ @param cls    The model class.
+ @param array  An array of NSDictionary.
+ @return A batch, or nil if an error occurs.
+ */
++ (nullable instancetype)batchWithClass:(Class)cls array:(NSArray *)array;
+
+/**
+ Creates and returns a batch with some columns only. This method is thread-safe.
+
+ @param cls         The model class.
+ @param array       An array of NSDictionary.
+ @param properties  The property names of the columns, nil for all properties.
+                    A property which has no column is ignored.
+ @return A batch, or nil if an error occurs.
+ */
++ (nullable instancetype)batchWithClass:(Class)cls
+                                  array:(NSArray *)array
+                             properties:(nullable NSArray<NSString *> *)properties;
+
+@end
+
+NS_ASSUME_NONNULL_END
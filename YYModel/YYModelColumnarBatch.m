@@ -0,0 +1,332 @@
+//
+//  YYModelColumnarBatch.m
+//  YYModel <https://github.com/ibireme/YYModel>
+//
+//  This source code is licensed under the MIT-style license found in the
+//  LICENSE file in the root directory of this source tree.
+//
+
+#import "YYModelColumnarBatch.h"
+#import "YYModelMeta.h"
+
+#define force_inline __inline__ __attribute__((always_inline))
+
+/// Alignment of the column buffers, same to a cache line (and wide enough for any SIMD load).
+#define kYYColumnAlignment 64
+
+/// Allocates a zero-filled aligned buffer, the size is rounded up to the alignment.
+static void *YYColumnBufferCreate(size_t size) {
+    size = (size + kYYColumnAlignment - 1) / kYYColumnAlignment * kYYColumnAlignment;
+    if (size == 0) size = kYYColumnAlignment;
+    void *buffer = NULL;
+    if (posix_memalign(&buffer, kYYColumnAlignment, size) != 0) return NULL;
+    memset(buffer, 0, size);
+    return buffer;
+}
+
+/// Get the column type of a property, returns NO if the property has no column.
+static BOOL YYColumnTypeForPropertyMeta(_YYModelPropertyMeta *meta, YYModelColumnType *type) {
+    if (meta->_isCNumber) {
+        switch (meta->_type & YYEncodingTypeMask) {
+            case YYEncodingTypeBool: *type = YYModelColumnTypeBool; return YES;
+            case YYEncodingTypeInt8:
+            case YYEncodingTypeUInt8:
+            case YYEncodingTypeInt16:
+            case YYEncodingTypeUInt16:
+            case YYEncodingTypeInt32: *type = YYModelColumnTypeInt32; return YES;
+            case YYEncodingTypeUInt32:
+            case YYEncodingTypeInt64: *type = YYModelColumnTypeInt64; return YES;
+            case YYEncodingTypeUInt64: *type = YYModelColumnTypeUInt64; return YES;
+            case YYEncodingTypeFloat:
+            case YYEncodingTypeDouble:
+            case YYEncodingTypeLongDouble: *type = YYModelColumnTypeDouble; return YES;
+            default: return NO;
+        }
+    }
+    switch (meta->_nsType) {
+        case YYEncodingTypeNSNumber:
+        case YYEncodingTypeNSDecimalNumber: *type = YYModelColumnTypeDouble; return YES;
+        case YYEncodingTypeNSString:
+        case YYEncodingTypeNSMutableString:
+        case YYEncodingTypeNSURL: *type = YYModelColumnTypeString; return YES;
+        default: return NO;
+    }
+}
+
+/// Get the byte width of a fixed-width column type.
+static force_inline size_t YYColumnTypeGetWidth(YYModelColumnType type) {
+    switch (type) {
+        case YYModelColumnTypeBool: return sizeof(uint8_t);
+        case YYModelColumnTypeInt32: return sizeof(int32_t);
+        case YYModelColumnTypeInt64: return sizeof(int64_t);
+        case YYModelColumnTypeUInt64: return sizeof(uint64_t);
+        case YYModelColumnTypeDouble: return sizeof(double);
+        default: return 0;
+    }
+}
+
+
+
+@interface YYModelColumn () {
+    @package
+    _YYModelPropertyMeta *_meta;
+    void *_valueBuffer;
+    uint8_t *_validityBuffer;
+    int32_t *_offsetBuffer;
+    uint8_t *_byteBuffer;
+    size_t _byteCapacity;
+}
+@end
+
+@implementation YYModelColumn
+
+- (instancetype)_initWithPropertyMeta:(_YYModelPropertyMeta *)meta type:(YYModelColumnType)type capacity:(NSUInteger)capacity {
+    self = [super init];
+    _meta = meta;
+    _name = meta->_name;
+    _type = type;
+    _validityBuffer = YYColumnBufferCreate((capacity + 7) / 8);
+    if (type == YYModelColumnTypeString) {
+        _offsetBuffer = YYColumnBufferCreate((capacity + 1) * sizeof(int32_t));
+        _byteCapacity = kYYColumnAlignment * 16;
+        _byteBuffer = YYColumnBufferCreate(_byteCapacity);
+        if (!_offsetBuffer || !_byteBuffer) return nil;
+    } else {
+        _valueBuffer = YYColumnBufferCreate(capacity * YYColumnTypeGetWidth(type));
+        if (!_valueBuffer) return nil;
+    }
+    if (!_validityBuffer) return nil;
+    return self;
+}
+
+- (void)dealloc {
+    free(_valueBuffer);
+    free(_validityBuffer);
+    free(_offsetBuffer);
+    free(_byteBuffer);
+}
+
+- (const void *)values {
+    return _valueBuffer;
+}
+
+- (const uint8_t *)validity {
+    return _validityBuffer;
+}
+
+- (const int32_t *)offsets {
+    return _offsetBuffer;
+}
+
+- (const uint8_t *)bytes {
+    return _byteBuffer;
+}
+
+- (NSUInteger)byteLength {
+    return _offsetBuffer ? (NSUInteger)_offsetBuffer[_count] : 0;
+}
+
+/// Ensure the string bytes buffer can hold `length` more bytes, keeping the alignment.
+- (BOOL)_reserveBytes:(size_t)length {
+    size_t used = (size_t)_offsetBuffer[_count];
+    if (used + length <= _byteCapacity) return YES;
+    if (used + length > INT32_MAX) return NO;
+    size_t capacity = _byteCapacity;
+    while (capacity < used + length) capacity *= 2;
+    uint8_t *buffer = YYColumnBufferCreate(capacity);
+    if (!buffer) return NO;
+    memcpy(buffer, _byteBuffer, used);
+    free(_byteBuffer);
+    _byteBuffer = buffer;
+    _byteCapacity = capacity;
+    return YES;
+}
+
+/// Append the utf-8 bytes of a json value, returns NO if the bytes overflow the column.
+- (BOOL)_appendStringValue:(id)value {
+    int32_t offset = _offsetBuffer[_count];
+    if (value && _meta->_decoder) value = _meta->_decoder(value);
+    if ([value isKindOfClass:[NSNumber class]]) value = ((NSNumber *)value).stringValue;
+    else if ([value isKindOfClass:[NSURL class]]) value = ((NSURL *)value).absoluteString;
+    else if ([value isKindOfClass:[NSAttributedString class]]) value = ((NSAttributedString *)value).string;
+
+    if ([value isKindOfClass:[NSString class]]) {
+        CFStringRef str = (__bridge CFStringRef)value;
+        CFIndex length = CFStringGetLength(str);
+        const char *cstr = CFStringGetCStringPtr(str, kCFStringEncodingUTF8);
+        if (cstr) {
+            size_t size = strlen(cstr);
+            if (![self _reserveBytes:size]) return NO;
+            memcpy(_byteBuffer + offset, cstr, size);
+            offset += (int32_t)size;
+        } else {
+            CFIndex maxSize = CFStringGetMaximumSizeForEncoding(length, kCFStringEncodingUTF8);
+            if (maxSize == kCFNotFound || ![self _reserveBytes:(size_t)maxSize]) return NO;
+            CFIndex used = 0;
+            CFStringGetBytes(str, CFRangeMake(0, length), kCFStringEncodingUTF8, 0, false, _byteBuffer + offset, maxSize, &used);
+            offset += (int32_t)used;
+        }
+        _validityBuffer[_count >> 3] |= (uint8_t)(1 << (_count & 7));
+    } else if ([value isKindOfClass:[NSData class]]) {
+        NSData *data = value;
+        if (![self _reserveBytes:data.length]) return NO;
+        memcpy(_byteBuffer + offset, data.bytes, data.length);
+        offset += (int32_t)data.length;
+        _validityBuffer[_count >> 3] |= (uint8_t)(1 << (_count & 7));
+    } else {
+        _nullCount++;
+    }
+    _count++;
+    _offsetBuffer[_count] = offset;
+    return YES;
+}
+
+/// Append a json value to a fixed-width column.
+- (void)_appendNumberValue:(__unsafe_unretained id)value {
+    NSNumber *num = YYModelNumberForProperty(value, _meta);
+    if (num) {
+        switch (_type) {
+            case YYModelColumnTypeBool: ((uint8_t *)_valueBuffer)[_count] = num.boolValue ? 1 : 0; break;
+            // the integer columns are c number properties, truncated the same as the setter
+            case YYModelColumnTypeInt32: ((int32_t *)_valueBuffer)[_count] = (int32_t)YYModelGetInt64FromNumber(num, _meta); break;
+            case YYModelColumnTypeInt64: ((int64_t *)_valueBuffer)[_count] = YYModelGetInt64FromNumber(num, _meta); break;
+            case YYModelColumnTypeUInt64: ((uint64_t *)_valueBuffer)[_count] = (uint64_t)YYModelGetInt64FromNumber(num, _meta); break;
+            case YYModelColumnTypeDouble: ((double *)_valueBuffer)[_count] = num.doubleValue; break;
+            default: break;
+        }
+        _validityBuffer[_count >> 3] |= (uint8_t)(1 << (_count & 7));
+    } else {
+        _nullCount++;
+    }
+    _count++;
+}
+
+- (BOOL)isNullAtIndex:(NSUInteger)index {
+    if (index >= _count) return YES;
+    return (_validityBuffer[index >> 3] & (1 << (index & 7))) == 0;
+}
+
+- (int64_t)int64AtIndex:(NSUInteger)index {
+    if ([self isNullAtIndex:index]) return 0;
+    switch (_type) {
+        case YYModelColumnTypeBool: return ((const uint8_t *)_valueBuffer)[index];
+        case YYModelColumnTypeInt32: return ((const int32_t *)_valueBuffer)[index];
+        case YYModelColumnTypeInt64: return ((const int64_t *)_valueBuffer)[index];
+        case YYModelColumnTypeUInt64: return (int64_t)((const uint64_t *)_valueBuffer)[index];
+        case YYModelColumnTypeDouble: return (int64_t)((const double *)_valueBuffer)[index];
+        default: return 0;
+    }
+}
+
+- (double)doubleAtIndex:(NSUInteger)index {
+    if ([self isNullAtIndex:index]) return 0;
+    switch (_type) {
+        case YYModelColumnTypeBool: return ((const uint8_t *)_valueBuffer)[index];
+        case YYModelColumnTypeInt32: return ((const int32_t *)_valueBuffer)[index];
+        case YYModelColumnTypeInt64: return ((const int64_t *)_valueBuffer)[index];
+        case YYModelColumnTypeUInt64: return ((const uint64_t *)_valueBuffer)[index];
+        case YYModelColumnTypeDouble: return ((const double *)_valueBuffer)[index];
+        default: return 0;
+    }
+}
+
+- (NSString *)stringAtIndex:(NSUInteger)index {
+    if (_type != YYModelColumnTypeString || [self isNullAtIndex:index]) return nil;
+    int32_t offset = _offsetBuffer[index];
+    return [[NSString alloc] initWithBytes:_byteBuffer + offset
+                                    length:(NSUInteger)(_offsetBuffer[index + 1] - offset)
+                                  encoding:NSUTF8StringEncoding];
+}
+
+- (NSString *)description {
+    return [NSString stringWithFormat:@"<%@: %p> %@ (%lu rows, %lu null)", self.class, self, _name, (unsigned long)_count, (unsigned long)_nullCount];
+}
+
+@end
+
+
+
+@implementation YYModelColumnarBatch {
+    NSDictionary *_columnsByName;
+}
+
++ (instancetype)batchWithClass:(Class)cls json:(id)json {
+    if (!json) return nil;
+    NSArray *arr = nil;
+    NSData *jsonData = nil;
+    if ([json isKindOfClass:[NSArray class]]) {
+        arr = json;
+    } else if ([json isKindOfClass:[NSString class]]) {
+        jsonData = [(NSString *)json dataUsingEncoding : NSUTF8StringEncoding];
+    } else if ([json isKindOfClass:[NSData class]]) {
+        jsonData = json;
+    }
+    if (jsonData) {
+        arr = [NSJSONSerialization JSONObjectWithData:jsonData options:kNilOptions error:NULL];
+        if (![arr isKindOfClass:[NSArray class]]) arr = nil;
+    }
+    return [self batchWithClass:cls array:arr properties:nil];
+}
+
++ (instancetype)batchWithClass:(Class)cls array:(NSArray *)array {
+    return [self batchWithClass:cls array:array properties:nil];
+}
+
++ (instancetype)batchWithClass:(Class)cls array:(NSArray *)array properties:(NSArray *)properties {
+    if (!cls || ![array isKindOfClass:[NSArray class]]) return nil;
+    _YYModelMeta *modelMeta = [_YYModelMeta metaWithClass:cls];
+    if (!modelMeta) return nil;
+
+    NSSet *names = properties ? [NSSet setWithArray:properties] : nil;
+    NSUInteger capacity = array.count;
+    NSMutableArray *columns = [NSMutableArray new];
+    NSMutableDictionary *columnsByName = [NSMutableDictionary new];
+    NSArray *propertyMetas = [modelMeta->_allPropertyMetas sortedArrayUsingComparator:^NSComparisonResult(_YYModelPropertyMeta *meta1, _YYModelPropertyMeta *meta2) {
+        return [meta1->_name compare:meta2->_name];
+    }];
+    for (_YYModelPropertyMeta *propertyMeta in propertyMetas) {
+        YYModelColumnType type;
+        if (names && ![names containsObject:propertyMeta->_name]) continue;
+        if (!YYColumnTypeForPropertyMeta(propertyMeta, &type)) continue;
+        YYModelColumn *column = [[YYModelColumn alloc] _initWithPropertyMeta:propertyMeta type:type capacity:capacity];
+        if (!column) return nil;
+        [columns addObject:column];
+        columnsByName[propertyMeta->_name] = column;
+    }
+
+    NSUInteger columnCount = columns.count;
+    __unsafe_unretained YYModelColumn *columnArray[columnCount > 0 ? columnCount : 1];
+    [columns getObjects:columnArray range:NSMakeRange(0, columnCount)];
+
+    NSUInteger count = 0;
+    for (NSDictionary *dic in array) {
+        if (![dic isKindOfClass:[NSDictionary class]]) continue;
+        for (NSUInteger i = 0; i < columnCount; i++) {
+            __unsafe_unretained YYModelColumn *column = columnArray[i];
+            id value = YYModelGetValueFromDictionary(dic, column->_meta);
+            if (value == (id)kCFNull) value = nil;
+            if (column.type == YYModelColumnTypeString) {
+                if (![column _appendStringValue:value]) return nil;
+            } else {
+                [column _appendNumberValue:value];
+            }
+        }
+        count++;
+    }
+
+    YYModelColumnarBatch *batch = [self new];
+    batch->_count = count;
+    batch->_columns = columns.copy;
+    batch->_columnsByName = columnsByName.copy;
+    return batch;
+}
+
+- (YYModelColumn *)columnForProperty:(NSString *)name {
+    return name ? _columnsByName[name] : nil;
+}
+
+- (NSString *)description {
+    return [NSString stringWithFormat:@"<%@: %p> (%lu rows) %@", self.class, self, (unsigned long)_count, _columns];
+}
+
+@end
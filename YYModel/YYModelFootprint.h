@@ -0,0 +1,64 @@
+//
+//  YYModelFootprint.h
+//  YYModel <https://github.com/ibireme/YYModel>
+//
+//  This source code is licensed under the MIT-style license found in the
+//  LICENSE file in the root directory of this source tree.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ An estimate of the memory retained by a model graph.
+
+ @discussion The object graph is walked from the root object: the properties of models
+ (with the model class info), the elements of arrays/sets and the keys/values of
+ dictionaries. Each object is counted once, even if it's referred more than once.
+ Weak properties are not followed.
+
+ The size of an object is its heap allocation size (or `class_getInstanceSize()` if
+ it's unknown), plus the storage of the object's content which is allocated separately:
+ the characters of strings, the bytes of data and the slots of collections. Tagged
+ pointers and constant strings are not allocated on heap, they take no space.
+
+ It's an estimate, the private storage of Foundation classes is approximated.
+ */
+@interface YYModelFootprint : NSObject
+
+/**
+ Walks the object graph and creates a footprint with breakdowns. This method is thread-safe,
+ but the objects in the graph should not be modified during the call.
+
+ @param object A model, or a container of models.
+ @return A new footprint.
+ */
++ (instancetype)footprintOfObject:(nullable id)object;
+
+/**
+ Returns the estimated bytes of an object graph, without the breakdowns.
+ It's faster than `footprintOfObject:`, and suitable for the cost of cache.
+ */
++ (NSUInteger)estimatedBytesOfObject:(nullable id)object;
+
+/// The estimated bytes of all objects.
+@property (nonatomic, assign, readonly) NSUInteger totalBytes;
+
+/// The number of objects.
+@property (nonatomic, assign, readonly) NSUInteger objectCount;
+
+/// Key: class name, Value: the bytes of the instances (without the objects they refer to).
+/// Foundation objects are grouped with the public class name, such as "NSString" and "NSArray".
+@property (nonatomic, strong, readonly) NSDictionary<NSString *, NSNumber *> *bytesByClass;
+
+/// Key: class name, Value: the number of the instances.
+@property (nonatomic, strong, readonly) NSDictionary<NSString *, NSNumber *> *countByClass;
+
+/// Key: "ModelClass.property", Value: the bytes of the objects which are first reached
+/// through the property (the value and the objects it refers to).
+@property (nonatomic, strong, readonly) NSDictionary<NSString *, NSNumber *> *bytesByProperty;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,295 @@
+//
+//  YYModelFootprint.m
+//  YYModel <https://github.com/ibireme/YYModel>
+//
+//  This source code is licensed under the MIT-style license found in the
+//  LICENSE file in the root directory of this source tree.
+//
+
+#import "YYModelFootprint.h"
+#import "YYModelMeta.h"
+#import <objc/message.h>
+#import <malloc/malloc.h>
+
+#define force_inline __inline__ __attribute__((always_inline))
+
+/// Max depth of the walk, deeper objects are ignored.
+#define kYYFootprintMaxDepth 512
+/// Estimated size of the header of a Foundation object.
+#define kYYFootprintObjectHeaderSize 16
+
+/// Kind of an object in the walk.
+typedef NS_ENUM (NSUInteger, YYFootprintKind) {
+    YYFootprintKindModel = 0,
+    YYFootprintKindString,
+    YYFootprintKindData,
+    YYFootprintKindValue, ///< NSValue, NSNumber, NSDate
+    YYFootprintKindURL,
+    YYFootprintKindArray,
+    YYFootprintKindSet,
+    YYFootprintKindDictionary,
+};
+
+/// Bytes and count of a class or a property.
+@interface _YYFootprintCounter : NSObject {
+    @package
+    NSString *_name;
+    YYFootprintKind _kind; ///< kind of the class
+    NSUInteger _bytes;
+    NSUInteger _count;
+}
+@end
+
+@implementation _YYFootprintCounter
+@end
+
+/// Same as +isSubclassOfClass:, which is not implemented by the root class NSProxy.
+static BOOL YYFootprintClassIsSubclass(Class cls, Class parent) {
+    for (; cls; cls = class_getSuperclass(cls)) {
+        if (cls == parent) return YES;
+    }
+    return NO;
+}
+
+static YYFootprintKind YYFootprintKindForClass(Class cls, NSString **name) {
+    if (YYFootprintClassIsSubclass(cls, [NSString class])) { *name = @"NSString"; return YYFootprintKindString; }
+    if (YYFootprintClassIsSubclass(cls, [NSDecimalNumber class])) { *name = @"NSDecimalNumber"; return YYFootprintKindValue; }
+    if (YYFootprintClassIsSubclass(cls, [NSNumber class])) { *name = @"NSNumber"; return YYFootprintKindValue; }
+    if (YYFootprintClassIsSubclass(cls, [NSValue class])) { *name = @"NSValue"; return YYFootprintKindValue; }
+    if (YYFootprintClassIsSubclass(cls, [NSData class])) { *name = @"NSData"; return YYFootprintKindData; }
+    if (YYFootprintClassIsSubclass(cls, [NSDate class])) { *name = @"NSDate"; return YYFootprintKindValue; }
+    if (YYFootprintClassIsSubclass(cls, [NSURL class])) { *name = @"NSURL"; return YYFootprintKindURL; }
+    if (YYFootprintClassIsSubclass(cls, [NSArray class])) { *name = @"NSArray"; return YYFootprintKindArray; }
+    if (YYFootprintClassIsSubclass(cls, [NSOrderedSet class])) { *name = @"NSOrderedSet"; return YYFootprintKindArray; }
+    if (YYFootprintClassIsSubclass(cls, [NSSet class])) { *name = @"NSSet"; return YYFootprintKindSet; }
+    if (YYFootprintClassIsSubclass(cls, [NSDictionary class])) { *name = @"NSDictionary"; return YYFootprintKindDictionary; }
+    *name = NSStringFromClass(cls);
+    return YYFootprintKindModel;
+}
+
+/// The walk state, the dictionaries are NULL if no breakdown is needed.
+typedef struct {
+    CFMutableSetRef visited;           ///< visited objects (retained, compared by pointer)
+    CFMutableDictionaryRef classes;    ///< Key:Class, Value:_YYFootprintCounter
+    CFMutableDictionaryRef properties; ///< Key:_YYModelPropertyMeta, Value:_YYFootprintCounter
+    CFMutableDictionaryRef kinds;      ///< Key:Class, Value:YYFootprintKind + 1, always used
+    NSUInteger count;
+} YYFootprintContext;
+
+/// Returns the kind of a class, and the counter of the class if breakdown is needed.
+static force_inline YYFootprintKind YYFootprintContextGetKind(YYFootprintContext *ctx, Class cls, _YYFootprintCounter **counter) {
+    if (ctx->classes) {
+        _YYFootprintCounter *one = CFDictionaryGetValue(ctx->classes, (__bridge const void *)(cls));
+        if (!one) {
+            one = [_YYFootprintCounter new];
+            NSString *name = nil;
+            one->_kind = YYFootprintKindForClass(cls, &name);
+            one->_name = name;
+            CFDictionarySetValue(ctx->classes, (__bridge const void *)(cls), (__bridge const void *)(one));
+        }
+        *counter = one;
+        return one->_kind;
+    }
+    uintptr_t kind = (uintptr_t)CFDictionaryGetValue(ctx->kinds, (__bridge const void *)(cls));
+    if (!kind) {
+        NSString *name = nil;
+        kind = YYFootprintKindForClass(cls, &name) + 1;
+        CFDictionarySetValue(ctx->kinds, (__bridge const void *)(cls), (const void *)kind);
+    }
+    *counter = nil;
+    return (YYFootprintKind)(kind - 1);
+}
+
+/// Heap size of an object, 0 for tagged pointer and static object.
+static force_inline size_t YYFootprintHeapSize(__unsafe_unretained id obj) {
+    return malloc_size((__bridge const void *)obj);
+}
+
+/// Add the storage of content if it's not allocated in the object.
+static force_inline size_t YYFootprintAddStorage(size_t size, size_t storage) {
+    if (size == 0) return 0; // not on heap
+    return size >= storage + kYYFootprintObjectHeaderSize ? size : size + storage;
+}
+
+static size_t YYFootprintStringSize(__unsafe_unretained NSString *string) {
+    size_t size = YYFootprintHeapSize(string);
+    if (!size) return 0;
+    CFIndex length = CFStringGetLength((CFStringRef)string);
+    BOOL narrow = CFStringGetCStringPtr((CFStringRef)string, kCFStringEncodingASCII) != NULL;
+    return YYFootprintAddStorage(size, (size_t)length * (narrow ? 1 : 2));
+}
+
+static size_t YYFootprintDataSize(__unsafe_unretained NSData *data) {
+    size_t size = YYFootprintHeapSize(data);
+    if (!size) return 0;
+    NSUInteger length = data.length;
+    if (!length) return size;
+    const uint8_t *bytes = data.bytes;
+    const uint8_t *object = (__bridge const void *)data;
+    if (bytes >= object && bytes < object + size) return size; // inline
+    size_t storage = malloc_size(bytes);
+    return size + (storage ? storage : length); // the bytes may be mapped or not owned
+}
+
+static NSUInteger YYFootprintVisit(YYFootprintContext *ctx, __unsafe_unretained id obj, NSUInteger depth);
+
+static NSUInteger YYFootprintVisitModel(YYFootprintContext *ctx, __unsafe_unretained id model, Class cls, NSUInteger depth) {
+    _YYModelMeta *modelMeta = [_YYModelMeta metaWithClass:cls];
+    if (!modelMeta) return 0;
+    NSUInteger total = 0;
+    for (_YYModelPropertyMeta *meta in modelMeta->_allPropertyMetas) {
+        if (!meta->_getter) continue;
+        if ((meta->_type & YYEncodingTypeMask) != YYEncodingTypeObject) continue;
+        if (meta->_type & YYEncodingTypePropertyWeak) continue;
+        id value = ((id (*)(id, SEL))(void *) objc_msgSend)((id)model, meta->_getter);
+        if (!value) continue;
+        NSUInteger bytes = YYFootprintVisit(ctx, value, depth + 1);
+        total += bytes;
+        if (ctx->properties && bytes) {
+            _YYFootprintCounter *counter = CFDictionaryGetValue(ctx->properties, (__bridge const void *)(meta));
+            if (!counter) {
+                counter = [_YYFootprintCounter new];
+                counter->_name = [NSString stringWithFormat:@"%@.%@", NSStringFromClass(cls), meta->_name];
+                CFDictionarySetValue(ctx->properties, (__bridge const void *)(meta), (__bridge const void *)(counter));
+            }
+            counter->_bytes += bytes;
+            counter->_count++;
+        }
+    }
+    return total;
+}
+
+/**
+ Visit an object and the objects it refers to.
+
+ @return The bytes of the objects which are not visited before.
+ */
+static NSUInteger YYFootprintVisit(YYFootprintContext *ctx, __unsafe_unretained id obj, NSUInteger depth) {
+    if (!obj || obj == (id)kCFNull || depth >= kYYFootprintMaxDepth) return 0;
+    if (object_isClass(obj)) return 0;
+    if (CFSetContainsValue(ctx->visited, (__bridge const void *)(obj))) return 0;
+    CFSetAddValue(ctx->visited, (__bridge const void *)(obj));
+    ctx->count++;
+
+    // not object_getClass(): a KVO observed model has a subclass, and a lazy url is a proxy
+    Class cls = [obj class];
+    _YYFootprintCounter *counter = nil;
+    YYFootprintKind kind = YYFootprintContextGetKind(ctx, cls, &counter);
+    size_t size = 0;
+    __block NSUInteger children = 0;
+    switch (kind) {
+        case YYFootprintKindString: {
+            size = YYFootprintStringSize(obj);
+        } break;
+        case YYFootprintKindData: {
+            size = YYFootprintDataSize(obj);
+        } break;
+        case YYFootprintKindValue: {
+            size = YYFootprintHeapSize(obj);
+        } break;
+        case YYFootprintKindURL: {
+            size = YYFootprintHeapSize(obj);
+            if ([obj isProxy]) { // lazy url, the description is the string it holds (not creating the url)
+                children += YYFootprintVisit(ctx, [obj description], depth + 1);
+            } else {
+                children += YYFootprintVisit(ctx, ((NSURL *)obj).relativeString, depth + 1);
+                children += YYFootprintVisit(ctx, ((NSURL *)obj).baseURL, depth + 1);
+            }
+        } break;
+        case YYFootprintKindArray:
+        case YYFootprintKindSet: {
+            NSUInteger count = [obj count];
+            size = YYFootprintAddStorage(YYFootprintHeapSize(obj), count * sizeof(void *));
+            for (id one in obj) {
+                children += YYFootprintVisit(ctx, one, depth + 1);
+            }
+        } break;
+        case YYFootprintKindDictionary: {
+            NSUInteger count = [obj count];
+            size = YYFootprintAddStorage(YYFootprintHeapSize(obj), count * sizeof(void *) * 2);
+            [((NSDictionary *)obj) enumerateKeysAndObjectsUsingBlock:^(id key, id value, BOOL *stop) {
+                children += YYFootprintVisit(ctx, key, depth + 1);
+                children += YYFootprintVisit(ctx, value, depth + 1);
+            }];
+        } break;
+        case YYFootprintKindModel: {
+            size = MAX(YYFootprintHeapSize(obj), class_getInstanceSize(cls));
+            children = YYFootprintVisitModel(ctx, obj, cls, depth);
+        } break;
+    }
+    if (counter) {
+        counter->_bytes += size;
+        counter->_count++;
+    }
+    return size + children;
+}
+
+static void YYFootprintContextInit(YYFootprintContext *ctx, BOOL breakdown) {
+    memset(ctx, 0, sizeof(YYFootprintContext));
+    // a getter may return a temporary object, it's retained so the address is not reused by a later one
+    CFSetCallBacks callbacks = kCFTypeSetCallBacks;
+    callbacks.equal = NULL;
+    callbacks.hash = NULL;
+    ctx->visited = CFSetCreateMutable(CFAllocatorGetDefault(), 0, &callbacks);
+    if (breakdown) {
+        ctx->classes = CFDictionaryCreateMutable(CFAllocatorGetDefault(), 0, NULL, &kCFTypeDictionaryValueCallBacks);
+        ctx->properties = CFDictionaryCreateMutable(CFAllocatorGetDefault(), 0, NULL, &kCFTypeDictionaryValueCallBacks);
+    } else {
+        ctx->kinds = CFDictionaryCreateMutable(CFAllocatorGetDefault(), 0, NULL, NULL);
+    }
+}
+
+static void YYFootprintContextFree(YYFootprintContext *ctx) {
+    if (ctx->visited) CFRelease(ctx->visited);
+    if (ctx->classes) CFRelease(ctx->classes);
+    if (ctx->properties) CFRelease(ctx->properties);
+    if (ctx->kinds) CFRelease(ctx->kinds);
+}
+
+/// Merge the counters with the same name.
+static void YYFootprintAddCounters(CFDictionaryRef counters, NSMutableDictionary *bytes, NSMutableDictionary *count) {
+    for (_YYFootprintCounter *counter in ((__bridge NSDictionary *)counters).allValues) {
+        if (!counter->_count) continue;
+        bytes[counter->_name] = @([bytes[counter->_name] unsignedIntegerValue] + counter->_bytes);
+        if (count) count[counter->_name] = @([count[counter->_name] unsignedIntegerValue] + counter->_count);
+    }
+}
+
+
+@implementation YYModelFootprint
+
++ (instancetype)footprintOfObject:(id)object {
+    YYFootprintContext ctx;
+    YYFootprintContextInit(&ctx, YES);
+    NSUInteger total = YYFootprintVisit(&ctx, object, 0);
+
+    YYModelFootprint *one = [self new];
+    one->_totalBytes = total;
+    one->_objectCount = ctx.count;
+    NSMutableDictionary *bytesByClass = [NSMutableDictionary new];
+    NSMutableDictionary *countByClass = [NSMutableDictionary new];
+    NSMutableDictionary *bytesByProperty = [NSMutableDictionary new];
+    YYFootprintAddCounters(ctx.classes, bytesByClass, countByClass);
+    YYFootprintAddCounters(ctx.properties, bytesByProperty, nil);
+    one->_bytesByClass = bytesByClass.copy;
+    one->_countByClass = countByClass.copy;
+    one->_bytesByProperty = bytesByProperty.copy;
+    YYFootprintContextFree(&ctx);
+    return one;
+}
+
++ (NSUInteger)estimatedBytesOfObject:(id)object {
+    if (!object) return 0;
+    YYFootprintContext ctx;
+    YYFootprintContextInit(&ctx, NO);
+    NSUInteger total = YYFootprintVisit(&ctx, object, 0);
+    YYFootprintContextFree(&ctx);
+    return total;
+}
+
+- (NSString *)description {
+    return [NSString stringWithFormat:@"<%@: %p> totalBytes:%lu objectCount:%lu", self.class, self,
+            (unsigned long)_totalBytes, (unsigned long)_objectCount];
+}
+
+@end
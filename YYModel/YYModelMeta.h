@@ -0,0 +1,288 @@
+//
+//  YYModelMeta.h
+//  YYModel <https://github.com/ibireme/YYModel>
+//
+//  This source code is licensed under the MIT-style license found in the
+//  LICENSE file in the root directory of this source tree.
+//
+
+#import <Foundation/Foundation.h>
+
+#if __has_include(<YYModel/YYModel.h>)
+#import <YYModel/NSObject+YYModel.h>
+#import <YYModel/YYClassInfo.h>
+#else
+#import "NSObject+YYModel.h"
+#import "YYClassInfo.h"
+#endif
+
+/*
+ 模型元数据的私有头文件, 由 NSObject+YYModel 和各个模型编解码器 (列式解码等) 共享.
+ 不要在外部代码中引用它, 其中的结构在任何版本中都可能改变.
+ */
+
+/// Declares a function shared by the model sources, it's not exported from the framework.
+#define YYMODEL_EXTERN FOUNDATION_EXTERN __attribute__((visibility("hidden")))
+
+@class _YYModelEnumMapper, _YYModelKeyPlanNode;
+
+/// Foundation Class Type
+typedef NS_ENUM (NSUInteger, YYEncodingNSType) {
+    YYEncodingTypeNSUnknown = 0,
+    YYEncodingTypeNSString,
+    YYEncodingTypeNSMutableString,
+    YYEncodingTypeNSValue,
+    YYEncodingTypeNSNumber,
+    YYEncodingTypeNSDecimalNumber,
+    YYEncodingTypeNSData,
+    YYEncodingTypeNSMutableData,
+    YYEncodingTypeNSDate,
+    YYEncodingTypeNSURL,
+    YYEncodingTypeNSArray,
+    YYEncodingTypeNSMutableArray,
+    YYEncodingTypeNSDictionary,
+    YYEncodingTypeNSMutableDictionary,
+    YYEncodingTypeNSSet,
+    YYEncodingTypeNSMutableSet,
+};
+
+
+/// A property info in object model.
+@interface _YYModelPropertyMeta : NSObject {
+    @package
+    NSString *_name;             ///< property's name
+    YYEncodingType _type;        ///< property's type
+    YYEncodingNSType _nsType;    ///< property's Foundation type
+    BOOL _isCNumber;             ///< is c number type
+    Class _cls;                  ///< property's class, or nil
+    Class _genericCls;           ///< container's generic class, or nil if threr's no generic class
+    SEL _getter;                 ///< getter, or nil if the instances cannot respond
+    SEL _setter;                 ///< setter, or nil if the instances cannot respond
+    BOOL _isKVCCompatible;       ///< YES if it can access with key-value coding
+    BOOL _isStructAvailableForKeyedArchiver; ///< YES if the struct can encoded with keyed archiver/unarchiver
+    BOOL _hasCustomClassFromDictionary; ///< class/generic class implements +modelCustomClassForDictionary:
+    BOOL _isStringNoCopy;        ///< YES if long ASCII strings are created from NSData without copying
+    BOOL _isLazyURL;             ///< YES if the NSURL is created lazily from string
+    _YYModelEnumMapper *_enumMapper; ///< string<->value mapper for c number, or nil
+    NSUInteger _autoreleaseBatchSize; ///< elements of the generic container decoded in one autorelease pool
+    id (^_decoder)(id value);    ///< json value -> property value transformer, or nil
+    id (^_encoder)(id value);    ///< property value -> json value transformer, or nil
+    
+    /*
+     property->key:       _mappedToKey:key     _mappedToKeyPath:nil            _mappedToKeyArray:nil
+     property->keyPath:   _mappedToKey:keyPath _mappedToKeyPath:keyPath(array) _mappedToKeyArray:nil
+     property->keys:      _mappedToKey:keys[0] _mappedToKeyPath:nil/keyPath    _mappedToKeyArray:keys(array)
+     */
+    NSString *_mappedToKey;      ///< the key mapped to
+    NSArray *_mappedToKeyPath;   ///< the key path mapped to (nil if the name is not key path)
+    NSArray *_mappedToKeyArray;  ///< the key(NSString) or keyPath(NSArray) array (nil if not mapped to multiple keys)
+    YYClassPropertyInfo *_info;  ///< property's info
+    _YYModelPropertyMeta *_next; ///< next meta if there are multiple properties mapped to the same key.
+}
+@end
+
+
+typedef struct _YYModelEncodeStep _YYModelEncodeStep;
+
+/**
+ Get the json value of a step's property, same as `YYModelGetJSONValueForProperty()`.
+ Each step has a function specialized for the property's type.
+ */
+typedef id (*YYModelEncodeFunction)(__unsafe_unretained id model, const _YYModelEncodeStep *step, BOOL convert);
+
+/// A mapped property in the encode plan of a model class.
+struct _YYModelEncodeStep {
+    __unsafe_unretained _YYModelPropertyMeta *meta; ///< property meta, retained by the model meta
+    __unsafe_unretained NSString *key; ///< same as meta->_mappedToKey
+    const char *keyBytes;         ///< the key as canonical json with colon (`"key":`), in model meta's _encodeKeyBytes
+    CFIndex keyLength;            ///< length of keyBytes
+    IMP getter;                   ///< getter's IMP of the model class, or NULL if it can not be called directly
+    YYModelEncodeFunction encode; ///< json value of the property
+    NSUInteger keyGroup;          ///< the adjacent steps with the same key have the same group
+    BOOL isSharedKey;             ///< YES if the key (not key path) is also written by another step
+};
+
+
+typedef struct _YYModelCoderStep _YYModelCoderStep;
+
+/// Encode a step's property to the coder, or decode it from the coder.
+typedef void (*YYModelCoderFunction)(__unsafe_unretained NSCoder *coder, __unsafe_unretained id model, const _YYModelCoderStep *step);
+
+/// A property in the coder plan of a model class.
+struct _YYModelCoderStep {
+    __unsafe_unretained _YYModelPropertyMeta *meta; ///< property meta, retained by the model meta
+    __unsafe_unretained NSString *key; ///< same as meta->_name
+    IMP getter;                   ///< getter's IMP of the model class, or NULL if not encoded
+    IMP setter;                   ///< setter's IMP of the model class, or NULL if not decoded
+    YYModelCoderFunction encode;  ///< encode the property, or NULL
+    YYModelCoderFunction decode;  ///< decode the property, or NULL
+};
+
+
+/// A class info in object model.
+@interface _YYModelMeta : NSObject {
+    @package
+    YYClassInfo *_classInfo;
+    /// Key:mapped key and key path, Value:_YYModelPropertyMeta.
+    NSDictionary *_mapper;
+    /// Array<_YYModelPropertyMeta>, all property meta of this model.
+    NSArray *_allPropertyMetas;
+    /// Array<_YYModelPropertyMeta>, property meta which is mapped to a key path.
+    NSArray *_keyPathPropertyMetas;
+    /// Array<_YYModelPropertyMeta>, property meta which is mapped to multi keys.
+    NSArray *_multiKeysPropertyMetas;
+    /// Key:json key, Value:_YYModelKeyPlanNode. All mapped keys, key paths and multi keys.
+    NSDictionary *_keyPlan;
+    /// Array<_YYModelKeyPlanNode>, all values of _keyPlan.
+    NSArray *_keyPlanRoots;
+    /// Same to _keyPlanRoots.count.
+    CFIndex _keyPlanRootCount;
+    /// The strategy to find the mapped keys in json dictionary.
+    YYModelDecodeStrategy _decodeStrategy;
+    /// Running average of the number of keys in json dictionary, 24.8 fixed-point, 0 if no sample.
+    /// The statistics are sampled and accessed with relaxed atomics, see ModelUpdateDecodeStatistics().
+    uint32_t _statKeyCount;
+    /// Running average of the ratio of json keys which are mapped, 16.16 fixed-point.
+    uint32_t _statHitRatio;
+    /// The number of decodes, to sample the statistics.
+    uint32_t _statDecodes;
+    /// Array<_YYModelPropertyMeta>, mapped property meta sorted by mapped key for canonical output,
+    /// nil if some property is mapped to a key path.
+    NSArray *_canonicalPropertyMetas;
+    /// Steps of all mapped properties (one per mapped key) sorted by mapped key, built once
+    /// for the json and canonical json output, freed when the meta is deallocated.
+    _YYModelEncodeStep *_encodePlan;
+    /// The number of steps in _encodePlan.
+    NSUInteger _encodePlanCount;
+    /// Storage of the keyBytes of _encodePlan.
+    NSData *_encodeKeyBytes;
+    /// Steps of the properties which can be encoded or decoded with NSCoder, in the order of
+    /// _allPropertyMetas, freed when the meta is deallocated.
+    _YYModelCoderStep *_coderPlan;
+    /// The number of steps in _coderPlan.
+    NSUInteger _coderPlanCount;
+    /// The number of mapped key (and key path), same to _mapper.count.
+    NSUInteger _keyMappedCount;
+    /// Model class type.
+    YYEncodingNSType _nsType;
+    /// Memoization policy of `+yy_modelWithJSON:`.
+    YYModelDecodeCachePolicy _decodeCachePolicy;
+    /// Models decoded in one autorelease pool in a collection, 0 means no pool.
+    NSUInteger _autoreleaseBatchSize;
+    
+    BOOL _hasCustomWillTransformFromDictionary;
+    BOOL _hasCustomTransformFromDictionary;
+    BOOL _hasCustomTransformToDictionary;
+    BOOL _hasCustomClassFromDictionary;
+}
+/// Returns the cached model class meta, thread-safe.
++ (instancetype)metaWithClass:(Class)cls;
+@end
+
+
+/**
+ Get the value of a property's mapped key (or key path, or multi keys) from a json dictionary.
+ 
+ @discussion This is the single lookup of one property's value, the result is same as
+ the key plan traversal of `-yy_modelSetWithDictionary:`. Modules which read the json
+ property by property (columnar batch, reconciliation...) should use this function.
+ 
+ @param dic  Should be NSDictionary.
+ @param meta Should not be nil.
+ @return The value, or nil if the key is not found.
+ */
+YYMODEL_EXTERN id YYModelGetValueFromDictionary(NSDictionary *dic, _YYModelPropertyMeta *meta);
+
+/**
+ Whether `-yy_modelSetWithDictionary:` iterates a json dictionary with `count` keys
+ (or looks up the mapped keys in it), with the model's strategy and current statistics.
+ 
+ @param modelMeta Should not be nil.
+ @param count     The number of json keys.
+ */
+YYMODEL_EXTERN BOOL YYModelShouldIterateDictionary(_YYModelMeta *modelMeta, CFIndex count);
+
+/**
+ Convert a json value to the number of a c number (or NSNumber) property, with the same
+ conversion as `-yy_modelSetWithDictionary:` (the property's decoder, enum mapper and string parser).
+ 
+ @param value A json value, can be nil.
+ @param meta  Should not be nil.
+ @return The number, or nil if the value is not a number.
+ */
+YYMODEL_EXTERN NSNumber *YYModelNumberForProperty(id value, _YYModelPropertyMeta *meta);
+
+/**
+ Get/set the value of a c number property without boxing, the same as the conversion
+ of `-yy_modelSetWithDictionary:` and `-yy_modelToJSONObject`.
+ 
+ @discussion The int64 functions use the bits of uint64 for YYEncodingTypeUInt64, and
+ the double functions convert the value (with saturation) for integer properties.
+ Caller should hold strong reference to the parameters before the function returns.
+ 
+ @param model Should not be nil.
+ @param meta  Should not be nil, meta->_isCNumber should be YES, and the getter/setter should not be nil.
+ */
+YYMODEL_EXTERN int64_t YYModelGetInt64FromProperty(id model, _YYModelPropertyMeta *meta);
+YYMODEL_EXTERN void YYModelSetInt64ToProperty(id model, int64_t num, _YYModelPropertyMeta *meta);
+YYMODEL_EXTERN double YYModelGetDoubleFromProperty(id model, _YYModelPropertyMeta *meta);
+YYMODEL_EXTERN void YYModelSetDoubleToProperty(id model, double num, _YYModelPropertyMeta *meta);
+
+/**
+ Convert a number to the int64 value of a c number integer property, the same as the value
+ set by `-yy_modelSetWithDictionary:` (truncated to the width of the property).
+ 
+ @param num  Should not be nil.
+ @param meta Should not be nil, meta->_isCNumber should be YES.
+ @return The value, or the bits of uint64 for YYEncodingTypeUInt32 and YYEncodingTypeUInt64.
+ */
+YYMODEL_EXTERN int64_t YYModelGetInt64FromNumber(NSNumber *num, _YYModelPropertyMeta *meta);
+
+/**
+ Set a json value to a property, with the property's decoder and the same conversion
+ as `-yy_modelSetWithDictionary:`.
+ 
+ @param model Should not be nil.
+ @param value Should not be nil, but can be NSNull.
+ @param meta  Should not be nil, and meta->_setter should not be nil.
+ */
+YYMODEL_EXTERN void YYModelSetValueForProperty(id model, id value, _YYModelPropertyMeta *meta);
+
+/**
+ Parse a number in C string and set it to a c number property without boxing, the result
+ is same as setting the string with `YYModelSetValueForProperty()` (when the property has
+ no decoder and enum mapper, and the string is not "true", "null"...).
+ 
+ @param model   Should not be nil.
+ @param cstring A NUL-terminated C string, should not be NULL.
+ @param meta    Should not be nil, meta->_isCNumber should be YES, and meta->_setter should not be nil.
+ */
+YYMODEL_EXTERN void YYModelSetNumberCStringToProperty(id model, const char *cstring, _YYModelPropertyMeta *meta);
+
+/**
+ Get the json value of a property, same as the value in `-yy_modelToJSONObject`.
+ 
+ @param model   Should not be nil.
+ @param meta    Should not be nil, and meta->_getter should not be nil.
+ @param convert YES to convert object values to json objects, NO to return them as is
+                (c numbers, enum names, transformer results, class and selector are
+                always converted).
+ @return The json value, or nil if the property should be ignored.
+ */
+YYMODEL_EXTERN id YYModelGetJSONValueForProperty(id model, _YYModelPropertyMeta *meta, BOOL convert);
+
+/**
+ Append a value as canonical json (same as `-yy_modelToCanonicalJSONData`) to the data,
+ "null" is appended if the value can not be converted to json.
+ */
+YYMODEL_EXTERN void YYModelAppendCanonicalJSON(NSMutableData *data, id value);
+
+/**
+ SipHash-2-4 with 128-bit output, the same hash as `-yy_modelGetDigest:`.
+ 
+ @param bytes  The input, can be NULL if length is 0.
+ @param length The input length in bytes.
+ @param key    The 16 bytes key (k0 and k1, little endian).
+ @param digest The 16 bytes output.
+ */
+YYMODEL_EXTERN void YYModelSipHash128(const void *bytes, size_t length, const uint8_t key[16], uint8_t digest[16]);
@@ -0,0 +1,90 @@
+//
+//  YYModelReconcile.h
+//  YYModel <https://github.com/ibireme/YYModel>
+//
+//  This source code is licensed under the MIT-style license found in the
+//  LICENSE file in the root directory of this source tree.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ The result of reconciling an array of existing models with a new json array.
+
+ @discussion The models are matched by the value of a primary key property: the value
+ in the json (converted the same as `-yy_modelSetWithDictionary:`) and the value of the
+ existing model. A matched model is reused and updated in place, a json element without
+ a matched model is decoded into a new model, and an existing model without a matched
+ element is removed.
+
+ A matched model is compared with the json property by property, only the properties
+ which are present in the json are compared (all properties if the class implements
+ `modelCustomWillTransformFromDictionary:` or `modelCustomTransformFromDictionary:`).
+ The changed properties are set to the model, and an unchanged model is not touched
+ (no setter is called). A nested model property is compared with its canonical json, and
+ the new nested model replaces the old one if it's changed.
+
+ The index sets can be used to update a list view in batch:
+
+     YYModelReconciliation *result = [YYModelReconciliation reconciliationWithModels:self.users
+                                                                               class:[YYUser class]
+                                                                                json:json
+                                                                          primaryKey:@"uid"];
+     self.users = result.array;
+     [tableView performBatchUpdates:^{
+         [tableView deleteRowsAtIndexPaths:paths(result.deletedIndexes) ...];
+         [tableView insertRowsAtIndexPaths:paths(result.insertedIndexes) ...];
+         [result.movedIndexes enumerateIndexesUsingBlock:^(NSUInteger idx, BOOL *stop) {
+             [tableView moveRowAtIndexPath:path([result oldIndexOfObjectAtIndex:idx]) toIndexPath:path(idx)];
+         }];
+     } completion:^(BOOL finished) {
+         [tableView reloadRowsAtIndexPaths:paths(result.updatedIndexes) ...];
+     }];
+ */
+@interface YYModelReconciliation : NSObject
+
+/**
+ Reconciles the existing models with a json array. The matched models are modified,
+ so they should not be accessed on other threads during the call.
+
+ @param models     The existing models, can be nil. The models without a primary key
+                   value (nil, or the class doesn't have the property) are removed, and
+                   only the first model of a duplicated key is matched.
+ @param cls        The class of the models.
+ @param json       A json array of `cls`, can be NSArray, NSString or NSData.
+ @param primaryKey The name of the primary key property of `cls`, should be a c number
+                   or an object (such as NSString and NSNumber) property. The json elements
+                   without a key value are decoded as new models.
+ @return A new result, or nil if an error occurs (the json is invalid, or the primary key
+         property is not found).
+ */
++ (nullable instancetype)reconciliationWithModels:(nullable NSArray *)models
+                                            class:(Class)cls
+                                             json:(id)json
+                                       primaryKey:(NSString *)primaryKey;
+
+/// The models in the order of the json, the invalid json elements are ignored.
+@property (nonatomic, strong, readonly) NSArray *array;
+
+/// Indexes of `array`, the new models.
+@property (nonatomic, strong, readonly) NSIndexSet *insertedIndexes;
+
+/// Indexes of the existing models, the removed models.
+@property (nonatomic, strong, readonly) NSIndexSet *deletedIndexes;
+
+/// Indexes of `array`, the reused models whose order is changed. It's a minimal set:
+/// the other reused models keep their relative order.
+@property (nonatomic, strong, readonly) NSIndexSet *movedIndexes;
+
+/// Indexes of `array`, the reused models which are modified.
+@property (nonatomic, strong, readonly) NSIndexSet *updatedIndexes;
+
+/// Returns the index of a model of `array` in the existing models,
+/// or NSNotFound if the model is inserted (or the index is out of bounds).
+- (NSUInteger)oldIndexOfObjectAtIndex:(NSUInteger)index;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,381 @@
+//
+//  YYModelReconcile.m
+//  YYModel <https://github.com/ibireme/YYModel>
+//
+//  This source code is licensed under the MIT-style license found in the
+//  LICENSE file in the root directory of this source tree.
+//
+
+#import "YYModelReconcile.h"
+#import "YYModelMeta.h"
+#import <objc/message.h>
+
+#define force_inline __inline__ __attribute__((always_inline))
+
+/// Properties of a matched model compared on the stack, more properties use heap buffer.
+#define kYYReconcileStackProperties 32
+
+
+/// Whether the c number property is a floating point type.
+static force_inline BOOL ReconcileIsFloatProperty(__unsafe_unretained _YYModelPropertyMeta *meta) {
+    switch (meta->_type & YYEncodingTypeMask) {
+        case YYEncodingTypeFloat:
+        case YYEncodingTypeDouble:
+        case YYEncodingTypeLongDouble: return YES;
+        default: return NO;
+    }
+}
+
+/// Whether the property holds a nested model, which is updated in place by `-yy_modelSetWithDictionary:`.
+static force_inline BOOL ReconcileIsModelProperty(__unsafe_unretained _YYModelPropertyMeta *meta) {
+    return (meta->_type & YYEncodingTypeMask) == YYEncodingTypeObject &&
+    meta->_nsType == YYEncodingTypeNSUnknown && meta->_cls;
+}
+
+/// Returns the primary key of a model, or nil if the model has no key.
+static id ReconcileKeyOfModel(__unsafe_unretained id model, __unsafe_unretained _YYModelPropertyMeta *meta) {
+    if (![model respondsToSelector:meta->_getter]) return nil;
+    if (meta->_isCNumber) {
+        if (ReconcileIsFloatProperty(meta)) return @(YYModelGetDoubleFromProperty(model, meta));
+        return @(YYModelGetInt64FromProperty(model, meta));
+    }
+    id key = ((id (*)(id, SEL))(void *) objc_msgSend)(model, meta->_getter);
+    return key == (id)kCFNull ? nil : key;
+}
+
+/// Returns the primary key of a json element, converted with the property (through `scratch`).
+static id ReconcileKeyOfDictionary(__unsafe_unretained NSDictionary *dic,
+                                   __unsafe_unretained _YYModelPropertyMeta *meta,
+                                   __unsafe_unretained id scratch) {
+    id value = YYModelGetValueFromDictionary(dic, meta);
+    if (!value || value == (id)kCFNull) return nil;
+    if (meta->_isCNumber) {
+        if (!YYModelNumberForProperty(value, meta)) return nil;
+    } else {
+        ((void (*)(id, SEL, id))(void *) objc_msgSend)(scratch, meta->_setter, (id)nil);
+    }
+    YYModelSetValueForProperty(scratch, value, meta);
+    return ReconcileKeyOfModel(scratch, meta);
+}
+
+/// Set the property value of `from` to `to`.
+static void ReconcileCopyProperty(__unsafe_unretained id from, __unsafe_unretained id to,
+                                  __unsafe_unretained _YYModelPropertyMeta *meta) {
+    if (meta->_isCNumber) {
+        if (ReconcileIsFloatProperty(meta)) {
+            YYModelSetDoubleToProperty(to, YYModelGetDoubleFromProperty(from, meta), meta);
+        } else {
+            YYModelSetInt64ToProperty(to, YYModelGetInt64FromProperty(from, meta), meta);
+        }
+        return;
+    }
+    switch (meta->_type & YYEncodingTypeMask) {
+        case YYEncodingTypeObject: {
+            id value = ((id (*)(id, SEL))(void *) objc_msgSend)(from, meta->_getter);
+            ((void (*)(id, SEL, id))(void *) objc_msgSend)(to, meta->_setter, value);
+        } break;
+        case YYEncodingTypeClass: {
+            Class value = ((Class (*)(id, SEL))(void *) objc_msgSend)(from, meta->_getter);
+            ((void (*)(id, SEL, Class))(void *) objc_msgSend)(to, meta->_setter, value);
+        } break;
+        case YYEncodingTypeSEL: {
+            SEL value = ((SEL (*)(id, SEL))(void *) objc_msgSend)(from, meta->_getter);
+            ((void (*)(id, SEL, SEL))(void *) objc_msgSend)(to, meta->_setter, value);
+        } break;
+        default: {
+            if (!meta->_isKVCCompatible) break;
+            NSString *key = NSStringFromSelector(meta->_getter);
+            id value = [from valueForKey:key];
+            if (value) [to setValue:value forKey:key];
+        } break;
+    }
+}
+
+/// Compare a property of the decoded `scratch` and the existing `model`.
+static BOOL ReconcilePropertyIsEqual(__unsafe_unretained id scratch, __unsafe_unretained id model,
+                                     __unsafe_unretained _YYModelPropertyMeta *meta,
+                                     __unsafe_unretained id jsonValue) {
+    if (meta->_isCNumber) {
+        if (ReconcileIsFloatProperty(meta)) {
+            double num1 = YYModelGetDoubleFromProperty(scratch, meta);
+            double num2 = YYModelGetDoubleFromProperty(model, meta);
+            return num1 == num2 || (isnan(num1) && isnan(num2));
+        }
+        return YYModelGetInt64FromProperty(scratch, meta) == YYModelGetInt64FromProperty(model, meta);
+    }
+    switch (meta->_type & YYEncodingTypeMask) {
+        case YYEncodingTypeObject: {
+            id value1 = ((id (*)(id, SEL))(void *) objc_msgSend)(scratch, meta->_getter);
+            id value2 = ((id (*)(id, SEL))(void *) objc_msgSend)(model, meta->_getter);
+            if (value1 == value2) return YES;
+            // the nested model of scratch is cleared before decoding, it's nil if the json value is invalid
+            if (!value1 && ReconcileIsModelProperty(meta)) return jsonValue != (id)kCFNull;
+            if (!value1 || !value2) return NO;
+            if ([value1 isEqual:value2]) return YES;
+            switch (meta->_nsType) {
+                case YYEncodingTypeNSUnknown:
+                case YYEncodingTypeNSArray:
+                case YYEncodingTypeNSMutableArray:
+                case YYEncodingTypeNSDictionary:
+                case YYEncodingTypeNSMutableDictionary:
+                case YYEncodingTypeNSSet:
+                case YYEncodingTypeNSMutableSet: {
+                    // models (or containers of models) are decoded as new instances
+                    NSMutableData *data1 = [NSMutableData new];
+                    NSMutableData *data2 = [NSMutableData new];
+                    YYModelAppendCanonicalJSON(data1, value1);
+                    YYModelAppendCanonicalJSON(data2, value2);
+                    return [data1 isEqualToData:data2];
+                }
+                default: return NO;
+            }
+        }
+        case YYEncodingTypeClass: {
+            Class value1 = ((Class (*)(id, SEL))(void *) objc_msgSend)(scratch, meta->_getter);
+            Class value2 = ((Class (*)(id, SEL))(void *) objc_msgSend)(model, meta->_getter);
+            return value1 == value2;
+        }
+        case YYEncodingTypeSEL: {
+            SEL value1 = ((SEL (*)(id, SEL))(void *) objc_msgSend)(scratch, meta->_getter);
+            SEL value2 = ((SEL (*)(id, SEL))(void *) objc_msgSend)(model, meta->_getter);
+            return value1 == value2;
+        }
+        default: {
+            // the struct/union which can not be compared is not decoded from json
+            if (!meta->_isKVCCompatible) return YES;
+            NSString *key = NSStringFromSelector(meta->_getter);
+            id value1 = [scratch valueForKey:key];
+            id value2 = [model valueForKey:key];
+            return value1 == value2 || [value1 isEqual:value2];
+        }
+    }
+}
+
+/**
+ Decode a json element into `scratch` (an instance of the model's class), and set the
+ changed properties to `model`.
+
+ @param changed Output, whether some property of the model is changed.
+ @return NO if the json element is invalid (`-yy_modelSetWithDictionary:` failed).
+ */
+static BOOL ReconcileUpdateModel(__unsafe_unretained id model, __unsafe_unretained id scratch,
+                                 __unsafe_unretained NSDictionary *dic, BOOL *changed) {
+    *changed = NO;
+    _YYModelMeta *modelMeta = [_YYModelMeta metaWithClass:[model class]];
+    BOOL compareAll = modelMeta->_hasCustomWillTransformFromDictionary || modelMeta->_hasCustomTransformFromDictionary;
+    CFArrayRef allMetas = (__bridge CFArrayRef)modelMeta->_allPropertyMetas;
+    CFIndex allCount = allMetas ? CFArrayGetCount(allMetas) : 0;
+
+    const void *stackMetas[kYYReconcileStackProperties], *stackValues[kYYReconcileStackProperties];
+    const void **metas = stackMetas, **values = stackValues;
+    if (allCount > kYYReconcileStackProperties) {
+        metas = malloc(sizeof(void *) * allCount);
+        values = malloc(sizeof(void *) * allCount);
+    }
+
+    // the compared properties start with the values of the model, so the properties
+    // which are not set by json (absent or invalid value) are equal
+    CFIndex count = 0;
+    for (CFIndex i = 0; i < allCount; i++) {
+        __unsafe_unretained _YYModelPropertyMeta *meta = CFArrayGetValueAtIndex(allMetas, i);
+        __unsafe_unretained id value = meta->_mappedToKey ? YYModelGetValueFromDictionary(dic, meta) : nil;
+        if (!value && !compareAll) continue;
+        if (ReconcileIsModelProperty(meta)) {
+            ((void (*)(id, SEL, id))(void *) objc_msgSend)(scratch, meta->_setter, (id)nil);
+        } else {
+            ReconcileCopyProperty(model, scratch, meta);
+        }
+        metas[count] = (__bridge const void *)meta;
+        values[count] = (__bridge const void *)value;
+        count++;
+    }
+
+    BOOL valid = count == 0 || [scratch yy_modelSetWithDictionary:dic];
+    if (valid) {
+        for (CFIndex i = 0; i < count; i++) {
+            __unsafe_unretained _YYModelPropertyMeta *meta = (__bridge _YYModelPropertyMeta *)metas[i];
+            if (ReconcilePropertyIsEqual(scratch, model, meta, (__bridge id)values[i])) continue;
+            ReconcileCopyProperty(scratch, model, meta);
+            *changed = YES;
+        }
+    }
+
+    if (metas != stackMetas) {
+        free(metas);
+        free(values);
+    }
+    return valid;
+}
+
+/// Set YES to `flags` at the positions of the longest increasing subsequence of `values`.
+static void ReconcileMarkIncreasingSubsequence(const NSUInteger *values, NSUInteger count, BOOL *flags) {
+    if (count == 0) return;
+    NSUInteger *tails = malloc(sizeof(NSUInteger) * count); // position of the smallest tail of each length
+    NSUInteger *prev = malloc(sizeof(NSUInteger) * count);
+    NSUInteger length = 0;
+    for (NSUInteger i = 0; i < count; i++) {
+        NSUInteger lo = 0, hi = length;
+        while (lo < hi) {
+            NSUInteger mid = (lo + hi) / 2;
+            if (values[tails[mid]] < values[i]) lo = mid + 1;
+            else hi = mid;
+        }
+        prev[i] = lo > 0 ? tails[lo - 1] : NSNotFound;
+        tails[lo] = i;
+        if (lo == length) length++;
+    }
+    for (NSUInteger i = tails[length - 1]; i != NSNotFound; i = prev[i]) flags[i] = YES;
+    free(tails);
+    free(prev);
+}
+
+
+@implementation YYModelReconciliation {
+    NSUInteger *_oldIndexes; ///< old index of each model in `_array`
+}
+
+- (void)dealloc {
+    if (_oldIndexes) free(_oldIndexes);
+}
+
++ (instancetype)reconciliationWithModels:(NSArray *)models class:(Class)cls json:(id)json primaryKey:(NSString *)primaryKey {
+    if (!cls || !json || ![primaryKey isKindOfClass:[NSString class]]) return nil;
+    NSArray *arr = nil;
+    NSData *jsonData = nil;
+    if ([json isKindOfClass:[NSArray class]]) {
+        arr = json;
+    } else if ([json isKindOfClass:[NSString class]]) {
+        jsonData = [(NSString *)json dataUsingEncoding : NSUTF8StringEncoding];
+    } else if ([json isKindOfClass:[NSData class]]) {
+        jsonData = json;
+    }
+    if (jsonData) {
+        arr = [NSJSONSerialization JSONObjectWithData:jsonData options:kNilOptions error:NULL];
+        if (![arr isKindOfClass:[NSArray class]]) arr = nil;
+    }
+    if (!arr) return nil;
+
+    _YYModelMeta *modelMeta = [_YYModelMeta metaWithClass:cls];
+    if (!modelMeta) return nil;
+    _YYModelPropertyMeta *keyMeta = nil;
+    for (_YYModelPropertyMeta *meta in modelMeta->_allPropertyMetas) {
+        if ([meta->_name isEqualToString:primaryKey]) {
+            keyMeta = meta;
+            break;
+        }
+    }
+    if (!keyMeta || !keyMeta->_mappedToKey) return nil;
+    if (!keyMeta->_isCNumber && (keyMeta->_type & YYEncodingTypeMask) != YYEncodingTypeObject) return nil;
+    if (![models isKindOfClass:[NSArray class]]) models = nil;
+
+    // primary key -> index of the existing model
+    NSUInteger oldCount = models.count;
+    CFMutableDictionaryRef oldKeys = CFDictionaryCreateMutable(CFAllocatorGetDefault(), oldCount, &kCFTypeDictionaryKeyCallBacks, NULL);
+    for (NSUInteger i = 0; i < oldCount; i++) {
+        id key = ReconcileKeyOfModel(models[i], keyMeta);
+        if (!key || CFDictionaryContainsKey(oldKeys, (__bridge const void *)key)) continue;
+        CFDictionarySetValue(oldKeys, (__bridge const void *)key, (const void *)i);
+    }
+    BOOL *matched = oldCount ? calloc(oldCount, sizeof(BOOL)) : NULL;
+
+    // model class -> the instance which json is decoded into for comparison, it's reused
+    CFMutableDictionaryRef scratches = CFDictionaryCreateMutable(CFAllocatorGetDefault(), 0, NULL, &kCFTypeDictionaryValueCallBacks);
+    id keyScratch = [cls new];
+
+    NSUInteger count = arr.count;
+    NSMutableArray *array = [NSMutableArray arrayWithCapacity:count];
+    NSUInteger *oldIndexes = malloc(sizeof(NSUInteger) * MAX(count, 1));
+    NSMutableIndexSet *inserted = [NSMutableIndexSet new];
+    NSMutableIndexSet *updated = [NSMutableIndexSet new];
+    NSUInteger batchSize = modelMeta->_autoreleaseBatchSize;
+
+    for (NSUInteger i = 0; i < count;) {
+        @autoreleasepool {
+            for (NSUInteger end = batchSize ? MIN(i + batchSize, count) : count; i < end; i++) {
+                NSDictionary *dic = arr[i];
+                if (![dic isKindOfClass:[NSDictionary class]]) continue;
+
+                id model = nil;
+                NSUInteger oldIndex = NSNotFound;
+                id key = ReconcileKeyOfDictionary(dic, keyMeta, keyScratch);
+                const void *found = NULL;
+                if (key && CFDictionaryGetValueIfPresent(oldKeys, (__bridge const void *)key, &found) && !matched[(NSUInteger)found]) {
+                    model = models[(NSUInteger)found];
+                    Class modelCls = cls;
+                    if (modelMeta->_hasCustomClassFromDictionary) {
+                        modelCls = [cls modelCustomClassForDictionary:dic] ?: cls;
+                    }
+                    if ([model class] == modelCls) { // not object_getClass(), a KVO observed model has a subclass
+                        oldIndex = (NSUInteger)found;
+                    } else {
+                        model = nil; // the class is changed, replaced with a new model
+                    }
+                }
+
+                if (model) {
+                    Class modelClass = [model class];
+                    id scratch = (__bridge id)CFDictionaryGetValue(scratches, (__bridge const void *)modelClass);
+                    if (!scratch) {
+                        scratch = [modelClass new];
+                        CFDictionarySetValue(scratches, (__bridge const void *)modelClass, (__bridge const void *)scratch);
+                    }
+                    BOOL changed = NO;
+                    if (!ReconcileUpdateModel(model, scratch, dic, &changed)) continue;
+                    matched[oldIndex] = YES;
+                    if (changed) [updated addIndex:array.count];
+                } else {
+                    model = [cls yy_modelWithDictionary:dic];
+                    if (!model) continue;
+                    [inserted addIndex:array.count];
+                }
+                oldIndexes[array.count] = oldIndex;
+                [array addObject:model];
+            }
+        }
+    }
+    CFRelease(scratches);
+    CFRelease(oldKeys);
+
+    NSMutableIndexSet *deleted = [NSMutableIndexSet new];
+    for (NSUInteger i = 0; i < oldCount; i++) {
+        if (!matched[i]) [deleted addIndex:i];
+    }
+    if (matched) free(matched);
+
+    // the reused models out of the longest increasing subsequence of old indexes are moved
+    NSUInteger newCount = array.count;
+    NSUInteger reusedCount = 0;
+    NSUInteger *reused = malloc(sizeof(NSUInteger) * MAX(newCount, 1));
+    NSUInteger *reusedOldIndexes = malloc(sizeof(NSUInteger) * MAX(newCount, 1));
+    for (NSUInteger i = 0; i < newCount; i++) {
+        if (oldIndexes[i] == NSNotFound) continue;
+        reused[reusedCount] = i;
+        reusedOldIndexes[reusedCount] = oldIndexes[i];
+        reusedCount++;
+    }
+    BOOL *stay = calloc(MAX(reusedCount, 1), sizeof(BOOL));
+    ReconcileMarkIncreasingSubsequence(reusedOldIndexes, reusedCount, stay);
+    NSMutableIndexSet *moved = [NSMutableIndexSet new];
+    for (NSUInteger i = 0; i < reusedCount; i++) {
+        if (!stay[i]) [moved addIndex:reused[i]];
+    }
+    free(stay);
+    free(reused);
+    free(reusedOldIndexes);
+
+    YYModelReconciliation *one = [self new];
+    one->_array = array.copy;
+    one->_oldIndexes = oldIndexes;
+    one->_insertedIndexes = inserted.copy;
+    one->_deletedIndexes = deleted.copy;
+    one->_movedIndexes = moved.copy;
+    one->_updatedIndexes = updated.copy;
+    return one;
+}
+
+- (NSUInteger)oldIndexOfObjectAtIndex:(NSUInteger)index {
+    if (index >= _array.count) return NSNotFound;
+    return _oldIndexes[index];
+}
+
+@end
@@ -0,0 +1,110 @@
+//
+//  YYModelSQLite.h
+//  YYModel <https://github.com/ibireme/YYModel>
+//
+//  This source code is licensed under the MIT-style license found in the
+//  LICENSE file in the root directory of this source tree.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ Stores models as rows of SQLite tables, the table layout is derived from the model class.
+
+ @discussion Each model class is stored in a table named with the class name, and each
+ property (which has getter and setter) is stored in a column named with the property name:
+
+     bool, int8/16/32/64, uint8/16/32/64  -> INTEGER (uint64 is stored with the bits of int64)
+     float, double, long double           -> REAL
+     NSString, NSURL                      -> TEXT
+     NSNumber                             -> NUMERIC (integer or real)
+     NSDecimalNumber                      -> TEXT
+     NSData                               -> BLOB
+     NSDate                               -> REAL (seconds since 1970)
+     other model, container, others       -> BLOB (binary property list, see YYModelBinaryPlist)
+
+ A property with a custom transformer (c number or object) is stored as a BLOB of its
+ json value, and the value read back is passed to the transformer's decoder. Properties
+ of other types (such as struct, SEL, Class and block) are not stored.
+
+ Values are bound to the statements directly from the properties, and rows are read
+ directly into the properties by column index, without intermediate dictionaries.
+ The prepared statements are cached, and the models of one insert are written in
+ one transaction.
+
+ The methods are thread-safe, the calls to the same database are serialized.
+ */
+@interface YYModelSQLite : NSObject
+
+/**
+ Opens (or creates) a database file.
+
+ @param path The file path.
+ @return A new instance, or nil if the database can not be opened.
+ */
+- (nullable instancetype)initWithPath:(NSString *)path NS_DESIGNATED_INITIALIZER;
+- (instancetype)init UNAVAILABLE_ATTRIBUTE;
++ (instancetype)new UNAVAILABLE_ATTRIBUTE;
+
+/// The database file path.
+@property (nonatomic, copy, readonly) NSString *path;
+
+/// The number of rows written in one transaction. Default is 1000, 0 for no limit.
+@property (nonatomic, assign) NSUInteger transactionBatchSize;
+
+/**
+ Creates the table of a model class if it's not exists, and adds the columns of the
+ new properties if the table exists. It's called automatically before the first access
+ to the table (without primary key).
+
+ @param cls         The model class.
+ @param primaryKey  The property name of the primary key, or nil. When a model is inserted
+                    with the same primary key as an existing row, the row is replaced.
+ @return Whether succeed. It fails if the table exists with another (or without) primary key,
+         as the primary key of an existing table can't be changed.
+ */
+- (BOOL)createTableWithClass:(Class)cls primaryKey:(nullable NSString *)primaryKey;
+
+/**
+ Inserts models to the table of the class.
+
+ @param models An array of `cls` instances, other objects are ignored.
+ @param cls    The model class.
+ @return Whether succeed. If failed, the rows of the failed transaction are not written.
+ */
+- (BOOL)insertModels:(NSArray *)models class:(Class)cls;
+
+/**
+ Reads models from the table of the class.
+
+ @param cls       The model class.
+ @param where     The SQL condition after "WHERE" (may have "ORDER BY" and "LIMIT"),
+                  such as @"age > ? ORDER BY name", or nil to read all rows.
+ @param arguments The values of the parameters in `where`: NSString, NSNumber, NSData,
+                  NSDate or NSNull.
+ @return An array of `cls` instances, or nil if an error occurs.
+ */
+- (nullable NSArray *)modelsWithClass:(Class)cls where:(nullable NSString *)where arguments:(nullable NSArray *)arguments;
+
+/**
+ Returns the number of rows in the table of the class, or -1 if an error occurs.
+ See `modelsWithClass:where:arguments:` for the parameters.
+ */
+- (NSInteger)countOfModelsWithClass:(Class)cls where:(nullable NSString *)where arguments:(nullable NSArray *)arguments;
+
+/**
+ Deletes rows from the table of the class.
+ See `modelsWithClass:where:arguments:` for the parameters.
+
+ @return Whether succeed.
+ */
+- (BOOL)deleteModelsWithClass:(Class)cls where:(nullable NSString *)where arguments:(nullable NSArray *)arguments;
+
+/// Closes the database, the instance can not be used after it's closed.
+- (void)close;
+
+@end
+
+NS_ASSUME_NONNULL_END
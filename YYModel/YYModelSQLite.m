@@ -0,0 +1,571 @@
+//
+//  YYModelSQLite.m
+//  YYModel <https://github.com/ibireme/YYModel>
+//
+//  This source code is licensed under the MIT-style license found in the
+//  LICENSE file in the root directory of this source tree.
+//
+
+#import "YYModelSQLite.h"
+#import "YYModelBinaryPlist.h"
+#import "YYModelMeta.h"
+#import <objc/message.h>
+#import <sqlite3.h>
+
+#define force_inline __inline__ __attribute__((always_inline))
+
+/// Number of rows between two autorelease pool drains when reading.
+#define kYYSQLitePoolBatchSize 256
+/// Max number of cached statements, the cache is cleared when it's full.
+#define kYYSQLiteStatementCacheLimit 128
+
+/// Storage type of a property in table.
+typedef NS_ENUM (NSUInteger, YYSQLiteColumnType) {
+    YYSQLiteColumnTypeNone = 0, ///< not stored
+    YYSQLiteColumnTypeInteger,  ///< c integer (and bool)
+    YYSQLiteColumnTypeReal,     ///< c float
+    YYSQLiteColumnTypeText,     ///< NSString, NSMutableString
+    YYSQLiteColumnTypeString,   ///< NSURL, NSDecimalNumber, stored as text and set with the json conversion
+    YYSQLiteColumnTypeNumber,   ///< NSNumber
+    YYSQLiteColumnTypeData,     ///< NSData, NSMutableData
+    YYSQLiteColumnTypeDate,     ///< NSDate
+    YYSQLiteColumnTypePlist,    ///< other objects, stored as binary property list
+};
+
+static YYSQLiteColumnType YYSQLiteColumnTypeForProperty(__unsafe_unretained _YYModelPropertyMeta *meta) {
+    if (!meta->_getter || !meta->_setter) return YYSQLiteColumnTypeNone;
+    BOOL isObject = (meta->_type & YYEncodingTypeMask) == YYEncodingTypeObject;
+    if ((meta->_encoder || meta->_decoder) && (meta->_isCNumber || isObject)) return YYSQLiteColumnTypePlist;
+    if (meta->_isCNumber) {
+        switch (meta->_type & YYEncodingTypeMask) {
+            case YYEncodingTypeFloat:
+            case YYEncodingTypeDouble:
+            case YYEncodingTypeLongDouble: return YYSQLiteColumnTypeReal;
+            default: return YYSQLiteColumnTypeInteger;
+        }
+    }
+    if (!isObject) return YYSQLiteColumnTypeNone;
+    switch (meta->_nsType) {
+        case YYEncodingTypeNSString:
+        case YYEncodingTypeNSMutableString: return YYSQLiteColumnTypeText;
+        case YYEncodingTypeNSURL:
+        case YYEncodingTypeNSDecimalNumber: return YYSQLiteColumnTypeString;
+        case YYEncodingTypeNSNumber: return YYSQLiteColumnTypeNumber;
+        case YYEncodingTypeNSData:
+        case YYEncodingTypeNSMutableData: return YYSQLiteColumnTypeData;
+        case YYEncodingTypeNSDate: return YYSQLiteColumnTypeDate;
+        default: return YYSQLiteColumnTypePlist;
+    }
+}
+
+static const char *YYSQLiteColumnTypeDeclaration(YYSQLiteColumnType type) {
+    switch (type) {
+        case YYSQLiteColumnTypeInteger: return "INTEGER";
+        case YYSQLiteColumnTypeReal:
+        case YYSQLiteColumnTypeDate: return "REAL";
+        case YYSQLiteColumnTypeText:
+        case YYSQLiteColumnTypeString: return "TEXT";
+        case YYSQLiteColumnTypeNumber: return "NUMERIC";
+        default: return "BLOB";
+    }
+}
+
+/// Quote an identifier with '"'.
+static NSString *YYSQLiteQuote(NSString *name) {
+    return [NSString stringWithFormat:@"\"%@\"", [name stringByReplacingOccurrencesOfString:@"\"" withString:@"\"\""]];
+}
+
+static force_inline int YYSQLiteBindString(sqlite3_stmt *stmt, int index, __unsafe_unretained NSString *string) {
+    const char *utf8 = string.UTF8String;
+    if (!utf8) return sqlite3_bind_null(stmt, index);
+    return sqlite3_bind_text(stmt, index, utf8, -1, SQLITE_TRANSIENT);
+}
+
+static force_inline int YYSQLiteBindData(sqlite3_stmt *stmt, int index, __unsafe_unretained NSData *data) {
+    // a zero length blob is bound with a non-NULL pointer, or it becomes NULL
+    return sqlite3_bind_blob(stmt, index, data.length ? data.bytes : "", (int)data.length, SQLITE_TRANSIENT);
+}
+
+static int YYSQLiteBindNumber(sqlite3_stmt *stmt, int index, __unsafe_unretained NSNumber *number) {
+    CFNumberRef num = (__bridge CFNumberRef)number;
+    if (CFGetTypeID(num) == CFBooleanGetTypeID()) return sqlite3_bind_int64(stmt, index, CFBooleanGetValue((CFBooleanRef)num));
+    if (CFGetTypeID(num) != CFNumberGetTypeID() || [number isKindOfClass:[NSDecimalNumber class]]) {
+        return YYSQLiteBindString(stmt, index, number.stringValue);
+    }
+    if (CFNumberIsFloatType(num)) return sqlite3_bind_double(stmt, index, number.doubleValue);
+    const char *type = number.objCType;
+    if ((strcmp(type, @encode(unsigned long long)) == 0 || strcmp(type, @encode(unsigned long)) == 0) &&
+        number.unsignedLongLongValue > INT64_MAX) {
+        // out of range of INTEGER, keep all digits in text
+        return YYSQLiteBindString(stmt, index, number.stringValue);
+    }
+    return sqlite3_bind_int64(stmt, index, number.longLongValue);
+}
+
+/// Bind a value of a statement argument.
+static int YYSQLiteBindObject(sqlite3_stmt *stmt, int index, __unsafe_unretained id value) {
+    if (!value || value == (id)kCFNull) return sqlite3_bind_null(stmt, index);
+    if ([value isKindOfClass:[NSString class]]) return YYSQLiteBindString(stmt, index, value);
+    if ([value isKindOfClass:[NSNumber class]]) return YYSQLiteBindNumber(stmt, index, value);
+    if ([value isKindOfClass:[NSData class]]) return YYSQLiteBindData(stmt, index, value);
+    if ([value isKindOfClass:[NSDate class]]) return sqlite3_bind_double(stmt, index, ((NSDate *)value).timeIntervalSince1970);
+    if ([value isKindOfClass:[NSURL class]]) return YYSQLiteBindString(stmt, index, ((NSURL *)value).absoluteString);
+    return SQLITE_MISMATCH;
+}
+
+/// Bind the value of a property, nil is bound as NULL.
+static int YYSQLiteBindProperty(sqlite3_stmt *stmt, int index, __unsafe_unretained id model,
+                                __unsafe_unretained _YYModelPropertyMeta *meta, YYSQLiteColumnType type) {
+    switch (type) {
+        case YYSQLiteColumnTypeInteger: {
+            return sqlite3_bind_int64(stmt, index, YYModelGetInt64FromProperty(model, meta));
+        }
+        case YYSQLiteColumnTypeReal: {
+            double num = YYModelGetDoubleFromProperty(model, meta);
+            return isnan(num) ? sqlite3_bind_null(stmt, index) : sqlite3_bind_double(stmt, index, num);
+        }
+        case YYSQLiteColumnTypePlist: {
+            id value = YYModelGetJSONValueForProperty(model, meta, NO);
+            if (!value || value == (id)kCFNull) return sqlite3_bind_null(stmt, index);
+            NSData *data = [YYModelBinaryPlist dataWithObject:value];
+            return data ? YYSQLiteBindData(stmt, index, data) : sqlite3_bind_null(stmt, index);
+        }
+        default: break;
+    }
+    id value = ((id (*)(id, SEL))(void *) objc_msgSend)((id)model, meta->_getter);
+    if (!value) return sqlite3_bind_null(stmt, index);
+    switch (type) {
+        case YYSQLiteColumnTypeText: {
+            if (![value isKindOfClass:[NSString class]]) return sqlite3_bind_null(stmt, index);
+            return YYSQLiteBindString(stmt, index, value);
+        }
+        case YYSQLiteColumnTypeString: {
+            if ([value isKindOfClass:[NSURL class]]) return YYSQLiteBindString(stmt, index, ((NSURL *)value).absoluteString);
+            if ([value isKindOfClass:[NSNumber class]]) return YYSQLiteBindString(stmt, index, ((NSNumber *)value).stringValue);
+            return sqlite3_bind_null(stmt, index);
+        }
+        case YYSQLiteColumnTypeNumber: {
+            if (![value isKindOfClass:[NSNumber class]]) return sqlite3_bind_null(stmt, index);
+            return YYSQLiteBindNumber(stmt, index, value);
+        }
+        case YYSQLiteColumnTypeData: {
+            if (![value isKindOfClass:[NSData class]]) return sqlite3_bind_null(stmt, index);
+            return YYSQLiteBindData(stmt, index, value);
+        }
+        case YYSQLiteColumnTypeDate: {
+            if (![value isKindOfClass:[NSDate class]]) return sqlite3_bind_null(stmt, index);
+            return sqlite3_bind_double(stmt, index, ((NSDate *)value).timeIntervalSince1970);
+        }
+        default: return sqlite3_bind_null(stmt, index);
+    }
+}
+
+static force_inline NSString *YYSQLiteColumnString(sqlite3_stmt *stmt, int index) {
+    const char *text = (const char *)sqlite3_column_text(stmt, index);
+    if (!text) return nil;
+    return [[NSString alloc] initWithBytes:text length:sqlite3_column_bytes(stmt, index) encoding:NSUTF8StringEncoding];
+}
+
+static force_inline void YYSQLiteSetObject(__unsafe_unretained id model, __unsafe_unretained _YYModelPropertyMeta *meta, __unsafe_unretained id value) {
+    ((void (*)(id, SEL, id))(void *) objc_msgSend)((id)model, meta->_setter, value);
+}
+
+/// Set the value of a plist column, nested models are created from the plist directly.
+static void YYSQLiteSetPlistToProperty(__unsafe_unretained id model, __unsafe_unretained _YYModelPropertyMeta *meta, NSData *data) {
+    if (!meta->_decoder && !meta->_hasCustomClassFromDictionary) {
+        if (meta->_nsType == YYEncodingTypeNSUnknown && meta->_cls) {
+            id one = [YYModelBinaryPlist modelWithClass:meta->_cls data:data];
+            if ([one isKindOfClass:meta->_cls]) YYSQLiteSetObject(model, meta, one);
+            return;
+        }
+        if ((meta->_nsType == YYEncodingTypeNSArray || meta->_nsType == YYEncodingTypeNSMutableArray) && meta->_genericCls) {
+            id array = [YYModelBinaryPlist modelWithClass:meta->_genericCls data:data];
+            if ([array isKindOfClass:[NSArray class]]) {
+                YYSQLiteSetObject(model, meta, meta->_nsType == YYEncodingTypeNSMutableArray ? [array mutableCopy] : array);
+            }
+            return;
+        }
+    }
+    id value = [NSPropertyListSerialization propertyListWithData:data options:NSPropertyListImmutable format:NULL error:NULL];
+    if (value) YYModelSetValueForProperty(model, value, meta);
+}
+
+/// Set a column of current row to a property, NULL is ignored.
+static void YYSQLiteSetColumnToProperty(sqlite3_stmt *stmt, int index, __unsafe_unretained id model,
+                                        __unsafe_unretained _YYModelPropertyMeta *meta, YYSQLiteColumnType type) {
+    int columnType = sqlite3_column_type(stmt, index);
+    if (columnType == SQLITE_NULL) return;
+    switch (type) {
+        case YYSQLiteColumnTypeInteger: {
+            if (columnType == SQLITE_INTEGER) {
+                YYModelSetInt64ToProperty(model, sqlite3_column_int64(stmt, index), meta);
+            } else if (columnType == SQLITE_FLOAT) {
+                YYModelSetDoubleToProperty(model, sqlite3_column_double(stmt, index), meta);
+            } else {
+                const char *text = (const char *)sqlite3_column_text(stmt, index);
+                if (text) YYModelSetNumberCStringToProperty(model, text, meta);
+            }
+        } break;
+        case YYSQLiteColumnTypeReal: {
+            YYModelSetDoubleToProperty(model, sqlite3_column_double(stmt, index), meta);
+        } break;
+        case YYSQLiteColumnTypeText: {
+            NSString *string = YYSQLiteColumnString(stmt, index);
+            if (!string) break;
+            YYSQLiteSetObject(model, meta, meta->_nsType == YYEncodingTypeNSMutableString ? string.mutableCopy : string);
+        } break;
+        case YYSQLiteColumnTypeString: {
+            NSString *string = YYSQLiteColumnString(stmt, index);
+            if (string) YYModelSetValueForProperty(model, string, meta);
+        } break;
+        case YYSQLiteColumnTypeNumber: {
+            if (columnType == SQLITE_INTEGER) {
+                YYSQLiteSetObject(model, meta, @(sqlite3_column_int64(stmt, index)));
+            } else if (columnType == SQLITE_FLOAT) {
+                YYSQLiteSetObject(model, meta, @(sqlite3_column_double(stmt, index)));
+            } else {
+                NSString *string = YYSQLiteColumnString(stmt, index);
+                if (string) YYModelSetValueForProperty(model, string, meta);
+            }
+        } break;
+        case YYSQLiteColumnTypeData: {
+            const void *bytes = sqlite3_column_blob(stmt, index);
+            int length = sqlite3_column_bytes(stmt, index);
+            Class cls = meta->_nsType == YYEncodingTypeNSMutableData ? [NSMutableData class] : [NSData class];
+            YYSQLiteSetObject(model, meta, [cls dataWithBytes:bytes length:length]);
+        } break;
+        case YYSQLiteColumnTypeDate: {
+            YYSQLiteSetObject(model, meta, [NSDate dateWithTimeIntervalSince1970:sqlite3_column_double(stmt, index)]);
+        } break;
+        case YYSQLiteColumnTypePlist: {
+            const void *bytes = sqlite3_column_blob(stmt, index);
+            int length = sqlite3_column_bytes(stmt, index);
+            if (!bytes || length <= 0) break;
+            // the bytes are valid until the next step, the data is not used after this call
+            NSData *data = [NSData dataWithBytesNoCopy:(void *)bytes length:length freeWhenDone:NO];
+            YYSQLiteSetPlistToProperty(model, meta, data);
+        } break;
+        default: break;
+    }
+}
+
+
+/// The table layout of a model class.
+@interface _YYModelSQLiteTable : NSObject {
+    @package
+    NSString *_name;           ///< quoted table name
+    NSArray *_metas;           ///< Array<_YYModelPropertyMeta>, stored properties in column order
+    YYSQLiteColumnType *_types; ///< column types, same count as _metas
+    int _count;                ///< column count
+    NSString *_selectSQL;      ///< select all columns
+    NSString *_insertSQL;      ///< insert or replace a row
+}
+@end
+
+@implementation _YYModelSQLiteTable
+
+- (void)dealloc {
+    if (_types) free(_types);
+}
+
++ (instancetype)tableWithClass:(Class)cls {
+    _YYModelMeta *modelMeta = [_YYModelMeta metaWithClass:cls];
+    if (!modelMeta || modelMeta->_nsType) return nil;
+    NSMutableArray *metas = [NSMutableArray new];
+    for (_YYModelPropertyMeta *meta in modelMeta->_allPropertyMetas) {
+        if (YYSQLiteColumnTypeForProperty(meta) != YYSQLiteColumnTypeNone) [metas addObject:meta];
+    }
+    if (metas.count == 0 || metas.count > INT_MAX) return nil;
+    [metas sortUsingComparator:^NSComparisonResult(_YYModelPropertyMeta *a, _YYModelPropertyMeta *b) {
+        return [a->_name compare:b->_name options:NSLiteralSearch];
+    }];
+
+    _YYModelSQLiteTable *table = [self new];
+    table->_name = YYSQLiteQuote(NSStringFromClass(cls));
+    table->_metas = metas;
+    table->_count = (int)metas.count;
+    table->_types = malloc(metas.count * sizeof(YYSQLiteColumnType));
+    if (!table->_types) return nil;
+    NSMutableString *columns = [NSMutableString new];
+    NSMutableString *values = [NSMutableString new];
+    for (int i = 0; i < table->_count; i++) {
+        _YYModelPropertyMeta *meta = metas[i];
+        table->_types[i] = YYSQLiteColumnTypeForProperty(meta);
+        [columns appendFormat:i ? @",%@" : @"%@", YYSQLiteQuote(meta->_name)];
+        [values appendString:i ? @",?" : @"?"];
+    }
+    table->_selectSQL = [NSString stringWithFormat:@"SELECT %@ FROM %@", columns, table->_name];
+    table->_insertSQL = [NSString stringWithFormat:@"INSERT OR REPLACE INTO %@ (%@) VALUES (%@)", table->_name, columns, values];
+    return table;
+}
+
+@end
+
+
+@implementation YYModelSQLite {
+    sqlite3 *_db;
+    dispatch_semaphore_t _lock;
+    CFMutableDictionaryRef _statements; ///< Key:SQL, Value:sqlite3_stmt
+    CFMutableDictionaryRef _tables;     ///< Key:Class, Value:_YYModelSQLiteTable
+}
+
+- (instancetype)init {
+    @throw [NSException exceptionWithName:@"YYModelSQLite init error" reason:@"Use the designated initializer to init." userInfo:nil];
+    return [self initWithPath:@""];
+}
+
+- (instancetype)initWithPath:(NSString *)path {
+    if (path.length == 0) return nil;
+    self = [super init];
+    if (sqlite3_open_v2(path.fileSystemRepresentation, &_db, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_NOMUTEX, NULL) != SQLITE_OK) {
+        if (_db) sqlite3_close(_db);
+        _db = NULL;
+        return nil;
+    }
+    sqlite3_exec(_db, "PRAGMA journal_mode = WAL; PRAGMA synchronous = NORMAL;", NULL, NULL, NULL);
+    _path = path.copy;
+    _transactionBatchSize = 1000;
+    _lock = dispatch_semaphore_create(1);
+    _statements = CFDictionaryCreateMutable(CFAllocatorGetDefault(), 0, &kCFTypeDictionaryKeyCallBacks, NULL);
+    _tables = CFDictionaryCreateMutable(CFAllocatorGetDefault(), 0, &kCFTypeDictionaryKeyCallBacks, &kCFTypeDictionaryValueCallBacks);
+    return self;
+}
+
+- (void)dealloc {
+    [self _close];
+    if (_statements) CFRelease(_statements);
+    if (_tables) CFRelease(_tables);
+}
+
+static void YYSQLiteFinalizeStatement(const void *key, const void *value, void *context) {
+    sqlite3_finalize((sqlite3_stmt *)value);
+}
+
+- (void)_close {
+    if (!_db) return;
+    CFDictionaryApplyFunction(_statements, YYSQLiteFinalizeStatement, NULL);
+    CFDictionaryRemoveAllValues(_statements);
+    sqlite3_close(_db);
+    _db = NULL;
+}
+
+- (void)close {
+    dispatch_semaphore_wait(_lock, DISPATCH_TIME_FOREVER);
+    [self _close];
+    dispatch_semaphore_signal(_lock);
+}
+
+/// Returns a cached (and reset) statement, or prepares a new one. The caller should reset it after use.
+- (sqlite3_stmt *)_statementWithSQL:(NSString *)sql {
+    sqlite3_stmt *stmt = (sqlite3_stmt *)CFDictionaryGetValue(_statements, (__bridge CFStringRef)sql);
+    if (stmt) {
+        sqlite3_reset(stmt);
+        sqlite3_clear_bindings(stmt);
+        return stmt;
+    }
+    if (sqlite3_prepare_v2(_db, sql.UTF8String, -1, &stmt, NULL) != SQLITE_OK) return NULL;
+    if (CFDictionaryGetCount(_statements) >= kYYSQLiteStatementCacheLimit) {
+        CFDictionaryApplyFunction(_statements, YYSQLiteFinalizeStatement, NULL);
+        CFDictionaryRemoveAllValues(_statements);
+    }
+    CFDictionarySetValue(_statements, (__bridge CFStringRef)sql, stmt);
+    return stmt;
+}
+
+- (BOOL)_execute:(NSString *)sql {
+    return sqlite3_exec(_db, sql.UTF8String, NULL, NULL, NULL) == SQLITE_OK;
+}
+
+/// Creates the table (or adds the new columns) and caches the layout.
+- (_YYModelSQLiteTable *)_createTableWithClass:(Class)cls primaryKey:(NSString *)primaryKey {
+    _YYModelSQLiteTable *table = [_YYModelSQLiteTable tableWithClass:cls];
+    if (!table) return nil;
+    NSMutableString *sql = [NSMutableString stringWithFormat:@"CREATE TABLE IF NOT EXISTS %@ (", table->_name];
+    BOOL hasPrimaryKey = NO;
+    for (int i = 0; i < table->_count; i++) {
+        _YYModelPropertyMeta *meta = table->_metas[i];
+        [sql appendFormat:@"%@%@ %s", i ? @", " : @"", YYSQLiteQuote(meta->_name), YYSQLiteColumnTypeDeclaration(table->_types[i])];
+        if (primaryKey && [meta->_name isEqualToString:primaryKey]) {
+            [sql appendString:@" PRIMARY KEY"];
+            hasPrimaryKey = YES;
+        }
+    }
+    [sql appendString:@")"];
+    if (primaryKey && !hasPrimaryKey) return nil;
+    if (![self _execute:sql]) return nil;
+
+    // add the columns of new properties
+    NSMutableSet *columns = [NSMutableSet new];
+    NSMutableArray *primaryKeyColumns = [NSMutableArray new];
+    sqlite3_stmt *stmt = NULL;
+    NSString *info = [NSString stringWithFormat:@"PRAGMA table_info(%@)", table->_name];
+    if (sqlite3_prepare_v2(_db, info.UTF8String, -1, &stmt, NULL) != SQLITE_OK) return nil;
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        NSString *name = YYSQLiteColumnString(stmt, 1);
+        if (!name) continue;
+        [columns addObject:name];
+        if (sqlite3_column_int(stmt, 5) > 0) [primaryKeyColumns addObject:name]; // "pk"
+    }
+    sqlite3_finalize(stmt);
+
+    // an existing table may be created with another (or without) primary key
+    if (primaryKey && !(primaryKeyColumns.count == 1 && [primaryKeyColumns.firstObject isEqualToString:primaryKey])) {
+        return nil;
+    }
+    for (int i = 0; i < table->_count; i++) {
+        _YYModelPropertyMeta *meta = table->_metas[i];
+        if ([columns containsObject:meta->_name]) continue;
+        NSString *alter = [NSString stringWithFormat:@"ALTER TABLE %@ ADD COLUMN %@ %s", table->_name,
+                           YYSQLiteQuote(meta->_name), YYSQLiteColumnTypeDeclaration(table->_types[i])];
+        if (![self _execute:alter]) return nil;
+    }
+    CFDictionarySetValue(_tables, (__bridge const void *)(cls), (__bridge const void *)(table));
+    return table;
+}
+
+- (_YYModelSQLiteTable *)_tableWithClass:(Class)cls {
+    if (!cls) return nil;
+    _YYModelSQLiteTable *table = CFDictionaryGetValue(_tables, (__bridge const void *)(cls));
+    if (!table) table = [self _createTableWithClass:cls primaryKey:nil];
+    return table;
+}
+
+/// Returns a statement with the arguments bound, or NULL.
+- (sqlite3_stmt *)_statementWithSQL:(NSString *)sql where:(NSString *)where arguments:(NSArray *)arguments {
+    if (where.length) sql = [sql stringByAppendingFormat:@" WHERE %@", where];
+    sqlite3_stmt *stmt = [self _statementWithSQL:sql];
+    if (!stmt) return NULL;
+    if ((NSUInteger)sqlite3_bind_parameter_count(stmt) != arguments.count) return NULL;
+    for (NSUInteger i = 0; i < arguments.count; i++) {
+        if (YYSQLiteBindObject(stmt, (int)i + 1, arguments[i]) != SQLITE_OK) {
+            sqlite3_clear_bindings(stmt);
+            return NULL;
+        }
+    }
+    return stmt;
+}
+
+- (BOOL)createTableWithClass:(Class)cls primaryKey:(NSString *)primaryKey {
+    if (!cls) return NO;
+    dispatch_semaphore_wait(_lock, DISPATCH_TIME_FOREVER);
+    BOOL succeed = _db && [self _createTableWithClass:cls primaryKey:primaryKey];
+    dispatch_semaphore_signal(_lock);
+    return succeed;
+}
+
+- (BOOL)_insertModels:(NSArray *)models class:(Class)cls {
+    _YYModelSQLiteTable *table = [self _tableWithClass:cls];
+    if (!table) return NO;
+    sqlite3_stmt *stmt = [self _statementWithSQL:table->_insertSQL];
+    if (!stmt) return NO;
+
+    // don't nest transactions if the caller is in one
+    BOOL transaction = sqlite3_get_autocommit(_db) != 0;
+    NSUInteger batchSize = _transactionBatchSize ?: NSUIntegerMax;
+    NSUInteger rows = 0;
+    BOOL succeed = YES;
+    if (transaction && ![self _execute:@"BEGIN IMMEDIATE"]) return NO;
+    for (id model in models) {
+        if (![model isKindOfClass:cls]) continue;
+        @autoreleasepool {
+            for (int i = 0; i < table->_count && succeed; i++) {
+                succeed = YYSQLiteBindProperty(stmt, i + 1, model, table->_metas[i], table->_types[i]) == SQLITE_OK;
+            }
+            if (succeed) succeed = sqlite3_step(stmt) == SQLITE_DONE;
+            sqlite3_reset(stmt);
+            sqlite3_clear_bindings(stmt);
+        }
+        if (!succeed) break;
+        if (transaction && ++rows % batchSize == 0) {
+            if (![self _execute:@"COMMIT"] || ![self _execute:@"BEGIN IMMEDIATE"]) {
+                succeed = NO;
+                break;
+            }
+        }
+    }
+    if (transaction && sqlite3_get_autocommit(_db) == 0) {
+        if (succeed) succeed = [self _execute:@"COMMIT"];
+        if (!succeed) [self _execute:@"ROLLBACK"];
+    }
+    return succeed;
+}
+
+- (BOOL)insertModels:(NSArray *)models class:(Class)cls {
+    if (!models || !cls) return NO;
+    dispatch_semaphore_wait(_lock, DISPATCH_TIME_FOREVER);
+    BOOL succeed = _db && [self _insertModels:models class:cls];
+    dispatch_semaphore_signal(_lock);
+    return succeed;
+}
+
+- (NSArray *)_modelsWithClass:(Class)cls where:(NSString *)where arguments:(NSArray *)arguments {
+    _YYModelSQLiteTable *table = [self _tableWithClass:cls];
+    if (!table) return nil;
+    sqlite3_stmt *stmt = [self _statementWithSQL:table->_selectSQL where:where arguments:arguments];
+    if (!stmt) return nil;
+    NSMutableArray *models = [NSMutableArray new];
+    int result = SQLITE_ROW;
+    while (result == SQLITE_ROW) {
+        @autoreleasepool {
+            for (int n = 0; n < kYYSQLitePoolBatchSize; n++) {
+                result = sqlite3_step(stmt);
+                if (result != SQLITE_ROW) break;
+                NSObject *one = [cls new];
+                for (int i = 0; i < table->_count; i++) {
+                    YYSQLiteSetColumnToProperty(stmt, i, one, table->_metas[i], table->_types[i]);
+                }
+                [models addObject:one];
+            }
+        }
+    }
+    sqlite3_reset(stmt);
+    sqlite3_clear_bindings(stmt);
+    return result == SQLITE_DONE ? models : nil;
+}
+
+- (NSArray *)modelsWithClass:(Class)cls where:(NSString *)where arguments:(NSArray *)arguments {
+    dispatch_semaphore_wait(_lock, DISPATCH_TIME_FOREVER);
+    NSArray *models = _db ? [self _modelsWithClass:cls where:where arguments:arguments] : nil;
+    dispatch_semaphore_signal(_lock);
+    return models;
+}
+
+- (NSInteger)_countOfModelsWithClass:(Class)cls where:(NSString *)where arguments:(NSArray *)arguments {
+    _YYModelSQLiteTable *table = [self _tableWithClass:cls];
+    if (!table) return -1;
+    NSString *sql = [NSString stringWithFormat:@"SELECT count(*) FROM %@", table->_name];
+    sqlite3_stmt *stmt = [self _statementWithSQL:sql where:where arguments:arguments];
+    if (!stmt) return -1;
+    NSInteger count = sqlite3_step(stmt) == SQLITE_ROW ? (NSInteger)sqlite3_column_int64(stmt, 0) : -1;
+    sqlite3_reset(stmt);
+    sqlite3_clear_bindings(stmt);
+    return count;
+}
+
+- (NSInteger)countOfModelsWithClass:(Class)cls where:(NSString *)where arguments:(NSArray *)arguments {
+    dispatch_semaphore_wait(_lock, DISPATCH_TIME_FOREVER);
+    NSInteger count = _db ? [self _countOfModelsWithClass:cls where:where arguments:arguments] : -1;
+    dispatch_semaphore_signal(_lock);
+    return count;
+}
+
+- (BOOL)_deleteModelsWithClass:(Class)cls where:(NSString *)where arguments:(NSArray *)arguments {
+    _YYModelSQLiteTable *table = [self _tableWithClass:cls];
+    if (!table) return NO;
+    NSString *sql = [NSString stringWithFormat:@"DELETE FROM %@", table->_name];
+    sqlite3_stmt *stmt = [self _statementWithSQL:sql where:where arguments:arguments];
+    if (!stmt) return NO;
+    BOOL succeed = sqlite3_step(stmt) == SQLITE_DONE;
+    sqlite3_reset(stmt);
+    sqlite3_clear_bindings(stmt);
+    return succeed;
+}
+
+- (BOOL)deleteModelsWithClass:(Class)cls where:(NSString *)where arguments:(NSArray *)arguments {
+    dispatch_semaphore_wait(_lock, DISPATCH_TIME_FOREVER);
+    BOOL succeed = _db && [self _deleteModelsWithClass:cls where:where arguments:arguments];
+    dispatch_semaphore_signal(_lock);
+    return succeed;
+}
+
+@end
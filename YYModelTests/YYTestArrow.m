@@ -0,0 +1,318 @@
+//
+//  YYTestArrow.m
+//  YYModel <https://github.com/ibireme/YYModel>
+//
+//  This source code is licensed under the MIT-style license found in the
+//  LICENSE file in the root directory of this source tree.
+//
+
+#import <XCTest/XCTest.h>
+#import "YYModel.h"
+
+@interface YYTestArrowTag : NSObject
+@property (nonatomic, strong) NSString *name;
+@property (nonatomic, assign) int weight;
+@end
+
+@implementation YYTestArrowTag
+@end
+
+@interface YYTestArrowAuthor : NSObject
+@property (nonatomic, strong) NSString *name;
+@property (nonatomic, strong) NSDate *birthday;
+@end
+
+@implementation YYTestArrowAuthor
+@end
+
+@interface YYTestArrowModel : NSObject
+@property (nonatomic, assign) bool b;
+@property (nonatomic, assign) int8_t i8;
+@property (nonatomic, assign) uint16_t u16;
+@property (nonatomic, assign) int i32;
+@property (nonatomic, assign) uint64_t u64;
+@property (nonatomic, assign) float f;
+@property (nonatomic, assign) double d;
+@property (nonatomic, strong) NSNumber *num;
+@property (nonatomic, strong) NSString *str;
+@property (nonatomic, strong) NSMutableString *mstr;
+@property (nonatomic, strong) NSURL *url;
+@property (nonatomic, strong) NSData *data;
+@property (nonatomic, strong) NSDate *date;
+@property (nonatomic, strong) YYTestArrowAuthor *author;
+@property (nonatomic, strong) NSArray *tags;
+@property (nonatomic, strong) NSArray *names;
+@property (nonatomic, strong) NSDictionary *dic;
+@property (nonatomic, strong) YYTestArrowModel *next;
+@end
+
+@implementation YYTestArrowModel
++ (NSDictionary *)modelContainerPropertyGenericClass {
+    return @{@"tags" : [YYTestArrowTag class], @"names" : [NSString class]};
+}
+@end
+
+
+/// The model of YYTestArrowGolden.arrow.
+@interface YYTestArrowGoldenModel : NSObject
+@property (nonatomic, assign) bool b;
+@property (nonatomic, assign) int i32;
+@property (nonatomic, strong) NSString *str;
+@property (nonatomic, strong) NSDate *date;
+@end
+
+@implementation YYTestArrowGoldenModel
+@end
+
+
+@interface YYTestArrow : XCTestCase
+
+@end
+
+@implementation YYTestArrow
+
+- (NSArray *)models {
+    YYTestArrowModel *m1 = [YYTestArrowModel new];
+    m1.b = true;
+    m1.i8 = -8;
+    m1.u16 = 65535;
+    m1.i32 = -123456;
+    m1.u64 = UINT64_MAX;
+    m1.f = 1.5;
+    m1.d = 0.1;
+    m1.num = @12.5;
+    m1.str = @"Harry 中文";
+    m1.mstr = @"mutable".mutableCopy;
+    m1.url = [NSURL URLWithString:@"https://github.com/ibireme"];
+    m1.data = [@"bytes" dataUsingEncoding:NSUTF8StringEncoding];
+    m1.date = [NSDate dateWithTimeIntervalSince1970:1445480000.123456];
+    m1.author = [YYTestArrowAuthor new];
+    m1.author.name = @"J.K.Rowling";
+    m1.author.birthday = [NSDate dateWithTimeIntervalSince1970:-141004800];
+    YYTestArrowTag *t1 = [YYTestArrowTag new];
+    t1.name = @"fantasy";
+    t1.weight = 3;
+    YYTestArrowTag *t2 = [YYTestArrowTag new];
+    t2.weight = 1;
+    m1.tags = @[t1, t2];
+    m1.names = @[@"a", @"b", @"c"];
+    m1.dic = @{@"a" : @1};
+    m1.next = [YYTestArrowModel new];
+
+    YYTestArrowModel *m2 = [YYTestArrowModel new]; // all default
+    YYTestArrowModel *m3 = [YYTestArrowModel new];
+    m3.i32 = 7;
+    m3.tags = @[];
+    m3.names = @[@"d"];
+    return @[m1, m2, @"not a model", m3];
+}
+
+- (void)checkModels:(NSArray *)models {
+    XCTAssertEqual(models.count, 3);
+    YYTestArrowModel *m1 = models[0], *m2 = models[1], *m3 = models[2];
+    XCTAssertTrue([m1 isKindOfClass:[YYTestArrowModel class]]);
+    XCTAssertTrue(m1.b);
+    XCTAssertEqual(m1.i8, -8);
+    XCTAssertEqual(m1.u16, 65535);
+    XCTAssertEqual(m1.i32, -123456);
+    XCTAssertEqual(m1.u64, UINT64_MAX);
+    XCTAssertEqual(m1.f, 1.5);
+    XCTAssertEqual(m1.d, 0.1);
+    XCTAssertEqualObjects(m1.num, @12.5);
+    XCTAssertEqualObjects(m1.str, @"Harry 中文");
+    XCTAssertEqualObjects(m1.mstr, @"mutable");
+    XCTAssertTrue([m1.mstr isKindOfClass:[NSMutableString class]]);
+    [m1.mstr appendString:@"!"];
+    XCTAssertEqualObjects(m1.url.absoluteString, @"https://github.com/ibireme");
+    XCTAssertEqualObjects(m1.data, [@"bytes" dataUsingEncoding:NSUTF8StringEncoding]);
+    XCTAssertEqualWithAccuracy(m1.date.timeIntervalSince1970, 1445480000.123456, 0.000001);
+    XCTAssertEqualObjects(m1.author.name, @"J.K.Rowling");
+    XCTAssertEqual(m1.author.birthday.timeIntervalSince1970, -141004800);
+    XCTAssertEqual(m1.tags.count, 2);
+    XCTAssertEqualObjects([m1.tags[0] name], @"fantasy");
+    XCTAssertEqual([m1.tags[0] weight], 3);
+    XCTAssertNil([m1.tags[1] name]);
+    XCTAssertEqual([m1.tags[1] weight], 1);
+    XCTAssertEqualObjects(m1.names, (@[@"a", @"b", @"c"]));
+    XCTAssertNil(m1.dic);  // not supported
+    XCTAssertNil(m1.next); // recursive model
+
+    XCTAssertFalse(m2.b);
+    XCTAssertEqual(m2.i32, 0);
+    XCTAssertNil(m2.num);
+    XCTAssertNil(m2.str);
+    XCTAssertNil(m2.date);
+    XCTAssertNil(m2.author);
+    XCTAssertNil(m2.tags);
+
+    XCTAssertEqual(m3.i32, 7);
+    XCTAssertNotNil(m3.tags);
+    XCTAssertEqual(m3.tags.count, 0);
+    XCTAssertEqualObjects(m3.names, @[@"d"]);
+}
+
+- (void)testStream {
+    NSData *data = [YYModelArrow dataWithModels:[self models] class:[YYTestArrowModel class] format:YYModelArrowFormatStream];
+    XCTAssertNotNil(data);
+    XCTAssertEqual(*(const uint32_t *)data.bytes, 0xFFFFFFFF);
+    XCTAssertEqual(data.length % 8, 0);
+    [self checkModels:[YYModelArrow modelsWithClass:[YYTestArrowModel class] data:data]];
+}
+
+- (void)testFile {
+    NSData *data = [YYModelArrow dataWithModels:[self models] class:[YYTestArrowModel class] format:YYModelArrowFormatFile];
+    XCTAssertNotNil(data);
+    XCTAssertTrue(memcmp(data.bytes, "ARROW1\0\0", 8) == 0);
+    XCTAssertTrue(memcmp((const uint8_t *)data.bytes + data.length - 6, "ARROW1", 6) == 0);
+    [self checkModels:[YYModelArrow modelsWithClass:[YYTestArrowModel class] data:data]];
+
+    NSString *path = [NSTemporaryDirectory() stringByAppendingPathComponent:@"YYTestArrow.arrow"];
+    XCTAssertTrue([YYModelArrow writeModels:[self models] class:[YYTestArrowModel class] toFile:path]);
+    [self checkModels:[YYModelArrow modelsWithClass:[YYTestArrowModel class] file:path]];
+    [[NSFileManager defaultManager] removeItemAtPath:path error:NULL];
+}
+
+- (void)testColumns {
+    NSData *data = [YYModelArrow dataWithModels:[self models] class:[YYTestArrowModel class] format:YYModelArrowFormatFile];
+    YYModelArrowReader *reader = [YYModelArrowReader readerWithData:data];
+    XCTAssertNotNil(reader);
+    XCTAssertEqual(reader.recordBatchCount, 1);
+    XCTAssertEqual(reader.length, 3);
+    XCTAssertEqualObjects(reader.fieldNames, (@[@"author", @"b", @"d", @"data", @"date", @"f", @"i32", @"i8",
+                                                @"mstr", @"names", @"num", @"str", @"tags", @"u16", @"u64", @"url"]));
+
+    YYModelArrowColumn *i32 = [reader columnWithName:@"i32" inRecordBatch:0];
+    XCTAssertEqual(i32.type, YYModelArrowTypeInt32);
+    XCTAssertEqual(i32.length, 3);
+    XCTAssertEqual(i32.nullCount, 0);
+    XCTAssertTrue(i32.validity == NULL);
+    const int32_t *values = i32.values;
+    XCTAssertEqual(values[0], -123456);
+    XCTAssertEqual(values[2], 7);
+    XCTAssertTrue((const uint8_t *)values > (const uint8_t *)data.bytes &&
+                  (const uint8_t *)values < (const uint8_t *)data.bytes + data.length); // zero-copy
+    XCTAssertEqual((uintptr_t)values % 8, (uintptr_t)data.bytes % 8);
+
+    YYModelArrowColumn *b = [reader columnWithName:@"b" inRecordBatch:0];
+    XCTAssertEqual(b.type, YYModelArrowTypeBool);
+    XCTAssertEqual([b int64AtIndex:0], 1);
+    XCTAssertEqual([b int64AtIndex:1], 0);
+
+    YYModelArrowColumn *str = [reader columnWithName:@"str" inRecordBatch:0];
+    XCTAssertEqual(str.type, YYModelArrowTypeUtf8);
+    XCTAssertEqual(str.nullCount, 2);
+    XCTAssertEqualObjects([str stringAtIndex:0], @"Harry 中文");
+    XCTAssertTrue([str isNullAtIndex:1]);
+    XCTAssertNil([str stringAtIndex:1]);
+    XCTAssertEqual((NSUInteger)str.offsets[3], str.byteLength);
+
+    YYModelArrowColumn *date = [reader columnWithName:@"date" inRecordBatch:0];
+    XCTAssertEqual(date.type, YYModelArrowTypeTimestamp);
+    XCTAssertEqual(date.timeUnit, YYModelArrowTimeUnitMicrosecond);
+    XCTAssertEqual([date int64AtIndex:0], 1445480000123456LL);
+
+    YYModelArrowColumn *author = [reader columnWithName:@"author" inRecordBatch:0];
+    XCTAssertEqual(author.type, YYModelArrowTypeStruct);
+    XCTAssertEqual(author.nullCount, 2);
+    XCTAssertEqual(author.children.count, 2);
+    XCTAssertEqualObjects([author.children[1] name], @"name");
+    XCTAssertEqualObjects([author.children[1] stringAtIndex:0], @"J.K.Rowling");
+
+    YYModelArrowColumn *tags = [reader columnWithName:@"tags" inRecordBatch:0];
+    XCTAssertEqual(tags.type, YYModelArrowTypeList);
+    XCTAssertEqual(tags.offsets[0], 0);
+    XCTAssertEqual(tags.offsets[1], 2);
+    XCTAssertEqual(tags.offsets[2], 2);
+    XCTAssertEqual(tags.offsets[3], 2);
+    XCTAssertTrue([tags isNullAtIndex:1]);
+    XCTAssertFalse([tags isNullAtIndex:2]);
+    YYModelArrowColumn *tag = tags.children.firstObject;
+    XCTAssertEqual(tag.type, YYModelArrowTypeStruct);
+    XCTAssertEqual(tag.length, 2);
+
+    XCTAssertNil([reader columnWithName:@"dic" inRecordBatch:0]);
+    XCTAssertNil([reader columnsInRecordBatch:1]);
+}
+
+- (NSData *)fixtureNamed:(NSString *)name {
+    NSString *path = [[NSBundle bundleForClass:self.class] pathForResource:name ofType:nil];
+    return path ? [NSData dataWithContentsOfFile:path] : nil;
+}
+
+- (void)testPyArrow {
+    // written by pyarrow (see YYTestArrowPyArrow.py): metadata V5, no validity buffer for
+    // a column without null, sliced record batches, and the unsupported "day" (date32) column
+    for (NSString *name in @[@"YYTestArrowPyArrow.arrow", @"YYTestArrowPyArrow.arrows"]) {
+        NSData *data = [self fixtureNamed:name];
+        XCTAssertNotNil(data);
+        YYModelArrowReader *reader = [YYModelArrowReader readerWithData:data];
+        XCTAssertNotNil(reader);
+        XCTAssertEqual(reader.recordBatchCount, 2);
+        XCTAssertEqual(reader.length, 3);
+        XCTAssertEqualObjects(reader.fieldNames.lastObject, @"extra");
+
+        YYModelArrowColumn *day = [reader columnWithName:@"day" inRecordBatch:0];
+        XCTAssertEqual(day.type, YYModelArrowTypeUnknown);
+        YYModelArrowColumn *extra = [reader columnWithName:@"extra" inRecordBatch:1];
+        XCTAssertEqual(extra.type, YYModelArrowTypeInt64);
+        XCTAssertTrue(extra.validity == NULL);
+        XCTAssertEqual([extra int64AtIndex:0], 30);
+        YYModelArrowColumn *birthday = [[reader columnWithName:@"author" inRecordBatch:0].children lastObject];
+        XCTAssertEqual(birthday.timeUnit, YYModelArrowTimeUnitSecond);
+
+        [self checkModels:[reader modelsWithClass:[YYTestArrowModel class]]];
+    }
+}
+
+- (void)testGolden {
+    YYTestArrowGoldenModel *m1 = [YYTestArrowGoldenModel new];
+    m1.b = true;
+    m1.i32 = -1;
+    m1.str = @"a";
+    m1.date = [NSDate dateWithTimeIntervalSince1970:1.5];
+    YYTestArrowGoldenModel *m2 = [YYTestArrowGoldenModel new];
+    m2.i32 = 7;
+    NSData *data = [YYModelArrow dataWithModels:@[m1, m2] class:[YYTestArrowGoldenModel class] format:YYModelArrowFormatFile];
+    // the bytes are read back by pyarrow as [{b:true, date:1.5s UTC, i32:-1, str:"a"}, {b:false, i32:7}]
+    XCTAssertEqualObjects(data, [self fixtureNamed:@"YYTestArrowGolden.arrow"]);
+}
+
+- (void)testInvalid {
+    XCTAssertNil([YYModelArrow dataWithModels:@[] class:[NSObject class] format:YYModelArrowFormatStream]);
+    NSData *empty = [YYModelArrow dataWithModels:@[] class:[YYTestArrowModel class] format:YYModelArrowFormatStream];
+    XCTAssertNotNil(empty);
+    XCTAssertEqual([YYModelArrow modelsWithClass:[YYTestArrowModel class] data:empty].count, 0);
+
+    XCTAssertNil([YYModelArrowReader readerWithData:[NSData new]]);
+    XCTAssertNil([YYModelArrowReader readerWithData:[@"{\"a\":1}" dataUsingEncoding:NSUTF8StringEncoding]]);
+    XCTAssertNil([YYModelArrowReader readerWithFile:@"/not/exist"]);
+
+    for (NSNumber *format in @[@(YYModelArrowFormatStream), @(YYModelArrowFormatFile)]) {
+        NSData *data = [YYModelArrow dataWithModels:[self models] class:[YYTestArrowModel class] format:format.unsignedIntegerValue];
+        // truncated data should be rejected or read partially, but never crash
+        for (NSUInteger length = 0; length < data.length; length += 7) {
+            YYModelArrowReader *reader = [YYModelArrowReader readerWithData:[data subdataWithRange:NSMakeRange(0, length)]];
+            [reader modelsWithClass:[YYTestArrowModel class]];
+        }
+        // corrupted data
+        NSMutableData *corrupted = data.mutableCopy;
+        uint8_t *bytes = corrupted.mutableBytes;
+        for (NSUInteger i = 8; i < corrupted.length; i += 13) {
+            uint8_t old = bytes[i];
+            bytes[i] = 0xFF;
+            YYModelArrowReader *reader = [YYModelArrowReader readerWithData:corrupted];
+            for (NSUInteger j = 0; j < reader.recordBatchCount; j++) {
+                for (YYModelArrowColumn *column in [reader columnsInRecordBatch:j]) {
+                    for (NSUInteger k = 0; k < column.length; k++) {
+                        [column stringAtIndex:k];
+                        [column int64AtIndex:k];
+                    }
+                }
+            }
+            [reader modelsWithClass:[YYTestArrowModel class]];
+            bytes[i] = old;
+        }
+    }
+}
+
+@end
@@ -0,0 +1,31 @@
+# Writes YYTestArrowPyArrow.arrow (IPC file) and YYTestArrowPyArrow.arrows (IPC stream)
+# for YYTestArrow.m, with the values of -[YYTestArrow models] in two record batches.
+#
+#   python3 YYTestArrowPyArrow.py YYTestArrowPyArrow    (pyarrow 26.0.0)
+
+import pyarrow as pa, pyarrow.ipc as ipc, sys
+tag = pa.struct([('name', pa.string()), ('weight', pa.int32())])
+schema = pa.schema([
+    ('b', pa.bool_()), ('i8', pa.int8()), ('u16', pa.uint16()), ('i32', pa.int32()), ('u64', pa.uint64()),
+    ('f', pa.float32()), ('d', pa.float64()), ('num', pa.float64()),
+    ('str', pa.string()), ('mstr', pa.string()), ('url', pa.string()), ('data', pa.binary()),
+    ('date', pa.timestamp('us', tz='UTC')),
+    ('author', pa.struct([('name', pa.string()), ('birthday', pa.timestamp('s'))])),
+    ('tags', pa.list_(tag)), ('names', pa.list_(pa.string())),
+    ('day', pa.date32()), ('extra', pa.int64()),
+])
+rows = {
+    'b': [True, None, False], 'i8': [-8, None, None], 'u16': [65535, None, None], 'i32': [-123456, None, 7],
+    'u64': [2**64 - 1, None, None], 'f': [1.5, None, None], 'd': [0.1, None, None], 'num': [12.5, None, None],
+    'str': ['Harry 中文', None, None], 'mstr': ['mutable', None, None], 'url': ['https://github.com/ibireme', None, None],
+    'data': [b'bytes', None, None], 'date': [1445480000123456, None, None],
+    'author': [{'name': 'J.K.Rowling', 'birthday': -141004800}, None, None],
+    'tags': [[{'name': 'fantasy', 'weight': 3}, {'name': None, 'weight': 1}], None, []],
+    'names': [['a', 'b', 'c'], None, ['d']], 'day': [1, 2, 3], 'extra': [10, 20, 30],
+}
+table = pa.table({k: pa.array(v, type=schema.field(k).type) for k, v in rows.items()}, schema=schema)
+batches = table.to_batches(max_chunksize=2)
+with ipc.new_file(sys.argv[1] + '.arrow', schema) as w:
+    for b in batches: w.write_batch(b)
+with ipc.new_stream(sys.argv[1] + '.arrows', schema) as w:
+    for b in batches: w.write_batch(b)
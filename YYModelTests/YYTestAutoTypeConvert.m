@@ -10,6 +10,7 @@
 //
 
 #import <XCTest/XCTest.h>
+#import <objc/runtime.h>
 #import "YYModel.h"
 #import "YYTestHelper.h"
 
@@ -103,6 +104,34 @@
 @end
 
 
+@interface YYTestNoCopyStringModel : NSObject
+@property (nonatomic, strong) NSString *string;
+@property (nonatomic, strong) NSMutableString *mString;
+@end
+
+@implementation YYTestNoCopyStringModel
++ (NSDictionary *)modelCustomPropertyMapper {
+    return @{ @"string" : @"v",
+              @"mString" : @"v" };
+}
++ (YYModelStringStorage)modelStringStorage {
+    return YYModelStringStorageNoCopy;
+}
+@end
+
+
+@interface YYTestLazyURLModel : NSObject
+@property (nonatomic, strong) NSURL *url;
+@property (nonatomic, strong) NSURL *avatar;
+@end
+
+@implementation YYTestLazyURLModel
++ (BOOL)modelLazyURL {
+    return YES;
+}
+@end
+
+
 
 
 
@@ -276,6 +305,58 @@
     XCTAssert(model.unsignedLongLongValue == 9876543210LLU);
     XCTAssert(model.longLongValue == 9876543210LL);
     
+    model = [YYTestAutoTypeModel yy_modelWithJSON:@{@"v" : [NSDecimalNumber decimalNumberWithString:@"18446744073709551615"]}];
+    XCTAssert(model.unsignedLongLongValue == 18446744073709551615LLU);
+    
+    model = [YYTestAutoTypeModel yy_modelWithJSON:@{@"v" : [NSDecimalNumber decimalNumberWithString:@"-9223372036854775808"]}];
+    XCTAssert(model.longLongValue == INT64_MIN);
+    
+    model = [YYTestAutoTypeModel yy_modelWithJSON:@{@"v" : [NSDecimalNumber decimalNumberWithString:@"12345.678"]}];
+    XCTAssert(model.longLongValue == 12345);
+    
+    // snowflake id in string
+    json = @"{\"v\" : \"1234567890123456789\"}";
+    model = [YYTestAutoTypeModel yy_modelWithJSON:json];
+    XCTAssert(model.longLongValue == 1234567890123456789LL);
+    XCTAssert(model.unsignedLongLongValue == 1234567890123456789LLU);
+    XCTAssert([model.number isEqual:@(1234567890123456789LL)]);
+    XCTAssert([model.decimal isEqual:[NSDecimalNumber decimalNumberWithString:@"1234567890123456789"]]);
+    
+    json = @"{\"v\" : \"18446744073709551615\"}";
+    model = [YYTestAutoTypeModel yy_modelWithJSON:json];
+    XCTAssert(model.unsignedLongLongValue == 18446744073709551615LLU);
+    
+    json = @"{\"v\" : \"-9223372036854775808\"}";
+    model = [YYTestAutoTypeModel yy_modelWithJSON:json];
+    XCTAssert(model.longLongValue == INT64_MIN);
+    
+    json = @"{\"v\" : \"1e3\"}";
+    model = [YYTestAutoTypeModel yy_modelWithJSON:json];
+    XCTAssert(model.intValue == 1000);
+    XCTAssert(model.doubleValue == 1000);
+    
+    json = @"{\"v\" : \"0.1\"}";
+    model = [YYTestAutoTypeModel yy_modelWithJSON:json];
+    XCTAssert(model.doubleValue == 0.1);
+    XCTAssert([model.decimal isEqual:[NSDecimalNumber decimalNumberWithMantissa:1 exponent:-1 isNegative:NO]]);
+    
+    json = @"{\"v\" : \"-0\"}";
+    model = [YYTestAutoTypeModel yy_modelWithJSON:json];
+    XCTAssert([model.decimal isEqual:[NSDecimalNumber zero]]);
+    XCTAssert(model.intValue == 0);
+    
+    json = @"{\"v\" : \"2.2250738585072011e-308\"}";
+    model = [YYTestAutoTypeModel yy_modelWithJSON:json];
+    XCTAssert(model.doubleValue == 2.2250738585072011e-308);
+    
+    json = @"{\"v\" : \"123456789012345678901234567890\"}";
+    model = [YYTestAutoTypeModel yy_modelWithJSON:json];
+    XCTAssert(model.doubleValue == 123456789012345678901234567890.0);
+    
+    json = @"{\"v\" : \"1e400\"}";
+    model = [YYTestAutoTypeModel yy_modelWithJSON:json];
+    XCTAssert(model.number == nil);
+    
     model = [YYTestAutoTypeModel yy_modelWithJSON:@{@"v" : [NSValue valueWithPointer:CFArrayCreate]}];
     XCTAssert(model.pointerValue == CFArrayCreate);
     
@@ -380,6 +461,77 @@
     
     model = [YYTestAutoTypeModel yy_modelWithJSON:@{@"v" : [[NSAttributedString alloc] initWithString:@"test"]}];
     XCTAssert([model.string isEqualToString:@"test"]);
+    
+    model = [YYTestAutoTypeModel yy_modelWithJSON:@{@"v" : [@"haha" dataUsingEncoding:NSUTF8StringEncoding]}];
+    XCTAssert([model.mString isEqualToString:@"haha"]);
+    XCTAssert([model.mString isKindOfClass:[NSMutableString class]]);
+    
+    model = [YYTestAutoTypeModel yy_modelWithJSON:@{@"v" : [@"中文" dataUsingEncoding:NSUTF8StringEncoding]}];
+    XCTAssert([model.string isEqualToString:@"中文"]);
+    
+    model = [YYTestAutoTypeModel yy_modelWithJSON:@{@"v" : [NSData data]}];
+    XCTAssert([model.string isEqualToString:@""]);
+}
+
+- (void)testStringNoCopy {
+    YYTestNoCopyStringModel *model;
+    NSString *text = @"The quick brown fox jumps over the lazy dog.";
+    
+    NSMutableData *data = [[text dataUsingEncoding:NSUTF8StringEncoding] mutableCopy];
+    model = [YYTestNoCopyStringModel yy_modelWithJSON:@{@"v" : data}];
+    XCTAssert([model.string isEqualToString:text]);
+    XCTAssert([model.mString isEqualToString:text]);
+    XCTAssert([model.mString isKindOfClass:[NSMutableString class]]);
+    
+    // the mutable input is copied once, later changes should not affect the string
+    ((char *)data.mutableBytes)[0] = 'A';
+    XCTAssert([model.string isEqualToString:text]);
+    
+    @autoreleasepool {
+        NSData *longData = [text dataUsingEncoding:NSUTF8StringEncoding];
+        model = [YYTestNoCopyStringModel yy_modelWithJSON:@{@"v" : longData}];
+    }
+    XCTAssert([model.string isEqualToString:text]);
+    
+    model = [YYTestNoCopyStringModel yy_modelWithJSON:@{@"v" : [@"short" dataUsingEncoding:NSUTF8StringEncoding]}];
+    XCTAssert([model.string isEqualToString:@"short"]);
+    
+    NSString *unicode = @"中文中文中文中文中文中文中文中文";
+    model = [YYTestNoCopyStringModel yy_modelWithJSON:@{@"v" : [unicode dataUsingEncoding:NSUTF8StringEncoding]}];
+    XCTAssert([model.string isEqualToString:unicode]);
+}
+
+- (void)testLazyURL {
+    YYTestLazyURLModel *model;
+    NSDictionary *json;
+    
+    model = [YYTestLazyURLModel yy_modelWithJSON:@{@"url" : @" https://github.com/ibireme/YYModel ", @"avatar" : @" "}];
+    XCTAssert(model.avatar == nil);
+    XCTAssert([model.url isKindOfClass:[NSURL class]]);
+    XCTAssert([model.url.absoluteString isEqualToString:@"https://github.com/ibireme/YYModel"]);
+    XCTAssert([model.url.host isEqualToString:@"github.com"]);
+    XCTAssert([model.url isEqual:[NSURL URLWithString:@"https://github.com/ibireme/YYModel"]]);
+    
+    json = [model yy_modelToJSONObject];
+    XCTAssert([json[@"url"] isEqualToString:@"https://github.com/ibireme/YYModel"]);
+    
+    model = [YYTestLazyURLModel yy_modelWithJSON:@{@"url" : @"https://github.com/中文"}];
+    XCTAssert(object_getClass(model.url) != NSClassFromString(@"_YYLazyURL"));
+    
+    YYTestLazyURLModel *other = [YYTestLazyURLModel yy_modelWithJSON:@{@"url" : @"https://github.com"}];
+    model = [YYTestLazyURLModel yy_modelWithJSON:@{@"url" : @"https://github.com"}];
+    XCTAssert([model.url isEqual:other.url]);
+    XCTAssert([model.url hash] == [[NSURL URLWithString:@"https://github.com"] hash]);
+    XCTAssert([[NSURL URLWithString:@"https://github.com"] isEqual:model.url]);
+    NSMethodSignature *signature = [(id)model.url methodSignatureForSelector:@selector(URLByAppendingPathComponent:)];
+    XCTAssert([signature isEqual:[NSURL instanceMethodSignatureForSelector:@selector(URLByAppendingPathComponent:)]]);
+    
+    // strings out of the lazy subset are validated by NSURL
+    for (NSString *string in @[@"https://github.com/%zz", @"https://github.com/%2", @"https://github.com/a#b#c", @"http://[::1]/"]) {
+        model = [YYTestLazyURLModel yy_modelWithJSON:@{@"url" : string}];
+        XCTAssert(object_getClass(model.url) != NSClassFromString(@"_YYLazyURL"));
+        XCTAssert((model.url == nil) == ([NSURL URLWithString:string] == nil));
+    }
 }
 
 - (void)testValue {
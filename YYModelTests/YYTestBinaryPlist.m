@@ -0,0 +1,202 @@
+//
+//  YYTestBinaryPlist.m
+//  YYModel <https://github.com/ibireme/YYModel>
+//
+//  This source code is licensed under the MIT-style license found in the
+//  LICENSE file in the root directory of this source tree.
+//
+
+#import <XCTest/XCTest.h>
+#import "YYModel.h"
+
+@interface YYTestPlistTag : NSObject
+@property (nonatomic, strong) NSString *name;
+@end
+
+@implementation YYTestPlistTag
+@end
+
+@interface YYTestPlistModel : NSObject
+@property (nonatomic, assign) bool b;
+@property (nonatomic, assign) int i;
+@property (nonatomic, assign) int64_t l;
+@property (nonatomic, assign) uint64_t ul;
+@property (nonatomic, assign) float f;
+@property (nonatomic, assign) double d;
+@property (nonatomic, strong) NSNumber *num;
+@property (nonatomic, strong) NSDecimalNumber *dec;
+@property (nonatomic, strong) NSString *name;
+@property (nonatomic, strong) NSString *text;
+@property (nonatomic, strong) NSData *data;
+@property (nonatomic, strong) NSDate *date;
+@property (nonatomic, strong) YYTestPlistTag *tag;
+@property (nonatomic, strong) NSArray *tags;
+@end
+
+@implementation YYTestPlistModel
++ (NSDictionary *)modelCustomPropertyMapper {
+    return @{ @"name" : @"n" };
+}
++ (NSDictionary *)modelContainerPropertyGenericClass {
+    return @{ @"tags" : [YYTestPlistTag class] };
+}
+@end
+
+@interface YYTestPlistKeyPathModel : NSObject
+@property (nonatomic, strong) NSString *city;
+@property (nonatomic, assign) int zip;
+@end
+
+@implementation YYTestPlistKeyPathModel
++ (NSDictionary *)modelCustomPropertyMapper {
+    return @{ @"city" : @"address.city",
+              @"zip" : @"address.zip" };
+}
+@end
+
+
+@interface YYTestBinaryPlist : XCTestCase
+
+@end
+
+@implementation YYTestBinaryPlist
+
+- (YYTestPlistModel *)sampleModel {
+    YYTestPlistModel *model = [YYTestPlistModel new];
+    model.b = true;
+    model.i = -12;
+    model.l = INT64_MIN;
+    model.ul = UINT64_MAX;
+    model.f = 0.5;
+    model.d = 0.1;
+    model.num = @(3.25);
+    model.dec = [NSDecimalNumber decimalNumberWithString:@"12345678901234567890.123456789"];
+    model.name = @"Harry";
+    model.text = @"中文 😀";
+    model.data = [@"data" dataUsingEncoding:NSUTF8StringEncoding];
+    model.date = [NSDate dateWithTimeIntervalSinceReferenceDate:123456.5];
+    YYTestPlistTag *tag = [YYTestPlistTag new];
+    tag.name = @"Harry";
+    model.tag = tag;
+    model.tags = @[tag, tag];
+    return model;
+}
+
+- (void)testRoundTrip {
+    YYTestPlistModel *model = [self sampleModel];
+    NSData *data = [YYModelBinaryPlist dataWithObject:model];
+    XCTAssertTrue(data.length > 8);
+    XCTAssertEqualObjects([data subdataWithRange:NSMakeRange(0, 8)], [@"bplist00" dataUsingEncoding:NSASCIIStringEncoding]);
+
+    YYTestPlistModel *one = [YYModelBinaryPlist modelWithClass:[YYTestPlistModel class] data:data];
+    XCTAssertTrue([one isKindOfClass:[YYTestPlistModel class]]);
+    XCTAssertTrue(one.b);
+    XCTAssertEqual(one.i, -12);
+    XCTAssertEqual(one.l, INT64_MIN);
+    XCTAssertEqual(one.ul, UINT64_MAX);
+    XCTAssertEqual(one.f, 0.5);
+    XCTAssertEqual(one.d, 0.1);
+    XCTAssertEqualObjects(one.num, @(3.25));
+    XCTAssertEqualObjects(one.dec, model.dec);
+    XCTAssertEqualObjects(one.name, @"Harry");
+    XCTAssertEqualObjects(one.text, model.text);
+    XCTAssertEqualObjects(one.data, model.data);
+    XCTAssertEqualObjects(one.date, model.date);
+    XCTAssertEqualObjects(one.tag.name, @"Harry");
+    XCTAssertEqual(one.tags.count, 2);
+    XCTAssertTrue([one.tags.firstObject isKindOfClass:[YYTestPlistTag class]]);
+
+    // a shared model is written once, and decoded (directly from the plist) to one instance
+    XCTAssertTrue(one.tags[0] == one.tags[1]);
+    XCTAssertTrue(one.tag == one.tags[0]);
+
+    // equal strings are written once
+    NSData *harry = [@"Harry" dataUsingEncoding:NSASCIIStringEncoding];
+    NSRange range = [data rangeOfData:harry options:0 range:NSMakeRange(0, data.length)];
+    XCTAssertNotEqual(range.location, NSNotFound);
+    NSUInteger start = NSMaxRange(range);
+    XCTAssertEqual([data rangeOfData:harry options:0 range:NSMakeRange(start, data.length - start)].location, NSNotFound);
+
+    NSArray *models = [YYModelBinaryPlist modelWithClass:[YYTestPlistModel class] data:[YYModelBinaryPlist dataWithObject:@[model, model]]];
+    XCTAssertEqual(models.count, 2);
+    XCTAssertEqual(((YYTestPlistModel *)models[1]).ul, UINT64_MAX);
+
+    YYTestPlistKeyPathModel *keyPath = [YYTestPlistKeyPathModel new];
+    keyPath.city = @"Tokyo";
+    keyPath.zip = 100;
+    keyPath = [YYModelBinaryPlist modelWithClass:[YYTestPlistKeyPathModel class] data:[YYModelBinaryPlist dataWithObject:keyPath]];
+    XCTAssertEqualObjects(keyPath.city, @"Tokyo");
+    XCTAssertEqual(keyPath.zip, 100);
+}
+
+- (void)testFoundationCompatibility {
+    YYTestPlistModel *model = [self sampleModel];
+    NSData *data = [YYModelBinaryPlist dataWithObject:model];
+    NSDictionary *plist = [NSPropertyListSerialization propertyListWithData:data options:NSPropertyListImmutable format:NULL error:NULL];
+    XCTAssertTrue([plist isKindOfClass:[NSDictionary class]]);
+    XCTAssertEqualObjects(plist[@"n"], @"Harry");
+    XCTAssertEqualObjects(plist[@"i"], @(-12));
+    XCTAssertEqualObjects(plist[@"ul"], @(UINT64_MAX));
+    XCTAssertEqualObjects(plist[@"b"], @YES);
+    XCTAssertEqualObjects(plist[@"dec"], @"12345678901234567890.123456789");
+    XCTAssertEqualObjects(plist[@"text"], model.text);
+    XCTAssertTrue([plist[@"data"] isKindOfClass:[NSData class]]);
+    XCTAssertTrue([plist[@"date"] isKindOfClass:[NSDate class]]);
+    XCTAssertEqualObjects(plist[@"date"], model.date);
+    XCTAssertEqualObjects(plist[@"tag"], @{ @"name" : @"Harry" });
+
+    NSDictionary *dic = @{ @"n" : @"Potter",
+                           @"i" : @(7),
+                           @"ul" : @(UINT64_MAX),
+                           @"d" : @(1.5),
+                           @"b" : @YES,
+                           @"data" : [NSData dataWithBytes:"\x00\x01" length:2],
+                           @"date" : [NSDate dateWithTimeIntervalSinceReferenceDate:-1],
+                           @"tags" : @[ @{ @"name" : @"a" }, @{ @"name" : @"b" } ] };
+    data = [NSPropertyListSerialization dataWithPropertyList:dic format:NSPropertyListBinaryFormat_v1_0 options:0 error:NULL];
+    YYTestPlistModel *one = [YYModelBinaryPlist modelWithClass:[YYTestPlistModel class] data:data];
+    XCTAssertEqualObjects(one.name, @"Potter");
+    XCTAssertEqual(one.i, 7);
+    XCTAssertEqual(one.ul, UINT64_MAX);
+    XCTAssertEqual(one.d, 1.5);
+    XCTAssertTrue(one.b);
+    XCTAssertEqualObjects(one.data, dic[@"data"]);
+    XCTAssertEqualObjects(one.date, dic[@"date"]);
+    XCTAssertEqual(one.tags.count, 2);
+    XCTAssertEqualObjects(((YYTestPlistTag *)one.tags[1]).name, @"b");
+}
+
+- (void)testInvalid {
+    XCTAssertNil([YYModelBinaryPlist modelWithClass:[YYTestPlistModel class] data:[NSData data]]);
+    XCTAssertNil([YYModelBinaryPlist modelWithClass:[YYTestPlistModel class] data:[@"bplist00" dataUsingEncoding:NSASCIIStringEncoding]]);
+    NSData *xml = [NSPropertyListSerialization dataWithPropertyList:@{ @"i" : @1 } format:NSPropertyListXMLFormat_v1_0 options:0 error:NULL];
+    XCTAssertNil([YYModelBinaryPlist modelWithClass:[YYTestPlistModel class] data:xml]);
+
+    NSMutableData *data = [YYModelBinaryPlist dataWithObject:[self sampleModel]].mutableCopy;
+    for (NSUInteger i = 8; i < data.length; i += 3) {
+        ((uint8_t *)data.mutableBytes)[i] ^= 0xFF;
+        [YYModelBinaryPlist modelWithClass:[YYTestPlistModel class] data:data]; // should not crash
+        ((uint8_t *)data.mutableBytes)[i] ^= 0xFF;
+    }
+    XCTAssertNil([YYModelBinaryPlist dataWithObject:[NSObject new]]);
+}
+
+- (void)testFile {
+    NSMutableArray *models = [NSMutableArray new];
+    for (int i = 0; i < 1000; i++) {
+        YYTestPlistModel *model = [YYTestPlistModel new];
+        model.i = i;
+        model.name = [NSString stringWithFormat:@"name-%d", i];
+        [models addObject:model];
+    }
+    NSString *path = [NSTemporaryDirectory() stringByAppendingPathComponent:@"yymodel_test.plist"];
+    XCTAssertTrue([YYModelBinaryPlist writeObject:models toFile:path]);
+    NSArray *read = [YYModelBinaryPlist modelWithClass:[YYTestPlistModel class] file:path];
+    XCTAssertEqual(read.count, 1000);
+    XCTAssertEqual(((YYTestPlistModel *)read[999]).i, 999);
+    XCTAssertEqualObjects(((YYTestPlistModel *)read[999]).name, @"name-999");
+    [[NSFileManager defaultManager] removeItemAtPath:path error:NULL];
+    XCTAssertNil([YYModelBinaryPlist modelWithClass:[YYTestPlistModel class] file:path]);
+}
+
+@end
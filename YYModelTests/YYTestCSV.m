@@ -0,0 +1,216 @@
+//
+//  YYTestCSV.m
+//  YYModel <https://github.com/ibireme/YYModel>
+//
+//  This source code is licensed under the MIT-style license found in the
+//  LICENSE file in the root directory of this source tree.
+//
+
+#import <XCTest/XCTest.h>
+#import "YYModel.h"
+
+typedef NS_ENUM (NSInteger, YYTestCSVState) {
+    YYTestCSVStateOff = 0,
+    YYTestCSVStateOn = 1,
+};
+
+@interface YYTestCSVTag : NSObject
+@property (nonatomic, strong) NSString *name;
+@end
+
+@implementation YYTestCSVTag
+@end
+
+@interface YYTestCSVModel : NSObject
+@property (nonatomic, assign) bool b;
+@property (nonatomic, assign) int i;
+@property (nonatomic, assign) uint64_t ul;
+@property (nonatomic, assign) double d;
+@property (nonatomic, assign) YYTestCSVState state;
+@property (nonatomic, strong) NSNumber *num;
+@property (nonatomic, strong) NSString *name;
+@property (nonatomic, strong) NSString *city;
+@property (nonatomic, strong) NSString *note;
+@property (nonatomic, strong) NSURL *url;
+@property (nonatomic, strong) NSDate *date;
+@property (nonatomic, strong) NSArray *tags;
+@end
+
+@implementation YYTestCSVModel
++ (NSDictionary *)modelCustomPropertyMapper {
+    return @{ @"city" : @"address.city",
+              @"name" : @[@"name", @"user.name"] };
+}
++ (NSDictionary *)modelEnumMapper {
+    return @{ @"state" : @{ @"off" : @(YYTestCSVStateOff), @"on" : @(YYTestCSVStateOn) } };
+}
++ (NSDictionary *)modelContainerPropertyGenericClass {
+    return @{ @"tags" : [YYTestCSVTag class] };
+}
+@end
+
+
+@interface YYTestCSV : XCTestCase
+
+@end
+
+@implementation YYTestCSV
+
+- (void)testRead {
+    NSString *csv = @"\xEF\xBB\xBFi,b,d,state,num,user.name,address.city,note,ul,url,date,tags,unknown\r\n"
+                    @"12,true,1.5,on,2.25,Harry,Tokyo,\"a, \"\"b\"\"\r\nc\",18446744073709551615,https://a.com/x,2015-10-01,\"[{\"\"name\"\":\"\"t\"\"}]\",x\r\n"
+                    @"\r\n"
+                    @"-3,0,abc,1,,中文,,\"\",1e3\n"
+                    @"7";
+    NSArray *models = [[YYModelCSV CSV] modelsWithClass:[YYTestCSVModel class] data:[csv dataUsingEncoding:NSUTF8StringEncoding]];
+    XCTAssertEqual(models.count, 3);
+
+    YYTestCSVModel *model = models[0];
+    XCTAssertEqual(model.i, 12);
+    XCTAssertTrue(model.b);
+    XCTAssertEqual(model.d, 1.5);
+    XCTAssertEqual(model.state, YYTestCSVStateOn);
+    XCTAssertEqualObjects(model.num, @2.25);
+    XCTAssertEqualObjects(model.name, @"Harry");
+    XCTAssertEqualObjects(model.city, @"Tokyo");
+    XCTAssertEqualObjects(model.note, @"a, \"b\"\r\nc");
+    XCTAssertEqual(model.ul, UINT64_MAX);
+    XCTAssertEqualObjects(model.url, [NSURL URLWithString:@"https://a.com/x"]);
+    XCTAssertNotNil(model.date);
+    XCTAssertEqual(model.tags.count, 1);
+    XCTAssertEqualObjects(((YYTestCSVTag *)model.tags.firstObject).name, @"t");
+
+    model = models[1];
+    XCTAssertEqual(model.i, -3);
+    XCTAssertFalse(model.b);
+    XCTAssertEqual(model.d, 0);
+    XCTAssertEqual(model.state, YYTestCSVStateOn);
+    XCTAssertNil(model.num);
+    XCTAssertEqualObjects(model.name, @"中文");
+    XCTAssertNil(model.city);
+    XCTAssertEqualObjects(model.note, @"");
+    XCTAssertEqual(model.ul, 1000);
+
+    model = models[2];
+    XCTAssertEqual(model.i, 7);
+    XCTAssertNil(model.name);
+
+    NSString *tsv = @"i\tname\n1\ta,b\n";
+    models = [[YYModelCSV TSV] modelsWithClass:[YYTestCSVModel class] data:[tsv dataUsingEncoding:NSUTF8StringEncoding]];
+    XCTAssertEqual(models.count, 1);
+    XCTAssertEqualObjects(((YYTestCSVModel *)models[0]).name, @"a,b");
+
+    XCTAssertNil([[YYModelCSV CSV] modelsWithClass:[YYTestCSVModel class] data:[NSData data]]);
+    XCTAssertEqual([[YYModelCSV CSV] modelsWithClass:[YYTestCSVModel class] data:[@"i\n" dataUsingEncoding:NSUTF8StringEncoding]].count, 0);
+    XCTAssertNil([[YYModelCSV alloc] initWithDelimiter:'"']);
+}
+
+- (void)testWrite {
+    YYTestCSVModel *model = [YYTestCSVModel new];
+    model.i = 5;
+    model.b = true;
+    model.d = 0.1;
+    model.state = YYTestCSVStateOff;
+    model.name = @"a,\"b\"";
+    model.note = @"";
+    model.ul = UINT64_MAX;
+    YYTestCSVTag *tag = [YYTestCSVTag new];
+    tag.name = @"t";
+    model.tags = @[tag];
+
+    NSData *data = [[YYModelCSV CSV] dataWithModels:@[model, @"not a model", [YYTestCSVModel new]] class:[YYTestCSVModel class]];
+    NSString *csv = [[NSString alloc] initWithData:data encoding:NSUTF8StringEncoding];
+    NSArray *lines = [csv componentsSeparatedByString:@"\n"];
+    XCTAssertEqual(lines.count, 4);
+    XCTAssertEqualObjects(lines[0], @"address.city,b,d,date,i,name,note,num,state,tags,ul,url");
+    XCTAssertEqualObjects(lines[1], @",true,0.1,,5,\"a,\"\"b\"\"\",\"\",,off,\"[{\"\"name\"\":\"\"t\"\"}]\",18446744073709551615,");
+
+    NSArray *models = [[YYModelCSV CSV] modelsWithClass:[YYTestCSVModel class] data:data];
+    XCTAssertEqual(models.count, 2);
+    YYTestCSVModel *one = models[0];
+    XCTAssertEqual(one.i, 5);
+    XCTAssertTrue(one.b);
+    XCTAssertEqual(one.d, 0.1);
+    XCTAssertEqual(one.state, YYTestCSVStateOff);
+    XCTAssertEqualObjects(one.name, model.name);
+    XCTAssertEqualObjects(one.note, @"");
+    XCTAssertEqual(one.ul, UINT64_MAX);
+    XCTAssertEqualObjects(((YYTestCSVTag *)one.tags.firstObject).name, @"t");
+    XCTAssertNil(((YYTestCSVModel *)models[1]).name);
+}
+
+- (void)testFile {
+    NSMutableArray *models = [NSMutableArray new];
+    for (int i = 0; i < 20000; i++) {
+        YYTestCSVModel *model = [YYTestCSVModel new];
+        model.i = i;
+        model.name = [NSString stringWithFormat:@"name-%d,\n\"é\"", i];
+        [models addObject:model];
+    }
+    NSString *path = [NSTemporaryDirectory() stringByAppendingPathComponent:@"yymodel_test.csv"];
+    YYModelCSV *codec = [YYModelCSV CSV];
+    XCTAssertTrue([codec writeModels:models class:[YYTestCSVModel class] toFile:path]);
+
+    __block int count = 0;
+    __block BOOL ordered = YES;
+    BOOL succeed = [codec enumerateModelsWithClass:[YYTestCSVModel class] file:path usingBlock:^(YYTestCSVModel *model, BOOL *stop) {
+        if (model.i != count) ordered = NO;
+        if (![model.name isEqualToString:[NSString stringWithFormat:@"name-%d,\n\"é\"", count]]) ordered = NO;
+        count++;
+    }];
+    XCTAssertTrue(succeed);
+    XCTAssertTrue(ordered);
+    XCTAssertEqual(count, 20000);
+
+    count = 0;
+    [codec enumerateModelsWithClass:[YYTestCSVModel class] file:path usingBlock:^(id model, BOOL *stop) {
+        if (++count == 10) *stop = YES;
+    }];
+    XCTAssertEqual(count, 10);
+
+    codec.parallelChunkSize = 4096; // parse in parallel chunks
+    NSArray *parallel = [codec modelsWithClass:[YYTestCSVModel class] file:path];
+    codec.parallelChunkSize = 0;
+    NSArray *serial = [codec modelsWithClass:[YYTestCSVModel class] file:path];
+    XCTAssertEqual(parallel.count, 20000);
+    XCTAssertEqual(serial.count, 20000);
+    for (int i = 0; i < 20000; i += 997) {
+        XCTAssertEqual(((YYTestCSVModel *)parallel[i]).i, i);
+        XCTAssertEqualObjects(((YYTestCSVModel *)parallel[i]).name, ((YYTestCSVModel *)serial[i]).name);
+    }
+    [[NSFileManager defaultManager] removeItemAtPath:path error:NULL];
+
+    XCTAssertFalse([codec enumerateModelsWithClass:[YYTestCSVModel class] file:path usingBlock:^(id model, BOOL *stop) {}]);
+    XCTAssertNil([codec modelsWithClass:[YYTestCSVModel class] file:path]);
+}
+
+- (void)testParallelMalformed {
+    // a quote which is not at the start of a field is a normal character
+    NSMutableString *csv = [NSMutableString stringWithString:@"i,name,note\n"];
+    for (int i = 0; i < 2000; i++) {
+        if (i % 3 == 0) [csv appendFormat:@"%d,5'11\",\"a\nb\"\n", i];
+        else if (i % 3 == 1) [csv appendFormat:@"%d,\"x\"y\",z\n", i];
+        else [csv appendFormat:@"%d,a\"\"b,\"\"\n", i];
+    }
+    NSData *data = [csv dataUsingEncoding:NSUTF8StringEncoding];
+    YYModelCSV *codec = [YYModelCSV CSV];
+    codec.parallelChunkSize = 0;
+    NSArray *serial = [codec modelsWithClass:[YYTestCSVModel class] data:data];
+    XCTAssertEqual(serial.count, 2000);
+    XCTAssertEqualObjects(((YYTestCSVModel *)serial[0]).name, @"5'11\"");
+    XCTAssertEqualObjects(((YYTestCSVModel *)serial[0]).note, @"a\nb");
+
+    for (NSUInteger chunkSize = 7; chunkSize < 2000; chunkSize = chunkSize * 3 + 1) {
+        codec.parallelChunkSize = chunkSize;
+        NSArray *parallel = [codec modelsWithClass:[YYTestCSVModel class] data:data];
+        XCTAssertEqual(parallel.count, serial.count);
+        for (NSUInteger i = 0; i < MIN(parallel.count, serial.count); i++) {
+            YYTestCSVModel *model1 = parallel[i], *model2 = serial[i];
+            XCTAssertEqual(model1.i, model2.i);
+            XCTAssertEqualObjects(model1.name, model2.name);
+            XCTAssertEqualObjects(model1.note, model2.note);
+        }
+    }
+}
+
+@end
@@ -0,0 +1,194 @@
+//
+//  YYTestColumnar.m
+//  YYModel <https://github.com/ibireme/YYModel>
+//
+//  This source code is licensed under the MIT-style license found in the
+//  LICENSE file in the root directory of this source tree.
+//
+
+#import <XCTest/XCTest.h>
+#import "YYModel.h"
+
+typedef NS_ENUM (NSInteger, YYTestColumnarState) {
+    YYTestColumnarStateOff = 0,
+    YYTestColumnarStateOn = 1,
+};
+
+@interface YYTestColumnarModel : NSObject
+@property (nonatomic, assign) BOOL flag;
+@property (nonatomic, assign) bool b;
+@property (nonatomic, assign) int i;
+@property (nonatomic, assign) uint32_t u;
+@property (nonatomic, assign) int64_t l;
+@property (nonatomic, assign) uint64_t ul;
+@property (nonatomic, assign) double d;
+@property (nonatomic, assign) YYTestColumnarState state;
+@property (nonatomic, strong) NSNumber *num;
+@property (nonatomic, strong) NSString *name;
+@property (nonatomic, strong) NSString *city;
+@property (nonatomic, strong) NSURL *url;
+@property (nonatomic, strong) NSDate *date;
+@property (nonatomic, strong) NSArray *array;
+@end
+
+@implementation YYTestColumnarModel
++ (NSDictionary *)modelCustomPropertyMapper {
+    return @{ @"city" : @"address.city",
+              @"name" : @[@"name", @"user.name"] };
+}
++ (NSDictionary *)modelEnumMapper {
+    return @{ @"state" : @{ @"off" : @(YYTestColumnarStateOff), @"on" : @(YYTestColumnarStateOn) } };
+}
+@end
+
+@interface YYTestColumnarWidthModel : NSObject
+@property (nonatomic, assign) uint32_t z;
+@property (nonatomic, assign) int8_t c;
+@property (nonatomic, assign) uint16_t s;
+@property (nonatomic, assign) uint32_t u;
+@end
+
+@implementation YYTestColumnarWidthModel
+@end
+
+
+@interface YYTestColumnar : XCTestCase
+
+@end
+
+@implementation YYTestColumnar
+
+- (void)testColumns {
+    NSArray *json = @[ @{ @"flag" : @"yes", @"b" : @true, @"i" : @"-12", @"u" : @4000000000, @"l" : @(-5), @"ul" : @(UINT64_MAX),
+                          @"d" : @1.5, @"state" : @"on", @"num" : @"2.25", @"name" : @"Harry",
+                          @"address" : @{ @"city" : @"Tokyo" }, @"url" : @"https://a.com/x", @"date" : @"2015-10-01" },
+                       @"not a dictionary",
+                       @{ @"i" : [NSNull null], @"d" : @"abc", @"user" : @{ @"name" : @"中文" }, @"address" : @"x" },
+                       @{ @"i" : @7, @"name" : @3, @"state" : @0 } ];
+    YYModelColumnarBatch *batch = [YYModelColumnarBatch batchWithClass:[YYTestColumnarModel class] json:json];
+    XCTAssertNotNil(batch);
+    XCTAssertEqual(batch.count, 3);
+    XCTAssertNil([batch columnForProperty:@"date"]);
+    XCTAssertNil([batch columnForProperty:@"array"]);
+    XCTAssertEqual(batch.columns.count, 12);
+
+    YYModelColumn *column = [batch columnForProperty:@"flag"];
+    XCTAssertEqual(column.type, YYModelColumnTypeInt32);
+    XCTAssertEqual([column int64AtIndex:0], 1);
+
+    column = [batch columnForProperty:@"b"];
+    XCTAssertEqual(column.type, YYModelColumnTypeBool);
+    XCTAssertEqual(((const uint8_t *)column.values)[0], 1);
+    XCTAssertTrue([column isNullAtIndex:1]);
+
+    column = [batch columnForProperty:@"i"];
+    XCTAssertEqual(column.type, YYModelColumnTypeInt32);
+    XCTAssertEqual(column.count, 3);
+    XCTAssertEqual(column.nullCount, 1);
+    XCTAssertEqual(((const int32_t *)column.values)[0], -12);
+    XCTAssertEqual(((const int32_t *)column.values)[1], 0);
+    XCTAssertEqual(((const int32_t *)column.values)[2], 7);
+    XCTAssertEqual(column.validity[0], 0x5);
+    XCTAssertEqual((uintptr_t)column.values % 64, 0);
+    XCTAssertEqual((uintptr_t)column.validity % 64, 0);
+
+    column = [batch columnForProperty:@"u"];
+    XCTAssertEqual(column.type, YYModelColumnTypeInt64);
+    XCTAssertEqual([column int64AtIndex:0], 4000000000LL);
+
+    column = [batch columnForProperty:@"l"];
+    XCTAssertEqual(column.type, YYModelColumnTypeInt64);
+    XCTAssertEqual([column int64AtIndex:0], -5);
+
+    column = [batch columnForProperty:@"ul"];
+    XCTAssertEqual(column.type, YYModelColumnTypeUInt64);
+    XCTAssertEqual(((const uint64_t *)column.values)[0], UINT64_MAX);
+
+    column = [batch columnForProperty:@"d"];
+    XCTAssertEqual(column.type, YYModelColumnTypeDouble);
+    XCTAssertEqual([column doubleAtIndex:0], 1.5);
+    XCTAssertTrue([column isNullAtIndex:1]);
+
+    column = [batch columnForProperty:@"state"];
+    XCTAssertEqual([column int64AtIndex:0], YYTestColumnarStateOn);
+    XCTAssertEqual([column int64AtIndex:2], YYTestColumnarStateOff);
+    XCTAssertFalse([column isNullAtIndex:2]);
+
+    column = [batch columnForProperty:@"num"];
+    XCTAssertEqual(column.type, YYModelColumnTypeDouble);
+    XCTAssertEqual([column doubleAtIndex:0], 2.25);
+
+    column = [batch columnForProperty:@"name"];
+    XCTAssertEqual(column.type, YYModelColumnTypeString);
+    XCTAssertNil(column.values);
+    XCTAssertEqualObjects([column stringAtIndex:0], @"Harry");
+    XCTAssertEqualObjects([column stringAtIndex:1], @"中文");
+    XCTAssertEqualObjects([column stringAtIndex:2], @"3");
+    XCTAssertEqual(column.offsets[0], 0);
+    XCTAssertEqual(column.offsets[1], 5);
+    XCTAssertEqual(column.offsets[2], 11);
+    XCTAssertEqual(column.byteLength, 12);
+    XCTAssertTrue(memcmp(column.bytes, "Harry", 5) == 0);
+
+    column = [batch columnForProperty:@"city"];
+    XCTAssertEqualObjects([column stringAtIndex:0], @"Tokyo");
+    XCTAssertNil([column stringAtIndex:1]);
+    XCTAssertEqual(column.offsets[1], column.offsets[2]);
+    XCTAssertEqual(column.nullCount, 2);
+
+    column = [batch columnForProperty:@"url"];
+    XCTAssertEqualObjects([column stringAtIndex:0], @"https://a.com/x");
+    XCTAssertNil([column stringAtIndex:3]);
+}
+
+- (void)testProperties {
+    NSString *json = @"[{\"i\":1,\"d\":0.5,\"name\":\"a\"},{\"i\":2,\"d\":1.5}]";
+    YYModelColumnarBatch *batch = [YYModelColumnarBatch batchWithClass:[YYTestColumnarModel class] json:json];
+    XCTAssertEqual(batch.count, 2);
+
+    NSArray *array = [NSJSONSerialization JSONObjectWithData:[json dataUsingEncoding:NSUTF8StringEncoding] options:kNilOptions error:NULL];
+    batch = [YYModelColumnarBatch batchWithClass:[YYTestColumnarModel class] array:array properties:@[@"d", @"date", @"unknown"]];
+    XCTAssertEqual(batch.count, 2);
+    XCTAssertEqual(batch.columns.count, 1);
+    const double *values = [batch columnForProperty:@"d"].values;
+    XCTAssertEqual(values[0] + values[1], 2);
+
+    XCTAssertNil([YYModelColumnarBatch batchWithClass:[YYTestColumnarModel class] json:@"{\"i\":1}"]);
+    XCTAssertNil([YYModelColumnarBatch batchWithClass:[YYTestColumnarModel class] json:@1]);
+    XCTAssertEqual([YYModelColumnarBatch batchWithClass:[YYTestColumnarModel class] json:@[]].count, 0);
+}
+
+- (void)testWidthAndOrder {
+    NSDictionary *dic = @{ @"z" : @1, @"c" : @300, @"s" : @(-1), @"u" : @(-1) };
+    YYModelColumnarBatch *batch = [YYModelColumnarBatch batchWithClass:[YYTestColumnarWidthModel class] array:@[dic]];
+    NSArray *names = [batch.columns valueForKey:@"name"];
+    XCTAssertEqualObjects(names, (@[@"c", @"s", @"u", @"z"]));
+
+    // same as the value set to the model
+    YYTestColumnarWidthModel *model = [YYTestColumnarWidthModel yy_modelWithDictionary:dic];
+    XCTAssertEqual(model.c, 44);
+    XCTAssertEqual([[batch columnForProperty:@"c"] int64AtIndex:0], model.c);
+    XCTAssertEqual([[batch columnForProperty:@"s"] int64AtIndex:0], model.s);
+    XCTAssertEqual([[batch columnForProperty:@"u"] int64AtIndex:0], model.u);
+    XCTAssertEqual([[batch columnForProperty:@"u"] int64AtIndex:0], UINT32_MAX);
+}
+
+- (void)testLongStrings {
+    NSMutableArray *array = [NSMutableArray new];
+    NSMutableString *expected = [NSMutableString new];
+    for (int i = 0; i < 1000; i++) {
+        NSString *name = [NSString stringWithFormat:@"name-%d-é", i];
+        [array addObject:@{ @"name" : name }];
+        [expected appendString:name];
+    }
+    YYModelColumnarBatch *batch = [YYModelColumnarBatch batchWithClass:[YYTestColumnarModel class] array:array];
+    YYModelColumn *column = [batch columnForProperty:@"name"];
+    XCTAssertEqual(column.count, 1000);
+    XCTAssertEqual(column.nullCount, 0);
+    XCTAssertEqualObjects([column stringAtIndex:999], @"name-999-é");
+    XCTAssertEqual((uintptr_t)column.bytes % 64, 0);
+    NSString *all = [[NSString alloc] initWithBytes:column.bytes length:column.byteLength encoding:NSUTF8StringEncoding];
+    XCTAssertEqualObjects(all, expected);
+}
+
+@end
@@ -11,6 +11,7 @@
 
 #import <XCTest/XCTest.h>
 #import "YYModel.h"
+#import "YYModelMeta.h"
 
 
 typedef struct my_struct {
@@ -166,7 +167,41 @@ typedef struct my_struct {
     XCTAssertTrue(model2.selectorValue == @selector(stringWithFormat:));
     XCTAssertTrue(model2.myStructValue.b == 0); // ignore in NSKeyedArchiver
     XCTAssertTrue(model2.valueValue == nil);    // ignore in NSKeyedArchiver
-    
+
+    // c numbers with typed primitives
+    model1.boolValue = true;
+    model1.charValue = -12;
+    model1.unsignedLongLongValue = UINT64_MAX;
+    model1.longLongValue = INT64_MIN;
+    model1.doubleValue = 0.1;
+    model1.longDoubleValue = 1e300;
+    data = [NSKeyedArchiver archivedDataWithRootObject:model1];
+    model2 = [NSKeyedUnarchiver unarchiveObjectWithData:data];
+    XCTAssertTrue(model2.boolValue);
+    XCTAssertEqual(model2.charValue, -12);
+    XCTAssertEqual(model2.unsignedLongLongValue, UINT64_MAX);
+    XCTAssertEqual(model2.longLongValue, INT64_MIN);
+    XCTAssertEqual(model2.doubleValue, 0.1);
+    XCTAssertEqual(model2.longDoubleValue, (long double)1e300);
+    XCTAssertEqual(model1.floatValue, model2.floatValue);
+
+    // archive with NSNumber objects (before typed primitives)
+    NSMutableData *boxedData = [NSMutableData new];
+    NSKeyedArchiver *archiver = [[NSKeyedArchiver alloc] initForWritingWithMutableData:boxedData];
+    [archiver encodeObject:@(123) forKey:@"intValue"];
+    [archiver encodeObject:@YES forKey:@"boolValue"];
+    [archiver encodeObject:@(UINT64_MAX) forKey:@"unsignedLongLongValue"];
+    [archiver encodeObject:@(12.5) forKey:@"doubleValue"];
+    [archiver finishEncoding];
+    NSKeyedUnarchiver *unarchiver = [[NSKeyedUnarchiver alloc] initForReadingWithData:boxedData];
+    model2 = [[YYTestModelHashModel alloc] initWithCoder:unarchiver];
+    [unarchiver finishDecoding];
+    XCTAssertEqual(model2.intValue, 123);
+    XCTAssertTrue(model2.boolValue);
+    XCTAssertEqual(model2.unsignedLongLongValue, UINT64_MAX);
+    XCTAssertEqual(model2.doubleValue, 12.5);
+    XCTAssertEqual(model2.floatValue, 0);
+
     // for code coverage
     NSArray *array = @[model1, model2];
     NSMutableData *mutableData = [NSMutableData new];
@@ -182,4 +217,29 @@ typedef struct my_struct {
     XCTAssertTrue(mutableData.length > 0);
 }
 
+- (void)testCoderPlan {
+    _YYModelMeta *meta = [_YYModelMeta metaWithClass:[YYTestModelHashModel class]];
+    NSMutableDictionary *steps = [NSMutableDictionary new];
+    for (NSUInteger i = 0; i < meta->_coderPlanCount; i++) {
+        const _YYModelCoderStep *step = meta->_coderPlan + i;
+        XCTAssertTrue(step->key == step->meta->_name);
+        XCTAssertTrue(step->encode == NULL || step->getter != NULL);
+        XCTAssertTrue(step->decode == NULL || step->setter != NULL);
+        steps[step->key] = [NSValue valueWithPointer:step];
+    }
+    // c numbers, objects, SEL and archivable structs are encoded and decoded
+    for (NSString *name in @[@"boolValue", @"intValue", @"unsignedLongLongValue", @"longDoubleValue",
+                             @"selectorValue", @"sizeValue", @"string", @"number"]) {
+        const _YYModelCoderStep *step = [steps[name] pointerValue];
+        XCTAssertTrue(step && step->encode && step->decode);
+    }
+    // the struct is decoded only (it's invalid for NSKeyedArchiver)
+    const _YYModelCoderStep *step = [steps[@"transform3DValue"] pointerValue];
+    XCTAssertTrue(step && !step->encode && step->decode);
+    // Class, block and pointer are not archived
+    XCTAssertNil(steps[@"classValue"]);
+    XCTAssertNil(steps[@"blockValue"]);
+    XCTAssertNil(steps[@"pointerValue"]);
+}
+
 @end
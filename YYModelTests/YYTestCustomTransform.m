@@ -54,6 +54,47 @@
 @end
 
 
+@interface YYTestPropertyTransformerModel : NSObject
+@property uint64_t id;
+@property NSString *content;
+@property NSDate *time;
+@property int level;
+@property NSURL *url;
+@end
+
+@implementation YYTestPropertyTransformerModel
++ (NSDictionary *)modelPropertyTransformers {
+    return @{@"time" : [YYModelTransformer transformerWithDecoder:^id(id value) {
+                 if (![value isKindOfClass:[NSNumber class]]) return nil;
+                 return [NSDate dateWithTimeIntervalSince1970:[value unsignedLongLongValue] / 1000.0];
+             } encoder:^id(NSDate *date) {
+                 return @((uint64_t)(date.timeIntervalSince1970 * 1000));
+             }],
+             @"level" : [YYModelTransformer transformerWithDecoder:^id(id value) {
+                 return @([value intValue] * 10);
+             } encoder:^id(NSNumber *value) {
+                 return @(value.intValue / 10);
+             }],
+             @"content" : [YYModelTransformer transformerWithDecoder:^id(id value) {
+                 return [value isEqual:@"null"] ? [NSNull null] : value;
+             } encoder:nil]};
+}
+@end
+
+@interface YYTestTransformerURL : NSURL
+@end
+@implementation YYTestTransformerURL
+@end
+
+@interface YYTestClassTransformerModel : NSObject
+@property NSURL *url;
+@property YYTestTransformerURL *subURL;
+@property NSString *name;
+@end
+@implementation YYTestClassTransformerModel
+@end
+
+
 
 @interface YYTestCustomTransform : XCTestCase
 
@@ -93,4 +134,43 @@
     
 }
 
+- (void)testPropertyTransformer {
+    NSString *json = @"{\"id\":5472746497,\"content\":\"Hello\",\"time\":1401234567000,\"level\":\"3\"}";
+    YYTestPropertyTransformerModel *model = [YYTestPropertyTransformerModel yy_modelWithJSON:json];
+    XCTAssert(model.id == 5472746497);
+    XCTAssert([model.content isEqualToString:@"Hello"]);
+    XCTAssert(model.time.timeIntervalSince1970 == 1401234567);
+    XCTAssert(model.level == 30);
+    
+    NSDictionary *jsonObject = [model yy_modelToJSONObject];
+    XCTAssert([jsonObject[@"time"] isEqual:@1401234567000]);
+    XCTAssert([jsonObject[@"level"] isEqual:@3]);
+    XCTAssert([jsonObject[@"content"] isEqual:@"Hello"]);
+    
+    model = [YYTestPropertyTransformerModel yy_modelWithJSON:@"{\"time\":\"1401234567000\",\"content\":\"null\"}"];
+    XCTAssert(model.time == nil);
+    XCTAssert(model.content == nil);
+    jsonObject = [model yy_modelToJSONObject];
+    XCTAssert(jsonObject[@"time"] == nil);
+}
+
+- (void)testClassTransformer {
+    [YYModelTransformer registerTransformer:[YYModelTransformer transformerWithDecoder:^id(id value) {
+        if (![value isKindOfClass:[NSString class]]) return nil;
+        return [NSURL URLWithString:[@"https://example.com/" stringByAppendingString:value]];
+    } encoder:^id(NSURL *url) {
+        return url.path;
+    }] forClass:[NSURL class]];
+    
+    YYTestClassTransformerModel *model = [YYTestClassTransformerModel yy_modelWithJSON:@"{\"url\":\"a\",\"name\":\"b\"}"];
+    XCTAssert([model.url.absoluteString isEqualToString:@"https://example.com/a"]);
+    XCTAssert([model.name isEqualToString:@"b"]);
+    
+    NSDictionary *jsonObject = [model yy_modelToJSONObject];
+    XCTAssert([jsonObject[@"url"] isEqualToString:@"/a"]);
+    XCTAssert([jsonObject[@"name"] isEqualToString:@"b"]);
+    
+    [YYModelTransformer registerTransformer:nil forClass:[NSURL class]];
+}
+
 @end
@@ -0,0 +1,152 @@
+//
+//  YYTestDecodeCache.m
+//  YYModel <https://github.com/ibireme/YYModel>
+//
+//  This source code is licensed under the MIT-style license found in the
+//  LICENSE file in the root directory of this source tree.
+//
+
+#import <XCTest/XCTest.h>
+#import "YYModel.h"
+
+@interface YYTestDecodeCacheSharedModel : NSObject
+@property (nonatomic, assign) int id;
+@property (nonatomic, strong) NSString *name;
+@end
+
+@implementation YYTestDecodeCacheSharedModel
++ (YYModelDecodeCachePolicy)modelDecodeCachePolicy {
+    return YYModelDecodeCachePolicyShared;
+}
+@end
+
+@interface YYTestDecodeCacheCopyModel : NSObject
+@property (nonatomic, assign) int id;
+@property (nonatomic, strong) NSString *name;
+@property (nonatomic, strong) YYTestDecodeCacheCopyModel *child;
+@property (nonatomic, strong) NSMutableArray *children;
+@property (nonatomic, strong) NSDictionary *info;
+@property (nonatomic, strong) YYTestDecodeCacheCopyModel *alias;
+@property (nonatomic, weak) YYTestDecodeCacheCopyModel *parent;
+@end
+
+@implementation YYTestDecodeCacheCopyModel
++ (YYModelDecodeCachePolicy)modelDecodeCachePolicy {
+    return YYModelDecodeCachePolicyCopy;
+}
++ (NSDictionary *)modelContainerPropertyGenericClass {
+    return @{@"children" : [YYTestDecodeCacheCopyModel class]};
+}
+- (BOOL)modelCustomTransformFromDictionary:(NSDictionary *)dic {
+    _child.parent = self;
+    for (YYTestDecodeCacheCopyModel *one in _children) one.parent = self;
+    _alias = _child;
+    return YES;
+}
+@end
+
+@interface YYTestDecodeCacheNoneModel : NSObject
+@property (nonatomic, assign) int id;
+@end
+
+@implementation YYTestDecodeCacheNoneModel
+@end
+
+
+
+@interface YYTestDecodeCache : XCTestCase
+
+@end
+
+@implementation YYTestDecodeCache
+
+- (void)setUp {
+    [super setUp];
+    [YYModelDecodeCache removeAllObjects];
+    [YYModelDecodeCache setCostLimit:4 * 1024 * 1024];
+}
+
+- (void)testShared {
+    NSString *json = @"{\"id\":1,\"name\":\"a\"}";
+    YYTestDecodeCacheSharedModel *model1 = [YYTestDecodeCacheSharedModel yy_modelWithJSON:json];
+    YYTestDecodeCacheSharedModel *model2 = [YYTestDecodeCacheSharedModel yy_modelWithJSON:[json dataUsingEncoding:NSUTF8StringEncoding]];
+    XCTAssert(model1 == model2);
+    XCTAssert(model1.id == 1);
+    XCTAssert([YYModelDecodeCache totalCount] == 1);
+    XCTAssert([YYModelDecodeCache totalCost] == json.length);
+    
+    YYTestDecodeCacheSharedModel *model3 = [YYTestDecodeCacheSharedModel yy_modelWithJSON:@"{\"id\":2,\"name\":\"a\"}"];
+    XCTAssert(model3 != model1);
+    XCTAssert(model3.id == 2);
+    
+    // dictionary and invalid json are not cached
+    XCTAssert([YYTestDecodeCacheSharedModel yy_modelWithDictionary:@{@"id" : @1}] != model1);
+    XCTAssert([YYTestDecodeCacheSharedModel yy_modelWithJSON:@"[1]"] == nil);
+    XCTAssert([YYModelDecodeCache totalCount] == 2);
+}
+
+- (void)testCopy {
+    NSString *json = @"{\"id\":1,\"name\":\"a\"}";
+    YYTestDecodeCacheCopyModel *model1 = [YYTestDecodeCacheCopyModel yy_modelWithJSON:json];
+    model1.id = 100;
+    YYTestDecodeCacheCopyModel *model2 = [YYTestDecodeCacheCopyModel yy_modelWithJSON:json];
+    YYTestDecodeCacheCopyModel *model3 = [YYTestDecodeCacheCopyModel yy_modelWithJSON:json];
+    XCTAssert(model1 != model2 && model2 != model3);
+    XCTAssert(model2.id == 1 && model3.id == 1);
+    XCTAssert([model2.name isEqualToString:@"a"]);
+    
+    // nested models and collections are not shared with the cached model
+    json = @"{\"id\":1,\"child\":{\"id\":2},\"children\":[{\"id\":3}],\"info\":{\"k\":[1]}}";
+    model1 = [YYTestDecodeCacheCopyModel yy_modelWithJSON:json];
+    model1.child.id = 200;
+    ((YYTestDecodeCacheCopyModel *)model1.children[0]).id = 300;
+    [model1.children addObject:[YYTestDecodeCacheCopyModel new]];
+    model2 = [YYTestDecodeCacheCopyModel yy_modelWithJSON:json];
+    model3 = [YYTestDecodeCacheCopyModel yy_modelWithJSON:json];
+    XCTAssert(model2.child != model3.child && model2.children != model3.children);
+    XCTAssert(model2.child.id == 2);
+    XCTAssert(model2.children.count == 1 && ((YYTestDecodeCacheCopyModel *)model2.children[0]).id == 3);
+    XCTAssert(model2.children[0] != model3.children[0]);
+    XCTAssert([model2.children isKindOfClass:[NSMutableArray class]]);
+    XCTAssert([model2.info isEqual:@{@"k" : @[@1]}]);
+    
+    // back references and shared models refer to the copies
+    XCTAssert(model2.child.parent == model2);
+    XCTAssert(((YYTestDecodeCacheCopyModel *)model2.children[0]).parent == model2);
+    XCTAssert(model2.alias == model2.child);
+    XCTAssert(model3.child.parent == model3 && model3.alias == model3.child);
+    
+    // same bytes, different class
+    json = @"{\"id\":1,\"name\":\"a\"}";
+    YYTestDecodeCacheSharedModel *shared = [YYTestDecodeCacheSharedModel yy_modelWithJSON:json];
+    XCTAssert([shared isKindOfClass:[YYTestDecodeCacheSharedModel class]]);
+    XCTAssert([YYModelDecodeCache totalCount] == 3);
+}
+
+- (void)testNone {
+    NSString *json = @"{\"id\":1}";
+    XCTAssert([YYTestDecodeCacheNoneModel yy_modelWithJSON:json] != [YYTestDecodeCacheNoneModel yy_modelWithJSON:json]);
+    XCTAssert([YYModelDecodeCache totalCount] == 0);
+}
+
+- (void)testEviction {
+    [YYModelDecodeCache setCostLimit:40];
+    NSString *json1 = @"{\"id\":1,\"name\":\"0123456789\"}"; // 28 bytes
+    NSString *json2 = @"{\"id\":2}";                        // 8 bytes
+    NSString *json3 = @"{\"id\":3,\"name\":\"abc\"}";       // 21 bytes
+    YYTestDecodeCacheSharedModel *model1 = [YYTestDecodeCacheSharedModel yy_modelWithJSON:json1];
+    YYTestDecodeCacheSharedModel *model2 = [YYTestDecodeCacheSharedModel yy_modelWithJSON:json2];
+    XCTAssert([YYModelDecodeCache totalCost] == 36);
+    
+    // touch json1, then json2 is the least recently used
+    XCTAssert([YYTestDecodeCacheSharedModel yy_modelWithJSON:json1] == model1);
+    [YYTestDecodeCacheSharedModel yy_modelWithJSON:json3];
+    XCTAssert([YYModelDecodeCache totalCost] <= 40);
+    XCTAssert([YYTestDecodeCacheSharedModel yy_modelWithJSON:json2] != model2);
+    
+    [YYModelDecodeCache setCostLimit:0];
+    XCTAssert([YYModelDecodeCache totalCount] == 0);
+    XCTAssert([YYTestDecodeCacheSharedModel yy_modelWithJSON:json2] != [YYTestDecodeCacheSharedModel yy_modelWithJSON:json2]);
+}
+
+@end
@@ -0,0 +1,124 @@
+//
+//  YYTestEnumMapper.m
+//  YYModel <https://github.com/ibireme/YYModel>
+//
+//  This source code is licensed under the MIT-style license found in the
+//  LICENSE file in the root directory of this source tree.
+//
+
+#import <XCTest/XCTest.h>
+#import "YYModel.h"
+
+typedef NS_ENUM (NSInteger, YYTestGender) {
+    YYTestGenderUnknown = 0,
+    YYTestGenderMale,
+    YYTestGenderFemale,
+};
+
+@interface YYTestEnumModel : NSObject
+@property (nonatomic, assign) YYTestGender gender;
+@property (nonatomic, assign) uint8_t type;
+@property (nonatomic, assign) int64_t level;
+@property (nonatomic, assign) int count;
+@end
+
+@implementation YYTestEnumModel
++ (NSDictionary *)modelCustomPropertyMapper {
+    return @{@"type" : @"media.type"};
+}
++ (NSDictionary *)modelEnumPropertyMapper {
+    return @{@"gender" : @{@"male" : @(YYTestGenderMale), @"m" : @(YYTestGenderMale), @"female" : @(YYTestGenderFemale)},
+             @"type" : @{@"photo" : @1, @"video" : @2, @"视频" : @2},
+             @"level" : @{@"max" : @(INT64_MAX), @"min" : @(INT64_MIN)},
+             @"invalid" : @{@"a" : @1}};
+}
+@end
+
+@interface YYTestEnumNULModel : NSObject
+@property (nonatomic, assign) int type;
+@end
+
+@implementation YYTestEnumNULModel
++ (NSDictionary *)modelEnumPropertyMapper {
+    // keys differ after an embedded NUL, and a lone surrogate can't be converted to utf-8
+    NSString *ab = [NSString stringWithCharacters:(unichar[]){'a', 0, 'b'} length:3];
+    NSString *ac = [NSString stringWithCharacters:(unichar[]){'a', 0, 'c'} length:3];
+    NSString *surrogate = [NSString stringWithCharacters:(unichar[]){0xD800} length:1];
+    return @{@"type" : @{ab : @1, ac : @2, surrogate : @3}};
+}
+@end
+
+
+
+@interface YYTestEnumMapper : XCTestCase
+
+@end
+
+@implementation YYTestEnumMapper
+
+- (void)test {
+    NSString *json;
+    YYTestEnumModel *model;
+    NSDictionary *jsonObject;
+    
+    json = @"{\"gender\":\"female\",\"media\":{\"type\":\"video\"},\"level\":\"max\",\"count\":\"3\"}";
+    model = [YYTestEnumModel yy_modelWithJSON:json];
+    XCTAssert(model.gender == YYTestGenderFemale);
+    XCTAssert(model.type == 2);
+    XCTAssert(model.level == INT64_MAX);
+    XCTAssert(model.count == 3);
+    
+    jsonObject = [model yy_modelToJSONObject];
+    XCTAssert([jsonObject[@"gender"] isEqualToString:@"female"]);
+    XCTAssert([jsonObject[@"media"][@"type"] isEqualToString:@"video"]);
+    XCTAssert([jsonObject[@"level"] isEqualToString:@"max"]);
+    XCTAssert([jsonObject[@"count"] isEqual:@3]);
+    
+    json = @"{\"gender\":\"m\",\"media\":{\"type\":\"视频\"},\"level\":\"min\"}";
+    model = [YYTestEnumModel yy_modelWithJSON:json];
+    XCTAssert(model.gender == YYTestGenderMale);
+    XCTAssert(model.type == 2);
+    XCTAssert(model.level == INT64_MIN);
+    
+    jsonObject = [model yy_modelToJSONObject];
+    XCTAssert([jsonObject[@"gender"] isEqualToString:@"m"]); // "m" < "male"
+    XCTAssert([jsonObject[@"media"][@"type"] isEqualToString:@"video"]); // "video" < "视频"
+    
+    // not in mapper
+    json = @"{\"gender\":2,\"media\":{\"type\":\"3\"},\"level\":\"unknown\"}";
+    model = [YYTestEnumModel yy_modelWithJSON:json];
+    XCTAssert(model.gender == YYTestGenderFemale);
+    XCTAssert(model.type == 3);
+    XCTAssert(model.level == 0);
+    
+    jsonObject = [model yy_modelToJSONObject];
+    XCTAssert([jsonObject[@"gender"] isEqualToString:@"female"]);
+    XCTAssert([jsonObject[@"media"][@"type"] isEqual:@3]);
+    XCTAssert([jsonObject[@"level"] isEqual:@0]);
+    
+    json = @"{\"gender\":\"males\"}";
+    model = [YYTestEnumModel yy_modelWithJSON:json];
+    XCTAssert(model.gender == YYTestGenderUnknown);
+    
+    json = @"{\"gender\":\"\"}";
+    model = [YYTestEnumModel yy_modelWithJSON:json];
+    XCTAssert(model.gender == YYTestGenderUnknown);
+}
+
+- (void)testNULAndSurrogate {
+    YYTestEnumNULModel *model;
+    
+    model = [YYTestEnumNULModel yy_modelWithJSON:@"{\"type\":\"a\\u0000b\"}"];
+    XCTAssert(model.type == 1);
+    model = [YYTestEnumNULModel yy_modelWithJSON:@"{\"type\":\"a\\u0000c\"}"];
+    XCTAssert(model.type == 2);
+    model = [YYTestEnumNULModel yy_modelWithJSON:@"{\"type\":\"a\"}"];
+    XCTAssert(model.type == 0);
+    
+    model = [YYTestEnumNULModel new];
+    model.type = 2;
+    NSString *name = [model yy_modelToJSONObject][@"type"];
+    XCTAssert(name.length == 3 && [name characterAtIndex:2] == 'c');
+}
+
+@end
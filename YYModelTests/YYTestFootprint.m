@@ -0,0 +1,118 @@
+//
+//  YYTestFootprint.m
+//  YYModel <https://github.com/ibireme/YYModel>
+//
+//  This source code is licensed under the MIT-style license found in the
+//  LICENSE file in the root directory of this source tree.
+//
+
+#import <XCTest/XCTest.h>
+#import <objc/runtime.h>
+#import "YYModel.h"
+
+@interface YYTestFootprintNode : NSObject
+@property (nonatomic, assign) int64_t uid;
+@property (nonatomic, strong) NSString *name;
+@property (nonatomic, strong) NSData *data;
+@property (nonatomic, strong) NSArray *children;
+@property (nonatomic, strong) NSDictionary *info;
+@property (nonatomic, strong) YYTestFootprintNode *next;
+@property (nonatomic, weak) YYTestFootprintNode *parent;
+@end
+
+@implementation YYTestFootprintNode
+@end
+
+@interface YYTestFootprintLazyURL : NSObject
+@property (nonatomic, strong) NSURL *url;
+@end
+
+@implementation YYTestFootprintLazyURL
++ (BOOL)modelLazyURL {
+    return YES;
+}
+@end
+
+
+@interface YYTestFootprint : XCTestCase
+
+@end
+
+@implementation YYTestFootprint
+
+- (void)testFootprint {
+    YYTestFootprintNode *root = [YYTestFootprintNode new];
+    root.name = [NSString stringWithFormat:@"%@", [@"" stringByPaddingToLength:1000 withString:@"a" startingAtIndex:0]];
+    root.data = [NSMutableData dataWithLength:100000];
+
+    NSUInteger empty = [YYModelFootprint estimatedBytesOfObject:[YYTestFootprintNode new]];
+    XCTAssertTrue(empty >= class_getInstanceSize([YYTestFootprintNode class]));
+
+    NSUInteger base = [YYModelFootprint estimatedBytesOfObject:root];
+    XCTAssertTrue(base >= empty + 1000 + 100000);
+
+    // shared objects are counted once
+    NSMutableArray *children = [NSMutableArray new];
+    for (int i = 0; i < 10; i++) {
+        YYTestFootprintNode *child = [YYTestFootprintNode new];
+        child.name = root.name;
+        child.data = root.data;
+        child.parent = root;
+        child.next = root; // cycle
+        [children addObject:child];
+    }
+    root.children = children;
+    NSUInteger total = [YYModelFootprint estimatedBytesOfObject:root];
+    XCTAssertTrue(total > base + empty * 10);
+    XCTAssertTrue(total < base + empty * 10 + 100000);
+
+    YYModelFootprint *footprint = [YYModelFootprint footprintOfObject:root];
+    XCTAssertEqual(footprint.totalBytes, total);
+    XCTAssertEqual(footprint.objectCount, 1 + 1 + 1 + 1 + 10); // root, name, data, array, children
+    XCTAssertEqualObjects(footprint.countByClass[@"YYTestFootprintNode"], @11);
+    XCTAssertEqualObjects(footprint.countByClass[@"NSArray"], @1);
+    XCTAssertTrue([footprint.bytesByClass[@"NSData"] unsignedIntegerValue] >= 100000);
+    XCTAssertTrue([footprint.bytesByProperty[@"YYTestFootprintNode.data"] unsignedIntegerValue] >= 100000);
+    XCTAssertTrue([footprint.bytesByProperty[@"YYTestFootprintNode.children"] unsignedIntegerValue] >= empty * 10);
+    XCTAssertNil(footprint.bytesByProperty[@"YYTestFootprintNode.parent"]);
+
+    NSUInteger sum = 0;
+    for (NSNumber *bytes in footprint.bytesByClass.allValues) sum += bytes.unsignedIntegerValue;
+    XCTAssertEqual(sum, footprint.totalBytes);
+
+    // container of models
+    root.info = @{ @"key" : children };
+    NSUInteger rootBytes = [YYModelFootprint estimatedBytesOfObject:root];
+    NSUInteger arrayBytes = [YYModelFootprint estimatedBytesOfObject:@[root, root]];
+    XCTAssertTrue(arrayBytes > rootBytes);
+    XCTAssertTrue(arrayBytes < rootBytes + 256);
+
+    XCTAssertEqual([YYModelFootprint estimatedBytesOfObject:nil], 0);
+    XCTAssertEqual([YYModelFootprint footprintOfObject:nil].objectCount, 0);
+}
+
+- (void)testProxyAndObserved {
+    NSString *string = [@"https://example.com/" stringByPaddingToLength:200 withString:@"a" startingAtIndex:0];
+    YYTestFootprintLazyURL *lazy = [YYTestFootprintLazyURL yy_modelWithDictionary:@{ @"url" : string }];
+    XCTAssertTrue([lazy.url isProxy]);
+    YYModelFootprint *footprint = [YYModelFootprint footprintOfObject:lazy];
+    XCTAssertEqualObjects(footprint.countByClass[@"NSURL"], @1);
+    XCTAssertEqualObjects(footprint.countByClass[@"NSString"], @1);
+    XCTAssertTrue([footprint.bytesByProperty[@"YYTestFootprintLazyURL.url"] unsignedIntegerValue] >= 200);
+
+    YYTestFootprintNode *node = [YYTestFootprintNode new];
+    node.name = [@"" stringByPaddingToLength:100 withString:@"a" startingAtIndex:0];
+    NSUInteger bytes = [YYModelFootprint estimatedBytesOfObject:node];
+    [node addObserver:self forKeyPath:@"name" options:kNilOptions context:NULL];
+    footprint = [YYModelFootprint footprintOfObject:node];
+    XCTAssertEqual(footprint.totalBytes, bytes);
+    XCTAssertEqualObjects(footprint.countByClass[@"YYTestFootprintNode"], @1);
+    XCTAssertEqual(footprint.countByClass.count, 2); // the node and the name
+    XCTAssertNotNil(footprint.bytesByProperty[@"YYTestFootprintNode.name"]);
+    [node removeObserver:self forKeyPath:@"name"];
+}
+
+- (void)observeValueForKeyPath:(NSString *)keyPath ofObject:(id)object change:(NSDictionary *)change context:(void *)context {
+}
+
+@end
@@ -11,6 +11,7 @@
 
 #import <XCTest/XCTest.h>
 #import "YYModel.h"
+#import "YYModelMeta.h"
 
 
 @interface YYTestPropertyMapperModelAuto : NSObject
@@ -43,6 +44,55 @@
 }
 @end
 
+@interface YYTestPropertyMapperModelPlan : NSObject
+@property (nonatomic, strong) NSString *name;
+@property (nonatomic, strong) NSString *city;
+@property (nonatomic, strong) NSString *zip;
+@property (nonatomic, strong) NSNumber *modelID;
+@property (nonatomic, strong) NSString *title;
+@end
+
+@implementation YYTestPropertyMapperModelPlan
++ (NSDictionary *)modelCustomPropertyMapper {
+    return @{ @"name" : @[@"name", @"user.name"],
+              @"city" : @"user.address.city",
+              @"zip" : @[@"zip", @"user.address.zip", @"postcode"],
+              @"modelID" : @[@"id", @"ID", @"user.id"]};
+}
+@end
+
+@interface YYTestPropertyMapperModelPlanDictionary : YYTestPropertyMapperModelPlan
+@end
+
+@implementation YYTestPropertyMapperModelPlanDictionary
++ (YYModelDecodeStrategy)modelDecodeStrategy {
+    return YYModelDecodeStrategyDictionary;
+}
+@end
+
+@interface YYTestPropertyMapperModelPlanMappedKeys : YYTestPropertyMapperModelPlan
+@end
+
+@implementation YYTestPropertyMapperModelPlanMappedKeys
++ (YYModelDecodeStrategy)modelDecodeStrategy {
+    return YYModelDecodeStrategyMappedKeys;
+}
+@end
+
+@interface YYTestPropertyMapperModelWide : NSObject
+@property (nonatomic, assign) int p0, p1, p2, p3, p4, p5, p6, p7, p8, p9, p10, p11, p12, p13, p14, p15;
+@end
+
+@implementation YYTestPropertyMapperModelWide
+@end
+
+@interface YYTestPropertyMapperModelStatistics : NSObject
+@property (nonatomic, strong) NSString *a, *b, *c, *d, *e;
+@end
+
+@implementation YYTestPropertyMapperModelStatistics
+@end
+
 @interface YYTestPropertyMapperModelWarn : NSObject {
     NSString *_description;
 }
@@ -190,6 +240,75 @@
     XCTAssertTrue([jsonObject[@"ID"] isEqualToString:@"ABCD"]);
 }
 
+- (void)testKeyPlan {
+    NSDictionary *user = @{@"name" : @"user", @"id" : @3, @"address" : @{@"city" : @"Beijing", @"zip" : @"100000"}};
+    NSMutableDictionary *dic = @{@"user" : user, @"postcode" : @"200000", @"ID" : @2}.mutableCopy;
+    
+    // dictionary-driven
+    YYTestPropertyMapperModelPlan *model = [YYTestPropertyMapperModelPlan yy_modelWithDictionary:dic];
+    XCTAssert([model.name isEqualToString:@"user"]);
+    XCTAssert([model.city isEqualToString:@"Beijing"]);
+    XCTAssert([model.zip isEqualToString:@"100000"]);
+    XCTAssert([model.modelID isEqual:@2]);
+    
+    // key-driven
+    for (int i = 0; i < 10; i++) dic[[NSString stringWithFormat:@"extra%d", i]] = @(i);
+    dic[@"id"] = @1;
+    dic[@"name"] = @"top";
+    model = [YYTestPropertyMapperModelPlan yy_modelWithDictionary:dic];
+    XCTAssert([model.name isEqualToString:@"top"]);
+    XCTAssert([model.city isEqualToString:@"Beijing"]);
+    XCTAssert([model.zip isEqualToString:@"100000"]);
+    XCTAssert([model.modelID isEqual:@1]);
+    
+    model = [YYTestPropertyMapperModelPlan yy_modelWithDictionary:@{@"user" : @"invalid", @"postcode" : @"200000"}];
+    XCTAssert(model.name == nil);
+    XCTAssert(model.city == nil);
+    XCTAssert([model.zip isEqualToString:@"200000"]);
+    XCTAssert(model.title == nil);
+}
+
+- (void)testDecodeStrategy {
+    NSMutableDictionary *dic = @{@"user" : @{@"name" : @"user", @"address" : @{@"city" : @"Beijing"}}, @"postcode" : @"200000", @"ID" : @2}.mutableCopy;
+    NSArray *classes = @[[YYTestPropertyMapperModelPlan class],
+                         [YYTestPropertyMapperModelPlanDictionary class],
+                         [YYTestPropertyMapperModelPlanMappedKeys class]];
+    for (int round = 0; round < 2; round++) {
+        for (Class cls in classes) {
+            YYTestPropertyMapperModelPlan *model = [cls yy_modelWithDictionary:dic];
+            XCTAssert([model.name isEqualToString:@"user"]);
+            XCTAssert([model.city isEqualToString:@"Beijing"]);
+            XCTAssert([model.zip isEqualToString:@"200000"]);
+            XCTAssert([model.modelID isEqual:@2]);
+        }
+        // sparse payload, the automatic strategy looks up the mapped keys
+        for (int i = 0; i < 32; i++) dic[[NSString stringWithFormat:@"extra%d", i]] = @(i);
+    }
+    XCTAssertTrue(YYModelShouldIterateDictionary([_YYModelMeta metaWithClass:[YYTestPropertyMapperModelPlanDictionary class]], 100));
+    XCTAssertFalse(YYModelShouldIterateDictionary([_YYModelMeta metaWithClass:[YYTestPropertyMapperModelPlanMappedKeys class]], 1));
+    
+    // 16 mapped keys, no statistics
+    _YYModelMeta *meta = [_YYModelMeta metaWithClass:[YYTestPropertyMapperModelWide class]];
+    XCTAssertTrue(YYModelShouldIterateDictionary(meta, 10));  // dense: 10 mapped keys
+    XCTAssertFalse(YYModelShouldIterateDictionary(meta, 14)); // sparse: 2 mapped keys and 12 others
+    XCTAssertFalse(YYModelShouldIterateDictionary(meta, 32)); // dense with extra keys: 16 mapped keys and 16 others
+    
+    // with statistics, a lookup of 5 mapped keys is expected to stop early if all json keys are mapped
+    meta = [_YYModelMeta metaWithClass:[YYTestPropertyMapperModelStatistics class]];
+    XCTAssertTrue(YYModelShouldIterateDictionary(meta, 4));
+    for (int i = 0; i < 8; i++) {
+        YYTestPropertyMapperModelStatistics *model = [YYTestPropertyMapperModelStatistics yy_modelWithDictionary:@{@"a" : @"1", @"b" : @"2", @"c" : @"3", @"d" : @"4"}];
+        XCTAssert([model.d isEqualToString:@"4"]);
+    }
+    XCTAssertFalse(YYModelShouldIterateDictionary(meta, 4));
+    for (int i = 0; i < 64; i++) {
+        YYTestPropertyMapperModelStatistics *model = [YYTestPropertyMapperModelStatistics yy_modelWithDictionary:@{@"a" : @"1", @"b" : @"2", @"x" : @"3", @"y" : @"4"}];
+        XCTAssert([model.b isEqualToString:@"2"]);
+        XCTAssert(model.c == nil);
+    }
+    XCTAssertTrue(YYModelShouldIterateDictionary(meta, 4));
+}
+
 - (void)testWarn {
     NSString *json = @"{\"description\":\"Apple\",\"id\":12345}";
     YYTestPropertyMapperModelWarn *model = [YYTestPropertyMapperModelWarn yy_modelWithJSON:json];
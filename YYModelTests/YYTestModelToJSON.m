@@ -12,6 +12,7 @@
 #import <XCTest/XCTest.h>
 #import <UIKit/UIKit.h>
 #import "YYModel.h"
+#import "YYModelMeta.h"
 #import "YYTestHelper.h"
 
 @interface YYTestModelToJSONModel : NSObject
@@ -94,6 +95,51 @@
 
 
 
+@interface YYTestCanonicalJSONModel : NSObject
+@property (nonatomic, assign) int b;
+@property (nonatomic, assign) double a;
+@property (nonatomic, assign) BOOL flag;
+@property (nonatomic, assign) unsigned long long big;
+@property (nonatomic, strong) NSString *text;
+@property (nonatomic, strong) NSData *data;
+@property (nonatomic, strong) NSDictionary *dict;
+@property (nonatomic, strong) NSSet *set;
+@property (nonatomic, strong) NSDate *date;
+@property (nonatomic, strong) NSURL *url;
+@property (nonatomic, strong) YYTestCanonicalJSONModel *child;
+@end
+
+@implementation YYTestCanonicalJSONModel
++ (NSDictionary *)modelCustomPropertyMapper {
+    return @{@"text" : @"Text"};
+}
+@end
+
+
+
+@interface YYTestEncodePlanModel : NSObject
+@property (nonatomic, assign) int count;
+@property (nonatomic, strong) NSString *name;
+@property (nonatomic, strong) NSString *title;
+@end
+
+@implementation YYTestEncodePlanModel
++ (NSDictionary *)modelCustomPropertyMapper {
+    return @{@"name" : @[@"n", @"name"], @"title" : @[@"n", @"title"]};
+}
+@end
+
+@interface YYTestEncodePlanSubModel : YYTestEncodePlanModel
+@end
+
+@implementation YYTestEncodePlanSubModel
+- (int)count {
+    return [super count] + 1;
+}
+@end
+
+
+
 @interface YYTestModelToJSON : XCTestCase
 
 @end
@@ -166,4 +212,127 @@
     XCTAssert([newModel.date isEqualToDate:date]);
 }
 
+- (void)testCanonicalJSON {
+    YYTestCanonicalJSONModel *model = [YYTestCanonicalJSONModel new];
+    model.b = -3;
+    model.a = 0.1;
+    model.flag = YES;
+    model.big = UINT64_MAX;
+    model.text = @"q\"\\\n\x01é";
+    model.data = [NSData dataWithBytes:"abc" length:3];
+    model.dict = @{@"z" : @1, @"y" : @[@2.5, [NSNull null]], @"é" : @"", @"Z" : @1e21};
+    model.set = [NSSet setWithArray:@[@"b", @"a", @3]];
+    model.child = [YYTestCanonicalJSONModel new];
+    model.child.a = 100;
+    
+    NSString *json = [model yy_modelToCanonicalJSONString];
+    NSString *expected = @"{\"Text\":\"q\\\"\\\\\\n\\u0001é\",\"a\":0.1,\"b\":-3,\"big\":18446744073709551615,"
+                         @"\"child\":{\"a\":100,\"b\":0,\"big\":0,\"flag\":false},"
+                         @"\"dict\":{\"Z\":1e+21,\"y\":[2.5,null],\"z\":1,\"é\":\"\"},"
+                         @"\"flag\":true,\"set\":[\"a\",\"b\",3]}";
+    XCTAssert([json isEqualToString:expected]);
+    
+    YYTestCanonicalJSONModel *newModel = [YYTestCanonicalJSONModel yy_modelWithJSON:json];
+    XCTAssert([[newModel yy_modelToCanonicalJSONData] isEqualToData:[model yy_modelToCanonicalJSONData]]);
+    
+    // key path mapping falls back to sorting at runtime
+    YYTestKeyPathModelToJSONModel *keyPathModel = [YYTestKeyPathModelToJSONModel new];
+    keyPathModel.b = @"b";
+    keyPathModel.d = @"d";
+    XCTAssert([[keyPathModel yy_modelToCanonicalJSONString] isEqualToString:@"{\"d\":\"d\",\"ext\":{\"b\":\"b\"}}"]);
+    
+    XCTAssert([[@[model.child, [NSNull null]] yy_modelToCanonicalJSONString] isEqualToString:@"[{\"a\":100,\"b\":0,\"big\":0,\"flag\":false},null]"]);
+    XCTAssert([@"string" yy_modelToCanonicalJSONData] == nil);
+}
+
+- (void)testEncodePlan {
+    YYTestEncodePlanModel *model = [YYTestEncodePlanModel new];
+    model.count = 1;
+    model.name = @"a";
+    model.title = @"b";
+    
+    // properties mapped to the same first key: the first one (sorted by name) with value wins
+    NSDictionary *jsonObject = [model yy_modelToJSONObject];
+    XCTAssert([jsonObject[@"count"] isEqual:@1]);
+    XCTAssert([jsonObject[@"n"] isEqual:@"a"]);
+    XCTAssert([[model yy_modelToCanonicalJSONString] isEqualToString:@"{\"count\":1,\"n\":\"a\"}"]);
+    model.name = nil;
+    XCTAssert([[model yy_modelToJSONObject][@"n"] isEqual:@"b"]);
+    XCTAssert([[model yy_modelToCanonicalJSONString] isEqualToString:@"{\"count\":1,\"n\":\"b\"}"]);
+    
+    // the plan of subclass calls the overridden getter
+    YYTestEncodePlanSubModel *subModel = [YYTestEncodePlanSubModel new];
+    subModel.count = 1;
+    XCTAssert([[subModel yy_modelToJSONObject][@"count"] isEqual:@2]);
+    XCTAssert([[subModel yy_modelToCanonicalJSONString] isEqualToString:@"{\"count\":2}"]);
+}
+
+- (void)testDigest {
+    YYTestCanonicalJSONModel *model = [YYTestCanonicalJSONModel new];
+    model.a = 0.5;
+    model.b = 7;
+    model.text = @"text";
+    model.dict = @{@"k" : @[@1, @"2"]};
+    model.child = [YYTestCanonicalJSONModel new];
+    
+    uint8_t digest1[16], digest2[16];
+    XCTAssert([model yy_modelGetDigest:digest1]);
+    YYTestCanonicalJSONModel *copied = [YYTestCanonicalJSONModel yy_modelWithJSON:[model yy_modelToJSONString]];
+    XCTAssert([copied yy_modelGetDigest:digest2]);
+    XCTAssert(memcmp(digest1, digest2, 16) == 0);
+    
+    // consistent with the canonical json form
+    NSDictionary *jsonObject = [model yy_modelToJSONObject];
+    XCTAssert([[jsonObject yy_modelDigestString] isEqualToString:[model yy_modelDigestString]]);
+    XCTAssert([model yy_modelDigestString].length == 32);
+    
+    copied.child.b = 1;
+    XCTAssert([copied yy_modelGetDigest:digest2]);
+    XCTAssert(memcmp(digest1, digest2, 16) != 0);
+    
+    XCTAssert(![@"string" yy_modelGetDigest:digest1]);
+    XCTAssert([@"string" yy_modelDigestString] == nil);
+    
+    // c numbers, dates and urls are hashed directly, the digest is still the hash of canonical json
+    const uint8_t key[16] = {0x6c, 0x65, 0x64, 0x6f, 0x4d, 0x20, 0x59, 0x59, 0x00, 0x74, 0x73, 0x65, 0x67, 0x69, 0x44, 0x20};
+    model.big = UINT64_MAX;
+    model.a = -1e-7;
+    model.date = [NSDate dateWithTimeIntervalSince1970:1445299200.75];
+    model.url = [NSURL URLWithString:@"https://github.com/ibireme/YYModel?a=1#b"];
+    model.child.url = [NSURL URLWithString:@"YYModel" relativeToURL:[NSURL URLWithString:@"https://github.com/ibireme/"]];
+    model.child.date = [NSDate dateWithTimeIntervalSince1970:-5e10]; // out of the fast path
+    NSData *canonical = [model yy_modelToCanonicalJSONData];
+    jsonObject = [model yy_modelToJSONObject];
+    NSString *canonicalString = [[NSString alloc] initWithData:canonical encoding:NSUTF8StringEncoding];
+    XCTAssert([canonicalString containsString:[NSString stringWithFormat:@"\"date\":\"%@\"", jsonObject[@"date"]]]);
+    XCTAssert([canonicalString containsString:[NSString stringWithFormat:@"\"date\":\"%@\"", jsonObject[@"child"][@"date"]]]);
+    XCTAssert([canonicalString containsString:@"\"url\":\"https://github.com/ibireme/YYModel\""]);
+    XCTAssert([[jsonObject yy_modelDigestString] isEqualToString:[model yy_modelDigestString]]);
+    YYModelSipHash128(canonical.bytes, canonical.length, key, digest2);
+    XCTAssert([model yy_modelGetDigest:digest1]);
+    XCTAssert(memcmp(digest1, digest2, 16) == 0);
+}
+
+- (void)testSipHash {
+    // reference vectors of SipHash-2-4 with 128-bit output:
+    // key is 00 01 ... 0f, message is 00 01 ... (length - 1)
+    static const uint8_t vectors[][16] = {
+        {0xa3, 0x81, 0x7f, 0x04, 0xba, 0x25, 0xa8, 0xe6, 0x6d, 0xf6, 0x72, 0x14, 0xc7, 0x55, 0x02, 0x93}, // 0
+        {0xda, 0x87, 0xc1, 0xd8, 0x6b, 0x99, 0xaf, 0x44, 0x34, 0x76, 0x59, 0x11, 0x9b, 0x22, 0xfc, 0x45}, // 1
+        {0xa1, 0xf1, 0xeb, 0xbe, 0xd8, 0xdb, 0xc1, 0x53, 0xc0, 0xb8, 0x4a, 0xa6, 0x1f, 0xf0, 0x82, 0x39}, // 7
+        {0x3b, 0x62, 0xa9, 0xba, 0x62, 0x58, 0xf5, 0x61, 0x0f, 0x83, 0xe2, 0x64, 0xf3, 0x14, 0x97, 0xb4}, // 8
+        {0x54, 0x93, 0xe9, 0x99, 0x33, 0xb0, 0xa8, 0x11, 0x7e, 0x08, 0xec, 0x0f, 0x97, 0xcf, 0xc3, 0xd9}, // 15
+        {0x6e, 0xe2, 0xa4, 0xca, 0x67, 0xb0, 0x54, 0xbb, 0xfd, 0x33, 0x15, 0xbf, 0x85, 0x23, 0x05, 0x77}, // 16
+        {0x51, 0x50, 0xd1, 0x77, 0x2f, 0x50, 0x83, 0x4a, 0x50, 0x3e, 0x06, 0x9a, 0x97, 0x3f, 0xbd, 0x7c}, // 63
+    };
+    static const size_t lengths[] = {0, 1, 7, 8, 15, 16, 63};
+    uint8_t key[16], message[64], digest[16];
+    for (int i = 0; i < 16; i++) key[i] = i;
+    for (int i = 0; i < 64; i++) message[i] = i;
+    for (int i = 0; i < 7; i++) {
+        YYModelSipHash128(message, lengths[i], key, digest);
+        XCTAssert(memcmp(digest, vectors[i], 16) == 0);
+    }
+}
+
 @end
@@ -28,6 +28,31 @@
 @implementation YYTestNestRepo
 @end
 
+@interface YYTestNestBatchUser : YYTestNestUser
+@end
+@implementation YYTestNestBatchUser
++ (NSUInteger)modelAutoreleaseBatchSize { return 2; }
+@end
+
+@interface YYTestNestNoBatchUser : YYTestNestUser
+@end
+@implementation YYTestNestNoBatchUser
++ (NSUInteger)modelAutoreleaseBatchSize { return 0; }
+@end
+
+@interface YYTestNestGroup : NSObject
+@property NSArray *users;
+@property NSSet *userSet;
+@property NSDictionary *userDict;
+@end
+@implementation YYTestNestGroup
++ (NSDictionary *)modelContainerPropertyGenericClass {
+    return @{ @"users" : [YYTestNestBatchUser class],
+              @"userSet" : [YYTestNestBatchUser class],
+              @"userDict" : [YYTestNestBatchUser class] };
+}
+@end
+
 
 
 @interface YYTestNestModel : XCTestCase
@@ -55,4 +80,38 @@
     XCTAssert([repo.user.name isEqualToString:@"bot"]);
 }
 
+- (void)testCollectionBatch {
+    NSMutableArray *users = [NSMutableArray new];
+    NSMutableDictionary *userDict = [NSMutableDictionary new];
+    for (int i = 0; i < 7; i++) {
+        NSDictionary *user = @{ @"uid" : @(i), @"name" : [NSString stringWithFormat:@"user%d", i] };
+        [users addObject:user];
+        userDict[user[@"name"]] = user;
+    }
+    [users insertObject:@"invalid" atIndex:3];
+    
+    for (Class cls in @[ [YYTestNestBatchUser class], [YYTestNestNoBatchUser class] ]) {
+        NSArray *array = [NSArray yy_modelArrayWithClass:cls json:users];
+        XCTAssert(array.count == 7);
+        for (int i = 0; i < 7; i++) {
+            YYTestNestUser *user = array[i];
+            XCTAssert([user isKindOfClass:cls]);
+            XCTAssert(user.uid == i);
+            XCTAssert([user.name isEqualToString:([NSString stringWithFormat:@"user%d", i])]);
+        }
+        
+        NSDictionary *dict = [NSDictionary yy_modelDictionaryWithClass:cls json:userDict];
+        XCTAssert(dict.count == 7);
+        XCTAssert(((YYTestNestUser *)dict[@"user5"]).uid == 5);
+    }
+    
+    YYTestNestGroup *group = [YYTestNestGroup yy_modelWithJSON:@{ @"users" : users, @"userSet" : users, @"userDict" : userDict }];
+    XCTAssert(group.users.count == 7);
+    XCTAssert(((YYTestNestUser *)group.users[6]).uid == 6);
+    XCTAssert([group.users.firstObject isKindOfClass:[YYTestNestBatchUser class]]);
+    XCTAssert(group.userSet.count == 7);
+    XCTAssert(group.userDict.count == 7);
+    XCTAssert([((YYTestNestUser *)group.userDict[@"user3"]).name isEqualToString:@"user3"]);
+}
+
 @end
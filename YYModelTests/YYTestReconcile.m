@@ -0,0 +1,162 @@
+//
+//  YYTestReconcile.m
+//  YYModel <https://github.com/ibireme/YYModel>
+//
+//  This source code is licensed under the MIT-style license found in the
+//  LICENSE file in the root directory of this source tree.
+//
+
+#import <XCTest/XCTest.h>
+#import "YYModel.h"
+
+@interface YYTestReconcileProfile : NSObject
+@property (nonatomic, strong) NSString *city;
+@end
+
+@implementation YYTestReconcileProfile
+@end
+
+@interface YYTestReconcileUser : NSObject
+@property (nonatomic, assign) int64_t uid;
+@property (nonatomic, strong) NSString *name;
+@property (nonatomic, assign) int age;
+@property (nonatomic, strong) YYTestReconcileProfile *profile;
+@property (nonatomic, assign) BOOL selected; ///< local state, not in json
+@property (nonatomic, assign) NSUInteger setterCount;
+@end
+
+@implementation YYTestReconcileUser
++ (NSArray *)modelPropertyBlacklist {
+    return @[ @"selected", @"setterCount" ];
+}
+- (void)setName:(NSString *)name {
+    _name = name;
+    _setterCount++;
+}
+- (void)setAge:(int)age {
+    _age = age;
+    _setterCount++;
+}
+- (void)setProfile:(YYTestReconcileProfile *)profile {
+    _profile = profile;
+    _setterCount++;
+}
+@end
+
+
+@interface YYTestReconcile : XCTestCase
+
+@end
+
+@implementation YYTestReconcile
+
+- (NSArray *)usersWithJSON:(NSString *)json {
+    NSArray *users = [NSArray yy_modelArrayWithClass:[YYTestReconcileUser class] json:json];
+    for (YYTestReconcileUser *user in users) user.setterCount = 0;
+    return users;
+}
+
+- (void)testReconcile {
+    NSArray *old = [self usersWithJSON:@"[{\"uid\":1,\"name\":\"a\",\"age\":10},{\"uid\":2,\"name\":\"b\",\"age\":20},"
+                    "{\"uid\":3,\"name\":\"c\",\"age\":30},{\"uid\":4,\"name\":\"d\",\"age\":40}]"];
+    ((YYTestReconcileUser *)old[2]).selected = YES;
+
+    NSString *json = @"[{\"uid\":3,\"name\":\"c\",\"age\":30},{\"uid\":1,\"name\":\"aa\",\"age\":10},"
+    "{\"uid\":5,\"name\":\"e\"},{\"uid\":\"2\",\"name\":\"b\"}, 1]";
+    YYModelReconciliation *result = [YYModelReconciliation reconciliationWithModels:old class:[YYTestReconcileUser class] json:json primaryKey:@"uid"];
+    XCTAssert(result.array.count == 4);
+    XCTAssert(result.array[0] == old[2]);
+    XCTAssert(result.array[1] == old[0]);
+    XCTAssert(result.array[3] == old[1]); // "2" is converted to int64
+    XCTAssert(((YYTestReconcileUser *)result.array[2]).uid == 5);
+
+    XCTAssert([result.insertedIndexes isEqualToIndexSet:[NSIndexSet indexSetWithIndex:2]]);
+    XCTAssert([result.deletedIndexes isEqualToIndexSet:[NSIndexSet indexSetWithIndex:3]]);
+    XCTAssert([result.updatedIndexes isEqualToIndexSet:[NSIndexSet indexSetWithIndex:1]]);
+    XCTAssert([result.movedIndexes isEqualToIndexSet:[NSIndexSet indexSetWithIndex:0]]);
+    XCTAssert([result oldIndexOfObjectAtIndex:0] == 2);
+    XCTAssert([result oldIndexOfObjectAtIndex:2] == NSNotFound);
+    XCTAssert([result oldIndexOfObjectAtIndex:4] == NSNotFound);
+
+    // only the changed property is set, the unchanged models are not touched
+    YYTestReconcileUser *user = result.array[1];
+    XCTAssert([user.name isEqualToString:@"aa"]);
+    XCTAssert(user.setterCount == 1);
+    XCTAssert(((YYTestReconcileUser *)old[1]).setterCount == 0);
+    XCTAssert(((YYTestReconcileUser *)old[2]).setterCount == 0);
+    XCTAssert(((YYTestReconcileUser *)old[2]).selected);
+
+    // absent key is not changed
+    XCTAssert(((YYTestReconcileUser *)old[1]).age == 20);
+}
+
+- (void)testNestedModel {
+    NSArray *old = [self usersWithJSON:@"[{\"uid\":1,\"profile\":{\"city\":\"x\"}},{\"uid\":2,\"profile\":{\"city\":\"y\"}}]"];
+    YYTestReconcileProfile *profile1 = ((YYTestReconcileUser *)old[0]).profile;
+    YYTestReconcileProfile *profile2 = ((YYTestReconcileUser *)old[1]).profile;
+
+    NSString *json = @"[{\"uid\":1,\"profile\":{\"city\":\"x\"}},{\"uid\":2,\"profile\":{\"city\":\"z\"}}]";
+    YYModelReconciliation *result = [YYModelReconciliation reconciliationWithModels:old class:[YYTestReconcileUser class] json:json primaryKey:@"uid"];
+    XCTAssert(result.array[0] == old[0]);
+    XCTAssert(result.array[1] == old[1]);
+    XCTAssert([result.updatedIndexes isEqualToIndexSet:[NSIndexSet indexSetWithIndex:1]]);
+    XCTAssert(result.movedIndexes.count == 0);
+    XCTAssert(((YYTestReconcileUser *)old[0]).profile == profile1);
+    XCTAssert(((YYTestReconcileUser *)old[1]).profile != profile2);
+    XCTAssert([((YYTestReconcileUser *)old[1]).profile.city isEqualToString:@"z"]);
+    XCTAssert([profile2.city isEqualToString:@"y"]);
+
+    // null clears the nested model, an invalid value is ignored
+    json = @"[{\"uid\":1,\"profile\":null},{\"uid\":2,\"profile\":1}]";
+    result = [YYModelReconciliation reconciliationWithModels:old class:[YYTestReconcileUser class] json:json primaryKey:@"uid"];
+    XCTAssert([result.updatedIndexes isEqualToIndexSet:[NSIndexSet indexSetWithIndex:0]]);
+    XCTAssert(((YYTestReconcileUser *)old[0]).profile == nil);
+    XCTAssert(((YYTestReconcileUser *)old[1]).profile != nil);
+}
+
+- (void)testMoveAndDuplicate {
+    NSArray *old = [self usersWithJSON:@"[{\"uid\":1},{\"uid\":2},{\"uid\":3},{\"uid\":4},{\"uid\":4}]"];
+    NSString *json = @"[{\"uid\":4},{\"uid\":1},{\"uid\":2},{\"uid\":3},{\"uid\":1},{\"name\":\"x\"}]";
+    YYModelReconciliation *result = [YYModelReconciliation reconciliationWithModels:old class:[YYTestReconcileUser class] json:json primaryKey:@"uid"];
+    XCTAssert(result.array.count == 6);
+    XCTAssert([result.movedIndexes isEqualToIndexSet:[NSIndexSet indexSetWithIndex:0]]);
+    NSMutableIndexSet *inserted = [NSMutableIndexSet indexSetWithIndex:4];
+    [inserted addIndex:5];
+    XCTAssert([result.insertedIndexes isEqualToIndexSet:inserted]);
+    XCTAssert([result.deletedIndexes isEqualToIndexSet:[NSIndexSet indexSetWithIndex:4]]);
+    XCTAssert(result.updatedIndexes.count == 0);
+}
+
+- (void)testObservedModel {
+    NSArray *old = [self usersWithJSON:@"[{\"uid\":1,\"name\":\"a\"},{\"uid\":2,\"name\":\"b\"}]"];
+    YYTestReconcileUser *user = old[0];
+    [user addObserver:self forKeyPath:@"name" options:kNilOptions context:NULL];
+
+    NSString *json = @"[{\"uid\":1,\"name\":\"aa\"},{\"uid\":2,\"name\":\"b\"}]";
+    YYModelReconciliation *result = [YYModelReconciliation reconciliationWithModels:old class:[YYTestReconcileUser class] json:json primaryKey:@"uid"];
+    XCTAssert(result.array[0] == user);
+    XCTAssert(result.array[1] == old[1]);
+    XCTAssert([user.name isEqualToString:@"aa"]);
+    XCTAssert([result.updatedIndexes isEqualToIndexSet:[NSIndexSet indexSetWithIndex:0]]);
+    XCTAssert(result.insertedIndexes.count == 0);
+    XCTAssert(result.deletedIndexes.count == 0);
+
+    [user removeObserver:self forKeyPath:@"name"];
+}
+
+- (void)observeValueForKeyPath:(NSString *)keyPath ofObject:(id)object change:(NSDictionary *)change context:(void *)context {
+}
+
+- (void)testInvalid {
+    Class cls = [YYTestReconcileUser class];
+    XCTAssert([YYModelReconciliation reconciliationWithModels:nil class:cls json:@"[]" primaryKey:@"id"] == nil);
+    XCTAssert([YYModelReconciliation reconciliationWithModels:nil class:cls json:@"{}" primaryKey:@"uid"] == nil);
+    XCTAssert([YYModelReconciliation reconciliationWithModels:nil class:cls json:@"[]" primaryKey:@"selected"] == nil);
+
+    YYModelReconciliation *result = [YYModelReconciliation reconciliationWithModels:nil class:cls json:@"[{\"uid\":1}]" primaryKey:@"uid"];
+    XCTAssert(result.array.count == 1);
+    XCTAssert([result.insertedIndexes isEqualToIndexSet:[NSIndexSet indexSetWithIndex:0]]);
+    XCTAssert(result.deletedIndexes.count == 0);
+}
+
+@end
@@ -0,0 +1,240 @@
+//
+//  YYTestSQLite.m
+//  YYModel <https://github.com/ibireme/YYModel>
+//
+//  This source code is licensed under the MIT-style license found in the
+//  LICENSE file in the root directory of this source tree.
+//
+
+#import <XCTest/XCTest.h>
+#import "YYModel.h"
+
+@interface YYTestSQLiteTag : NSObject
+@property (nonatomic, strong) NSString *name;
+@end
+
+@implementation YYTestSQLiteTag
+@end
+
+@interface YYTestSQLiteModel : NSObject
+@property (nonatomic, assign) int64_t uid;
+@property (nonatomic, assign) bool b;
+@property (nonatomic, assign) int i;
+@property (nonatomic, assign) uint64_t ul;
+@property (nonatomic, assign) double d;
+@property (nonatomic, strong) NSNumber *num;
+@property (nonatomic, strong) NSDecimalNumber *decimal;
+@property (nonatomic, strong) NSString *name;
+@property (nonatomic, strong) NSMutableString *mutableName;
+@property (nonatomic, strong) NSURL *url;
+@property (nonatomic, strong) NSData *data;
+@property (nonatomic, strong) NSDate *date;
+@property (nonatomic, strong) YYTestSQLiteTag *tag;
+@property (nonatomic, strong) NSArray *tags;
+@property (nonatomic, strong) NSDictionary *info;
+@property (nonatomic, assign) CGPoint point;
+@end
+
+@implementation YYTestSQLiteModel
++ (NSDictionary *)modelContainerPropertyGenericClass {
+    return @{ @"tags" : [YYTestSQLiteTag class] };
+}
+@end
+
+@interface YYTestSQLiteTransformModel : NSObject
+@property (nonatomic, assign) int64_t uid;
+@property (nonatomic, assign) int level;
+@end
+
+@implementation YYTestSQLiteTransformModel
++ (NSDictionary *)modelPropertyTransformers {
+    return @{@"level" : [YYModelTransformer transformerWithDecoder:^id(id value) {
+                 if (![value isKindOfClass:[NSString class]]) return nil;
+                 return @([[value substringFromIndex:1] intValue]);
+             } encoder:^id(NSNumber *value) {
+                 return [NSString stringWithFormat:@"L%d", value.intValue];
+             }]};
+}
+@end
+
+
+@interface YYTestSQLite : XCTestCase
+@property (nonatomic, strong) NSString *path;
+@end
+
+@implementation YYTestSQLite
+
+- (void)setUp {
+    [super setUp];
+    self.path = [NSTemporaryDirectory() stringByAppendingPathComponent:@"yymodel_test.sqlite"];
+    [self removeDatabase];
+}
+
+- (void)tearDown {
+    [self removeDatabase];
+    [super tearDown];
+}
+
+- (void)removeDatabase {
+    for (NSString *suffix in @[@"", @"-wal", @"-shm"]) {
+        [[NSFileManager defaultManager] removeItemAtPath:[self.path stringByAppendingString:suffix] error:NULL];
+    }
+}
+
+- (void)testReadWrite {
+    YYModelSQLite *db = [[YYModelSQLite alloc] initWithPath:self.path];
+    XCTAssertNotNil(db);
+    XCTAssertTrue([db createTableWithClass:[YYTestSQLiteModel class] primaryKey:@"uid"]);
+    XCTAssertFalse([db createTableWithClass:[YYTestSQLiteModel class] primaryKey:@"unknown"]);
+
+    YYTestSQLiteModel *model = [YYTestSQLiteModel new];
+    model.uid = 1;
+    model.b = true;
+    model.i = -12;
+    model.ul = UINT64_MAX;
+    model.d = 0.1;
+    model.num = @(UINT64_MAX);
+    model.decimal = [NSDecimalNumber decimalNumberWithString:@"12345678901234567890.123"];
+    model.name = @"中文 😀";
+    model.mutableName = @"Harry".mutableCopy;
+    model.url = [NSURL URLWithString:@"https://a.com/x"];
+    model.data = [NSData data];
+    model.date = [NSDate dateWithTimeIntervalSince1970:1445000000.5];
+    YYTestSQLiteTag *tag = [YYTestSQLiteTag new];
+    tag.name = @"t";
+    model.tag = tag;
+    model.tags = @[tag, tag];
+    model.info = @{ @"a" : @1, @"b" : @[@"x"] };
+    model.point = CGPointMake(1, 2);
+
+    YYTestSQLiteModel *empty = [YYTestSQLiteModel new];
+    empty.uid = 2;
+    XCTAssertTrue([db insertModels:@[model, @"not a model", empty] class:[YYTestSQLiteModel class]]);
+    XCTAssertEqual([db countOfModelsWithClass:[YYTestSQLiteModel class] where:nil arguments:nil], 2);
+
+    NSArray *models = [db modelsWithClass:[YYTestSQLiteModel class] where:@"uid = ?" arguments:@[@1]];
+    XCTAssertEqual(models.count, 1);
+    YYTestSQLiteModel *one = models.firstObject;
+    XCTAssertEqual(one.uid, 1);
+    XCTAssertTrue(one.b);
+    XCTAssertEqual(one.i, -12);
+    XCTAssertEqual(one.ul, UINT64_MAX);
+    XCTAssertEqual(one.d, 0.1);
+    XCTAssertEqualObjects(one.num, @(UINT64_MAX));
+    XCTAssertEqualObjects(one.decimal, model.decimal);
+    XCTAssertEqualObjects(one.name, model.name);
+    XCTAssertTrue([one.mutableName isKindOfClass:[NSMutableString class]]);
+    XCTAssertEqualObjects(one.mutableName, @"Harry");
+    XCTAssertEqualObjects(one.url, model.url);
+    XCTAssertEqualObjects(one.data, [NSData data]);
+    XCTAssertEqualObjects(one.date, model.date);
+    XCTAssertEqualObjects(one.tag.name, @"t");
+    XCTAssertEqual(one.tags.count, 2);
+    XCTAssertTrue([one.tags.firstObject isKindOfClass:[YYTestSQLiteTag class]]);
+    XCTAssertEqualObjects(one.info, model.info);
+    XCTAssertTrue(CGPointEqualToPoint(one.point, CGPointZero)); // struct is not stored
+
+    one = [db modelsWithClass:[YYTestSQLiteModel class] where:@"uid = ?" arguments:@[@2]].firstObject;
+    XCTAssertEqual(one.uid, 2);
+    XCTAssertNil(one.name);
+    XCTAssertNil(one.data);
+    XCTAssertNil(one.tag);
+
+    // replace by primary key
+    model.name = @"new";
+    XCTAssertTrue([db insertModels:@[model] class:[YYTestSQLiteModel class]]);
+    XCTAssertEqual([db countOfModelsWithClass:[YYTestSQLiteModel class] where:nil arguments:nil], 2);
+    one = [db modelsWithClass:[YYTestSQLiteModel class] where:@"name = ?" arguments:@[@"new"]].firstObject;
+    XCTAssertEqual(one.uid, 1);
+
+    XCTAssertTrue([db deleteModelsWithClass:[YYTestSQLiteModel class] where:@"uid > ?" arguments:@[@1]]);
+    XCTAssertEqual([db countOfModelsWithClass:[YYTestSQLiteModel class] where:nil arguments:nil], 1);
+
+    // invalid sql or arguments
+    XCTAssertNil([db modelsWithClass:[YYTestSQLiteModel class] where:@"unknown = ?" arguments:@[@1]]);
+    XCTAssertNil([db modelsWithClass:[YYTestSQLiteModel class] where:@"uid = ?" arguments:nil]);
+    XCTAssertNil([db modelsWithClass:[YYTestSQLiteModel class] where:@"uid = ?" arguments:@[[NSObject new]]]);
+    XCTAssertEqual([db modelsWithClass:[YYTestSQLiteModel class] where:nil arguments:nil].count, 1);
+
+    [db close];
+    XCTAssertNil([db modelsWithClass:[YYTestSQLiteModel class] where:nil arguments:nil]);
+    XCTAssertFalse([db insertModels:@[model] class:[YYTestSQLiteModel class]]);
+
+    // reopen the file
+    db = [[YYModelSQLite alloc] initWithPath:self.path];
+    one = [db modelsWithClass:[YYTestSQLiteModel class] where:nil arguments:nil].firstObject;
+    XCTAssertEqualObjects(one.name, @"new");
+    XCTAssertEqual(one.ul, UINT64_MAX);
+}
+
+- (void)testPrimaryKeyMismatch {
+    YYModelSQLite *db = [[YYModelSQLite alloc] initWithPath:self.path];
+    XCTAssertEqual([db countOfModelsWithClass:[YYTestSQLiteModel class] where:nil arguments:nil], 0); // created without primary key
+    XCTAssertFalse([db createTableWithClass:[YYTestSQLiteModel class] primaryKey:@"uid"]);
+    XCTAssertTrue([db createTableWithClass:[YYTestSQLiteModel class] primaryKey:nil]);
+    [db close];
+
+    [self removeDatabase];
+    db = [[YYModelSQLite alloc] initWithPath:self.path];
+    XCTAssertTrue([db createTableWithClass:[YYTestSQLiteModel class] primaryKey:@"uid"]);
+    XCTAssertTrue([db createTableWithClass:[YYTestSQLiteModel class] primaryKey:@"uid"]);
+    XCTAssertFalse([db createTableWithClass:[YYTestSQLiteModel class] primaryKey:@"name"]);
+    [db close];
+}
+
+- (void)testBatch {
+    YYModelSQLite *db = [[YYModelSQLite alloc] initWithPath:self.path];
+    db.transactionBatchSize = 300;
+    NSMutableArray *models = [NSMutableArray new];
+    for (int i = 0; i < 5000; i++) {
+        YYTestSQLiteModel *model = [YYTestSQLiteModel new];
+        model.uid = i;
+        model.i = i * 2;
+        model.name = [NSString stringWithFormat:@"name-%d", i];
+        [models addObject:model];
+    }
+    XCTAssertTrue([db insertModels:models class:[YYTestSQLiteModel class]]);
+    XCTAssertEqual([db countOfModelsWithClass:[YYTestSQLiteModel class] where:nil arguments:nil], 5000);
+
+    NSArray *read = [db modelsWithClass:[YYTestSQLiteModel class] where:@"i >= ? ORDER BY uid DESC LIMIT 10" arguments:@[@100]];
+    XCTAssertEqual(read.count, 10);
+    XCTAssertEqual(((YYTestSQLiteModel *)read.firstObject).uid, 4999);
+    XCTAssertEqualObjects(((YYTestSQLiteModel *)read.firstObject).name, @"name-4999");
+
+    // reuse the cached statement with other arguments
+    for (int i = 0; i < 100; i++) {
+        YYTestSQLiteModel *one = [db modelsWithClass:[YYTestSQLiteModel class] where:@"uid = ?" arguments:@[@(i * 7)]].firstObject;
+        XCTAssertEqual(one.i, i * 14);
+    }
+}
+
+- (void)testTransformer {
+    YYModelSQLite *db = [[YYModelSQLite alloc] initWithPath:self.path];
+    XCTAssertTrue([db createTableWithClass:[YYTestSQLiteTransformModel class] primaryKey:@"uid"]);
+    YYTestSQLiteTransformModel *model = [YYTestSQLiteTransformModel new];
+    model.uid = 1;
+    model.level = 7;
+    XCTAssertTrue([db insertModels:@[model] class:[YYTestSQLiteTransformModel class]]);
+
+    // the c number goes through the transformer, and is stored as a blob of the json value
+    XCTAssertEqual([db countOfModelsWithClass:[YYTestSQLiteTransformModel class] where:@"typeof(level) = 'blob'" arguments:nil], 1);
+    YYTestSQLiteTransformModel *one = [db modelsWithClass:[YYTestSQLiteTransformModel class] where:nil arguments:nil].firstObject;
+    XCTAssertEqual(one.level, 7);
+}
+
+- (void)testConcurrent {
+    YYModelSQLite *db = [[YYModelSQLite alloc] initWithPath:self.path];
+    dispatch_apply(8, dispatch_get_global_queue(0, 0), ^(size_t n) {
+        NSMutableArray *models = [NSMutableArray new];
+        for (int i = 0; i < 100; i++) {
+            YYTestSQLiteModel *model = [YYTestSQLiteModel new];
+            model.i = (int)n;
+            [models addObject:model];
+        }
+        [db insertModels:models class:[YYTestSQLiteModel class]];
+        [db countOfModelsWithClass:[YYTestSQLiteModel class] where:@"i = ?" arguments:@[@(n)]];
+    });
+    XCTAssertEqual([db countOfModelsWithClass:[YYTestSQLiteModel class] where:nil arguments:nil], 800);
+}
+
+@end